@@ -0,0 +1,203 @@
+#pragma once
+/*
+ * File contains compact affine transform
+ *
+ * Affine<T> keeps top 3 rows of 4x4 affine matrix: linear part (rotation,
+ * scale, shear) and translation column. Last row (0 0 0 1) is implicit,
+ * so it takes 48 (float) or 96 (double) bytes against 64/128 of
+ * Matrix<T,4,4> and skips a quarter of multiplications.
+ * Convention matches transform.hpp: column vectors, a * b applies b first.
+ *
+ * Composition and inverse are dispatched by Optimizer, batch transforms of
+ * vectors go through transform.hpp kernels.
+*/
+
+#include "quaternion.hpp"
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <StreamType T>
+class Affine
+{
+public:
+    using Type = T;
+    using Array = T[3][4];
+
+    // identity transform
+    Affine() noexcept : _rows{{T(1), T(0), T(0), T(0)}, {T(0), T(1), T(0), T(0)}, {T(0), T(0), T(1), T(0)}} {}
+    explicit Affine(const Matrix<T, 3, 3> &linear, const Vector3D<T> &translation = Vector3D<T>(T(0))) noexcept
+    {
+        for (std::size_t i = 0; i < 3; ++i)
+            _rows[i] = Vector4D<T>(linear[i][0], linear[i][1], linear[i][2], translation[i]);
+    }
+    explicit Affine(const Quaternion<T> &rotation, const Vector3D<T> &translation = Vector3D<T>(T(0))) noexcept
+        : Affine(rotation.matrix3(), translation)
+    {}
+    // last row of m is dropped, it must be (0 0 0 1)
+    explicit Affine(const Matrix<T, 4, 4> &m) noexcept
+    {
+        for (std::size_t i = 0; i < 3; ++i)
+            _rows[i] = Vector4D<T>(m[i][0], m[i][1], m[i][2], m[i][3]);
+    }
+
+    Vector4D<T> &operator[](std::size_t row) noexcept
+    {
+        assert(row < 3);
+        return _rows[row];
+    }
+    const Vector4D<T> &operator[](std::size_t row) const noexcept
+    {
+        assert(row < 3);
+        return _rows[row];
+    }
+    Array &data() noexcept { return reinterpret_cast<Array &>(_rows); }
+    const Array &data() const noexcept { return reinterpret_cast<const Array &>(_rows); }
+
+    Matrix<T, 3, 3> linear() const noexcept
+    {
+        Matrix<T, 3, 3> m;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                m[i][j] = _rows[i][j];
+        return m;
+    }
+    Vector3D<T> translation() const noexcept { return Vector3D<T>(_rows[0][3], _rows[1][3], _rows[2][3]); }
+    Matrix<T, 4, 4> matrix4() const noexcept
+    {
+        Matrix<T, 4, 4> m(T(0));
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                m[i][j] = _rows[i][j];
+        m[3][3] = T(1);
+        return m;
+    }
+
+    // p' = A * p + t
+    Vector3D<T> transformPoint(const Vector3D<T> &p) const noexcept
+    {
+        return Vector3D<T>(row(0, p) + _rows[0][3], row(1, p) + _rows[1][3], row(2, p) + _rows[2][3]);
+    }
+    // d' = A * d
+    Vector3D<T> transformDirection(const Vector3D<T> &d) const noexcept
+    {
+        return Vector3D<T>(row(0, d), row(1, d), row(2, d));
+    }
+
+    // applies a first, then this
+    Affine &operator*=(const Affine &a) noexcept
+    {
+        _OptimizerInternal::composeAffine<T>(data(), a.data(), data());
+        return *this;
+    }
+
+    friend bool operator==(const Affine &lhs, const Affine &rhs)
+    {
+        return lhs._rows[0] == rhs._rows[0] && lhs._rows[1] == rhs._rows[1] && lhs._rows[2] == rhs._rows[2];
+    }
+    friend bool operator!=(const Affine &lhs, const Affine &rhs) { return !(lhs == rhs); }
+
+private:
+    T row(std::size_t i, const Vector3D<T> &v) const noexcept
+    {
+        return _rows[i][0] * v[0] + _rows[i][1] * v[1] + _rows[i][2] * v[2];
+    }
+
+    Vector4D<T> _rows[3];
+};
+
+template <StreamType T>
+Affine<T> operator*(Affine<T> lhs, const Affine<T> &rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+/*
+ * Inverse through 3x3 inverse of linear part:
+ *
+ *  | A t |^-1   | A^-1  -A^-1*t |
+ *  | 0 1 |    = |  0       1    |
+ */
+template <StreamType T>
+Affine<T> invert(const Affine<T> &a, bool *correctness = nullptr) noexcept
+{
+    Affine<T> result;
+    const T det = _OptimizerInternal::inverseAffine<T>(a.data(), result.data());
+    if (correctness)
+        *correctness = det != 0;
+    return result;
+}
+
+/*
+ * Inverse of rotation and translation only, linear part is transposed
+ */
+template <StreamType T>
+Affine<T> invertRigid(const Affine<T> &a) noexcept
+{
+    Affine<T> result;
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+            result[i][j] = a[j][i];
+        result[i][3] = -(a[0][i] * a[0][3] + a[1][i] * a[1][3] + a[2][i] * a[2][3]);
+    }
+    return result;
+}
+
+namespace _Affine
+{
+template <StreamType T>
+const T (*data(const Affine<T> *a) noexcept)[3][4]
+{
+    static_assert(sizeof(Affine<T>) == 12 * sizeof(T), "Affine rows must be packed");
+    return reinterpret_cast<const T (*)[3][4]>(a);
+}
+
+template <StreamType T>
+T (*data(Affine<T> *a) noexcept)[3][4]
+{
+    return reinterpret_cast<T (*)[3][4]>(a);
+}
+}
+
+/*
+ * Batch composition result[i] = a[i] * b[i], output may alias input
+ */
+template <StreamType T>
+void compose(const Affine<T> *a, const Affine<T> *b, Affine<T> *result, std::size_t count)
+{
+    _OptimizerInternal::composeAffineBatch<T>(_Affine::data(a), _Affine::data(b), _Affine::data(result), count);
+}
+
+/*
+ * Batch transforms of many vectors by one affine transform
+ */
+template <StreamType T>
+void transformPoints(const Affine<T> &a, const Vector3D<T> *in, Vector3D<T> *out, std::size_t count)
+{
+    transformPoints(a.matrix4(), in, out, count);
+}
+
+template <StreamType T>
+void transformDirections(const Affine<T> &a, const Vector3D<T> *in, Vector3D<T> *out, std::size_t count)
+{
+    transformDirections(a.matrix4(), in, out, count);
+}
+
+template <StreamType T>
+void transformPoints(const Affine<T> &a, const VectorArray<T, 3> &in, VectorArray<T, 3> &out)
+{
+    transformPoints(a.matrix4(), in, out);
+}
+
+template <StreamType T>
+void transformDirections(const Affine<T> &a, const VectorArray<T, 3> &in, VectorArray<T, 3> &out)
+{
+    transformDirections(a.matrix4(), in, out);
+}
+
+}
+}
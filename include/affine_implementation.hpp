@@ -0,0 +1,140 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of affine
+ * transform operations (see affine.hpp).
+ *
+ * Affine transform is stored as 3 rows of 4 numbers: linear part in the
+ * first 3 columns and translation in the last one. Implicit last row is
+ * (0 0 0 1). Intrinsic versions keep one row per register, so they exist
+ * for instruction sets with 4 lanes of T (SSE float and AVX2 double).
+ * Results may alias operands.
+*/
+
+#include "matrix_implementation.hpp"
+#include "simd.hpp"
+#include "transform_implementation.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// ================================ Fallback ================================ //
+template<typename T>
+void composeAffineFallbackImplementation(const T (&a)[3][4], const T (&b)[3][4], T (&result)[3][4]) requires(std::is_floating_point_v<T>)
+{
+    T r[3][4];
+    for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = 0; j < 4; ++j)
+            r[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j] + (j == 3 ? a[i][3] : T(0));
+    for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = 0; j < 4; ++j)
+            result[i][j] = r[i][j];
+}
+
+template<typename T>
+void composeAffineBatchFallbackImplementation(const T (*a)[3][4], const T (*b)[3][4], T (*result)[3][4], std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        composeAffineFallbackImplementation(a[i], b[i], result[i]);
+}
+
+/*
+ * Inverse of linear part and translation -A^-1 * t, returns determinant
+ * of linear part
+ */
+template<typename T>
+T inverseAffineFallbackImplementation(const T (&a)[3][4], T (&result)[3][4]) requires(std::is_floating_point_v<T>)
+{
+    T linear[3][3], inverse[3][3];
+    for (std::size_t i = 0; i < 3; ++i)
+        for (std::size_t j = 0; j < 3; ++j)
+            linear[i][j] = a[i][j];
+    const T translation[3] = {a[0][3], a[1][3], a[2][3]};
+    const T det = inverseMatrixFallbackImplementation<T, 3>(linear, inverse);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        for (std::size_t j = 0; j < 3; ++j)
+            result[i][j] = inverse[i][j];
+        result[i][3] = -(inverse[i][0] * translation[0] + inverse[i][1] * translation[1] + inverse[i][2] * translation[2]);
+    }
+    return det;
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * Rows of the result are rows of b, scaled by broadcast elements of a,
+ * translation of a is added through (0 0 0 1) row
+ */
+template<typename Isa, typename T>
+void composeAffineIntrinImplementation(const T (&a)[3][4], const T (&b)[3][4], T (&result)[3][4])
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    using Register = typename L::Register;
+    static_assert(L::Width == 4, "Register must hold one row");
+
+    alignas(sizeof(Register)) static constexpr T lastRow[4] = {T(0), T(0), T(0), T(1)};
+    const Register b0 = L::load(b[0]), b1 = L::load(b[1]), b2 = L::load(b[2]);
+    const Register w = L::load(lastRow);
+    Register rows[3];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const Register r = L::load(a[i]);
+        rows[i] = L::fmadd(Q::template splat<2>(r), b2,
+                  L::fmadd(Q::template splat<1>(r), b1,
+                  L::fmadd(Q::template splat<0>(r), b0, L::mul(r, w))));
+    }
+    for (std::size_t i = 0; i < 3; ++i)
+        L::store(result[i], rows[i]);
+}
+
+template<typename Isa, typename T>
+void composeAffineBatchIntrinImplementation(const T (*a)[3][4], const T (*b)[3][4], T (*result)[3][4], std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        composeAffineIntrinImplementation<Isa, T>(a[i], b[i], result[i]);
+}
+
+/*
+ * Columns of inverse linear part are cross products of rows divided by
+ * determinant: (r1 x r2, r2 x r0, r0 x r1) / det. Translation is their
+ * combination, so the result is transposed only once at the end.
+ * Translation lane of cross products isn't exactly zero (mul and sub may
+ * be contracted to FMA), so it's masked out of the determinant
+ */
+template<typename Isa, typename T>
+T inverseAffineIntrinImplementation(const T (&a)[3][4], T (&result)[3][4])
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    using Register = typename L::Register;
+    static_assert(L::Width == 4, "Register must hold one row");
+
+    constexpr int YZX = _MM_SHUFFLE(3, 0, 2, 1), ZXY = _MM_SHUFFLE(3, 1, 0, 2);
+    auto cross = [](Register x, Register y) {
+        return L::sub(L::mul(Q::template permute<YZX>(x), Q::template permute<ZXY>(y)),
+                      L::mul(Q::template permute<ZXY>(x), Q::template permute<YZX>(y)));
+    };
+
+    // sign bit selects zero for translation lane
+    alignas(sizeof(Register)) static constexpr T translationLane[4] = {T(0), T(0), T(0), T(-1)};
+    const Register r0 = L::load(a[0]), r1 = L::load(a[1]), r2 = L::load(a[2]);
+    Register columns[4] = {cross(r1, r2), cross(r2, r0), cross(r0, r1)};
+    const Register det = sumQuad<T, Isa>(L::blend(L::mul(r0, columns[0]), L::zero(), L::load(translationLane)));
+    const Register inv = L::div(L::set1(T(1)), det);
+    for (std::size_t k = 0; k < 3; ++k)
+        columns[k] = L::mul(columns[k], inv);
+    columns[3] = L::sub(L::zero(), L::fmadd(columns[2], Q::template splat<3>(r2),
+                                   L::fmadd(columns[1], Q::template splat<3>(r1),
+                                   L::mul(columns[0], Q::template splat<3>(r0)))));
+    Q::transpose(columns);
+    for (std::size_t i = 0; i < 3; ++i)
+        L::store(result[i], columns[i]);
+
+    alignas(sizeof(Register)) T determinant[4];
+    L::store(determinant, det);
+    return determinant[0];
+}
+
+}
@@ -0,0 +1,120 @@
+#pragma once
+/*
+ * File contains bulk conversions of float matrices and vectors to double
+ * and binary16 ones and back
+ *
+ * operator Matrix<U, R, C>() converts a single matrix element by element,
+ * convert() takes "count" matrices and converts their numbers as one
+ * stream by a dispatched SIMD kernel. Widening (float to double, Half to
+ * float) is exact, narrowing rounds by Rounding, to nearest even by
+ * default, and overflows by IEEE 754 rules: to infinity or the largest
+ * finite number of the direction. Padded matrices (3x3 ones) are
+ * converted one by one. VectorArray streams are converted as they are.
+ * in and out must not overlap. convert() of integer_matrix.hpp takes
+ * Rounding the same way.
+*/
+
+#include "matrix.hpp"
+#include "vector_array.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+// direction of rounding of numbers, which the target type doesn't hold
+using Rounding = _Impl::Rounding;
+
+// IEEE 754 binary16 number, only stored: arithmetic is done in float
+struct Half
+{
+    std::uint16_t bits;
+
+    Half() noexcept = default;
+    explicit Half(float v) noexcept : bits(_Impl::floatToHalf<Rounding::Nearest>(v)) {}
+    explicit operator float() const noexcept { return _Impl::halfToFloat(bits); }
+
+    static Half fromBits(std::uint16_t bits) noexcept
+    {
+        Half h;
+        h.bits = bits;
+        return h;
+    }
+
+    // by bits: zeros of both signs differ, NaN equals itself
+    friend bool operator==(Half lhs, Half rhs) noexcept = default;
+};
+
+namespace _Conversion
+{
+// matrices without padding are one stream of count * R * C numbers, padded ones
+// keep R * C numbers in front and are converted by the inline scalar kernel
+template <typename From, typename To, std::size_t R, std::size_t C, typename Stream, typename Scalar>
+void apply(const Matrix<From, R, C> *in, Matrix<To, R, C> *out, std::size_t count, Stream stream, Scalar scalar)
+{
+    using Target = std::conditional_t<std::is_same_v<To, Half>, std::uint16_t, To>;
+    using Source = std::conditional_t<std::is_same_v<From, Half>, std::uint16_t, From>;
+    static_assert(sizeof(Matrix<From, R, C>) >= R * C * sizeof(From) && sizeof(Matrix<To, R, C>) >= R * C * sizeof(To));
+    if constexpr (sizeof(Matrix<From, R, C>) == R * C * sizeof(From) && sizeof(Matrix<To, R, C>) == R * C * sizeof(To))
+        stream(reinterpret_cast<const Source *>(in), reinterpret_cast<Target *>(out), count * R * C);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            scalar(reinterpret_cast<const Source *>(in + i), reinterpret_cast<Target *>(out + i), R * C);
+}
+}
+
+// float matrices to double ones
+template <std::size_t R, std::size_t C>
+void convert(const Matrix<float, R, C> *in, Matrix<double, R, C> *out, std::size_t count)
+{
+    _Conversion::apply(in, out, count, _OptimizerInternal::floatToDoubleStream,
+                       &_Impl::floatToDoubleStreamIntrinImplementation<_Impl::Scalar>);
+}
+
+// double matrices to float ones
+template <Rounding Mode = Rounding::Nearest, std::size_t R, std::size_t C>
+void convert(const Matrix<double, R, C> *in, Matrix<float, R, C> *out, std::size_t count)
+{
+    _Conversion::apply(in, out, count, _OptimizerInternal::doubleToFloatStream<Mode>,
+                       &_Impl::doubleToFloatStreamIntrinImplementation<_Impl::Scalar, Mode>);
+}
+
+// binary16 matrices to float ones
+template <std::size_t R, std::size_t C>
+void convert(const Matrix<Half, R, C> *in, Matrix<float, R, C> *out, std::size_t count)
+{
+    _Conversion::apply(in, out, count, _OptimizerInternal::halfToFloatStream,
+                       &_Impl::halfToFloatStreamIntrinImplementation<_Impl::Scalar>);
+}
+
+// float matrices to binary16 ones
+template <Rounding Mode = Rounding::Nearest, std::size_t R, std::size_t C>
+void convert(const Matrix<float, R, C> *in, Matrix<Half, R, C> *out, std::size_t count)
+{
+    _Conversion::apply(in, out, count, _OptimizerInternal::floatToHalfStream<Mode>,
+                       &_Impl::floatToHalfStreamIntrinImplementation<_Impl::Scalar, Mode>);
+}
+
+// float vectors to double ones, out is resized to in
+template <std::size_t Dim>
+void convert(const VectorArray<float, Dim> &in, VectorArray<double, Dim> &out)
+{
+    out.resize(in.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::floatToDoubleStream(in.stream(k), out.stream(k), in.size());
+}
+
+template <Rounding Mode = Rounding::Nearest, std::size_t Dim>
+void convert(const VectorArray<double, Dim> &in, VectorArray<float, Dim> &out)
+{
+    out.resize(in.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::doubleToFloatStream<Mode>(in.stream(k), out.stream(k), in.size());
+}
+
+}
+}
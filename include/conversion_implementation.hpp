@@ -0,0 +1,401 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of conversions
+ * of float arrays to double and IEEE 754 binary16 ones and back
+ * (see conversion.hpp).
+ *
+ * Rounding names the direction of IEEE 754 rounding, its values are
+ * immediates of round and convert instructions, so every mode is
+ * a constant of the kernel. Widening conversions are exact. AVX-512 and
+ * F16C round by instruction, SSE and AVX2 round double to nearest float
+ * and move it by one step, where it lies on the wrong side of the double.
+ * Builds without SSE4.1 round float lanes to integers by truncation,
+ * which holds for numbers already clamped to the range of int32_t.
+ * Builds with it round by instruction, so Optimizer takes their SSE
+ * kernels only on CPUs with SSE4.1 (Optimizer::hasSseFeatures()).
+ * binary16 numbers are kept as their bits in std::uint16_t, NaN stays
+ * quiet NaN with upper payload bits like in hardware.
+*/
+
+#include "simd.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+
+namespace _Impl
+{
+enum class Rounding
+{
+    Nearest = 0,        // to nearest, ties to even
+    Down = 1,           // toward -infinity
+    Up = 2,             // toward +infinity
+    TowardZero = 3
+};
+
+// ================================= Scalar ================================= //
+// float rounded to integral value
+template<Rounding Mode>
+float roundIntegral(float v) noexcept
+{
+    if constexpr (Mode == Rounding::Nearest)
+        return std::nearbyint(v);
+    else if constexpr (Mode == Rounding::Down)
+        return std::floor(v);
+    else if constexpr (Mode == Rounding::Up)
+        return std::ceil(v);
+    else
+        return std::trunc(v);
+}
+
+// double rounded to float
+template<Rounding Mode>
+float narrowFloat(double d) noexcept
+{
+    const float f = float(d);
+    if constexpr (Mode == Rounding::Down)
+        return double(f) > d ? std::nextafter(f, -std::numeric_limits<float>::infinity()) : f;
+    else if constexpr (Mode == Rounding::Up)
+        return double(f) < d ? std::nextafter(f, std::numeric_limits<float>::infinity()) : f;
+    else if constexpr (Mode == Rounding::TowardZero)
+        return std::abs(double(f)) > std::abs(d) ? std::nextafter(f, 0.f) : f;
+    else
+        return f;
+}
+
+inline float halfToFloat(std::uint16_t h) noexcept
+{
+    const std::uint32_t sign = std::uint32_t(h & 0x8000) << 16, exponent = h >> 10 & 0x1f, mantissa = h & 0x3ff;
+    if (exponent == 0x1f)
+        return std::bit_cast<float>(sign | (mantissa ? 0x7fc00000 : 0x7f800000) | mantissa << 13);
+    if (exponent == 0)
+    {
+        // zeros and subnormals, mantissa * 2^-24 is exact
+        const float v = float(mantissa) * 0x1p-24f;
+        return sign ? -v : v;
+    }
+    return std::bit_cast<float>(sign | (exponent + 112) << 23 | mantissa << 13);
+}
+
+template<Rounding Mode>
+std::uint16_t floatToHalf(float v) noexcept
+{
+    const std::uint32_t bits = std::bit_cast<std::uint32_t>(v), abs = bits & 0x7fffffff;
+    const std::uint16_t sign = std::uint16_t(bits >> 16 & 0x8000);
+    if (abs >= 0x7f800000)
+        return sign | std::uint16_t(abs > 0x7f800000 ? 0x7e00 | (abs >> 13 & 0x3ff) : 0x7c00);
+    // directed rounding, which increases magnitude
+    const bool away = (Mode == Rounding::Up && !sign) || (Mode == Rounding::Down && sign);
+    // 2^16 and more overflow to infinity or the largest number
+    if (abs >= 0x47800000)
+        return sign | std::uint16_t(Mode == Rounding::Nearest || away ? 0x7c00 : 0x7bff);
+
+    const int exponent = int(abs >> 23) - 127;
+    std::uint32_t base, rest, half;
+    if (exponent >= -14)
+    {
+        // carry of rounding goes to exponent, up to infinity
+        base = std::uint32_t(exponent + 15) << 10 | (abs >> 13 & 0x3ff);
+        rest = abs & 0x1fff;
+        half = 0x1000;
+    }
+    else
+    {
+        // subnormal results, float subnormals have no implicit bit
+        const std::uint32_t mantissa = abs < 0x800000 ? abs : (abs & 0x7fffff) | 0x800000;
+        const std::uint32_t shift = std::uint32_t(std::min(13 - 14 - exponent, 25));
+        base = mantissa >> shift;
+        rest = mantissa & ((1u << shift) - 1);
+        half = 1u << (shift - 1);
+    }
+    bool up = false;
+    if constexpr (Mode == Rounding::Nearest)
+        up = rest > half || (rest == half && (base & 1));
+    else if constexpr (Mode != Rounding::TowardZero)
+        up = rest && away;
+    return sign | std::uint16_t(base + up);
+}
+
+// ============================ Register helpers ============================ //
+#ifdef __SSE2__
+// instruction is chosen at compile time, callers run on CPUs with SSE4.1 where the build enables it
+template<Rounding Mode>
+__m128 roundIntegral(__m128 v) noexcept
+{
+#ifdef __SSE4_1__
+    return _mm_round_ps(v, int(Mode) | _MM_FROUND_NO_EXC);
+#else
+    const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    if constexpr (Mode == Rounding::Nearest)
+        return _mm_cvtepi32_ps(_mm_cvtps_epi32(v));
+    else if constexpr (Mode == Rounding::Down)
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, v), _mm_set1_ps(1.f)));
+    else if constexpr (Mode == Rounding::Up)
+        return _mm_add_ps(t, _mm_and_ps(_mm_cmplt_ps(t, v), _mm_set1_ps(1.f)));
+    else
+        return t;
+#endif
+}
+
+// lanes of double, where the nearest float f lies on the wrong side of d
+template<Rounding Mode>
+__m128d wrongSide(__m128d d, __m128d f) noexcept
+{
+    if constexpr (Mode == Rounding::Down)
+        return _mm_cmpgt_pd(f, d);
+    else if constexpr (Mode == Rounding::Up)
+        return _mm_cmplt_pd(f, d);
+    else
+        return _mm_cmpgt_pd(_mm_andnot_pd(_mm_set1_pd(-0.), f), _mm_andnot_pd(_mm_set1_pd(-0.), d));
+}
+
+// floats of selected lanes moved to the next one in rounding direction by their bits:
+// toward zero the magnitude decreases, down and up it changes by sign
+template<Rounding Mode>
+__m128 stepFloats(__m128 f, __m128 selected) noexcept
+{
+    const __m128i bits = _mm_castps_si128(f), sign = _mm_srai_epi32(bits, 31);
+    __m128i step = _mm_set1_epi32(-1);
+    if constexpr (Mode == Rounding::Down)
+        step = _mm_sub_epi32(step, _mm_add_epi32(sign, sign));
+    else if constexpr (Mode == Rounding::Up)
+        step = _mm_add_epi32(_mm_set1_epi32(1), _mm_add_epi32(sign, sign));
+    return _mm_castsi128_ps(_mm_add_epi32(bits, _mm_and_si128(_mm_castps_si128(selected), step)));
+}
+
+// two doubles rounded to lower floats
+template<Rounding Mode>
+__m128 narrowFloats(__m128d d) noexcept
+{
+    const __m128 f = _mm_cvtpd_ps(d);
+    if constexpr (Mode == Rounding::Nearest)
+        return f;
+    else
+    {
+        const __m128 wrong = _mm_castpd_ps(wrongSide<Mode>(d, _mm_cvtps_pd(f)));
+        return stepFloats<Mode>(f, _mm_shuffle_ps(wrong, wrong, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+}
+#endif
+
+#ifdef __AVX2__
+template<Rounding Mode>
+__m256 roundIntegral(__m256 v) noexcept
+{
+    return _mm256_round_ps(v, int(Mode) | _MM_FROUND_NO_EXC);
+}
+
+template<Rounding Mode>
+__m256d wrongSide(__m256d d, __m256d f) noexcept
+{
+    if constexpr (Mode == Rounding::Down)
+        return _mm256_cmp_pd(f, d, _CMP_GT_OQ);
+    else if constexpr (Mode == Rounding::Up)
+        return _mm256_cmp_pd(f, d, _CMP_LT_OQ);
+    else
+        return _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.), f), _mm256_andnot_pd(_mm256_set1_pd(-0.), d), _CMP_GT_OQ);
+}
+
+template<Rounding Mode>
+__m128 narrowFloats(__m256d d) noexcept
+{
+    const __m128 f = _mm256_cvtpd_ps(d);
+    if constexpr (Mode == Rounding::Nearest)
+        return f;
+    else
+    {
+        const __m256 wrong = _mm256_castpd_ps(wrongSide<Mode>(d, _mm256_cvtps_pd(f)));
+        return stepFloats<Mode>(f, _mm_shuffle_ps(_mm256_castps256_ps128(wrong), _mm256_extractf128_ps(wrong, 1),
+                                                  _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+}
+#endif
+
+#ifdef __AVX512F__
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+template<Rounding Mode>
+__m512 roundIntegral(__m512 v) noexcept
+{
+    return _mm512_roundscale_ps(v, int(Mode) | _MM_FROUND_NO_EXC);
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+/*
+ * Loads of Lanes<double, Isa>::Width floats as double lanes and stores
+ * of double lanes as floats, rounded by Mode
+ */
+template<typename Isa>
+struct PrecisionConversion;
+
+template<>
+struct PrecisionConversion<Scalar>
+{
+    static double widen(const float *p) noexcept { return double(*p); }
+    template<Rounding Mode>
+    static void narrow(float *p, double v) noexcept { *p = narrowFloat<Mode>(v); }
+};
+
+#ifdef __SSE2__
+template<>
+struct PrecisionConversion<SSE>
+{
+    static __m128d widen(const float *p) noexcept
+    {
+        return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p))));
+    }
+    template<Rounding Mode>
+    static void narrow(float *p, __m128d v) noexcept
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_castps_si128(narrowFloats<Mode>(v)));
+    }
+};
+#endif
+
+#ifdef __AVX2__
+template<>
+struct PrecisionConversion<AVX2>
+{
+    static __m256d widen(const float *p) noexcept { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+    template<Rounding Mode>
+    static void narrow(float *p, __m256d v) noexcept { _mm_storeu_ps(p, narrowFloats<Mode>(v)); }
+};
+#endif
+
+#ifdef __AVX512F__
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+template<>
+struct PrecisionConversion<AVX512>
+{
+    static __m512d widen(const float *p) noexcept { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+    template<Rounding Mode>
+    static void narrow(float *p, __m512d v) noexcept
+    {
+        _mm256_storeu_ps(p, _mm512_cvt_roundpd_ps(v, int(Mode) | _MM_FROUND_NO_EXC));
+    }
+};
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+/*
+ * Loads of Lanes<float, Isa>::Width binary16 numbers as float lanes and
+ * stores of float lanes as binary16 numbers, rounded by Mode. F16C comes
+ * with AVX2 processors, AVX-512 has instructions of its own
+ */
+template<typename Isa>
+struct HalfConversion;
+
+template<>
+struct HalfConversion<Scalar>
+{
+    static float load(const std::uint16_t *p) noexcept { return halfToFloat(*p); }
+    template<Rounding Mode>
+    static void store(std::uint16_t *p, float v) noexcept { *p = floatToHalf<Mode>(v); }
+};
+
+#if defined(__AVX2__) && defined(__F16C__)
+template<>
+struct HalfConversion<AVX2>
+{
+    static __m256 load(const std::uint16_t *p) noexcept
+    {
+        return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    }
+    template<Rounding Mode>
+    static void store(std::uint16_t *p, __m256 v) noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm256_cvtps_ph(v, int(Mode)));
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+template<>
+struct HalfConversion<AVX512>
+{
+    static __m512 load(const std::uint16_t *p) noexcept
+    {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+    }
+    template<Rounding Mode>
+    static void store(std::uint16_t *p, __m512 v) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtps_ph(v, int(Mode)));
+    }
+};
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+// ================================ Intrinsic =============================== //
+template<typename Isa>
+void floatToDoubleStreamIntrinImplementation(const float *in, double *out, std::size_t count)
+{
+    using L = Lanes<double, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+        L::store(out + i, PrecisionConversion<Isa>::widen(in + i));
+    for (; i < count; ++i)
+        out[i] = double(in[i]);
+}
+
+template<typename Isa, Rounding Mode>
+void doubleToFloatStreamIntrinImplementation(const double *in, float *out, std::size_t count)
+{
+    using L = Lanes<double, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+        PrecisionConversion<Isa>::template narrow<Mode>(out + i, L::load(in + i));
+    for (; i < count; ++i)
+        out[i] = narrowFloat<Mode>(in[i]);
+}
+
+template<typename Isa>
+void halfToFloatStreamIntrinImplementation(const std::uint16_t *in, float *out, std::size_t count)
+{
+    using L = Lanes<float, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+        L::store(out + i, HalfConversion<Isa>::load(in + i));
+    for (; i < count; ++i)
+        out[i] = halfToFloat(in[i]);
+}
+
+template<typename Isa, Rounding Mode>
+void floatToHalfStreamIntrinImplementation(const float *in, std::uint16_t *out, std::size_t count)
+{
+    using L = Lanes<float, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+        HalfConversion<Isa>::template store<Mode>(out + i, L::load(in + i));
+    for (; i < count; ++i)
+        out[i] = floatToHalf<Mode>(in[i]);
+}
+
+// ================================ Fallback ================================ //
+inline void floatToDoubleStreamFallbackImplementation(const float *in, double *out, std::size_t count)
+{
+    floatToDoubleStreamIntrinImplementation<Scalar>(in, out, count);
+}
+
+template<Rounding Mode>
+void doubleToFloatStreamFallbackImplementation(const double *in, float *out, std::size_t count)
+{
+    doubleToFloatStreamIntrinImplementation<Scalar, Mode>(in, out, count);
+}
+
+inline void halfToFloatStreamFallbackImplementation(const std::uint16_t *in, float *out, std::size_t count)
+{
+    halfToFloatStreamIntrinImplementation<Scalar>(in, out, count);
+}
+
+template<Rounding Mode>
+void floatToHalfStreamFallbackImplementation(const float *in, std::uint16_t *out, std::size_t count)
+{
+    floatToHalfStreamIntrinImplementation<Scalar, Mode>(in, out, count);
+}
+
+}
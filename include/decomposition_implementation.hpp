@@ -0,0 +1,193 @@
+#pragma once
+/*
+ * File contains LU and Cholesky decompositions of square floating-point
+ * matrices and substitution routines built on them.
+ *
+ * All loops have compile-time bounds, so small sizes are unrolled by
+ * compiler. LU of larger matrices is computed by column panels, so the
+ * trailing update walks contiguous rows (i-k-j order).
+*/
+
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// panel width of blocked LU, smaller matrices are factorized at once
+inline constexpr std::size_t LUBlockSize = 16;
+
+/*
+ * In-place LU decomposition with partial pivoting: P * A = L * U.
+ * L is stored below diagonal (its unit diagonal is implicit), U on and above.
+ * perm[i] is the row of A, which went to row i.
+ * Returns permutation sign, or 0 if matrix is singular
+ */
+template<typename T, std::size_t N>
+int luDecompositionImplementation(T (&a)[N][N], std::size_t (&perm)[N]) requires(std::is_floating_point_v<T>)
+{
+    constexpr std::size_t Block = N < LUBlockSize ? N : LUBlockSize;
+
+    int sign = 1;
+    for (std::size_t i = 0; i < N; ++i)
+        perm[i] = i;
+
+    for (std::size_t k0 = 0; k0 < N; k0 += Block)
+    {
+        const std::size_t k1 = k0 + Block < N ? k0 + Block : N;
+
+        // panel factorization, only panel columns are updated
+        for (std::size_t k = k0; k < k1; ++k)
+        {
+            std::size_t pivot = k;
+            T pivotAbs = std::abs(a[k][k]);
+            for (std::size_t i = k + 1; i < N; ++i)
+                if (std::abs(a[i][k]) > pivotAbs)
+                {
+                    pivot = i;
+                    pivotAbs = std::abs(a[i][k]);
+                }
+            if (pivotAbs == T(0))
+                return 0;
+
+            if (pivot != k)
+            {
+                for (std::size_t j = 0; j < N; ++j)
+                {
+                    const T tmp = a[k][j];
+                    a[k][j] = a[pivot][j];
+                    a[pivot][j] = tmp;
+                }
+                const std::size_t tmp = perm[k];
+                perm[k] = perm[pivot];
+                perm[pivot] = tmp;
+                sign = -sign;
+            }
+
+            const T inv = T(1) / a[k][k];
+            for (std::size_t i = k + 1; i < N; ++i)
+            {
+                const T l = a[i][k] *= inv;
+                for (std::size_t j = k + 1; j < k1; ++j)
+                    a[i][j] -= l * a[k][j];
+            }
+        }
+
+        // U12 = L11^-1 * A12
+        for (std::size_t k = k0; k < k1; ++k)
+            for (std::size_t i = k + 1; i < k1; ++i)
+            {
+                const T l = a[i][k];
+                for (std::size_t j = k1; j < N; ++j)
+                    a[i][j] -= l * a[k][j];
+            }
+
+        // A22 -= L21 * U12
+        for (std::size_t i = k1; i < N; ++i)
+            for (std::size_t k = k0; k < k1; ++k)
+            {
+                const T l = a[i][k];
+                for (std::size_t j = k1; j < N; ++j)
+                    a[i][j] -= l * a[k][j];
+            }
+    }
+
+    return sign;
+}
+
+// Solves A * X = B for every column of B, given LU decomposition of A
+template<typename T, std::size_t N, std::size_t M>
+void luSolveImplementation(const T (&lu)[N][N], const std::size_t (&perm)[N],
+                           const T (&b)[N][M], T (&x)[N][M]) requires(std::is_floating_point_v<T>)
+{
+    // L * Y = P * B
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < M; ++j)
+            x[i][j] = b[perm[i]][j];
+        for (std::size_t k = 0; k < i; ++k)
+        {
+            const T l = lu[i][k];
+            for (std::size_t j = 0; j < M; ++j)
+                x[i][j] -= l * x[k][j];
+        }
+    }
+
+    // U * X = Y
+    for (std::size_t i = N; i--;)
+    {
+        for (std::size_t k = i + 1; k < N; ++k)
+        {
+            const T u = lu[i][k];
+            for (std::size_t j = 0; j < M; ++j)
+                x[i][j] -= u * x[k][j];
+        }
+        const T inv = T(1) / lu[i][i];
+        for (std::size_t j = 0; j < M; ++j)
+            x[i][j] *= inv;
+    }
+}
+
+/*
+ * In-place Cholesky decomposition A = L * L^T of symmetric positive-definite
+ * matrix. L is stored on and below diagonal, upper part is zeroed.
+ * Returns false if matrix is not positive-definite
+ */
+template<typename T, std::size_t N>
+bool choleskyDecompositionImplementation(T (&a)[N][N]) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t j = 0; j < N; ++j)
+    {
+        T diag = a[j][j];
+        for (std::size_t k = 0; k < j; ++k)
+            diag -= a[j][k] * a[j][k];
+        if (!(diag > T(0)))
+            return false;
+        diag = std::sqrt(diag);
+        a[j][j] = diag;
+
+        const T inv = T(1) / diag;
+        for (std::size_t i = j + 1; i < N; ++i)
+        {
+            T accum = a[i][j];
+            for (std::size_t k = 0; k < j; ++k)
+                accum -= a[i][k] * a[j][k];
+            a[i][j] = accum * inv;
+        }
+        for (std::size_t i = j + 1; i < N; ++i)
+            a[j][i] = T(0);
+    }
+    return true;
+}
+
+// Solves A * X = B for every column of B, given Cholesky factor of A
+template<typename T, std::size_t N, std::size_t M>
+void choleskySolveImplementation(const T (&l)[N][N], const T (&b)[N][M], T (&x)[N][M]) requires(std::is_floating_point_v<T>)
+{
+    // L * Y = B
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        for (std::size_t j = 0; j < M; ++j)
+            x[i][j] = b[i][j];
+        for (std::size_t k = 0; k < i; ++k)
+            for (std::size_t j = 0; j < M; ++j)
+                x[i][j] -= l[i][k] * x[k][j];
+        const T inv = T(1) / l[i][i];
+        for (std::size_t j = 0; j < M; ++j)
+            x[i][j] *= inv;
+    }
+
+    // L^T * X = Y
+    for (std::size_t i = N; i--;)
+    {
+        for (std::size_t k = i + 1; k < N; ++k)
+            for (std::size_t j = 0; j < M; ++j)
+                x[i][j] -= l[k][i] * x[k][j];
+        const T inv = T(1) / l[i][i];
+        for (std::size_t j = 0; j < M; ++j)
+            x[i][j] *= inv;
+    }
+}
+
+}
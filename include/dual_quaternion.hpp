@@ -0,0 +1,108 @@
+#pragma once
+/*
+ * File contains dual quaternion of rigid transform
+ *
+ * DualQuaternion<T> = real + eps * dual, where real is unit quaternion of
+ * rotation and dual = 0.5 * translation * real. It's 32 (float) or 64 (double)
+ * bytes, and unlike matrices dual quaternions can be blended without
+ * losing rigidity (see skinning.hpp). Convention matches quaternion.hpp:
+ * a * b applies b first.
+*/
+
+#include "affine.hpp"
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <StreamType T>
+class DualQuaternion
+{
+public:
+    using Type = T;
+
+    // identity transform
+    DualQuaternion() noexcept : _real(), _dual(T(0), T(0), T(0), T(0)) {}
+    DualQuaternion(const Quaternion<T> &real, const Quaternion<T> &dual) noexcept : _real(real), _dual(dual) {}
+    // rotation by unit quaternion, then translation
+    DualQuaternion(const Quaternion<T> &rotation, const Vector3D<T> &translation) noexcept
+        : _real(rotation), _dual(Quaternion<T>(translation, T(0)) * rotation * T(0.5))
+    {}
+    // linear part must be orthonormal
+    explicit DualQuaternion(const Affine<T> &rigid) noexcept
+        : DualQuaternion(Quaternion<T>(rigid.linear()), rigid.translation())
+    {}
+
+    const Quaternion<T> &real() const noexcept { return _real; }
+    const Quaternion<T> &dual() const noexcept { return _dual; }
+    const Quaternion<T> &rotation() const noexcept { return _real; }
+    Vector3D<T> translation() const noexcept { return (_dual * _real.conjugate()).imaginary() * T(2); }
+    Affine<T> affine() const noexcept { return Affine<T>(_real, translation()); }
+
+    // divides by length of real part, so it becomes rigid transform again
+    DualQuaternion &unit() noexcept
+    {
+        const T k = T(1) / _real.length();
+        _real *= k;
+        _dual *= k;
+        return *this;
+    }
+    // inverse of unit dual quaternion
+    DualQuaternion conjugate() const noexcept { return DualQuaternion(_real.conjugate(), _dual.conjugate()); }
+
+    // applies q first, then this
+    DualQuaternion &operator*=(const DualQuaternion &q) noexcept
+    {
+        _dual = _real * q._dual + _dual * q._real;
+        _real *= q._real;
+        return *this;
+    }
+    DualQuaternion &operator*=(T k) noexcept
+    {
+        _real *= k;
+        _dual *= k;
+        return *this;
+    }
+    DualQuaternion &operator+=(const DualQuaternion &q) noexcept
+    {
+        _real += q._real;
+        _dual += q._dual;
+        return *this;
+    }
+
+    Vector3D<T> transformPoint(const Vector3D<T> &p) const noexcept { return _real.rotate(p) + translation(); }
+    Vector3D<T> transformDirection(const Vector3D<T> &d) const noexcept { return _real.rotate(d); }
+
+    friend bool operator==(const DualQuaternion &lhs, const DualQuaternion &rhs)
+    {
+        return lhs._real == rhs._real && lhs._dual == rhs._dual;
+    }
+    friend bool operator!=(const DualQuaternion &lhs, const DualQuaternion &rhs) { return !(lhs == rhs); }
+
+private:
+    Quaternion<T> _real;
+    Quaternion<T> _dual;
+};
+
+template <StreamType T>
+DualQuaternion<T> operator*(DualQuaternion<T> lhs, const DualQuaternion<T> &rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+DualQuaternion<T> operator*(DualQuaternion<T> lhs, T rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+DualQuaternion<T> operator+(DualQuaternion<T> lhs, const DualQuaternion<T> &rhs) noexcept
+{
+    return lhs += rhs;
+}
+
+}
+}
@@ -0,0 +1,282 @@
+#pragma once
+/*
+ * File contains matrix of run-time size
+ *
+ * DynamicMatrix<T> keeps rows on the heap, every row starts at cache line
+ * boundary (stride() numbers apart), so large matrices don't instantiate
+ * templates per size and don't live on the stack. It converts to and from
+ * LA::Matrix and takes VectorArray points as rows, so e.g. least squares
+ * over thousands of points is built here and solved by fixed-size
+ * decompositions of the small normal matrix.
+ *
+ * Products of float and double matrices are dispatched by Optimizer
+ * to cache-blocked kernels and split over threads of Parallel::ThreadPool.
+*/
+
+#include "parallel.hpp"
+#include "vector_array.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <typename T>
+class DynamicMatrix
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "DynamicMatrix stores plain numbers only");
+
+    using Type = T;
+    // rows start at cache line boundary
+    static constexpr std::size_t Alignment = 64;
+
+    DynamicMatrix() noexcept = default;
+    // zero matrix
+    DynamicMatrix(std::size_t rows, std::size_t columns) { resize(rows, columns); fill(T(0)); }
+    DynamicMatrix(std::size_t rows, std::size_t columns, T value) { resize(rows, columns); fill(value); }
+    template <std::size_t R, std::size_t C>
+    explicit DynamicMatrix(const Matrix<T, R, C> &m)
+    {
+        resize(R, C);
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+                (*this)[i][j] = element(m, i, j);
+    }
+    // vector i becomes row i
+    template <std::size_t Dim>
+    explicit DynamicMatrix(const VectorArray<T, Dim> &rows)
+    {
+        resize(rows.size(), Dim);
+        for (std::size_t k = 0; k < Dim; ++k)
+            for (std::size_t i = 0; i < rows.size(); ++i)
+                (*this)[i][k] = rows.stream(k)[i];
+    }
+
+    DynamicMatrix(const DynamicMatrix &m)
+    {
+        resize(m._rows, m._columns);
+        if (_data)
+            std::memcpy(_data, m._data, _rows * _stride * sizeof(T));
+    }
+    DynamicMatrix(DynamicMatrix &&m) noexcept
+        : _data(m._data), _rows(m._rows), _columns(m._columns), _stride(m._stride), _capacity(m._capacity)
+    {
+        m._data = nullptr;
+        m._rows = m._columns = m._stride = m._capacity = 0;
+    }
+    DynamicMatrix &operator=(const DynamicMatrix &m)
+    {
+        if (this != &m)
+        {
+            resize(m._rows, m._columns);
+            if (_data)
+                std::memcpy(_data, m._data, _rows * _stride * sizeof(T));
+        }
+        return *this;
+    }
+    DynamicMatrix &operator=(DynamicMatrix &&m) noexcept
+    {
+        if (this != &m)
+        {
+            release();
+            _data = m._data;
+            _rows = m._rows;
+            _columns = m._columns;
+            _stride = m._stride;
+            _capacity = m._capacity;
+            m._data = nullptr;
+            m._rows = m._columns = m._stride = m._capacity = 0;
+        }
+        return *this;
+    }
+    ~DynamicMatrix() { release(); }
+
+    static DynamicMatrix identity(std::size_t size)
+    {
+        DynamicMatrix m(size, size);
+        for (std::size_t i = 0; i < size; ++i)
+            m[i][i] = T(1);
+        return m;
+    }
+
+    std::size_t rows() const noexcept { return _rows; }
+    std::size_t columns() const noexcept { return _columns; }
+    // numbers between starts of rows
+    std::size_t stride() const noexcept { return _stride; }
+    bool empty() const noexcept { return !_rows || !_columns; }
+
+    T *data() noexcept { return _data; }
+    const T *data() const noexcept { return _data; }
+    // Row pointer, so elements are m[i][j] like in LA::Matrix
+    T *operator[](std::size_t row) noexcept
+    {
+        assert(row < _rows);
+        return _data + row * _stride;
+    }
+    const T *operator[](std::size_t row) const noexcept
+    {
+        assert(row < _rows);
+        return _data + row * _stride;
+    }
+
+    // Memory is reused, if it's enough. Elements are uninitialized
+    void resize(std::size_t rows, std::size_t columns)
+    {
+        constexpr std::size_t Granularity = Alignment / sizeof(T) ? Alignment / sizeof(T) : 1;
+        const std::size_t stride = (columns + Granularity - 1) / Granularity * Granularity;
+        if (rows * stride > _capacity)
+        {
+            release();
+            _data = static_cast<T *>(::operator new(rows * stride * sizeof(T), std::align_val_t(Alignment)));
+            _capacity = rows * stride;
+        }
+        _rows = rows;
+        _columns = columns;
+        _stride = stride;
+    }
+    void fill(T value) noexcept
+    {
+        for (std::size_t i = 0; i < _rows; ++i)
+            std::fill_n((*this)[i], _columns, value);
+    }
+
+    template <std::size_t R, std::size_t C>
+    Matrix<T, R, C> toMatrix() const noexcept
+    {
+        assert(_rows == R && _columns == C);
+        Matrix<T, R, C> m;
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+                element(m, i, j) = (*this)[i][j];
+        return m;
+    }
+
+    friend bool operator==(const DynamicMatrix &lhs, const DynamicMatrix &rhs)
+    {
+        if (lhs._rows != rhs._rows || lhs._columns != rhs._columns)
+            return false;
+        for (std::size_t i = 0; i < lhs._rows; ++i)
+            if (!std::equal(lhs[i], lhs[i] + lhs._columns, rhs[i]))
+                return false;
+        return true;
+    }
+    friend bool operator!=(const DynamicMatrix &lhs, const DynamicMatrix &rhs) { return !(lhs == rhs); }
+
+private:
+    // one-row matrices are indexed by element
+    template <typename M>
+    static auto &element(M &m, std::size_t row, std::size_t column) noexcept
+    {
+        if constexpr (std::remove_cv_t<M>::Rows == 1)
+            return m[column];
+        else
+            return m[row][column];
+    }
+
+    void release() noexcept
+    {
+        if (_data)
+            ::operator delete(_data, std::align_val_t(Alignment));
+        _data = nullptr;
+        _capacity = 0;
+    }
+
+    T *_data = nullptr;
+    std::size_t _rows = 0;
+    std::size_t _columns = 0;
+    std::size_t _stride = 0;
+    std::size_t _capacity = 0;
+};
+
+namespace _DynamicMatrix
+{
+// multiply-adds per thread at least, so waking a worker is paid off
+inline constexpr std::size_t MinChunkWork = std::size_t(1) << 18;
+// chunks of rows or columns are multiples of micro kernel tiles
+inline constexpr std::size_t ChunkGranularity = 48;
+// square blocks of transpose fit L1
+inline constexpr std::size_t TransposeBlock = 32;
+}
+
+/*
+ * Product of matrices, result must not be an operand. The longer side of
+ * result is split over at most "threads" threads, 0 means all threads
+ * of the pool
+ */
+template <StreamType T>
+void dot(const DynamicMatrix<T> &lhs, const DynamicMatrix<T> &rhs, DynamicMatrix<T> &result, unsigned threads = 0)
+{
+    assert(lhs.columns() == rhs.rows());
+    assert(&result != &lhs && &result != &rhs);
+    const std::size_t m = lhs.rows(), n = rhs.columns(), k = lhs.columns();
+    result.resize(m, n);
+    if (!m || !n)
+        return;
+    // sum of no products, operands may have no storage
+    if (!k)
+    {
+        result.fill(T(0));
+        return;
+    }
+
+    const bool byRows = m >= n;
+    const std::size_t work = (byRows ? n : m) * k;
+    const std::size_t minChunk = std::max<std::size_t>(1, _DynamicMatrix::MinChunkWork / work);
+    Parallel::parallelChunks(byRows ? m : n, threads, minChunk, _DynamicMatrix::ChunkGranularity,
+                             [&](std::size_t first, std::size_t size) {
+        if (byRows)
+            _OptimizerInternal::gemm<T>(lhs[first], lhs.stride(), rhs.data(), rhs.stride(),
+                                        result[first], result.stride(), size, n, k);
+        else
+            _OptimizerInternal::gemm<T>(lhs.data(), lhs.stride(), rhs.data() + first, rhs.stride(),
+                                        result.data() + first, result.stride(), m, size, k);
+    });
+}
+
+template <StreamType T>
+DynamicMatrix<T> dot(const DynamicMatrix<T> &lhs, const DynamicMatrix<T> &rhs, unsigned threads = 0)
+{
+    DynamicMatrix<T> result;
+    dot(lhs, rhs, result, threads);
+    return result;
+}
+
+/*
+ * Transposed copy, result must not be the operand. float and double go
+ * through dispatched cache-oblivious transpose, others by square blocks
+ */
+template <typename T>
+void transpose(const DynamicMatrix<T> &m, DynamicMatrix<T> &result)
+{
+    assert(&result != &m);
+    constexpr std::size_t Block = _DynamicMatrix::TransposeBlock;
+    result.resize(m.columns(), m.rows());
+    if constexpr (StreamType<T>)
+    {
+        if (m.rows() && m.columns())
+            _OptimizerInternal::transposeBlock<T>(m.data(), m.stride(), result.data(), result.stride(), m.rows(), m.columns());
+    }
+    else
+        for (std::size_t i0 = 0; i0 < m.rows(); i0 += Block)
+            for (std::size_t j0 = 0; j0 < m.columns(); j0 += Block)
+                for (std::size_t i = i0; i < std::min(i0 + Block, m.rows()); ++i)
+                    for (std::size_t j = j0; j < std::min(j0 + Block, m.columns()); ++j)
+                        result[j][i] = m[i][j];
+}
+
+template <typename T>
+DynamicMatrix<T> transpose(const DynamicMatrix<T> &m)
+{
+    DynamicMatrix<T> result;
+    transpose(m, result);
+    return result;
+}
+
+}
+}
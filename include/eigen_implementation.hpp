@@ -0,0 +1,254 @@
+#pragma once
+/*
+ * File contains eigen decomposition of symmetric 3x3 matrices and singular
+ * value decomposition of 3x3 matrices (see matrix.hpp and matrix_array.hpp).
+ *
+ * Both use cyclic Jacobi method with fixed count of sweeps. Rotations,
+ * sorting and QR steps are computed without branches, so matrices are
+ * element-interleaved streams like in matrix_array_implementation.hpp
+ * and one register holds the same element of Width matrices.
+ * Fallbacks run the same kernels with Lanes<T, Scalar>.
+*/
+
+#include "matrix_array_implementation.hpp"
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// Jacobi converges quadratically, 4 sweeps reach rounding error of float and double
+inline constexpr std::size_t JacobiSweeps = 4;
+
+/*
+ * Rotation in (P, Q) plane, which zeroes s[P][Q] of symmetric matrix and
+ * is accumulated into columns of v. Diagonal is kept in d, off-diagonal
+ * element, which doesn't belong to row and column K, is kept in o[K].
+ * tan of rotation angle is the smaller root of t^2 + 2 * t * theta - 1,
+ * theta = (s[Q][Q] - s[P][P]) / (2 * s[P][Q]), which is written without
+ * division by s[P][Q]
+ */
+template<typename L, std::size_t P, std::size_t Q>
+void jacobiRotation(typename L::Register (&d)[3], typename L::Register (&o)[3], typename L::Register (&v)[3][3]) noexcept
+{
+    using T = typename L::Type;
+    using Register = typename L::Register;
+    constexpr std::size_t R = 3 - P - Q;
+
+    const Register one = L::set1(T(1));
+    // negligible element is zeroed, converged matrices get exact identity
+    // rotations instead of squares of tiny numbers, which are denormal
+    const Register threshold = L::mul(L::set1(std::numeric_limits<T>::epsilon()), L::add(L::abs(d[P]), L::abs(d[Q])));
+    const Register apq = L::blend(o[R], L::zero(), L::sub(L::abs(o[R]), threshold));
+    const Register diff = L::sub(d[Q], d[P]);
+    const Register twoApq = L::add(apq, apq);
+    const Register root = L::sqrt(L::fmadd(twoApq, twoApq, L::mul(diff, diff)));
+    // t = num / den, tiny term turns 0 / 0 of diagonal block into zero angle,
+    // its square is still normal. cos and sin are taken from num and den,
+    // so they don't wait for t
+    const Register num = L::mulSign(twoApq, diff);
+    const Register den = L::add(L::add(L::abs(diff), root), L::set1(std::sqrt(std::numeric_limits<T>::min())));
+    const Register t = L::div(num, den);
+    const Register inv = L::div(one, L::sqrt(L::fmadd(num, num, L::mul(den, den))));
+    const Register c = L::mul(den, inv);
+    const Register s = L::mul(num, inv);
+
+    d[P] = L::sub(d[P], L::mul(t, apq));
+    d[Q] = L::fmadd(t, apq, d[Q]);
+    o[R] = L::zero();
+    const Register arp = o[Q], arq = o[P];
+    o[Q] = mulSub<L>(c, arp, s, arq);
+    o[P] = L::fmadd(s, arp, L::mul(c, arq));
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+        const Register vp = v[k][P], vq = v[k][Q];
+        v[k][P] = mulSub<L>(c, vp, s, vq);
+        v[k][Q] = L::fmadd(s, vp, L::mul(c, vq));
+    }
+}
+
+/*
+ * Diagonalizes symmetric matrix (d, o) by rotations accumulated in v,
+ * v must be initialized
+ */
+template<typename L>
+void jacobiSweeps(typename L::Register (&d)[3], typename L::Register (&o)[3], typename L::Register (&v)[3][3]) noexcept
+{
+    for (std::size_t sweep = 0; sweep < JacobiSweeps; ++sweep)
+    {
+        jacobiRotation<L, 0, 1>(d, o, v);
+        jacobiRotation<L, 0, 2>(d, o, v);
+        jacobiRotation<L, 1, 2>(d, o, v);
+    }
+}
+
+/*
+ * Swaps columns I and J of matrices m, where key[I] < key[J], and keys
+ * themselves. One of swapped columns is negated, so determinants are kept
+ */
+template<typename L, std::size_t I, std::size_t J, typename... M>
+void sortColumns(typename L::Register (&key)[3], M &...m) noexcept
+{
+    using Register = typename L::Register;
+    const Register swap = L::sub(key[I], key[J]);
+    const Register ki = key[I];
+    key[I] = L::blend(ki, key[J], swap);
+    key[J] = L::blend(key[J], ki, swap);
+    auto columns = [swap](Register (&a)[3][3]) {
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            const Register ai = a[k][I];
+            a[k][I] = L::blend(ai, a[k][J], swap);
+            a[k][J] = L::blend(a[k][J], L::sub(L::zero(), ai), swap);
+        }
+    };
+    (columns(m), ...);
+}
+
+// Descending order of keys by sorting network
+template<typename L, typename... M>
+void sortDescending(typename L::Register (&key)[3], M &...m) noexcept
+{
+    sortColumns<L, 0, 1>(key, m...);
+    sortColumns<L, 1, 2>(key, m...);
+    sortColumns<L, 0, 1>(key, m...);
+}
+
+/*
+ * Givens rotation of rows P and Q of b, which zeroes b[Q][P]. Its transpose
+ * is accumulated into columns of u, so u * b stays the same
+ */
+template<typename L, std::size_t P, std::size_t Q>
+void givensRotation(typename L::Register (&b)[3][3], typename L::Register (&u)[3][3]) noexcept
+{
+    using T = typename L::Type;
+    using Register = typename L::Register;
+
+    const Register tiny = L::set1(std::numeric_limits<T>::min());
+    const Register x = b[P][P], y = b[Q][P];
+    const Register rho = L::sqrt(L::fmadd(x, x, L::mul(y, y)));
+    const Register inv = L::div(L::set1(T(1)), L::max(rho, tiny));
+    // zero column is left as it is
+    const Register degenerate = L::sub(rho, tiny);
+    const Register c = L::blend(L::mul(x, inv), L::set1(T(1)), degenerate);
+    const Register s = L::blend(L::mul(y, inv), L::zero(), degenerate);
+    for (std::size_t k = 0; k < 3; ++k)
+    {
+        const Register bp = b[P][k], bq = b[Q][k];
+        b[P][k] = L::fmadd(c, bp, L::mul(s, bq));
+        b[Q][k] = mulSub<L>(c, bq, s, bp);
+        const Register up = u[k][P], uq = u[k][Q];
+        u[k][P] = L::fmadd(c, up, L::mul(s, uq));
+        u[k][Q] = mulSub<L>(c, uq, s, up);
+    }
+}
+
+template<typename L>
+void identity(typename L::Register (&m)[3][3]) noexcept
+{
+    for (std::size_t r = 0; r < 3; ++r)
+        for (std::size_t c = 0; c < 3; ++c)
+            m[r][c] = L::set1(typename L::Type(r == c));
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * A = V * diag(values) * V^T, values are in descending order, V is
+ * a rotation. Only upper triangle of A is read
+ */
+template<typename Isa, typename T>
+void symmetricEigenMatrixArrayIntrinImplementation(const T *const *a, T *const *values, T *const *vectors, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *src[9];
+    T *dst[9];
+    for (std::size_t k = 0; k < 9; ++k)
+    {
+        src[k] = a[k];
+        dst[k] = vectors[k];
+    }
+
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register d[3] = {load(src[0] + i), load(src[4] + i), load(src[8] + i)};
+        Register o[3] = {load(src[5] + i), load(src[2] + i), load(src[1] + i)};
+        Register v[3][3];
+        identity<L>(v);
+        jacobiSweeps<L>(d, o, v);
+        sortDescending<L>(d, v);
+        for (std::size_t k = 0; k < 3; ++k)
+            store(values[k] + i, d[k]);
+        storeMatrices<L>(dst, i, store, v);
+    });
+}
+
+/*
+ * A = U * diag(sigma) * V^T. V diagonalizes A^T * A, columns of A * V are
+ * sorted by length and orthogonalized by Givens QR, which gives U. Sigma
+ * is non-negative and in descending order, V is a rotation
+ */
+template<typename Isa, typename T>
+void svdMatrixArrayIntrinImplementation(const T *const *a, T *const *u, T *const *sigma, T *const *v, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *src[9];
+    T *dstU[9], *dstV[9];
+    for (std::size_t k = 0; k < 9; ++k)
+    {
+        src[k] = a[k];
+        dstU[k] = u[k];
+        dstV[k] = v[k];
+    }
+
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register m[3][3];
+        loadMatrices<L>(src, i, load, m);
+        auto gram = [&m](std::size_t r, std::size_t c) {
+            return L::fmadd(m[2][r], m[2][c], L::fmadd(m[1][r], m[1][c], L::mul(m[0][r], m[0][c])));
+        };
+        Register d[3] = {gram(0, 0), gram(1, 1), gram(2, 2)};
+        Register o[3] = {gram(1, 2), gram(0, 2), gram(0, 1)};
+        Register rv[3][3], ru[3][3], b[3][3];
+        identity<L>(rv);
+        jacobiSweeps<L>(d, o, rv);
+
+        for (std::size_t r = 0; r < 3; ++r)
+            for (std::size_t c = 0; c < 3; ++c)
+                b[r][c] = L::fmadd(m[r][2], rv[2][c], L::fmadd(m[r][1], rv[1][c], L::mul(m[r][0], rv[0][c])));
+        Register norm[3];
+        for (std::size_t c = 0; c < 3; ++c)
+            norm[c] = L::fmadd(b[2][c], b[2][c], L::fmadd(b[1][c], b[1][c], L::mul(b[0][c], b[0][c])));
+        sortDescending<L>(norm, b, rv);
+
+        identity<L>(ru);
+        givensRotation<L, 0, 1>(b, ru);
+        givensRotation<L, 0, 2>(b, ru);
+        givensRotation<L, 1, 2>(b, ru);
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            store(sigma[k] + i, L::abs(b[k][k]));
+            for (std::size_t r = 0; r < 3; ++r)
+                ru[r][k] = L::mulSign(ru[r][k], b[k][k]);
+        }
+        storeMatrices<L>(dstU, i, store, ru);
+        storeMatrices<L>(dstV, i, store, rv);
+    });
+}
+
+// ================================ Fallback ================================ //
+template<typename T>
+void symmetricEigenMatrixArrayFallbackImplementation(const T *const *a, T *const *values, T *const *vectors, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    symmetricEigenMatrixArrayIntrinImplementation<Scalar, T>(a, values, vectors, count);
+}
+
+template<typename T>
+void svdMatrixArrayFallbackImplementation(const T *const *a, T *const *u, T *const *sigma, T *const *v, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    svdMatrixArrayIntrinImplementation<Scalar, T>(a, u, sigma, v, count);
+}
+
+}
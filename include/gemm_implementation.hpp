@@ -0,0 +1,200 @@
+#pragma once
+/*
+ * File contains product of row-major matrices of run-time sizes
+ * (see dynamic_matrix.hpp).
+ *
+ * C = A * B is computed by blocks, which fit caches: KC x NC panel of B
+ * and MC x KC block of A are packed into contiguous slivers of NR columns
+ * and MR rows, then micro kernel keeps MR x NR block of C in registers
+ * and adds one outer product of slivers per step of k. Edges of matrices
+ * are padded by zeroes in packed copies, so the micro kernel has no
+ * branches inside the k loop. Fallbacks run the same kernels with
+ * Lanes<T, Scalar>.
+*/
+
+#include "simd.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// Register tile of micro kernel: Rows of C by Registers of its columns
+template<typename Isa>
+struct GemmTile
+{
+    // 12 accumulators of 16 registers
+    static constexpr std::size_t Rows = 6;
+    static constexpr std::size_t Registers = 2;
+};
+
+template<>
+struct GemmTile<AVX512>
+{
+    // 24 accumulators of 32 registers
+    static constexpr std::size_t Rows = 12;
+    static constexpr std::size_t Registers = 2;
+};
+
+template<>
+struct GemmTile<Scalar>
+{
+    static constexpr std::size_t Rows = 4;
+    static constexpr std::size_t Registers = 4;
+};
+
+// Cache blocks: packed A block stays in L2, packed B panel in L3
+inline constexpr std::size_t GemmBlockK = 256;
+inline constexpr std::size_t GemmBlockM = 96;
+inline constexpr std::size_t GemmBlockN = 2048;
+// packed buffers start at cache line boundary
+inline constexpr std::size_t GemmAlignment = 64;
+
+template<typename T>
+struct GemmBuffer
+{
+    void operator()(T *p) const noexcept { ::operator delete(p, std::align_val_t(GemmAlignment)); }
+};
+
+template<typename T>
+std::unique_ptr<T, GemmBuffer<T>> gemmBuffer(std::size_t count)
+{
+    return std::unique_ptr<T, GemmBuffer<T>>(
+        static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t(GemmAlignment))));
+}
+
+/*
+ * Copies rows x columns block of row-major matrix into slivers of Sliver
+ * columns, every sliver is columns-major: its k-th row takes Sliver numbers.
+ * Transposed = true reads block of the transposed matrix, so A is packed
+ * by the same routine with slivers of rows
+ */
+template<std::size_t Sliver, bool Transposed, typename T>
+void packSlivers(const T *src, std::size_t ld, std::size_t rows, std::size_t columns, T *dst) noexcept
+{
+    for (std::size_t j0 = 0; j0 < columns; j0 += Sliver)
+    {
+        const std::size_t width = std::min(Sliver, columns - j0);
+        for (std::size_t k = 0; k < rows; ++k, dst += Sliver)
+        {
+            for (std::size_t j = 0; j < width; ++j)
+                dst[j] = Transposed ? src[(j0 + j) * ld + k] : src[k * ld + j0 + j];
+            for (std::size_t j = width; j < Sliver; ++j)
+                dst[j] = T(0);
+        }
+    }
+}
+
+/*
+ * C block (rows x columns, at most MR x NR) = sum over k of outer products
+ * of packed A and B slivers, added to C if "accumulate" is set
+ */
+template<typename Isa, typename T>
+void gemmMicroKernel(std::size_t depth, const T *a, const T *b, T *c, std::size_t ldc,
+                     std::size_t rows, std::size_t columns, bool accumulate) noexcept
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    constexpr std::size_t MR = GemmTile<Isa>::Rows;
+    constexpr std::size_t NRegs = GemmTile<Isa>::Registers;
+    constexpr std::size_t NR = NRegs * L::Width;
+
+    Register acc[MR][NRegs];
+    for (std::size_t r = 0; r < MR; ++r)
+        for (std::size_t j = 0; j < NRegs; ++j)
+            acc[r][j] = L::zero();
+    for (std::size_t k = 0; k < depth; ++k, a += MR, b += NR)
+    {
+        Register row[NRegs];
+        for (std::size_t j = 0; j < NRegs; ++j)
+            row[j] = L::load(b + j * L::Width);
+        for (std::size_t r = 0; r < MR; ++r)
+        {
+            const Register x = L::set1(a[r]);
+            for (std::size_t j = 0; j < NRegs; ++j)
+                acc[r][j] = L::fmadd(x, row[j], acc[r][j]);
+        }
+    }
+
+    if (rows == MR && columns == NR)
+    {
+        for (std::size_t r = 0; r < MR; ++r)
+            for (std::size_t j = 0; j < NRegs; ++j)
+            {
+                T *p = c + r * ldc + j * L::Width;
+                L::store(p, accumulate ? L::add(L::load(p), acc[r][j]) : acc[r][j]);
+            }
+        return;
+    }
+    // partial loads and stores take less than Width numbers
+    for (std::size_t r = 0; r < rows; ++r)
+        for (std::size_t j = 0; j * L::Width < columns; ++j)
+        {
+            T *p = c + r * ldc + j * L::Width;
+            const std::size_t width = columns - j * L::Width;
+            if (width >= L::Width)
+                L::store(p, accumulate ? L::add(L::load(p), acc[r][j]) : acc[r][j]);
+            else
+                L::storePartial(p, accumulate ? L::add(L::loadPartial(p, width), acc[r][j]) : acc[r][j], width);
+        }
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * C (m x n) = A (m x k) * B (k x n), ld* are distances between rows.
+ * C must not overlap operands
+ */
+template<typename Isa, typename T>
+void gemmIntrinImplementation(const T *a, std::size_t lda, const T *b, std::size_t ldb, T *c, std::size_t ldc,
+                              std::size_t m, std::size_t n, std::size_t k)
+{
+    constexpr std::size_t MR = GemmTile<Isa>::Rows;
+    constexpr std::size_t NR = GemmTile<Isa>::Registers * Lanes<T, Isa>::Width;
+    if (!m || !n)
+        return;
+    if (!k)
+    {
+        for (std::size_t i = 0; i < m; ++i)
+            std::fill_n(c + i * ldc, n, T(0));
+        return;
+    }
+
+    const std::size_t blockK = std::min(k, GemmBlockK);
+    const std::size_t blockM = std::min((m + MR - 1) / MR * MR, GemmBlockM);
+    const std::size_t blockN = std::min((n + NR - 1) / NR * NR, GemmBlockN);
+    const auto packedA = gemmBuffer<T>(blockM * blockK);
+    const auto packedB = gemmBuffer<T>(blockK * blockN);
+
+    for (std::size_t jc = 0; jc < n; jc += GemmBlockN)
+    {
+        const std::size_t nc = std::min(GemmBlockN, n - jc);
+        for (std::size_t pc = 0; pc < k; pc += GemmBlockK)
+        {
+            const std::size_t kc = std::min(GemmBlockK, k - pc);
+            packSlivers<NR, false>(b + pc * ldb + jc, ldb, kc, nc, packedB.get());
+            for (std::size_t ic = 0; ic < m; ic += GemmBlockM)
+            {
+                const std::size_t mc = std::min(GemmBlockM, m - ic);
+                packSlivers<MR, true>(a + ic * lda + pc, lda, kc, mc, packedA.get());
+                for (std::size_t jr = 0; jr < nc; jr += NR)
+                    for (std::size_t ir = 0; ir < mc; ir += MR)
+                        gemmMicroKernel<Isa, T>(kc, packedA.get() + ir * kc, packedB.get() + jr * kc,
+                                                c + (ic + ir) * ldc + jc + jr, ldc,
+                                                std::min(MR, mc - ir), std::min(NR, nc - jr), pc != 0);
+            }
+        }
+    }
+}
+
+// ================================ Fallback ================================ //
+template<typename T>
+void gemmFallbackImplementation(const T *a, std::size_t lda, const T *b, std::size_t ldb, T *c, std::size_t ldc,
+                                std::size_t m, std::size_t n, std::size_t k) requires(std::is_floating_point_v<T>)
+{
+    gemmIntrinImplementation<Scalar, T>(a, lda, b, ldb, c, ldc, m, n, k);
+}
+
+}
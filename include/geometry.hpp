@@ -1,37 +1,100 @@
 #pragma once
 
 #include "matrix.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
 
 
 namespace Geometrix
 {
-using Vector2D = Math::Vector2D<float>;
-using Vector3D = Math::Vector3D<float>;
-using Vector4D = Math::Vector4D<float>;
+using Vector2D = LA::Vector2D<float>;
+using Vector3D = LA::Vector3D<float>;
+using Vector4D = LA::Vector4D<float>;
+
+using Point2D = LA::Vector2D<std::size_t>;
+using Point3D = LA::Vector3D<std::size_t>;
+
+/*
+ * Compact points of grids and images take 4-12 bytes instead of 16-24
+ * and fill SIMD registers with 2-4 times more coordinates: batches of
+ * them run through integer_matrix.hpp, which adds and subtracts with
+ * wrapping or saturation and converts to and from float vectors
+ */
+using Point2D16 = LA::Vector2D<std::int16_t>;
+using Point3D16 = LA::Vector3D<std::int16_t>;
+using Point2D32 = LA::Vector2D<std::int32_t>;
+using Point3D32 = LA::Vector3D<std::int32_t>;
+
+static_assert(sizeof(Point2D16) == 4 && sizeof(Point3D16) == 6);
+static_assert(sizeof(Point2D32) == 8 && sizeof(Point3D32) == 12);
 
-using Point2D = Math::Vector2D<std::size_t>;
-using Point3D = Math::Vector3D<std::size_t>;
+// squared length, integer points accumulate in 64 bits
+template<typename T>
+inline constexpr auto squaredLength(const LA::Vector<T,2> &v) noexcept
+{
+    using Wide = std::conditional_t<std::is_integral_v<T>, std::int64_t, T>;
+    return Wide(v.x()) * Wide(v.x()) + Wide(v.y()) * Wide(v.y());
+}
+
+namespace _Geometry
+{
+// radii of integer circles are compared in 64 bits
+template<typename T>
+using Radius = std::conditional_t<std::is_integral_v<T>, std::uint64_t, T>;
+
+// |a - b| of integer coordinates, exact for any coordinates of 64 bits or less
+template<typename T>
+inline constexpr std::uint64_t distance(T a, T b) noexcept
+{
+    return a > b ? std::uint64_t(a) - std::uint64_t(b) : std::uint64_t(b) - std::uint64_t(a);
+}
+
+/*
+ * Sign of |a - b|^2 - r^2. Integer coordinates don't wrap: differences are
+ * taken in 64 bits and axes farther than r end early, so squares stay
+ * below r^2, which fits for r < 2^32
+ */
+template<typename T>
+inline constexpr int compareDistance(const LA::Vector<T,2> &a, const LA::Vector<T,2> &b, Radius<T> r) noexcept
+{
+    if constexpr (std::is_integral_v<T>)
+    {
+        const std::uint64_t dx = distance(a.x(), b.x()), dy = distance(a.y(), b.y());
+        if (dx > r || dy > r)
+            return 1;
+        const std::uint64_t rest = r * r - dx * dx, dy2 = dy * dy;
+        return dy2 < rest ? -1 : dy2 > rest ? 1 : 0;
+    }
+    else
+    {
+        const T dx = a.x() - b.x(), dy = a.y() - b.y();
+        const T d = dx * dx + dy * dy, r2 = r * r;
+        return d < r2 ? -1 : d > r2 ? 1 : 0;
+    }
+}
+}
 
 
 template<typename T, std::size_t Dim>
 struct Ray
 {
-    Math::Vector<T,Dim> origin;
-    Math::Vector<T,Dim> direction;
-    Math::Vector<T,Dim> at(T t) const noexcept {return origin + direction*t;}
+    LA::Vector<T,Dim> origin;
+    LA::Vector<T,Dim> direction;
+    LA::Vector<T,Dim> at(T t) const noexcept {return origin + direction*t;}
 };
 
 template<typename T, std::size_t Dim>
 struct Line
 {
-    Math::Vector<T,Dim> a;
-    Math::Vector<T,Dim> b;
+    LA::Vector<T,Dim> a;
+    LA::Vector<T,Dim> b;
 };
 
 template<typename T, std::size_t Dim>
 struct Circle
 {
-    Math::Vector<T,Dim> origin;
+    LA::Vector<T,Dim> origin;
     T                   radius;
 };
 
@@ -39,7 +102,7 @@ struct Circle
 template<typename T, std::size_t Dim>
 struct Triangle
 {
-    Math::Vector<T,Dim> angle[3];
+    LA::Vector<T,Dim> angle[3];
 };
 
 /*      width
@@ -58,15 +121,15 @@ struct Triangle
 template<typename T, std::size_t Dim>
 struct Rectangle
 {
-    Math::Vector<T,Dim> topleft;
-    Math::Vector<T,Dim> botright;
+    LA::Vector<T,Dim> topleft;
+    LA::Vector<T,Dim> botright;
 
     auto height() const noexcept { return botright.y() - topleft.y(); }
     auto width() const noexcept { return botright.x() - topleft.x(); }
     auto p1() const noexcept {return topleft;}
-    auto p2() const noexcept {return Math::Vector<T,Dim>(topleft.y(), botright.x());}
+    auto p2() const noexcept {return LA::Vector<T,Dim>(botright.x(), topleft.y());}
     auto p3() const noexcept {return botright;}
-    auto p4() const noexcept {return Math::Vector<T,Dim>(topleft.x(), botright.y());}
+    auto p4() const noexcept {return LA::Vector<T,Dim>(topleft.x(), botright.y());}
 };
 
 template<typename T>
@@ -82,7 +145,7 @@ template<typename T>
 using Circle2D = Circle<T,2>;
 
 template<typename T>
-inline constexpr bool intersect(const Math::Vector<T,2> &p, const Rectangle2D<T> &rect) noexcept
+inline constexpr bool intersect(const LA::Vector<T,2> &p, const Rectangle2D<T> &rect) noexcept
 {
     if(p.x() > rect.topleft.x() &&
        p.x() < rect.botright.x() &&
@@ -93,14 +156,9 @@ inline constexpr bool intersect(const Math::Vector<T,2> &p, const Rectangle2D<T>
 }
 
 template<typename T>
-inline constexpr bool intersect(const Math::Vector<T,2> &p, const Circle2D<T> &crcl) noexcept
-{
-    const T dx = std::abs(p.x() - crcl.origin.x());
-    if(dx > crcl.radius) return false;
-    const T dy = std::abs(p.y() - crcl.origin.y());
-    if(dy > crcl.radius) return false;
-    if(dx+dy<=crcl.radius) return true;
-    return dx*dx + dy*dy <= crcl.radius*crcl.radius;
+inline constexpr bool intersect(const LA::Vector<T,2> &p, const Circle2D<T> &crcl) noexcept
+{
+    return _Geometry::compareDistance(p, crcl.origin, _Geometry::Radius<T>(crcl.radius)) <= 0;
 }
 
 //AABB Algorithm
@@ -124,21 +182,17 @@ inline constexpr bool intersect(const Rectangle2D<T> &lhs, const Rectangle2D<T>
 template<typename T>
 inline constexpr bool intersect(const Circle2D<T> &lhs, const Circle2D<T> &rhs) noexcept
 {
-    const auto diff = (lhs.origin + lhs.radius) - (rhs.origin + rhs.radius);
-    const auto dist = diff.norm();
-    if(dist < (lhs.radius + rhs.radius))
-        return true;
-    return false;
+    const auto radius = _Geometry::Radius<T>(lhs.radius) + _Geometry::Radius<T>(rhs.radius);
+    return _Geometry::compareDistance(lhs.origin, rhs.origin, radius) < 0;
 }
 
 template<typename T>
 inline constexpr bool intersect(const Rectangle2D<T> &r, const Circle2D<T> &c) noexcept
 {
-    Math::Vector<T,2> n( std::max(r.topleft.x(),std::min(c.origin.x(), r.botright.x())),
+    LA::Vector<T,2> n( std::max(r.topleft.x(),std::min(c.origin.x(), r.botright.x())),
                          std::max(r.topleft.y(),std::min(c.origin.y(), r.botright.y())));
 
-    Math::Vector<T,2> d = n-c.origin;
-    return d.norm() <= c.radius*c.radius;
+    return _Geometry::compareDistance(n, c.origin, _Geometry::Radius<T>(c.radius)) <= 0;
 }
 
 template<typename T>
@@ -151,9 +205,9 @@ template<typename T, std::size_t Dim>
 inline constexpr bool intersect(const Circle<T,Dim> &c, const Ray<T,Dim> &l) noexcept
 {
     auto oc = l.origin - c.origin;
-    T a = Math::dot(l.direction,l.direction);
-    T b = Math::dot(oc,l.direction);
-    T e = Math::dot(oc,oc) - c.radius * c.radius;
+    T a = LA::dot(l.direction,l.direction);
+    T b = LA::dot(oc,l.direction);
+    T e = LA::dot(oc,oc) - c.radius * c.radius;
     T d = b*b-a*e;
 
     if(d>0) return true;
@@ -165,11 +219,11 @@ inline constexpr bool intersect(const Circle<T,Dim> &c, const Ray<T,Dim> &l) noe
 template<typename T, std::size_t Dim>
 inline constexpr auto intersect(const Ray<T,Dim> &ray, const Triangle<T,Dim> &triangle)
 {
-    using Vec = Math::Vector<T,Dim>;
+    using Vec = LA::Vector<T,Dim>;
     Vec e1 = triangle.angle[1] - triangle.angle[0];
     Vec e2 = triangle.angle[2] - triangle.angle[0];
 
-    Vec normVec = Math::cross(ray.direction,e2);
+    Vec normVec = LA::cross(ray.direction,e2);
     T det = dot(e1,normVec);
 
     if(det < 1e-8 && det > -1e-8) //if det == 0
@@ -0,0 +1,821 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of element-wise
+ * operations over arrays of 16, 32 and 64 bit integers and their
+ * conversions to and from float (see integer_matrix.hpp).
+ *
+ * IntegerLanes<T, Isa> wraps integer registers like Lanes<T, Isa> does
+ * floating-point ones. Arithmetic wraps around in two's complement for
+ * signed types too, saturating versions clamp to the range of T. Shifts
+ * take counts as unsigned numbers: counts of bit width or more give 0,
+ * or the sign of arithmetic right shift, in every implementation. Signed
+ * right shifts are arithmetic, unsigned ones logical. Operations without
+ * instructions (SSE2 variable shifts and 32 bit multiplication, 16 bit
+ * variable shifts before AVX-512, 64 bit multiplication, 32 and 64 bit
+ * saturation) are emulated. SSE4.1 builds multiply by instruction, Optimizer
+ * takes their SSE kernels only on CPUs with SSE4.1.
+ * 16 bit AVX-512 lanes need AVX512BW. Results may alias operands.
+*/
+
+#include "conversion_implementation.hpp"
+#include "simd.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+
+namespace _Impl
+{
+enum class IntegerOp
+{
+    Add,
+    Sub,
+    Mul,
+    And,
+    Or,
+    Xor,
+    ShiftLeft,
+    ShiftRight,
+    AddSaturate,
+    SubSaturate
+};
+
+// fixed-width type of the same size and sign, which dispatch tables are kept for
+template<typename T>
+using IntegerLane = std::conditional_t<sizeof(T) == 2,
+                                       std::conditional_t<std::is_signed_v<T>, std::int16_t, std::uint16_t>,
+                    std::conditional_t<sizeof(T) == 4,
+                                       std::conditional_t<std::is_signed_v<T>, std::int32_t, std::uint32_t>,
+                                       std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>>;
+
+template<typename T, typename Isa>
+struct IntegerLanes;
+
+template<typename T>
+struct IntegerLanes<T, Scalar>
+{
+private:
+    using U = std::make_unsigned_t<T>;
+    // unsigned arithmetic, which isn't promoted to int and can't overflow
+    using W = std::common_type_t<U, unsigned>;
+    static constexpr U Bits = U(sizeof(T) * 8);
+
+public:
+    using Type = T;
+    using Register = T;
+    static constexpr std::size_t Width = 1;
+
+    static Register load(const T *p) noexcept { return *p; }
+    static void store(T *p, Register v) noexcept { *p = v; }
+    static Register set1(T v) noexcept { return v; }
+
+    static Register add(Register a, Register b) noexcept { return T(W(a) + W(b)); }
+    static Register sub(Register a, Register b) noexcept { return T(W(a) - W(b)); }
+    static Register mul(Register a, Register b) noexcept { return T(W(a) * W(b)); }
+    static Register bitAnd(Register a, Register b) noexcept { return a & b; }
+    static Register bitOr(Register a, Register b) noexcept { return a | b; }
+    static Register bitXor(Register a, Register b) noexcept { return a ^ b; }
+    // ~a & b
+    static Register bitAndNot(Register a, Register b) noexcept { return T(~a & b); }
+    // all bits set, where the highest one is
+    static Register signMask(Register a) noexcept { return U(a) >> (Bits - 1) ? T(~U(0)) : T(0); }
+    static Register shiftLeft(Register a, U n) noexcept { return n < Bits ? T(W(a) << n) : T(0); }
+    static Register shiftRight(Register a, U n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return a >> (n < Bits ? n : Bits - 1);
+        else
+            return n < Bits ? T(a >> n) : T(0);
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return shiftLeft(a, U(n)); }
+    static Register shiftRightVar(Register a, Register n) noexcept { return shiftRight(a, U(n)); }
+};
+
+// variable shifts without instructions, lanes are shifted one by one
+template<bool Left, typename T, typename Register>
+Register shiftByLanes(Register a, Register n) noexcept
+{
+    using S = IntegerLanes<T, Scalar>;
+    constexpr std::size_t Width = sizeof(Register) / sizeof(T);
+    alignas(sizeof(Register)) T x[Width], c[Width];
+    std::memcpy(x, &a, sizeof(Register));
+    std::memcpy(c, &n, sizeof(Register));
+    for (std::size_t i = 0; i < Width; ++i)
+        x[i] = Left ? S::shiftLeftVar(x[i], c[i]) : S::shiftRightVar(x[i], c[i]);
+    std::memcpy(&a, x, sizeof(Register));
+    return a;
+}
+
+#ifdef __SSE2__
+template<typename T> requires(sizeof(T) == 2)
+struct IntegerLanes<T, SSE>
+{
+    using Type = T;
+    using Register = __m128i;
+    static constexpr std::size_t Width = 8;
+
+    static Register load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm_set1_epi16(std::int16_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm_add_epi16(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_epi16(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm_mullo_epi16(a, b); }
+    static Register addSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm_adds_epi16(a, b);
+        else
+            return _mm_adds_epu16(a, b);
+    }
+    static Register subSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm_subs_epi16(a, b);
+        else
+            return _mm_subs_epu16(a, b);
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm_and_si128(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm_or_si128(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm_xor_si128(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm_andnot_si128(a, b); }
+    static Register signMask(Register a) noexcept { return _mm_srai_epi16(a, 15); }
+    static Register shiftLeft(Register a, std::uint16_t n) noexcept { return _mm_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+    static Register shiftRight(Register a, std::uint16_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm_sra_epi16(a, _mm_cvtsi32_si128(n));
+        else
+            return _mm_srl_epi16(a, _mm_cvtsi32_si128(n));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return shiftByLanes<true, T>(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept { return shiftByLanes<false, T>(a, n); }
+};
+
+template<typename T> requires(sizeof(T) == 4)
+struct IntegerLanes<T, SSE>
+{
+    using Type = T;
+    using Register = __m128i;
+    static constexpr std::size_t Width = 4;
+
+    static Register load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm_set1_epi32(std::int32_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm_add_epi32(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_epi32(a, b); }
+    static Register mul(Register a, Register b) noexcept
+    {
+#ifdef __SSE4_1__
+        return _mm_mullo_epi32(a, b);
+#else
+        // low halves of even and odd lane products
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0,0,2,0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0,0,2,0)));
+#endif
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm_and_si128(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm_or_si128(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm_xor_si128(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm_andnot_si128(a, b); }
+    static Register signMask(Register a) noexcept { return _mm_srai_epi32(a, 31); }
+    static Register shiftLeft(Register a, std::uint32_t n) noexcept { return _mm_sll_epi32(a, _mm_cvtsi32_si128(int(n))); }
+    static Register shiftRight(Register a, std::uint32_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm_sra_epi32(a, _mm_cvtsi32_si128(int(n)));
+        else
+            return _mm_srl_epi32(a, _mm_cvtsi32_si128(int(n)));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return shiftByLanes<true, T>(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept { return shiftByLanes<false, T>(a, n); }
+};
+
+template<typename T> requires(sizeof(T) == 8)
+struct IntegerLanes<T, SSE>
+{
+    using Type = T;
+    using Register = __m128i;
+    static constexpr std::size_t Width = 2;
+
+    static Register load(const T *p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm_set1_epi64x(std::int64_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm_add_epi64(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_epi64(a, b); }
+    // lo * lo + ((hi * lo + lo * hi) << 32)
+    static Register mul(Register a, Register b) noexcept
+    {
+        const __m128i cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                                            _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+        return _mm_add_epi64(_mm_mul_epu32(a, b), _mm_slli_epi64(cross, 32));
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm_and_si128(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm_or_si128(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm_xor_si128(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm_andnot_si128(a, b); }
+    static Register signMask(Register a) noexcept { return _mm_shuffle_epi32(_mm_srai_epi32(a, 31), _MM_SHUFFLE(3,3,1,1)); }
+    static Register shiftLeft(Register a, std::uint64_t n) noexcept { return _mm_sll_epi64(a, _mm_cvtsi64_si128(std::int64_t(n))); }
+    static Register shiftRight(Register a, std::uint64_t n) noexcept
+    {
+        const __m128i count = _mm_cvtsi64_si128(std::int64_t(n));
+        if constexpr (std::is_signed_v<T>)
+        {
+            // no arithmetic 64 bit shift: negative numbers are inverted around logical one
+            const __m128i sign = signMask(a);
+            return _mm_xor_si128(_mm_srl_epi64(_mm_xor_si128(a, sign), count), sign);
+        }
+        else
+            return _mm_srl_epi64(a, count);
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return shiftByLanes<true, T>(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept { return shiftByLanes<false, T>(a, n); }
+};
+#endif
+
+#ifdef __AVX2__
+template<typename T> requires(sizeof(T) == 2)
+struct IntegerLanes<T, AVX2>
+{
+    using Type = T;
+    using Register = __m256i;
+    static constexpr std::size_t Width = 16;
+
+    static Register load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm256_set1_epi16(std::int16_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm256_add_epi16(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_epi16(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm256_mullo_epi16(a, b); }
+    static Register addSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm256_adds_epi16(a, b);
+        else
+            return _mm256_adds_epu16(a, b);
+    }
+    static Register subSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm256_subs_epi16(a, b);
+        else
+            return _mm256_subs_epu16(a, b);
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm256_and_si256(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm256_or_si256(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm256_xor_si256(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm256_andnot_si256(a, b); }
+    static Register signMask(Register a) noexcept { return _mm256_srai_epi16(a, 15); }
+    static Register shiftLeft(Register a, std::uint16_t n) noexcept { return _mm256_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+    static Register shiftRight(Register a, std::uint16_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm256_sra_epi16(a, _mm_cvtsi32_si128(n));
+        else
+            return _mm256_srl_epi16(a, _mm_cvtsi32_si128(n));
+    }
+    // no 16 bit variable shifts: even and odd lanes are shifted as 32 bit ones
+    static Register shiftLeftVar(Register a, Register n) noexcept
+    {
+        const __m256i low = _mm256_set1_epi32(0xFFFF);
+        const __m256i even = _mm256_sllv_epi32(a, _mm256_and_si256(n, low));
+        const __m256i odd = _mm256_sllv_epi32(_mm256_andnot_si256(low, a), _mm256_srli_epi32(n, 16));
+        return _mm256_blend_epi16(even, odd, 0xAA);
+    }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        const __m256i low = _mm256_set1_epi32(0xFFFF);
+        const __m256i odd = std::is_signed_v<T> ? _mm256_srav_epi32(a, _mm256_srli_epi32(n, 16))
+                                                : _mm256_srlv_epi32(a, _mm256_srli_epi32(n, 16));
+        const __m256i even = std::is_signed_v<T> ? _mm256_srav_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16), _mm256_and_si256(n, low))
+                                                 : _mm256_srlv_epi32(_mm256_and_si256(a, low), _mm256_and_si256(n, low));
+        return _mm256_blend_epi16(even, odd, 0xAA);
+    }
+};
+
+template<typename T> requires(sizeof(T) == 4)
+struct IntegerLanes<T, AVX2>
+{
+    using Type = T;
+    using Register = __m256i;
+    static constexpr std::size_t Width = 8;
+
+    static Register load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm256_set1_epi32(std::int32_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm256_add_epi32(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_epi32(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm256_mullo_epi32(a, b); }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm256_and_si256(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm256_or_si256(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm256_xor_si256(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm256_andnot_si256(a, b); }
+    static Register signMask(Register a) noexcept { return _mm256_srai_epi32(a, 31); }
+    static Register shiftLeft(Register a, std::uint32_t n) noexcept { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(int(n))); }
+    static Register shiftRight(Register a, std::uint32_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm256_sra_epi32(a, _mm_cvtsi32_si128(int(n)));
+        else
+            return _mm256_srl_epi32(a, _mm_cvtsi32_si128(int(n)));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return _mm256_sllv_epi32(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm256_srav_epi32(a, n);
+        else
+            return _mm256_srlv_epi32(a, n);
+    }
+};
+
+template<typename T> requires(sizeof(T) == 8)
+struct IntegerLanes<T, AVX2>
+{
+    using Type = T;
+    using Register = __m256i;
+    static constexpr std::size_t Width = 4;
+
+    static Register load(const T *p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static void store(T *p, Register v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+    static Register set1(T v) noexcept { return _mm256_set1_epi64x(std::int64_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm256_add_epi64(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_epi64(a, b); }
+    // lo * lo + ((hi * lo + lo * hi) << 32)
+    static Register mul(Register a, Register b) noexcept
+    {
+        const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                               _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross, 32));
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm256_and_si256(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm256_or_si256(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm256_xor_si256(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm256_andnot_si256(a, b); }
+    static Register signMask(Register a) noexcept { return _mm256_cmpgt_epi64(_mm256_setzero_si256(), a); }
+    static Register shiftLeft(Register a, std::uint64_t n) noexcept { return _mm256_sll_epi64(a, _mm_cvtsi64_si128(std::int64_t(n))); }
+    static Register shiftRight(Register a, std::uint64_t n) noexcept
+    {
+        const __m128i count = _mm_cvtsi64_si128(std::int64_t(n));
+        if constexpr (std::is_signed_v<T>)
+        {
+            const __m256i sign = signMask(a);
+            return _mm256_xor_si256(_mm256_srl_epi64(_mm256_xor_si256(a, sign), count), sign);
+        }
+        else
+            return _mm256_srl_epi64(a, count);
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return _mm256_sllv_epi64(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            // no arithmetic 64 bit shift: negative numbers are inverted around logical one
+            const __m256i sign = signMask(a);
+            return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(a, sign), n), sign);
+        }
+        else
+            return _mm256_srlv_epi64(a, n);
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+template<typename T> requires(sizeof(T) == 4)
+struct IntegerLanes<T, AVX512>
+{
+    using Type = T;
+    using Register = __m512i;
+    static constexpr std::size_t Width = 16;
+
+    static Register load(const T *p) noexcept { return _mm512_loadu_si512(p); }
+    static void store(T *p, Register v) noexcept { _mm512_storeu_si512(p, v); }
+    static Register set1(T v) noexcept { return _mm512_set1_epi32(std::int32_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm512_add_epi32(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm512_sub_epi32(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm512_mullo_epi32(a, b); }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm512_and_si512(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm512_or_si512(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm512_xor_si512(a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm512_andnot_si512(a, b); }
+    static Register signMask(Register a) noexcept { return _mm512_srai_epi32(a, 31); }
+    static Register shiftLeft(Register a, std::uint32_t n) noexcept { return _mm512_sll_epi32(a, _mm_cvtsi32_si128(int(n))); }
+    static Register shiftRight(Register a, std::uint32_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_sra_epi32(a, _mm_cvtsi32_si128(int(n)));
+        else
+            return _mm512_srl_epi32(a, _mm_cvtsi32_si128(int(n)));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return _mm512_sllv_epi32(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_srav_epi32(a, n);
+        else
+            return _mm512_srlv_epi32(a, n);
+    }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+};
+
+template<typename T> requires(sizeof(T) == 8)
+struct IntegerLanes<T, AVX512>
+{
+    using Type = T;
+    using Register = __m512i;
+    static constexpr std::size_t Width = 8;
+
+    static Register load(const T *p) noexcept { return _mm512_loadu_si512(p); }
+    static void store(T *p, Register v) noexcept { _mm512_storeu_si512(p, v); }
+    static Register set1(T v) noexcept { return _mm512_set1_epi64(std::int64_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm512_add_epi64(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm512_sub_epi64(a, b); }
+    // AVX512F sequence, single instruction needs AVX512DQ
+    static Register mul(Register a, Register b) noexcept { return _mm512_mullox_epi64(a, b); }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm512_and_si512(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm512_or_si512(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm512_xor_si512(a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm512_andnot_si512(a, b); }
+    static Register signMask(Register a) noexcept { return _mm512_srai_epi64(a, 63); }
+    static Register shiftLeft(Register a, std::uint64_t n) noexcept { return _mm512_sll_epi64(a, _mm_cvtsi64_si128(std::int64_t(n))); }
+    static Register shiftRight(Register a, std::uint64_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_sra_epi64(a, _mm_cvtsi64_si128(std::int64_t(n)));
+        else
+            return _mm512_srl_epi64(a, _mm_cvtsi64_si128(std::int64_t(n)));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return _mm512_sllv_epi64(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_srav_epi64(a, n);
+        else
+            return _mm512_srlv_epi64(a, n);
+    }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+};
+#endif
+
+#ifdef __AVX512BW__
+template<typename T> requires(sizeof(T) == 2)
+struct IntegerLanes<T, AVX512>
+{
+    using Type = T;
+    using Register = __m512i;
+    static constexpr std::size_t Width = 32;
+
+    static Register load(const T *p) noexcept { return _mm512_loadu_si512(p); }
+    static void store(T *p, Register v) noexcept { _mm512_storeu_si512(p, v); }
+    static Register set1(T v) noexcept { return _mm512_set1_epi16(std::int16_t(v)); }
+
+    static Register add(Register a, Register b) noexcept { return _mm512_add_epi16(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm512_sub_epi16(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm512_mullo_epi16(a, b); }
+    static Register addSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_adds_epi16(a, b);
+        else
+            return _mm512_adds_epu16(a, b);
+    }
+    static Register subSaturate(Register a, Register b) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_subs_epi16(a, b);
+        else
+            return _mm512_subs_epu16(a, b);
+    }
+    static Register bitAnd(Register a, Register b) noexcept { return _mm512_and_si512(a, b); }
+    static Register bitOr(Register a, Register b) noexcept { return _mm512_or_si512(a, b); }
+    static Register bitXor(Register a, Register b) noexcept { return _mm512_xor_si512(a, b); }
+    static Register bitAndNot(Register a, Register b) noexcept { return _mm512_andnot_si512(a, b); }
+    static Register signMask(Register a) noexcept { return _mm512_srai_epi16(a, 15); }
+    static Register shiftLeft(Register a, std::uint16_t n) noexcept { return _mm512_sll_epi16(a, _mm_cvtsi32_si128(n)); }
+    static Register shiftRight(Register a, std::uint16_t n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_sra_epi16(a, _mm_cvtsi32_si128(n));
+        else
+            return _mm512_srl_epi16(a, _mm_cvtsi32_si128(n));
+    }
+    static Register shiftLeftVar(Register a, Register n) noexcept { return _mm512_sllv_epi16(a, n); }
+    static Register shiftRightVar(Register a, Register n) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+            return _mm512_srav_epi16(a, n);
+        else
+            return _mm512_srlv_epi16(a, n);
+    }
+};
+#endif
+
+/*
+ * Loads and stores of Lanes<float, Isa>::Width integers as float lanes.
+ * Stored numbers are rounded to nearest even and already clamped to
+ * [Lowest, Highest], so narrowing needs no saturation. Other rounding
+ * modes round lanes to integral values before the store
+ */
+template<typename T, typename Isa>
+struct FloatConversion;
+
+template<typename T>
+struct FloatLimits
+{
+    static constexpr float Lowest = float(std::numeric_limits<T>::lowest());
+    // the largest float, which T holds, 2^31 - 128 for int32_t
+    static constexpr float Highest = sizeof(T) < 4 ? float(std::numeric_limits<T>::max()) : 2147483520.f;
+};
+
+// float clamped to the range of T and rounded by Mode, NaN gives Lowest
+template<typename T, Rounding Mode = Rounding::Nearest>
+T fromFloat(float v) noexcept
+{
+    v = v > FloatLimits<T>::Lowest ? v : FloatLimits<T>::Lowest;
+    v = v < FloatLimits<T>::Highest ? v : FloatLimits<T>::Highest;
+    return T(roundIntegral<Mode>(v));
+}
+
+#ifdef __SSE2__
+template<typename T> requires(sizeof(T) == 4)
+struct FloatConversion<T, SSE>
+{
+    static __m128 load(const T *p) noexcept { return _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))); }
+    static void store(T *p, __m128 v) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), _mm_cvtps_epi32(v)); }
+};
+
+template<typename T> requires(sizeof(T) == 2)
+struct FloatConversion<T, SSE>
+{
+    static __m128 load(const T *p) noexcept
+    {
+        const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(p));
+        if constexpr (std::is_signed_v<T>)
+            return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        else
+            return _mm_cvtepi32_ps(_mm_unpacklo_epi16(x, _mm_setzero_si128()));
+    }
+    static void store(T *p, __m128 v) noexcept
+    {
+        const __m128i x = _mm_cvtps_epi32(v);
+        if constexpr (std::is_signed_v<T>)
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_packs_epi32(x, x));
+        else
+        {
+            // no unsigned pack before SSE4.1: numbers are packed as signed ones around 32768
+            const __m128i bias = _mm_packs_epi32(_mm_sub_epi32(x, _mm_set1_epi32(32768)), _mm_setzero_si128());
+            _mm_storel_epi64(reinterpret_cast<__m128i *>(p), _mm_xor_si128(bias, _mm_set1_epi16(std::int16_t(0x8000))));
+        }
+    }
+};
+#endif
+
+#ifdef __AVX2__
+template<typename T> requires(sizeof(T) == 4)
+struct FloatConversion<T, AVX2>
+{
+    static __m256 load(const T *p) noexcept { return _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p))); }
+    static void store(T *p, __m256 v) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm256_cvtps_epi32(v)); }
+};
+
+template<typename T> requires(sizeof(T) == 2)
+struct FloatConversion<T, AVX2>
+{
+    static __m256 load(const T *p) noexcept
+    {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        return _mm256_cvtepi32_ps(std::is_signed_v<T> ? _mm256_cvtepi16_epi32(x) : _mm256_cvtepu16_epi32(x));
+    }
+    static void store(T *p, __m256 v) noexcept
+    {
+        const __m256i x = _mm256_cvtps_epi32(v);
+        const __m128i lo = _mm256_castsi256_si128(x), hi = _mm256_extracti128_si256(x, 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(p), std::is_signed_v<T> ? _mm_packs_epi32(lo, hi) : _mm_packus_epi32(lo, hi));
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+template<typename T> requires(sizeof(T) == 4)
+struct FloatConversion<T, AVX512>
+{
+    static __m512 load(const T *p) noexcept { return _mm512_cvtepi32_ps(_mm512_loadu_si512(p)); }
+    static void store(T *p, __m512 v) noexcept { _mm512_storeu_si512(p, _mm512_cvtps_epi32(v)); }
+};
+
+template<typename T> requires(sizeof(T) == 2)
+struct FloatConversion<T, AVX512>
+{
+    static __m512 load(const T *p) noexcept
+    {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        return _mm512_cvtepi32_ps(std::is_signed_v<T> ? _mm512_cvtepi16_epi32(x) : _mm512_cvtepu16_epi32(x));
+    }
+    static void store(T *p, __m512 v) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), _mm512_cvtepi32_epi16(_mm512_cvtps_epi32(v)));
+    }
+};
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+/*
+ * a + b clamped to the range of T. Without instructions overflow is found
+ * by signs: of operands and result for signed numbers, of the carry
+ * for unsigned ones
+ */
+template<typename L>
+typename L::Register addSaturate(typename L::Register a, typename L::Register b) noexcept
+{
+    using T = typename L::Type;
+    if constexpr (requires { L::addSaturate(a, b); })
+        return L::addSaturate(a, b);
+    else if constexpr (std::is_signed_v<T>)
+    {
+        const auto r = L::add(a, b);
+        const auto overflow = L::signMask(L::bitAnd(L::bitXor(a, r), L::bitXor(b, r)));
+        const auto bound = L::bitXor(L::signMask(a), L::set1(std::numeric_limits<T>::max()));
+        return L::bitOr(L::bitAnd(overflow, bound), L::bitAndNot(overflow, r));
+    }
+    else
+    {
+        const auto r = L::add(a, b);
+        const auto carry = L::signMask(L::bitOr(L::bitAnd(a, b), L::bitAndNot(r, L::bitOr(a, b))));
+        return L::bitOr(r, carry);
+    }
+}
+
+// a - b clamped to the range of T
+template<typename L>
+typename L::Register subSaturate(typename L::Register a, typename L::Register b) noexcept
+{
+    using T = typename L::Type;
+    if constexpr (requires { L::subSaturate(a, b); })
+        return L::subSaturate(a, b);
+    else if constexpr (std::is_signed_v<T>)
+    {
+        const auto r = L::sub(a, b);
+        const auto overflow = L::signMask(L::bitAnd(L::bitXor(a, b), L::bitXor(a, r)));
+        const auto bound = L::bitXor(L::signMask(a), L::set1(std::numeric_limits<T>::max()));
+        return L::bitOr(L::bitAnd(overflow, bound), L::bitAndNot(overflow, r));
+    }
+    else
+    {
+        const auto r = L::sub(a, b);
+        const auto borrow = L::signMask(L::bitOr(L::bitAndNot(a, b), L::bitAndNot(L::bitXor(a, b), r)));
+        return L::bitAndNot(borrow, r);
+    }
+}
+
+// one operation of two registers, shifts take counts lane by lane
+template<IntegerOp Op, typename L>
+typename L::Register integerOp(typename L::Register a, typename L::Register b) noexcept
+{
+    if constexpr (Op == IntegerOp::Add)
+        return L::add(a, b);
+    else if constexpr (Op == IntegerOp::Sub)
+        return L::sub(a, b);
+    else if constexpr (Op == IntegerOp::Mul)
+        return L::mul(a, b);
+    else if constexpr (Op == IntegerOp::And)
+        return L::bitAnd(a, b);
+    else if constexpr (Op == IntegerOp::Or)
+        return L::bitOr(a, b);
+    else if constexpr (Op == IntegerOp::Xor)
+        return L::bitXor(a, b);
+    else if constexpr (Op == IntegerOp::ShiftLeft)
+        return L::shiftLeftVar(a, b);
+    else if constexpr (Op == IntegerOp::ShiftRight)
+        return L::shiftRightVar(a, b);
+    else if constexpr (Op == IntegerOp::AddSaturate)
+        return addSaturate<L>(a, b);
+    else
+        return subSaturate<L>(a, b);
+}
+
+// the same with one number for all lanes, shifts by it are cheaper than variable ones
+template<IntegerOp Op, typename L>
+typename L::Register integerOpSingle(typename L::Register a, typename L::Type b) noexcept
+{
+    using U = std::make_unsigned_t<typename L::Type>;
+    if constexpr (Op == IntegerOp::ShiftLeft)
+        return L::shiftLeft(a, U(b));
+    else if constexpr (Op == IntegerOp::ShiftRight)
+        return L::shiftRight(a, U(b));
+    else
+        return integerOp<Op, L>(a, L::set1(b));
+}
+
+// ================================ Intrinsic =============================== //
+template<typename Isa, typename T, IntegerOp Op>
+void integerStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = IntegerLanes<T, Isa>;
+    using S = IntegerLanes<T, Scalar>;
+    std::size_t i = 0;
+    // every register is stored once it is computed, GCC reorders stores of a pair of them
+    // by descending addresses, which halves throughput of cheap operations
+    for (; i + 2 * L::Width <= count; i += 2 * L::Width)
+    {
+        L::store(result + i, integerOp<Op, L>(L::load(a + i), L::load(b + i)));
+        L::store(result + i + L::Width, integerOp<Op, L>(L::load(a + i + L::Width), L::load(b + i + L::Width)));
+    }
+    for (; i + L::Width <= count; i += L::Width)
+        L::store(result + i, integerOp<Op, L>(L::load(a + i), L::load(b + i)));
+    for (; i < count; ++i)
+        result[i] = integerOp<Op, S>(a[i], b[i]);
+}
+
+template<typename Isa, typename T, IntegerOp Op>
+void integerStreamSingleIntrinImplementation(const T *a, T b, T *result, std::size_t count)
+{
+    using L = IntegerLanes<T, Isa>;
+    using S = IntegerLanes<T, Scalar>;
+    std::size_t i = 0;
+    for (; i + 2 * L::Width <= count; i += 2 * L::Width)
+    {
+        L::store(result + i, integerOpSingle<Op, L>(L::load(a + i), b));
+        L::store(result + i + L::Width, integerOpSingle<Op, L>(L::load(a + i + L::Width), b));
+    }
+    for (; i + L::Width <= count; i += L::Width)
+        L::store(result + i, integerOpSingle<Op, L>(L::load(a + i), b));
+    for (; i < count; ++i)
+        result[i] = integerOpSingle<Op, S>(a[i], b);
+}
+
+// int16_t, uint16_t and int32_t to float, exact for 16 bit numbers
+template<typename Isa, typename T>
+void toFloatStreamIntrinImplementation(const T *in, float *out, std::size_t count)
+{
+    using L = Lanes<float, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+        L::store(out + i, FloatConversion<T, Isa>::load(in + i));
+    for (; i < count; ++i)
+        out[i] = float(in[i]);
+}
+
+// float to int16_t, uint16_t and int32_t, rounded by Mode and saturated
+template<typename Isa, typename T, Rounding Mode>
+void fromFloatStreamIntrinImplementation(const float *in, T *out, std::size_t count)
+{
+    using L = Lanes<float, Isa>;
+    const auto lowest = L::set1(FloatLimits<T>::Lowest);
+    const auto highest = L::set1(FloatLimits<T>::Highest);
+    std::size_t i = 0;
+    // max takes the second operand for NaN
+    for (; i + L::Width <= count; i += L::Width)
+    {
+        auto v = L::min(L::max(L::load(in + i), lowest), highest);
+        if constexpr (Mode != Rounding::Nearest)
+            v = roundIntegral<Mode>(v);
+        FloatConversion<T, Isa>::store(out + i, v);
+    }
+    for (; i < count; ++i)
+        out[i] = fromFloat<T, Mode>(in[i]);
+}
+
+// ================================ Fallback ================================ //
+template<typename T, IntegerOp Op>
+void integerStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_integral_v<T>)
+{
+    integerStreamIntrinImplementation<Scalar, T, Op>(a, b, result, count);
+}
+
+template<typename T, IntegerOp Op>
+void integerStreamSingleFallbackImplementation(const T *a, T b, T *result, std::size_t count) requires(std::is_integral_v<T>)
+{
+    integerStreamSingleIntrinImplementation<Scalar, T, Op>(a, b, result, count);
+}
+
+
+template<typename T>
+void toFloatStreamFallbackImplementation(const T *in, float *out, std::size_t count) requires(std::is_integral_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = float(in[i]);
+}
+
+template<typename T, Rounding Mode>
+void fromFloatStreamFallbackImplementation(const float *in, T *out, std::size_t count) requires(std::is_integral_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = fromFloat<T, Mode>(in[i]);
+}
+
+}
@@ -0,0 +1,192 @@
+#pragma once
+/*
+ * File contains bulk element-wise operations of integer matrices and vectors
+ *
+ * Arrays of Matrix<T, R, C> of 16, 32 and 64 bit integers (Vector4D<int32_t>,
+ * compact points of geometry.hpp, ...) are processed as one stream of
+ * numbers by a dispatched kernel, so a batch costs one call instead of
+ * a call or a loop per vector. Single matrices keep their inline operators,
+ * which the compiler already turns into a few instructions. Every function
+ * takes "count" matrices, result may alias operands. add and sub wrap
+ * around or saturate by Overflow policy, mul wraps around, shift counts
+ * of bit width or more give 0 (or the sign of negative numbers shifted
+ * right). Remainders have no SIMD instructions and stay with operator%=.
+ * convert() moves 16 bit and int32_t matrices to float ones and back,
+ * floats are rounded to integers by Rounding of conversion.hpp.
+*/
+
+#include "conversion.hpp"
+#include "matrix.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <typename T>
+concept IntegerStreamType = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                            (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+// integers, which float holds exactly or, for int32_t, rounds
+template <typename T>
+concept FloatConvertibleType = IntegerStreamType<T> && (sizeof(T) == 2 || (sizeof(T) == 4 && std::is_signed_v<T>));
+
+// what add and sub do with results, which don't fit T
+enum class Overflow
+{
+    Wrap,
+    Saturate
+};
+
+namespace _IntegerMatrix
+{
+template <_Impl::IntegerOp Op, typename T, std::size_t R, std::size_t C>
+void apply(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    using Lane = _Impl::IntegerLane<T>;
+    // matrices are one stream of count * R * C numbers
+    static_assert(sizeof(Matrix<T, R, C>) == R * C * sizeof(T), "Matrix must not be padded");
+    _OptimizerInternal::integerStream<Lane, Op>(reinterpret_cast<const Lane *>(lhs), reinterpret_cast<const Lane *>(rhs),
+                                                reinterpret_cast<Lane *>(result), count * R * C);
+}
+
+template <_Impl::IntegerOp Op, typename T, std::size_t R, std::size_t C>
+void apply(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    using Lane = _Impl::IntegerLane<T>;
+    static_assert(sizeof(Matrix<T, R, C>) == R * C * sizeof(T), "Matrix must not be padded");
+    _OptimizerInternal::integerStreamSingle<Lane, Op>(reinterpret_cast<const Lane *>(lhs), Lane(rhs),
+                                                      reinterpret_cast<Lane *>(result), count * R * C);
+}
+}
+
+// result[i] = lhs[i] + rhs[i], element-wise, e.g. add<Overflow::Saturate>(a, b, result, count)
+template <Overflow Policy = Overflow::Wrap, IntegerStreamType T, std::size_t R, std::size_t C>
+void add(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<Policy == Overflow::Wrap ? _Impl::IntegerOp::Add : _Impl::IntegerOp::AddSaturate>(lhs, rhs, result, count);
+}
+
+template <Overflow Policy = Overflow::Wrap, IntegerStreamType T, std::size_t R, std::size_t C>
+void add(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<Policy == Overflow::Wrap ? _Impl::IntegerOp::Add : _Impl::IntegerOp::AddSaturate>(lhs, rhs, result, count);
+}
+
+template <Overflow Policy = Overflow::Wrap, IntegerStreamType T, std::size_t R, std::size_t C>
+void sub(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<Policy == Overflow::Wrap ? _Impl::IntegerOp::Sub : _Impl::IntegerOp::SubSaturate>(lhs, rhs, result, count);
+}
+
+template <Overflow Policy = Overflow::Wrap, IntegerStreamType T, std::size_t R, std::size_t C>
+void sub(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<Policy == Overflow::Wrap ? _Impl::IntegerOp::Sub : _Impl::IntegerOp::SubSaturate>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void mul(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Mul>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void mul(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Mul>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitAnd(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::And>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitAnd(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::And>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitOr(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Or>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitOr(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Or>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitXor(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Xor>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitXor(const Matrix<T, R, C> *lhs, T rhs, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Xor>(lhs, rhs, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void bitNot(const Matrix<T, R, C> *m, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::Xor>(m, T(~T(0)), result, count);
+}
+
+// every element is shifted by the matching element of counts
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void shiftLeft(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *counts, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::ShiftLeft>(lhs, counts, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void shiftLeft(const Matrix<T, R, C> *lhs, T n, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::ShiftLeft>(lhs, n, result, count);
+}
+
+// arithmetic for signed types, logical for unsigned ones
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void shiftRight(const Matrix<T, R, C> *lhs, const Matrix<T, R, C> *counts, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::ShiftRight>(lhs, counts, result, count);
+}
+
+template <IntegerStreamType T, std::size_t R, std::size_t C>
+void shiftRight(const Matrix<T, R, C> *lhs, T n, Matrix<T, R, C> *result, std::size_t count)
+{
+    _IntegerMatrix::apply<_Impl::IntegerOp::ShiftRight>(lhs, n, result, count);
+}
+
+// integer matrices to float ones
+template <FloatConvertibleType T, std::size_t R, std::size_t C>
+void convert(const Matrix<T, R, C> *in, Matrix<float, R, C> *out, std::size_t count)
+{
+    using Lane = _Impl::IntegerLane<T>;
+    static_assert(sizeof(Matrix<T, R, C>) == R * C * sizeof(T) && sizeof(Matrix<float, R, C>) == R * C * sizeof(float),
+                  "Matrix must not be padded");
+    _OptimizerInternal::toFloatStream<Lane>(reinterpret_cast<const Lane *>(in), reinterpret_cast<float *>(out), count * R * C);
+}
+
+// float matrices to integer ones, rounded by Mode and saturated, NaN gives the lowest number
+template <Rounding Mode = Rounding::Nearest, FloatConvertibleType T, std::size_t R, std::size_t C>
+void convert(const Matrix<float, R, C> *in, Matrix<T, R, C> *out, std::size_t count)
+{
+    using Lane = _Impl::IntegerLane<T>;
+    static_assert(sizeof(Matrix<T, R, C>) == R * C * sizeof(T) && sizeof(Matrix<float, R, C>) == R * C * sizeof(float),
+                  "Matrix must not be padded");
+    _OptimizerInternal::fromFloatStream<Lane, Mode>(reinterpret_cast<const float *>(in), reinterpret_cast<Lane *>(out), count * R * C);
+}
+
+}
+}
@@ -10,21 +10,31 @@
 #include <initializer_list>
 #include <cassert>
 #include <concepts>
+#include <type_traits>
 #include "optimizer.hpp"
+#include "decomposition_implementation.hpp"
 
 namespace Geometrix
 {
 namespace LA  // linear algebra
 {
 
+// Order of numbers in memory
+enum class Layout
+{
+    RowMajor,
+    ColumnMajor
+};
+
 /*
  * Matrix definition
  *
  * R - Rows Count
  * C - Columns Count
  * T - Type, that the matrix contains
+ * L - Layout, row-major by default
  */
-template <typename T, std::size_t R, std::size_t C>
+template <typename T, std::size_t R, std::size_t C, Layout L = Layout::RowMajor>
 struct Matrix;
 
 /*
@@ -65,26 +75,10 @@ struct Matrix<T, 1, D>
         for (std::size_t i = Size; i--; _data[i] = d[i]);
     }
 
-    constexpr Matrix(const Matrix &v) noexcept
-    {
-        for (std::size_t i = Size; i--; _data[i] = v._data[i]);
-    }
-    constexpr Matrix(Matrix &&v) noexcept
-    {
-        for (std::size_t i = Size; i--; _data[i] = v._data[i]);
-    }
-
-    Matrix &operator=(const Matrix &rhs) noexcept
-    {
-        for (std::size_t i = Size; i--; _data[i] = rhs._data[i]);
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept
-    {
-        for (std::size_t i = Size; i--; _data[i] = rhs._data[i]);
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn &operator[](std::size_t pos) noexcept
     {
@@ -260,7 +254,7 @@ protected:
 
 
 
-template <typename T, std::size_t R, std::size_t C>
+template <typename T, std::size_t R, std::size_t C, Layout L>
 struct Matrix
 {
     static constexpr auto Rows = R;
@@ -283,14 +277,8 @@ struct Matrix
         for (std::size_t i = Rows; i--;)
             for (std::size_t j = Columns; j--; _data[i][j] = defaultValue);
     }
-    constexpr Matrix(const Matrix &rhs) noexcept {
-        for (std::size_t i = Rows; i--;)
-            for (std::size_t j = Columns; j--; _data[i][j] = rhs._data[i][j]);
-    }
-    constexpr Matrix(Matrix &&rhs) noexcept {
-        for (std::size_t i = Rows; i--;)
-            for (std::size_t j = Columns; j--; _data[i][j] = rhs._data[i][j]);
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
     constexpr Matrix(Type (&data)[Rows][Columns]) {
         for(std::size_t i = Rows; i--;)
             for(std::size_t j = Columns; j--; _data[i][j] = data[i][j]);
@@ -303,17 +291,8 @@ struct Matrix
             for(std::size_t j = Columns; j--; _data[i][j] = (*it)[j]);
     }
 
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        for (std::size_t i = Rows; i--;)
-            for (std::size_t j = Columns; j--; _data[i][j] = rhs._data[i][j]);
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        for (std::size_t i = Rows; i--;)
-            for (std::size_t j = Columns; j--; _data[i][j] = rhs._data[i][j]);
-        return *this;
-    }
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn operator[](std::size_t pos) noexcept {
         assert(pos < Rows && "out of row range");
@@ -511,20 +490,10 @@ struct Matrix<T, 1, 2>
     constexpr Matrix(Type x, Type y) noexcept : _data{x, y} {}
     constexpr Matrix(T d) noexcept : _data{d, d} {}
     constexpr Matrix(const T (&d)[Size]) noexcept : _data{d[0], d[1]} {}
-    constexpr Matrix(const Matrix &v) noexcept : _data{v._data[0], v._data[1]} {}
-    constexpr Matrix(Matrix &&v) noexcept : _data{v._data[0], v._data[1]} {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     Reference &operator[](std::size_t pos) noexcept {
         assert(pos < Size);
@@ -749,24 +718,10 @@ struct Matrix<T, 1, 3>
     constexpr Matrix(Type x, Type y, Type z) noexcept : _data{x, y, z} {}
     constexpr Matrix(T d) noexcept : _data{d, d, d} {}
     constexpr Matrix(const T (&d)[Size]) noexcept : _data{d[0], d[1], d[2]} {}
-    constexpr Matrix(const Matrix &v) noexcept : _data{v._data[0], v._data[1], v._data[2]} {}
-    constexpr Matrix(Matrix &&v) noexcept : _data{v._data[0], v._data[1], v._data[2]} {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept
-    {
-        _data[0] = rhs[0];
-        _data[1] = rhs[1];
-        _data[2] = rhs[2];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept
-    {
-        _data[0] = rhs[0];
-        _data[1] = rhs[1];
-        _data[2] = rhs[2];
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     Reference &operator[](std::size_t pos) noexcept
     {
@@ -1022,28 +977,10 @@ struct Matrix<T, 1, 4>
     constexpr Matrix(const T (&d)[Size]) noexcept
         : _data{d[0], d[1], d[2], d[3]}
     {}
-    constexpr Matrix(const Matrix &v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-    constexpr Matrix(Matrix &&v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     Reference &operator[](std::size_t pos) noexcept {
         assert(pos < Size);
@@ -1309,14 +1246,8 @@ struct Matrix<T,2,2>
           _data{{defaultValue,defaultValue},
                 {defaultValue,defaultValue}}
     {}
-    constexpr Matrix(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-    }
-    constexpr Matrix(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
     constexpr Matrix(Type (&data)[Rows][Columns]) {
         _data[0][0] = data[0][0];
         _data[0][1] = data[0][1];
@@ -1327,17 +1258,8 @@ struct Matrix<T,2,2>
           _data{x,y}
     {}
 
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        return *this;
-    }
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn operator[](std::size_t pos) noexcept {
         assert(pos < Rows && "out of row range");
@@ -1556,16 +1478,8 @@ struct Matrix<T,3,3>
                 {defaultValue,defaultValue,defaultValue},
                 {defaultValue,defaultValue,defaultValue}}
     {}
-    constexpr Matrix(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-    }
-    constexpr Matrix(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
     constexpr Matrix(Type (&data)[Rows][Columns]) :
         _data{data[0],data[1],data[2]}
     {}
@@ -1573,19 +1487,8 @@ struct Matrix<T,3,3>
           _data{x,y,z}
     {}
 
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        return *this;
-    }
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn operator[](std::size_t pos) noexcept {
         assert(pos < Rows && "out of row range");
@@ -1833,18 +1736,8 @@ struct Matrix<T,4,4>
                 {defaultValue,defaultValue,defaultValue,defaultValue},
                 {defaultValue,defaultValue,defaultValue,defaultValue}}
     {}
-    constexpr Matrix(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-    }
-    constexpr Matrix(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
     constexpr Matrix(Type (&data)[Rows][Columns]) :
           _data{data[0],data[1],data[2],data[3]}
     {}
@@ -1852,21 +1745,8 @@ struct Matrix<T,4,4>
           _data{x,y,z,w}
     {}
 
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn operator[](std::size_t pos) noexcept {
         assert(pos < Rows && "out of row range");
@@ -2135,18 +2015,10 @@ struct Matrix<T, 1, 1>
 
     constexpr Matrix() noexcept {}
     constexpr Matrix(Type a) noexcept : _data{a} {}
-    constexpr Matrix(const Matrix &v) noexcept : _data{v._data} {}
-    constexpr Matrix(Matrix &&v) noexcept : _data{v._data} {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data = rhs._data;
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data = rhs._data;
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     constexpr auto size() const noexcept { return Size; }
     constexpr std::size_t rows() const noexcept { return Rows; }
@@ -2222,7 +2094,8 @@ using Vector4D = Matrix<T, 1, 4>;
 template <typename T, std::size_t Row, std::size_t Col>
 bool operator==(Matrix<T, Row, Col> lhs, Matrix<T, Row, Col> rhs)
 {
-    for (std::size_t i = Col; i--;)
+    // vectors are indexed by element, other matrices by row
+    for (std::size_t i = (Row == 1 ? Col : Row); i--;)
         if (lhs[i] != rhs[i])
             return false;
     return true;
@@ -2231,7 +2104,7 @@ bool operator==(Matrix<T, Row, Col> lhs, Matrix<T, Row, Col> rhs)
 template <typename T, std::size_t Row, std::size_t Col>
 bool operator!=(const Matrix<T, Row, Col> lhs, const Matrix<T, Row, Col> rhs)
 {
-    for (std::size_t i = Col; i--;)
+    for (std::size_t i = (Row == 1 ? Col : Row); i--;)
         if (lhs[i] != rhs[i])
             return true;
     return false;
@@ -2332,100 +2205,100 @@ Matrix<T, Rows, Cols> operator<<=(Matrix<T, Rows, Cols> lhs,
 
 // arithmetic operations with number
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator*(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator*(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs *= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator+(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator+(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs += rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator-(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator-(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs -= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator/(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator/(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs /= rhs;
 }
 
 // Bitwise operations with number
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator^(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator^(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs ^= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator&(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator&(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs &= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator|(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator|(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs |= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator>>=(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator>>=(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs >>= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator<<=(Matrix<T, Rows, Cols> lhs, const U rhs)
+Matrix<T, Rows, Cols> operator<<=(Matrix<T, Rows, Cols> lhs, const U rhs) requires std::convertible_to<U, T>
 {
     return lhs <<= rhs;
 }
 
 // Symmetric arithmetic operations with number
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator*(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator*(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs *= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator+(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator+(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs += rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator-(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator-(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs -= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator/(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator/(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs /= rhs;
 }
 
 // Symmetric bitwise operations with number
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator^(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator^(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs ^= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator&(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator&(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs &= rhs;
 }
 
 template <typename T, typename U, std::size_t Rows, std::size_t Cols>
-Matrix<T, Rows, Cols> operator|(const U rhs, Matrix<T, Rows, Cols> lhs)
+Matrix<T, Rows, Cols> operator|(const U rhs, Matrix<T, Rows, Cols> lhs) requires std::convertible_to<U, T>
 {
     return lhs |= rhs;
 }
@@ -2450,27 +2323,67 @@ Matrix<T, Cols, 1> transpose(Vector<T, Cols> vector) noexcept
     return result;
 }
 
+/*
+ * Floating-point matrices of 8 rows and columns and more go through
+ * in-register 8x8 kernel or dispatched cache-oblivious transpose
+ */
 template <typename T, std::size_t Rows, std::size_t Cols>
 Matrix<T, Cols, Rows> transpose(const Matrix<T, Rows, Cols> &matrix) noexcept
 {
     Matrix<T, Cols, Rows> result;
 
-    for (std::size_t i = Rows; i--;)
-        for (std::size_t j = Cols; j--; result[j][i] = matrix[i][j]);
+    if constexpr (std::is_floating_point_v<T> && Rows >= 8 && Cols >= 8 &&
+                  sizeof(Matrix<T, Rows, Cols>) == Rows * Cols * sizeof(T))
+    {
+        if constexpr (Rows == 8 && Cols == 8)
+            _OptimizerInternal::transposeMatrix<T, 8>(reinterpret_cast<const T (&)[8][8]>(matrix),
+                                                      reinterpret_cast<T (&)[8][8]>(result));
+        else
+            _OptimizerInternal::transposeBlock<T>(&matrix[0][0], Cols, &result[0][0], Rows, Rows, Cols);
+    }
+    else
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Cols; j--; result[j][i] = matrix[i][j]);
 
     return result;
 }
 
-// Dot product two matrix
+/*
+ * Dot product two matrix
+ * Numbers are multiplied by register tiles in i-k-j order, so rows
+ * of rhs are read contiguously, float and double take SIMD registers
+ */
 template <typename T, std::size_t Dim, std::size_t LRow, std::size_t RCol>
 Matrix<T, LRow, RCol> dot(const Matrix<T, LRow, Dim> &lhs,
                           const Matrix<T, Dim, RCol> &rhs)
 {
     Matrix<T, LRow, RCol> res;
 
-    for (std::size_t i = LRow; i--;)
-        for (std::size_t j = RCol; j--;)
-            for (std::size_t k = Dim; k--; res[i][j] += lhs[i][k] * rhs[k][j]);
+    using TLhs = T[LRow][Dim];
+    using TRhs = T[Dim][RCol];
+    using TRes = T[LRow][RCol];
+    if constexpr (std::is_arithmetic_v<T> && sizeof(lhs) == sizeof(TLhs) &&
+                  sizeof(rhs) == sizeof(TRhs) && sizeof(res) == sizeof(TRes))
+    {
+        const auto &a = reinterpret_cast<const TLhs &>(lhs);
+        const auto &b = reinterpret_cast<const TRhs &>(rhs);
+        auto &c = reinterpret_cast<TRes &>(res);
+        // no tables for every size, the CPU is checked instead
+        if constexpr (std::is_floating_point_v<T>)
+            if (Optimizer::hasCompiledIsa())
+            {
+                _Impl::dotGenericIntrinImplementation<_Impl::CompiledIsa, T, LRow, Dim, RCol>(a, b, c);
+                return res;
+            }
+        _Impl::dotGenericIntrinImplementation<_Impl::Scalar, T, LRow, Dim, RCol>(a, b, c);
+    }
+    else
+        for (std::size_t i = LRow; i--;)
+        {
+            for (std::size_t j = RCol; j--; res[i][j] = T(0));
+            for (std::size_t k = 0; k < Dim; ++k)
+                for (std::size_t j = RCol; j--; res[i][j] += lhs[i][k] * rhs[k][j]);
+        }
 
     return res;
 }
@@ -2599,6 +2512,237 @@ T submatrix(const Matrix<T, 2, 2> &m, std::size_t subRow, std::size_t subCol)
         return m[0][0];
 }
 
+/*
+ * LU decomposition with partial pivoting: P * A = L * U
+ *
+ * lu          - L below diagonal (it's unit diagonal is implicit), U on and above
+ * permutation - row of A, which went to the row of decomposition
+ * sign        - permutation sign, 0 for singular matrix
+ */
+template <typename T, std::size_t Dim>
+struct LUDecomposition
+{
+    T lu[Dim][Dim];
+    std::size_t permutation[Dim];
+    int sign;
+
+    bool singular() const noexcept { return sign == 0; }
+};
+
+/*
+ * Cholesky decomposition of symmetric positive-definite matrix: A = L * L^T
+ *
+ * lower    - L on and below diagonal, zeroes above
+ * positive - false if matrix is not positive-definite, lower is meaningless then
+ */
+template <typename T, std::size_t Dim>
+struct CholeskyDecomposition
+{
+    T lower[Dim][Dim];
+    bool positive;
+};
+
+/*
+ * Eigen decomposition of symmetric matrix: A = V * diag(values) * V^T
+ *
+ * values  - eigenvalues in descending order
+ * vectors - V, unit eigenvectors in columns, it's a rotation
+ */
+template <typename T, std::size_t Dim>
+struct SymmetricEigenDecomposition
+{
+    T values[Dim];
+    T vectors[Dim][Dim];
+};
+
+/*
+ * Singular value decomposition: A = U * diag(values) * V^T
+ *
+ * u, v   - orthogonal matrices of singular vectors in columns, v is a rotation
+ * values - non-negative singular values in descending order
+ */
+template <typename T, std::size_t Dim>
+struct SingularValueDecomposition
+{
+    T u[Dim][Dim];
+    T values[Dim];
+    T v[Dim][Dim];
+};
+
+template <typename T, std::size_t Dim>
+LUDecomposition<T, Dim> decomposeLU(const Matrix<T, Dim, Dim> &m) requires(std::is_floating_point_v<T>)
+{
+    LUDecomposition<T, Dim> result;
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--; result.lu[i][j] = m[i][j]);
+    result.sign = _Impl::luDecompositionImplementation(result.lu, result.permutation);
+    return result;
+}
+
+template <typename T, std::size_t Dim>
+CholeskyDecomposition<T, Dim> decomposeCholesky(const Matrix<T, Dim, Dim> &m) requires(std::is_floating_point_v<T>)
+{
+    CholeskyDecomposition<T, Dim> result;
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--; result.lower[i][j] = m[i][j]);
+    result.positive = _Impl::choleskyDecompositionImplementation(result.lower);
+    return result;
+}
+
+/*
+ * Fixed count of Jacobi sweeps without branches, so the time doesn't depend
+ * on the matrix. Only upper triangle of m is read.
+ * MatrixArray<T,3,3> is decomposed the same way by many matrices at once
+ */
+template <typename T>
+SymmetricEigenDecomposition<T, 3> decomposeSymmetricEigen(const Matrix<T, 3, 3> &m) requires(std::is_floating_point_v<T>)
+{
+    SymmetricEigenDecomposition<T, 3> result;
+    const T *a[9];
+    T *values[3], *vectors[9];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        values[i] = &result.values[i];
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            a[i * 3 + j] = &m[i][j];
+            vectors[i * 3 + j] = &result.vectors[i][j];
+        }
+    }
+    _Impl::symmetricEigenMatrixArrayFallbackImplementation(a, values, vectors, 1);
+    return result;
+}
+
+// Jacobi sweeps over A^T * A, then QR of A * V, without branches
+template <typename T>
+SingularValueDecomposition<T, 3> decomposeSVD(const Matrix<T, 3, 3> &m) requires(std::is_floating_point_v<T>)
+{
+    SingularValueDecomposition<T, 3> result;
+    const T *a[9];
+    T *u[9], *values[3], *v[9];
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        values[i] = &result.values[i];
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            a[i * 3 + j] = &m[i][j];
+            u[i * 3 + j] = &result.u[i][j];
+            v[i * 3 + j] = &result.v[i][j];
+        }
+    }
+    _Impl::svdMatrixArrayFallbackImplementation(a, u, values, v, 1);
+    return result;
+}
+
+template <typename T, std::size_t Dim>
+T determinant(const LUDecomposition<T, Dim> &d) noexcept
+{
+    T result = d.sign;
+    for (std::size_t i = Dim; i--; result *= d.lu[i][i]);
+    return result;
+}
+
+template <typename T, std::size_t Dim>
+T determinant(const CholeskyDecomposition<T, Dim> &d) noexcept
+{
+    T result = 1;
+    for (std::size_t i = Dim; i--; result *= d.lower[i][i]);
+    return result * result;
+}
+
+/*
+ * Solve A * x = b, given decomposition of A
+ * b, x - row vectors, which are treated as columns
+ */
+template <typename T, std::size_t Dim>
+Vector<T, Dim> solve(const LUDecomposition<T, Dim> &d, const Vector<T, Dim> &b) noexcept
+{
+    T rhs[Dim][1], x[Dim][1];
+    for (std::size_t i = Dim; i--; rhs[i][0] = b[i]);
+    _Impl::luSolveImplementation(d.lu, d.permutation, rhs, x);
+
+    Vector<T, Dim> result;
+    for (std::size_t i = Dim; i--; result[i] = x[i][0]);
+    return result;
+}
+
+template <typename T, std::size_t Dim>
+Vector<T, Dim> solve(const CholeskyDecomposition<T, Dim> &d, const Vector<T, Dim> &b) noexcept
+{
+    T rhs[Dim][1], x[Dim][1];
+    for (std::size_t i = Dim; i--; rhs[i][0] = b[i]);
+    _Impl::choleskySolveImplementation(d.lower, rhs, x);
+
+    Vector<T, Dim> result;
+    for (std::size_t i = Dim; i--; result[i] = x[i][0]);
+    return result;
+}
+
+/*
+ * Solve A * x = b by LU decomposition of A
+ * correctness is false for singular matrix
+ */
+template <typename T, std::size_t Dim>
+Vector<T, Dim> solve(const Matrix<T, Dim, Dim> &a, const Vector<T, Dim> &b,
+                     bool *correctness = nullptr) requires(std::is_floating_point_v<T>)
+{
+    const auto d = decomposeLU(a);
+    if (correctness)
+        *correctness = !d.singular();
+    if (d.singular())
+        return Vector<T, Dim>(T{0});
+    return solve(d, b);
+}
+
+/*
+ * Least squares solution of overdetermined A * x = b (R >= C): x minimizes
+ * |A * x - b|, by modified Gram-Schmidt QR of [A | b], which doesn't square
+ * condition number as normal equations do. correctness is false, if columns
+ * of A are linearly dependent up to rounding, x is zero then.
+ * MatrixArray<T,R,C> is solved the same way by many systems at once
+ */
+template <typename T, std::size_t R, std::size_t C>
+Vector<T, C> solveLeastSquares(const Matrix<T, R, C> &a, const Vector<T, R> &b,
+                               bool *correctness = nullptr) requires(std::is_floating_point_v<T> && R >= C && C > 1)
+{
+    const T *elements[R * C], *rhs[R];
+    Vector<T, C> result;
+    T *x[C];
+    for (std::size_t r = 0; r < R; ++r)
+    {
+        rhs[r] = &b[r];
+        for (std::size_t c = 0; c < C; ++c)
+            elements[r * C + c] = &a[r][c];
+    }
+    for (std::size_t c = 0; c < C; ++c)
+        x[c] = &result[c];
+    const bool singular = _Impl::leastSquaresMatrixArrayFallbackImplementation<T, R, C>(elements, rhs, x, nullptr, 1) != 0;
+    if (correctness)
+        *correctness = !singular;
+    return result;
+}
+
+// Inverse of decomposed matrix, by solving for identity columns
+template <typename T, std::size_t Dim>
+Matrix<T, Dim, Dim> invert(const LUDecomposition<T, Dim> &d) noexcept
+{
+    T identity[Dim][Dim], x[Dim][Dim];
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--; identity[i][j] = T(i == j));
+    _Impl::luSolveImplementation(d.lu, d.permutation, identity, x);
+    return Matrix<T, Dim, Dim>(x);
+}
+
+template <typename T, std::size_t Dim>
+Matrix<T, Dim, Dim> invert(const CholeskyDecomposition<T, Dim> &d) noexcept
+{
+    T identity[Dim][Dim], x[Dim][Dim];
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--; identity[i][j] = T(i == j));
+    _Impl::choleskySolveImplementation(d.lower, identity, x);
+    return Matrix<T, Dim, Dim>(x);
+}
+
 /*
  * Determinant
  */
@@ -2644,15 +2788,21 @@ T determinant(const Matrix<T, 3, 3> &m)
 template <typename T, std::size_t Dim>
 T determinant(const Matrix<T, Dim, Dim> &m)
 {
-    signed char o = 1;
-    T result = {0};
+    // cofactor expansion is O(n!), floating-point matrices are decomposed instead
+    if constexpr (std::is_floating_point_v<T> && (Dim > 4))
+        return determinant(decomposeLU(m));
+    else
+    {
+        signed char o = 1;
+        T result = {0};
 
-    for (std::size_t i = 0; i < Dim; ++i) {
-        result += o * m[0][i] * determinant(submatrix(m, 0, i));
-        o *= -1;
-    }
+        for (std::size_t i = 0; i < Dim; ++i) {
+            result += o * m[0][i] * determinant(submatrix(m, 0, i));
+            o *= -1;
+        }
 
-    return result;
+        return result;
+    }
 }
 
 /*
@@ -2678,37 +2828,106 @@ template <typename T, std::size_t Dim>
 Matrix<T, Dim, Dim> invert(const Matrix<T, Dim, Dim> &d,
                            bool *correctness = nullptr)
 {
-    constexpr auto sing = [](std::size_t i, std::size_t j) -> T
+    if constexpr (std::is_floating_point_v<T> && (Dim > 4))
     {
-        auto s = i + j;
-        if (s % 2 == 0)
-            return 1;
-        else
-            return -1;
-    };
+        const auto lu = decomposeLU(d);
+        if (correctness)
+            *correctness = !lu.singular();
+        return lu.singular() ? Matrix<T, Dim, Dim>(T(0)) : invert(lu);
+    }
+    else
+    {
+        constexpr auto sing = [](std::size_t i, std::size_t j) -> T
+        {
+            auto s = i + j;
+            if (s % 2 == 0)
+                return 1;
+            else
+                return -1;
+        };
 
-    Matrix<T, Dim, Dim> result;
+        Matrix<T, Dim, Dim> result;
 
-    const auto det = determinant(d);
-    if (correctness)
-    {
-        if (det == 0)
+        const auto det = determinant(d);
+        if (correctness)
         {
-            *correctness = false;
-            return result; // NO
+            if (det == 0)
+            {
+                *correctness = false;
+                return result; // NO
+            }
+            else
+                *correctness = true;
         }
-        else
-            *correctness = true;
+
+        result = minor(d);
+
+        for (std::size_t i = 0; i < result.rows(); ++i)
+            for (std::size_t j = 0; j < result.columns(); j++)
+                result[i][j] *= sing(i, j);
+
+        result = transpose(result);
+        result /= det;
+        return result;
     }
+}
+
+/*
+ * Invert affine transform, last row of which is (0 ... 0 1):
+ *
+ *  | A t |^-1   | A^-1  -A^-1*t |
+ *  | 0 1 |    = |  0       1    |
+ */
+template <typename T, std::size_t Dim>
+Matrix<T, Dim, Dim> invertAffine(const Matrix<T, Dim, Dim> &d,
+                                 bool *correctness = nullptr)
+{
+    static_assert(Dim > 2, "Affine transform is at least 3x3 matrix");
 
-    result = minor(d);
+    Matrix<T, Dim - 1, Dim - 1> linear;
+    for (std::size_t i = Dim - 1; i--;)
+        for (std::size_t j = Dim - 1; j--; linear[i][j] = d[i][j]);
+    linear = invert(linear, correctness);
 
-    for (std::size_t i = 0; i < result.rows(); ++i)
-        for (std::size_t j = 0; j < result.columns(); j++)
-            result[i][j] *= sing(i, j);
+    Matrix<T, Dim, Dim> result(T{0});
+    for (std::size_t i = Dim - 1; i--;)
+    {
+        T translation = 0;
+        for (std::size_t j = Dim - 1; j--;)
+        {
+            result[i][j] = linear[i][j];
+            translation -= linear[i][j] * d[j][Dim - 1];
+        }
+        result[i][Dim - 1] = translation;
+    }
+    result[Dim - 1][Dim - 1] = 1;
+    return result;
+}
+
+/*
+ * Invert rigid transform (rotation and translation only),
+ * rotation is orthonormal, so it's inverse is transposition:
+ *
+ *  | R t |^-1   | R^T  -R^T*t |
+ *  | 0 1 |    = |  0      1   |
+ */
+template <typename T, std::size_t Dim>
+Matrix<T, Dim, Dim> invertRigid(const Matrix<T, Dim, Dim> &d) noexcept
+{
+    static_assert(Dim > 2, "Rigid transform is at least 3x3 matrix");
 
-    result = transpose(result);
-    result /= det;
+    Matrix<T, Dim, Dim> result(T{0});
+    for (std::size_t i = Dim - 1; i--;)
+    {
+        T translation = 0;
+        for (std::size_t j = Dim - 1; j--;)
+        {
+            result[i][j] = d[j][i];
+            translation -= d[j][i] * d[j][Dim - 1];
+        }
+        result[i][Dim - 1] = translation;
+    }
+    result[Dim - 1][Dim - 1] = 1;
     return result;
 }
 
@@ -2804,28 +3023,10 @@ struct alignas(16) Matrix<float, 1, 4>
     constexpr Matrix(const float (&d)[Size]) noexcept
         : _data{d[0], d[1], d[2], d[3]}
     {}
-    constexpr Matrix(const Matrix &v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-    constexpr Matrix(Matrix &&v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     Reference &operator[](std::size_t pos) noexcept {
         assert(pos < Size);
@@ -2962,35 +3163,17 @@ struct alignas(32) Matrix<double, 1, 4>
     constexpr Matrix(Type x, Type y, Type z, Type w) noexcept
         : _data{x, y, z, w}
     {}
-    constexpr Matrix(const float (&d)[Size]) noexcept
+    constexpr Matrix(const double (&d)[Size]) noexcept
         : _data{d[0], d[1], d[2], d[3]}
     {}
-    constexpr Matrix(const Matrix &v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-    constexpr Matrix(Matrix &&v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Reference &operator[](std::size_t pos) noexcept {
-        assert(pos < Size);
-        return _data[pos];
+    Reference &operator[](std::size_t pos) noexcept {
+        assert(pos < Size);
+        return _data[pos];
     }
     ConstReference &operator[](std::size_t pos) const noexcept {
         assert(pos < Size);
@@ -3114,6 +3297,7 @@ struct alignas(64) Matrix<float, 4, 4>
     using CRData = const TColumn (&)[Rows];
     using TArray = float[4][4];
     using RArray = TArray &;
+    using CRArray = const TArray &;
 
     constexpr Matrix() noexcept {}
     constexpr Matrix(float defaultValue) noexcept :
@@ -3128,28 +3312,10 @@ struct alignas(64) Matrix<float, 4, 4>
     constexpr Matrix(Type (&data)[Rows][Columns]) :
           _data{data[0],data[1],data[2],data[3]}
     {}
-    constexpr Matrix(const Matrix &v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-    constexpr Matrix(Matrix &&v) noexcept :
-          _data{v._data[0], v._data[1], v._data[2], v._data[3]}
-    {}
-
-    Matrix &operator=(const Matrix &rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
-
-    Matrix &operator=(Matrix &&rhs) noexcept {
-        _data[0] = rhs._data[0];
-        _data[1] = rhs._data[1];
-        _data[2] = rhs._data[2];
-        _data[3] = rhs._data[3];
-        return *this;
-    }
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
 
     RColumn &operator[](std::size_t pos) noexcept {
         assert(pos < Size);
@@ -3166,6 +3332,7 @@ struct alignas(64) Matrix<float, 4, 4>
     operator RData() { return _data; }
     operator CRData() const { return _data; }
     operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
 
     inline RColumn x() noexcept { return _data[0]; }
     inline RColumn y() noexcept { return _data[1]; }
@@ -3187,42 +3354,42 @@ struct alignas(64) Matrix<float, 4, 4>
     }
     Matrix &operator-=(Matrix m)
     {
-        _OptimizerInternal::subTwoMatrix4(*this, m, *this);
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator+=(Matrix m)
     {
-        _OptimizerInternal::addTwoMatrix4(*this, m, *this);
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator*=(Matrix m)
     {
-        _OptimizerInternal::mulTwoMatrix4(*this, m, *this);
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator/=(Matrix m)
     {
-        _OptimizerInternal::divTwoMatrix4(*this, m, *this);
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator-=(float m)
     {
-        _OptimizerInternal::subMatrixSingle4(*this, m, *this);
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator+=(float m)
     {
-        _OptimizerInternal::addMatrixSingle4(*this, m, *this);
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator*=(float m)
     {
-        _OptimizerInternal::mulMatrixSingle4(*this, m, *this);
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
     Matrix &operator/=(float m)
     {
-        _OptimizerInternal::divMatrixSingle4(*this, m, *this);
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
         return *this;
     }
 
@@ -3241,19 +3408,1222 @@ protected:
     TData _data;
 };
 
-// TODO Intrin
 // Dot product two matrix
 template <>
 Matrix<float, 4, 4> dot(const Matrix<float, 4, 4> &lhs, const Matrix<float, 4, 4> &rhs)
 {
     Matrix<float, 4, 4> res;
+    _OptimizerInternal::dotTwoMatrix<float, 4>(lhs, rhs, res);
+    return res;
+}
+
+template <>
+inline Matrix<float, 4, 4> transpose(const Matrix<float, 4, 4> &matrix) noexcept
+{
+    Matrix<float, 4, 4> res;
+    _OptimizerInternal::transposeMatrix<float,4>(matrix, res);
+    return res;
+}
+
+// Closed-form inverse, correctness is false for singular matrix
+template <>
+inline Matrix<float, 4, 4> invert(const Matrix<float, 4, 4> &d, bool *correctness)
+{
+    Matrix<float, 4, 4> res;
+    const auto det = _OptimizerInternal::inverseMatrix<float,4>(d, res);
+    if (correctness)
+        *correctness = det != 0;
+    return res;
+}
+
+/*
+ * 4x4 matrix double specialization
+ */
+template <>
+struct alignas(64) Matrix<double, 4, 4>
+{
+    static constexpr auto Rows = 4;
+    static constexpr auto Columns = 4;
+    static constexpr auto Size = Rows * Columns;
+    using Type = double;
+    using Pointer = Type *;
+    using Reference = Type &;
+    using ConstReference = const Type &;
+    using TColumn  = Matrix<Type,1,Columns>;
+    using RColumn  = TColumn &;
+    using CRColumn = const TColumn &;
+    using TData = TColumn[Rows];
+    using RData = TColumn (&)[Rows];
+    using CRData = const TColumn (&)[Rows];
+    using TArray = Type[Rows][Columns];
+    using RArray = TArray &;
+    using CRArray = const TArray &;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(Type defaultValue) noexcept :
+          _data{{defaultValue,defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue,defaultValue}}
+    {}
+    constexpr Matrix(TColumn x, TColumn y, TColumn z, TColumn w) noexcept
+        : _data{x, y, z, w}
+    {}
+    constexpr Matrix(Type (&data)[Rows][Columns]) :
+          _data{data[0],data[1],data[2],data[3]}
+    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
+
+    RColumn operator[](std::size_t pos) noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    CRColumn operator[](std::size_t pos) const noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    constexpr auto size() const noexcept { return Size; }
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+
+    operator RData() { return _data; }
+    operator CRData() const { return _data; }
+    operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
+
+    inline RColumn x() noexcept { return _data[0]; }
+    inline RColumn y() noexcept { return _data[1]; }
+    inline RColumn z() noexcept { return _data[2]; }
+    inline RColumn w() noexcept { return _data[3]; }
+    inline CRColumn x() const noexcept { return _data[0]; }
+    inline CRColumn y() const noexcept { return _data[1]; }
+    inline CRColumn z() const noexcept { return _data[2]; }
+    inline CRColumn w() const noexcept { return _data[3]; }
+
+    // Math operations
+    Matrix operator-() const {
+        Matrix newOne;
+        newOne._data[0] = -_data[0];
+        newOne._data[1] = -_data[1];
+        newOne._data[2] = -_data[2];
+        newOne._data[3] = -_data[3];
+        return newOne;
+    }
+    Matrix &operator-=(Matrix m)
+    {
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Matrix m)
+    {
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Matrix m)
+    {
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Matrix m)
+    {
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator-=(Type m)
+    {
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Type m)
+    {
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Type m)
+    {
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Type m)
+    {
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+
+    template<typename U>
+    operator Matrix<U,Rows,Columns>() const noexcept requires std::is_convertible_v<Type,U>
+    {
+        Matrix<U,Rows,Columns> m;
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Columns; j--; m[i][j] = static_cast<U>(_data[i][j]));
+        return m;
+    }
+
+protected:
+    TData _data;
+};
+
+// Dot product two matrix
+template <>
+inline Matrix<double, 4, 4> dot(const Matrix<double, 4, 4> &lhs, const Matrix<double, 4, 4> &rhs)
+{
+    Matrix<double, 4, 4> res;
+    _OptimizerInternal::dotTwoMatrix<double,4>(lhs, rhs, res);
+    return res;
+}
+
+template <>
+inline Matrix<double, 4, 4> transpose(const Matrix<double, 4, 4> &matrix) noexcept
+{
+    Matrix<double, 4, 4> res;
+    _OptimizerInternal::transposeMatrix<double,4>(matrix, res);
+    return res;
+}
+
+// Closed-form inverse, correctness is false for singular matrix
+template <>
+inline Matrix<double, 4, 4> invert(const Matrix<double, 4, 4> &d, bool *correctness)
+{
+    Matrix<double, 4, 4> res;
+    const auto det = _OptimizerInternal::inverseMatrix<double,4>(d, res);
+    if (correctness)
+        *correctness = det != 0;
+    return res;
+}
+
+/*
+ * 3x3 matrix float specialization
+ */
+template <>
+struct alignas(16) Matrix<float, 3, 3>
+{
+    static constexpr auto Rows = 3;
+    static constexpr auto Columns = 3;
+    static constexpr auto Size = Rows * Columns;
+    using Type = float;
+    using Pointer = Type *;
+    using Reference = Type &;
+    using ConstReference = const Type &;
+    using TColumn  = Matrix<Type,1,Columns>;
+    using RColumn  = TColumn &;
+    using CRColumn = const TColumn &;
+    using TData = TColumn[Rows];
+    using RData = TColumn (&)[Rows];
+    using CRData = const TColumn (&)[Rows];
+    using TArray = Type[Rows][Columns];
+    using RArray = TArray &;
+    using CRArray = const TArray &;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(Type defaultValue) noexcept :
+          _data{{defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue}}
+    {}
+    constexpr Matrix(TColumn x, TColumn y, TColumn z) noexcept
+        : _data{x, y, z}
+    {}
+    constexpr Matrix(Type (&data)[Rows][Columns]) :
+          _data{data[0],data[1],data[2]}
+    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
+
+    RColumn operator[](std::size_t pos) noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    CRColumn operator[](std::size_t pos) const noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    constexpr auto size() const noexcept { return Size; }
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+
+    operator RData() { return _data; }
+    operator CRData() const { return _data; }
+    operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
+
+    inline RColumn x() noexcept { return _data[0]; }
+    inline RColumn y() noexcept { return _data[1]; }
+    inline RColumn z() noexcept { return _data[2]; }
+    inline CRColumn x() const noexcept { return _data[0]; }
+    inline CRColumn y() const noexcept { return _data[1]; }
+    inline CRColumn z() const noexcept { return _data[2]; }
+
+    // Math operations
+    Matrix operator-() const {
+        Matrix newOne;
+        newOne._data[0] = -_data[0];
+        newOne._data[1] = -_data[1];
+        newOne._data[2] = -_data[2];
+        return newOne;
+    }
+    Matrix &operator-=(Matrix m)
+    {
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Matrix m)
+    {
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Matrix m)
+    {
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Matrix m)
+    {
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator-=(Type m)
+    {
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Type m)
+    {
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Type m)
+    {
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Type m)
+    {
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+
+    template<typename U>
+    operator Matrix<U,Rows,Columns>() const noexcept requires std::is_convertible_v<Type,U>
+    {
+        Matrix<U,Rows,Columns> m;
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Columns; j--; m[i][j] = static_cast<U>(_data[i][j]));
+        return m;
+    }
 
-    for (std::size_t i = 4; i--;)
-        for (std::size_t j = 4; j--;)
-            for (std::size_t k = 4; k--; res[i][j] += lhs[i][k] * rhs[k][j]);
+protected:
+    TData _data;
+};
 
+// Dot product two matrix
+template <>
+inline Matrix<float, 3, 3> dot(const Matrix<float, 3, 3> &lhs, const Matrix<float, 3, 3> &rhs)
+{
+    Matrix<float, 3, 3> res;
+    _OptimizerInternal::dotTwoMatrix<float,3>(lhs, rhs, res);
     return res;
 }
 
+template <>
+inline Matrix<float, 3, 3> transpose(const Matrix<float, 3, 3> &matrix) noexcept
+{
+    Matrix<float, 3, 3> res;
+    _OptimizerInternal::transposeMatrix<float,3>(matrix, res);
+    return res;
+}
+
+// Closed-form inverse, correctness is false for singular matrix
+template <>
+inline Matrix<float, 3, 3> invert(const Matrix<float, 3, 3> &d, bool *correctness)
+{
+    Matrix<float, 3, 3> res;
+    const auto det = _OptimizerInternal::inverseMatrix<float,3>(d, res);
+    if (correctness)
+        *correctness = det != 0;
+    return res;
+}
+
+/*
+ * 3x3 matrix double specialization
+ */
+template <>
+struct alignas(16) Matrix<double, 3, 3>
+{
+    static constexpr auto Rows = 3;
+    static constexpr auto Columns = 3;
+    static constexpr auto Size = Rows * Columns;
+    using Type = double;
+    using Pointer = Type *;
+    using Reference = Type &;
+    using ConstReference = const Type &;
+    using TColumn  = Matrix<Type,1,Columns>;
+    using RColumn  = TColumn &;
+    using CRColumn = const TColumn &;
+    using TData = TColumn[Rows];
+    using RData = TColumn (&)[Rows];
+    using CRData = const TColumn (&)[Rows];
+    using TArray = Type[Rows][Columns];
+    using RArray = TArray &;
+    using CRArray = const TArray &;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(Type defaultValue) noexcept :
+          _data{{defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue},
+                {defaultValue,defaultValue,defaultValue}}
+    {}
+    constexpr Matrix(TColumn x, TColumn y, TColumn z) noexcept
+        : _data{x, y, z}
+    {}
+    constexpr Matrix(Type (&data)[Rows][Columns]) :
+          _data{data[0],data[1],data[2]}
+    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
+
+    RColumn operator[](std::size_t pos) noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    CRColumn operator[](std::size_t pos) const noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    constexpr auto size() const noexcept { return Size; }
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+
+    operator RData() { return _data; }
+    operator CRData() const { return _data; }
+    operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
+
+    inline RColumn x() noexcept { return _data[0]; }
+    inline RColumn y() noexcept { return _data[1]; }
+    inline RColumn z() noexcept { return _data[2]; }
+    inline CRColumn x() const noexcept { return _data[0]; }
+    inline CRColumn y() const noexcept { return _data[1]; }
+    inline CRColumn z() const noexcept { return _data[2]; }
+
+    // Math operations
+    Matrix operator-() const {
+        Matrix newOne;
+        newOne._data[0] = -_data[0];
+        newOne._data[1] = -_data[1];
+        newOne._data[2] = -_data[2];
+        return newOne;
+    }
+    Matrix &operator-=(Matrix m)
+    {
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Matrix m)
+    {
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Matrix m)
+    {
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Matrix m)
+    {
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator-=(Type m)
+    {
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Type m)
+    {
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Type m)
+    {
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Type m)
+    {
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+
+    template<typename U>
+    operator Matrix<U,Rows,Columns>() const noexcept requires std::is_convertible_v<Type,U>
+    {
+        Matrix<U,Rows,Columns> m;
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Columns; j--; m[i][j] = static_cast<U>(_data[i][j]));
+        return m;
+    }
+
+protected:
+    TData _data;
+};
+
+// Dot product two matrix
+template <>
+inline Matrix<double, 3, 3> dot(const Matrix<double, 3, 3> &lhs, const Matrix<double, 3, 3> &rhs)
+{
+    Matrix<double, 3, 3> res;
+    _OptimizerInternal::dotTwoMatrix<double,3>(lhs, rhs, res);
+    return res;
+}
+
+template <>
+inline Matrix<double, 3, 3> transpose(const Matrix<double, 3, 3> &matrix) noexcept
+{
+    Matrix<double, 3, 3> res;
+    _OptimizerInternal::transposeMatrix<double,3>(matrix, res);
+    return res;
+}
+
+// Closed-form inverse, correctness is false for singular matrix
+template <>
+inline Matrix<double, 3, 3> invert(const Matrix<double, 3, 3> &d, bool *correctness)
+{
+    Matrix<double, 3, 3> res;
+    const auto det = _OptimizerInternal::inverseMatrix<double,3>(d, res);
+    if (correctness)
+        *correctness = det != 0;
+    return res;
+}
+
+/*
+ * 2x2 matrix float specialization
+ */
+template <>
+struct alignas(16) Matrix<float, 2, 2>
+{
+    static constexpr auto Rows = 2;
+    static constexpr auto Columns = 2;
+    static constexpr auto Size = Rows * Columns;
+    using Type = float;
+    using Pointer = Type *;
+    using Reference = Type &;
+    using ConstReference = const Type &;
+    using TColumn  = Matrix<Type,1,Columns>;
+    using RColumn  = TColumn &;
+    using CRColumn = const TColumn &;
+    using TData = TColumn[Rows];
+    using RData = TColumn (&)[Rows];
+    using CRData = const TColumn (&)[Rows];
+    using TArray = Type[Rows][Columns];
+    using RArray = TArray &;
+    using CRArray = const TArray &;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(Type defaultValue) noexcept :
+          _data{{defaultValue,defaultValue},
+                {defaultValue,defaultValue}}
+    {}
+    constexpr Matrix(TColumn x, TColumn y) noexcept
+        : _data{x, y}
+    {}
+    constexpr Matrix(Type (&data)[Rows][Columns]) :
+          _data{data[0],data[1]}
+    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
+
+    RColumn operator[](std::size_t pos) noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    CRColumn operator[](std::size_t pos) const noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    constexpr auto size() const noexcept { return Size; }
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+
+    operator RData() { return _data; }
+    operator CRData() const { return _data; }
+    operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
+
+    inline RColumn x() noexcept { return _data[0]; }
+    inline RColumn y() noexcept { return _data[1]; }
+    inline CRColumn x() const noexcept { return _data[0]; }
+    inline CRColumn y() const noexcept { return _data[1]; }
+
+    // Math operations
+    Matrix operator-() const {
+        Matrix newOne;
+        newOne._data[0] = -_data[0];
+        newOne._data[1] = -_data[1];
+        return newOne;
+    }
+    Matrix &operator-=(Matrix m)
+    {
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Matrix m)
+    {
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Matrix m)
+    {
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Matrix m)
+    {
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator-=(Type m)
+    {
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Type m)
+    {
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Type m)
+    {
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Type m)
+    {
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+
+    template<typename U>
+    operator Matrix<U,Rows,Columns>() const noexcept requires std::is_convertible_v<Type,U>
+    {
+        Matrix<U,Rows,Columns> m;
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Columns; j--; m[i][j] = static_cast<U>(_data[i][j]));
+        return m;
+    }
+
+protected:
+    TData _data;
+};
+
+// Dot product two matrix
+template <>
+inline Matrix<float, 2, 2> dot(const Matrix<float, 2, 2> &lhs, const Matrix<float, 2, 2> &rhs)
+{
+    Matrix<float, 2, 2> res;
+    _OptimizerInternal::dotTwoMatrix<float,2>(lhs, rhs, res);
+    return res;
+}
+
+template <>
+inline Matrix<float, 2, 2> transpose(const Matrix<float, 2, 2> &matrix) noexcept
+{
+    Matrix<float, 2, 2> res;
+    _OptimizerInternal::transposeMatrix<float,2>(matrix, res);
+    return res;
+}
+
+/*
+ * 2x2 matrix double specialization
+ */
+template <>
+struct alignas(32) Matrix<double, 2, 2>
+{
+    static constexpr auto Rows = 2;
+    static constexpr auto Columns = 2;
+    static constexpr auto Size = Rows * Columns;
+    using Type = double;
+    using Pointer = Type *;
+    using Reference = Type &;
+    using ConstReference = const Type &;
+    using TColumn  = Matrix<Type,1,Columns>;
+    using RColumn  = TColumn &;
+    using CRColumn = const TColumn &;
+    using TData = TColumn[Rows];
+    using RData = TColumn (&)[Rows];
+    using CRData = const TColumn (&)[Rows];
+    using TArray = Type[Rows][Columns];
+    using RArray = TArray &;
+    using CRArray = const TArray &;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(Type defaultValue) noexcept :
+          _data{{defaultValue,defaultValue},
+                {defaultValue,defaultValue}}
+    {}
+    constexpr Matrix(TColumn x, TColumn y) noexcept
+        : _data{x, y}
+    {}
+    constexpr Matrix(Type (&data)[Rows][Columns]) :
+          _data{data[0],data[1]}
+    {}
+    constexpr Matrix(const Matrix &) noexcept = default;
+    constexpr Matrix(Matrix &&) noexcept = default;
+    Matrix &operator=(const Matrix &) noexcept = default;
+    Matrix &operator=(Matrix &&) noexcept = default;
+
+    RColumn operator[](std::size_t pos) noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    CRColumn operator[](std::size_t pos) const noexcept {
+        assert(pos < Rows && "out of row range");
+        return _data[pos];
+    }
+    constexpr auto size() const noexcept { return Size; }
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+
+    operator RData() { return _data; }
+    operator CRData() const { return _data; }
+    operator RArray() { return reinterpret_cast<RArray>(_data); }
+    operator CRArray() const { return reinterpret_cast<CRArray>(_data); }
+
+    inline RColumn x() noexcept { return _data[0]; }
+    inline RColumn y() noexcept { return _data[1]; }
+    inline CRColumn x() const noexcept { return _data[0]; }
+    inline CRColumn y() const noexcept { return _data[1]; }
+
+    // Math operations
+    Matrix operator-() const {
+        Matrix newOne;
+        newOne._data[0] = -_data[0];
+        newOne._data[1] = -_data[1];
+        return newOne;
+    }
+    Matrix &operator-=(Matrix m)
+    {
+        _OptimizerInternal::subTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Matrix m)
+    {
+        _OptimizerInternal::addTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Matrix m)
+    {
+        _OptimizerInternal::mulTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Matrix m)
+    {
+        _OptimizerInternal::divTwoMatrix<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator-=(Type m)
+    {
+        _OptimizerInternal::subMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator+=(Type m)
+    {
+        _OptimizerInternal::addMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator*=(Type m)
+    {
+        _OptimizerInternal::mulMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+    Matrix &operator/=(Type m)
+    {
+        _OptimizerInternal::divMatrixSingle<Type,Rows,Columns>(*this, m, *this);
+        return *this;
+    }
+
+    template<typename U>
+    operator Matrix<U,Rows,Columns>() const noexcept requires std::is_convertible_v<Type,U>
+    {
+        Matrix<U,Rows,Columns> m;
+        for (std::size_t i = Rows; i--;)
+            for (std::size_t j = Columns; j--; m[i][j] = static_cast<U>(_data[i][j]));
+        return m;
+    }
+
+protected:
+    TData _data;
+};
+
+// Dot product two matrix
+template <>
+inline Matrix<double, 2, 2> dot(const Matrix<double, 2, 2> &lhs, const Matrix<double, 2, 2> &rhs)
+{
+    Matrix<double, 2, 2> res;
+    _OptimizerInternal::dotTwoMatrix<double,2>(lhs, rhs, res);
+    return res;
+}
+
+template <>
+inline Matrix<double, 2, 2> transpose(const Matrix<double, 2, 2> &matrix) noexcept
+{
+    Matrix<double, 2, 2> res;
+    _OptimizerInternal::transposeMatrix<double,2>(matrix, res);
+    return res;
+}
+
+/*
+ * All matrices are plain memory: they are copied by memcpy, passed in
+ * registers when they fit, and containers of them use bulk moves
+ */
+template <typename M>
+constexpr bool IsPlainMatrix = std::is_trivially_copyable_v<M> && std::is_standard_layout_v<M>;
+
+static_assert(IsPlainMatrix<Matrix<float, 1, 1>>);
+static_assert(IsPlainMatrix<Vector2D<float>>);
+static_assert(IsPlainMatrix<Vector3D<float>>);
+static_assert(IsPlainMatrix<Vector<float, 5>>);
+static_assert(IsPlainMatrix<Vector4D<float>>);
+static_assert(IsPlainMatrix<Vector4D<double>>);
+static_assert(IsPlainMatrix<Vector4D<int>>);
+static_assert(IsPlainMatrix<Matrix<float, 2, 2>>);
+static_assert(IsPlainMatrix<Matrix<double, 2, 2>>);
+static_assert(IsPlainMatrix<Matrix<int, 2, 2>>);
+static_assert(IsPlainMatrix<Matrix<float, 3, 3>>);
+static_assert(IsPlainMatrix<Matrix<double, 3, 3>>);
+static_assert(IsPlainMatrix<Matrix<int, 3, 3>>);
+static_assert(IsPlainMatrix<Matrix<float, 4, 4>>);
+static_assert(IsPlainMatrix<Matrix<double, 4, 4>>);
+static_assert(IsPlainMatrix<Matrix<int, 4, 4>>);
+static_assert(IsPlainMatrix<Matrix<float, 3, 5>>);
+
+/*
+ * Batched product of square matrices: result[i] = dot(lhs[i], rhs[i])
+ * for i in [0, count). Result must not alias arguments.
+ * Floating-point matrices without padding go through one dispatched call.
+ */
+template <typename T, std::size_t Dim>
+void dot(const Matrix<T, Dim, Dim> *lhs, const Matrix<T, Dim, Dim> *rhs,
+         Matrix<T, Dim, Dim> *result, std::size_t count)
+{
+    using TArray = T[Dim][Dim];
+    if constexpr (std::is_floating_point_v<T> && sizeof(Matrix<T, Dim, Dim>) == sizeof(TArray))
+        _OptimizerInternal::dotMatrixBatch<T, Dim>(reinterpret_cast<const TArray *>(lhs),
+                                                   reinterpret_cast<const TArray *>(rhs),
+                                                   reinterpret_cast<TArray *>(result), count);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = dot(lhs[i], rhs[i]);
+}
+
+/*
+ * Batched transpose of square matrices: result[i] = transpose(m[i])
+ * for i in [0, count). Result must not alias the argument.
+ * Floating-point matrices up to 8x8 without padding go through one dispatched call.
+ */
+template <typename T, std::size_t Dim>
+void transpose(const Matrix<T, Dim, Dim> *m, Matrix<T, Dim, Dim> *result, std::size_t count)
+{
+    using TArray = T[Dim][Dim];
+    if constexpr (std::is_floating_point_v<T> && Dim <= 8 && sizeof(Matrix<T, Dim, Dim>) == sizeof(TArray))
+        _OptimizerInternal::transposeMatrixBatch<T, Dim>(reinterpret_cast<const TArray *>(m),
+                                                         reinterpret_cast<TArray *>(result), count);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = transpose(m[i]);
+}
+
+/*
+ * Fused element-wise operations of vectors, one pass without temporaries:
+ * lerp(a, b, t) = a + t * (b - a), fma(a, b, c) = a * b + c, min, max,
+ * clamp, abs and floor. min and max take the second operand, where one
+ * of them is NaN, as SIMD instructions do, so clamp gives lo for NaN
+ */
+template <typename T, std::size_t D>
+Vector<T, D> lerp(const Vector<T, D> &a, const Vector<T, D> &b, std::type_identity_t<T> t) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+        result[i] = a[i] + t * (b[i] - a[i]);
+    return result;
+}
+
+template <typename T, std::size_t D>
+Vector<T, D> fma(const Vector<T, D> &a, const Vector<T, D> &b, const Vector<T, D> &c) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+        result[i] = a[i] * b[i] + c[i];
+    return result;
+}
+
+template <typename T, std::size_t D>
+Vector<T, D> min(const Vector<T, D> &a, const Vector<T, D> &b) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+        result[i] = a[i] < b[i] ? a[i] : b[i];
+    return result;
+}
+
+template <typename T, std::size_t D>
+Vector<T, D> max(const Vector<T, D> &a, const Vector<T, D> &b) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+        result[i] = a[i] > b[i] ? a[i] : b[i];
+    return result;
+}
+
+// component k between lo[k] and hi[k]
+template <typename T, std::size_t D>
+Vector<T, D> clamp(const Vector<T, D> &v, const Vector<T, D> &lo, const Vector<T, D> &hi) noexcept
+{
+    return min(max(v, lo), hi);
+}
+
+template <typename T, std::size_t D>
+Vector<T, D> clamp(const Vector<T, D> &v, std::type_identity_t<T> lo, std::type_identity_t<T> hi) noexcept
+{
+    return clamp(v, Vector<T, D>(lo), Vector<T, D>(hi));
+}
+
+template <typename T, std::size_t D>
+Vector<T, D> abs(const Vector<T, D> &v) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+    {
+        // sign bit is cleared, as by absStream, so -0 and -NaN lose it too
+        if constexpr (std::is_floating_point_v<T>)
+            result[i] = std::abs(v[i]);
+        else
+            result[i] = v[i] < T(0) ? T(-v[i]) : v[i];
+    }
+    return result;
+}
+
+template <std::floating_point T, std::size_t D>
+Vector<T, D> floor(const Vector<T, D> &v) noexcept
+{
+    Vector<T, D> result;
+    for (std::size_t i = 0; i < D; ++i)
+        result[i] = std::floor(v[i]);
+    return result;
+}
+
+namespace _Fused
+{
+// float and double vectors without padding are one stream of count * D numbers
+template <typename T, std::size_t D>
+constexpr bool IsStream = (std::is_same_v<T, float> || std::is_same_v<T, double>) && sizeof(Vector<T, D>) == D * sizeof(T);
+
+template <typename T, std::size_t D>
+const T *numbers(const Vector<T, D> *v) noexcept { return reinterpret_cast<const T *>(v); }
+template <typename T, std::size_t D>
+T *numbers(Vector<T, D> *v) noexcept { return reinterpret_cast<T *>(v); }
+}
+
+/*
+ * The same over arrays of "count" vectors by one dispatched SIMD pass,
+ * result may alias operands. axpy(a, x, y, result, count) computes
+ * a * x + y, the update of particles and integrators
+ */
+template <typename T, std::size_t D>
+void axpy(std::type_identity_t<T> a, const Vector<T, D> *x, const Vector<T, D> *y, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::axpyStream<T>(a, _Fused::numbers(x), _Fused::numbers(y), _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = fma(Vector<T, D>(a), x[i], y[i]);
+}
+
+template <typename T, std::size_t D>
+void lerp(const Vector<T, D> *a, const Vector<T, D> *b, std::type_identity_t<T> t, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::lerpStream<T>(_Fused::numbers(a), _Fused::numbers(b), t, _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = lerp(a[i], b[i], t);
+}
+
+template <typename T, std::size_t D>
+void fma(const Vector<T, D> *a, const Vector<T, D> *b, const Vector<T, D> *c, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::fmaStream<T>(_Fused::numbers(a), _Fused::numbers(b), _Fused::numbers(c), _Fused::numbers(result),
+                                         count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = fma(a[i], b[i], c[i]);
+}
+
+template <typename T, std::size_t D>
+void min(const Vector<T, D> *a, const Vector<T, D> *b, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::minStream<T>(_Fused::numbers(a), _Fused::numbers(b), _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = min(a[i], b[i]);
+}
+
+template <typename T, std::size_t D>
+void max(const Vector<T, D> *a, const Vector<T, D> *b, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::maxStream<T>(_Fused::numbers(a), _Fused::numbers(b), _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = max(a[i], b[i]);
+}
+
+template <typename T, std::size_t D>
+void clamp(const Vector<T, D> *v, std::type_identity_t<T> lo, std::type_identity_t<T> hi, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::clampStream<T>(_Fused::numbers(v), lo, hi, _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = clamp(v[i], lo, hi);
+}
+
+template <typename T, std::size_t D>
+void abs(const Vector<T, D> *v, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::absStream<T>(_Fused::numbers(v), _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = abs(v[i]);
+}
+
+template <std::floating_point T, std::size_t D>
+void floor(const Vector<T, D> *v, Vector<T, D> *result, std::size_t count)
+{
+    if constexpr (_Fused::IsStream<T, D>)
+        _OptimizerInternal::floorStream<T>(_Fused::numbers(v), _Fused::numbers(result), count * D);
+    else
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = floor(v[i]);
+}
+
+/*
+ * Column-major matrix
+ *
+ * Numbers are stored column by column, as column-major graphics APIs
+ * expect them. Such a matrix keeps its transpose as row-major
+ * Matrix<T, C, R>, so its columns are rows of storage: they are accessed
+ * by reference, transpose() is a reinterpretation and products, inverses
+ * and submatrices run row-major (SIMD) implementations of storage.
+ */
+template <typename T, std::size_t R, std::size_t C>
+struct Matrix<T, R, C, Layout::ColumnMajor>
+{
+    static constexpr auto Rows = R;
+    static constexpr auto Columns = C;
+    static constexpr auto Size = R * C;
+    using Type = T;
+    using TColumn = Matrix<T, 1, R>;
+    using Storage = Matrix<T, C, R>;
+
+    constexpr Matrix() noexcept {}
+    constexpr Matrix(T defaultValue) noexcept : _storage(defaultValue) {}
+    // the same numbers in the other layout
+    explicit Matrix(const Matrix<T, R, C> &m) noexcept : _storage(transpose(m)) {}
+    explicit operator Matrix<T, R, C>() const noexcept { return transpose(_storage); }
+
+    T &operator()(std::size_t row, std::size_t column) noexcept
+    {
+        assert(row < R && column < C);
+        return entry(_storage, column, row);
+    }
+    const T &operator()(std::size_t row, std::size_t column) const noexcept
+    {
+        assert(row < R && column < C);
+        return entry(_storage, column, row);
+    }
+    TColumn &column(std::size_t c) noexcept
+    {
+        assert(c < C);
+        if constexpr (C == 1)
+            return _storage;
+        else
+            return _storage[c];
+    }
+    const TColumn &column(std::size_t c) const noexcept
+    {
+        assert(c < C);
+        if constexpr (C == 1)
+            return _storage;
+        else
+            // const operator[] of some specializations gives plain arrays
+            return static_cast<typename Storage::CRData>(_storage)[c];
+    }
+
+    constexpr std::size_t rows() const noexcept { return Rows; }
+    constexpr std::size_t columns() const noexcept { return Columns; }
+    constexpr std::size_t size() const noexcept { return Size; }
+    // numbers column by column, e.g. for glUniformMatrix4fv(..., GL_FALSE, m.data())
+    T *data() noexcept { return reinterpret_cast<T *>(&_storage); }
+    const T *data() const noexcept { return reinterpret_cast<const T *>(&_storage); }
+
+    // row-major matrix of the same numbers
+    Storage &transposed() noexcept { return _storage; }
+    const Storage &transposed() const noexcept { return _storage; }
+
+    Matrix operator-() const noexcept requires std::is_arithmetic_v<T>
+    {
+        Matrix result = *this;
+        result._storage *= T(-1);
+        return result;
+    }
+    Matrix &operator+=(const Matrix &m) noexcept requires std::is_arithmetic_v<T>
+    {
+        _storage += m._storage;
+        return *this;
+    }
+    Matrix &operator-=(const Matrix &m) noexcept requires std::is_arithmetic_v<T>
+    {
+        _storage -= m._storage;
+        return *this;
+    }
+    // element-wise, as for row-major matrices
+    Matrix &operator*=(const Matrix &m) noexcept requires std::is_arithmetic_v<T>
+    {
+        _storage *= m._storage;
+        return *this;
+    }
+    Matrix &operator*=(T k) noexcept requires std::is_arithmetic_v<T>
+    {
+        _storage *= k;
+        return *this;
+    }
+    Matrix &operator/=(T k) requires std::is_arithmetic_v<T>
+    {
+        _storage /= k;
+        return *this;
+    }
+
+    friend bool operator==(const Matrix &lhs, const Matrix &rhs) { return lhs._storage == rhs._storage; }
+    friend bool operator!=(const Matrix &lhs, const Matrix &rhs) { return lhs._storage != rhs._storage; }
+
+private:
+    // one-row storage is indexed by element
+    template <typename M>
+    static auto &entry(M &m, std::size_t row, std::size_t column) noexcept
+    {
+        if constexpr (C == 1)
+            return m[column];
+        else
+            return m[row][column];
+    }
+
+    Storage _storage;
+};
+
+template <typename T, std::size_t R, std::size_t C>
+using ColumnMajorMatrix = Matrix<T, R, C, Layout::ColumnMajor>;
+
+// Row-major matrix of the same numbers, no copy
+template <typename T, std::size_t R, std::size_t C>
+Matrix<T, C, R> &transpose(ColumnMajorMatrix<T, R, C> &m) noexcept
+{
+    return m.transposed();
+}
+
+template <typename T, std::size_t R, std::size_t C>
+const Matrix<T, C, R> &transpose(const ColumnMajorMatrix<T, R, C> &m) noexcept
+{
+    return m.transposed();
+}
+
+/*
+ * Product of column-major matrices: (A * B)^T = B^T * A^T,
+ * storages are multiplied in reverse order
+ */
+template <typename T, std::size_t Dim, std::size_t LRow, std::size_t RCol>
+ColumnMajorMatrix<T, LRow, RCol> dot(const ColumnMajorMatrix<T, LRow, Dim> &lhs, const ColumnMajorMatrix<T, Dim, RCol> &rhs)
+{
+    ColumnMajorMatrix<T, LRow, RCol> result;
+    result.transposed() = dot(rhs.transposed(), lhs.transposed());
+    return result;
+}
+
+/*
+ * Product of column-major matrix and column vector: sum of matrix
+ * columns, scaled by vector numbers
+ */
+template <typename T, std::size_t R, std::size_t C>
+Vector<T, R> dot(const ColumnMajorMatrix<T, R, C> &m, const Vector<T, C> &v)
+{
+    Vector<T, R> result = m.column(0) * v[0];
+    for (std::size_t k = 1; k < C; ++k)
+        result += m.column(k) * v[k];
+    return result;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+ColumnMajorMatrix<T, R, C> operator+(ColumnMajorMatrix<T, R, C> lhs, const ColumnMajorMatrix<T, R, C> &rhs)
+{
+    return lhs += rhs;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+ColumnMajorMatrix<T, R, C> operator-(ColumnMajorMatrix<T, R, C> lhs, const ColumnMajorMatrix<T, R, C> &rhs)
+{
+    return lhs -= rhs;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+ColumnMajorMatrix<T, R, C> operator*(ColumnMajorMatrix<T, R, C> lhs, T rhs)
+{
+    return lhs *= rhs;
+}
+
+// Submatrix begins with subRow and subCol
+template <typename T, std::size_t R, std::size_t C>
+auto submatrix(const ColumnMajorMatrix<T, R, C> &m, std::size_t subRow, std::size_t subCol)
+{
+    if constexpr (R == 2 && C == 2)
+        return submatrix(m.transposed(), subCol, subRow);
+    else
+    {
+        ColumnMajorMatrix<T, R - 1, C - 1> result;
+        result.transposed() = submatrix(m.transposed(), subCol, subRow);
+        return result;
+    }
+}
+
+// |A| = |A^T|
+template <typename T, std::size_t Dim>
+T determinant(const ColumnMajorMatrix<T, Dim, Dim> &m)
+{
+    return determinant(m.transposed());
+}
+
+// (A^-1)^T = (A^T)^-1
+template <typename T, std::size_t Dim>
+ColumnMajorMatrix<T, Dim, Dim> invert(const ColumnMajorMatrix<T, Dim, Dim> &m, bool *correctness = nullptr)
+{
+    ColumnMajorMatrix<T, Dim, Dim> result;
+    result.transposed() = invert(m.transposed(), correctness);
+    return result;
+}
+
+static_assert(IsPlainMatrix<ColumnMajorMatrix<float, 4, 4>>);
+static_assert(IsPlainMatrix<ColumnMajorMatrix<double, 3, 2>>);
+static_assert(sizeof(ColumnMajorMatrix<float, 4, 4>) == 64 && alignof(ColumnMajorMatrix<float, 4, 4>) == 64);
+
 }
 }
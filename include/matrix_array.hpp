@@ -0,0 +1,285 @@
+#pragma once
+/*
+ * File contains element-interleaved container of small matrices
+ *
+ * MatrixArray<T,R,C> keeps element (r, c) of all matrices in its own
+ * aligned stream, so batch kernels evaluate product, transpose,
+ * determinant and inverse of 4 to 16 matrices per instruction.
+ * Single matrices are accessed through proxies, which convert
+ * to and from LA::Matrix.
+ *
+ * Batch operations of float and double 2x2, 3x3 and 4x4 matrices,
+ * eigen and singular value decompositions of 3x3 ones and solvers of
+ * linear systems up to 6x6 are dispatched by Optimizer, results may
+ * alias operands.
+*/
+
+#include "vector_array.hpp"
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <typename T, std::size_t R, std::size_t C>
+class MatrixArray
+{
+public:
+    using Type = T;
+    using Value = Matrix<T, R, C>;
+    static constexpr std::size_t Rows = R;
+    static constexpr std::size_t Columns = C;
+    // all elements of one matrix form one "vector" of streams
+    using Elements = VectorArray<T, R * C>;
+
+    // Proxy to the matrix stored at index
+    class Reference
+    {
+    public:
+        Reference(MatrixArray &array, std::size_t index) noexcept : _array(array), _index(index) {}
+
+        operator Value() const noexcept { return _array.at(_index); }
+        Reference &operator=(const Value &m) noexcept
+        {
+            _array.set(_index, m);
+            return *this;
+        }
+        Reference &operator=(const Reference &r) noexcept { return *this = Value(r); }
+        T &operator()(std::size_t row, std::size_t column) const noexcept { return _array.stream(row, column)[_index]; }
+
+        friend bool operator==(const Reference &lhs, const Value &rhs) { return Value(lhs) == rhs; }
+        friend bool operator!=(const Reference &lhs, const Value &rhs) { return Value(lhs) != rhs; }
+
+    private:
+        MatrixArray &_array;
+        std::size_t _index;
+    };
+
+    MatrixArray() noexcept = default;
+    explicit MatrixArray(std::size_t size) : _elements(size) {}
+    // From array of matrices
+    MatrixArray(const Value *aos, std::size_t count) { assign(aos, count); }
+    explicit MatrixArray(const std::vector<Value> &aos) { assign(aos.data(), aos.size()); }
+
+    std::size_t size() const noexcept { return _elements.size(); }
+    std::size_t capacity() const noexcept { return _elements.capacity(); }
+    bool empty() const noexcept { return _elements.empty(); }
+
+    // Element streams
+    T *stream(std::size_t row, std::size_t column) noexcept
+    {
+        assert(row < R && column < C);
+        return _elements.stream(row * C + column);
+    }
+    const T *stream(std::size_t row, std::size_t column) const noexcept
+    {
+        assert(row < R && column < C);
+        return _elements.stream(row * C + column);
+    }
+    Elements &elements() noexcept { return _elements; }
+    const Elements &elements() const noexcept { return _elements; }
+
+    Value at(std::size_t i) const noexcept
+    {
+        assert(i < size());
+        Value m;
+        for (std::size_t r = 0; r < R; ++r)
+            for (std::size_t c = 0; c < C; ++c)
+                element(m, r, c) = stream(r, c)[i];
+        return m;
+    }
+    void set(std::size_t i, const Value &m) noexcept
+    {
+        assert(i < size());
+        for (std::size_t r = 0; r < R; ++r)
+            for (std::size_t c = 0; c < C; ++c)
+                stream(r, c)[i] = element(m, r, c);
+    }
+    Reference operator[](std::size_t i) noexcept
+    {
+        assert(i < size());
+        return Reference(*this, i);
+    }
+    Value operator[](std::size_t i) const noexcept { return at(i); }
+
+    // Keeps stored matrices, new ones are uninitialized
+    void reserve(std::size_t capacity) { _elements.reserve(capacity); }
+    void resize(std::size_t size) { _elements.resize(size); }
+    void push_back(const Value &m)
+    {
+        resize(size() + 1);
+        set(size() - 1, m);
+    }
+    void clear() noexcept { _elements.clear(); }
+
+    // Conversion from and to array of matrices
+    void assign(const Value *aos, std::size_t count)
+    {
+        _elements.clear();
+        resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            set(i, aos[i]);
+    }
+    void store(Value *aos) const noexcept
+    {
+        for (std::size_t i = 0; i < size(); ++i)
+            aos[i] = at(i);
+    }
+    std::vector<Value> toAoS() const
+    {
+        std::vector<Value> result(size());
+        store(result.data());
+        return result;
+    }
+
+private:
+    // one-row matrices are indexed by element
+    template <typename M>
+    static auto &element(M &m, std::size_t row, std::size_t column) noexcept
+    {
+        if constexpr (R == 1)
+            return m[column];
+        else
+            return m[row][column];
+    }
+
+    Elements _elements;
+};
+
+template <std::size_t N>
+concept BatchDimension = N >= 2 && N <= 4;
+
+/*
+ * Products of matrices with the same index
+ */
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+void dot(const MatrixArray<T, N, N> &lhs, const MatrixArray<T, N, N> &rhs, MatrixArray<T, N, N> &result)
+{
+    assert(lhs.size() == rhs.size());
+    result.resize(lhs.size());
+    _OptimizerInternal::dotMatrixArray<T, N>(Streams(lhs.elements()).data, Streams(rhs.elements()).data,
+                                             MutableStreams(result.elements()).data, lhs.size());
+}
+
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+MatrixArray<T, N, N> dot(const MatrixArray<T, N, N> &lhs, const MatrixArray<T, N, N> &rhs)
+{
+    MatrixArray<T, N, N> result;
+    dot(lhs, rhs, result);
+    return result;
+}
+
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+void transpose(const MatrixArray<T, N, N> &a, MatrixArray<T, N, N> &result)
+{
+    result.resize(a.size());
+    _OptimizerInternal::transposeMatrixArray<T, N>(Streams(a.elements()).data, MutableStreams(result.elements()).data, a.size());
+}
+
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+MatrixArray<T, N, N> transpose(const MatrixArray<T, N, N> &a)
+{
+    MatrixArray<T, N, N> result;
+    transpose(a, result);
+    return result;
+}
+
+/*
+ * Determinants, result must hold a.size() numbers
+ */
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+void determinant(const MatrixArray<T, N, N> &a, T *result)
+{
+    _OptimizerInternal::determinantMatrixArray<T, N>(Streams(a.elements()).data, result, a.size());
+}
+
+/*
+ * Inverses, singular matrices get non-finite elements.
+ * Determinants are written, if "determinants" isn't nullptr,
+ * zero one marks the matrix, which has no inverse
+ */
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+void invert(const MatrixArray<T, N, N> &a, MatrixArray<T, N, N> &result, T *determinants = nullptr)
+{
+    result.resize(a.size());
+    _OptimizerInternal::inverseMatrixArray<T, N>(Streams(a.elements()).data, MutableStreams(result.elements()).data,
+                                                 determinants, a.size());
+}
+
+template <StreamType T, std::size_t N> requires BatchDimension<N>
+MatrixArray<T, N, N> invert(const MatrixArray<T, N, N> &a, T *determinants = nullptr)
+{
+    MatrixArray<T, N, N> result;
+    invert(a, result, determinants);
+    return result;
+}
+
+template <std::size_t N>
+concept SolveDimension = N >= 2 && N <= 6;
+
+template <std::size_t R, std::size_t C>
+concept LeastSquaresDimension = C >= 2 && C <= 4 && R >= C && R <= 6;
+
+/*
+ * Solves a[i] * x[i] = b[i] by Gaussian elimination with partial pivoting,
+ * every system has its own pivots. Systems with singular matrix up to
+ * rounding (pivot not above N * eps * max |a[i]|, while LU takes only zero
+ * pivot) get zero solution and singular[i] = true, if "singular" isn't
+ * nullptr, it must hold a.size() flags then. Returns count of singular systems.
+ * x is resized to a.size() and may alias b
+ */
+template <StreamType T, std::size_t N> requires SolveDimension<N>
+std::size_t solve(const MatrixArray<T, N, N> &a, const VectorArray<T, N> &b, VectorArray<T, N> &x, bool *singular = nullptr)
+{
+    assert(a.size() == b.size());
+    x.resize(a.size());
+    return _OptimizerInternal::solveMatrixArray<T, N>(Streams(a.elements()).data, Streams(b).data,
+                                                      MutableStreams(x).data, singular, a.size());
+}
+
+/*
+ * Least squares solutions of overdetermined systems: x[i] minimizes
+ * |a[i] * x[i] - b[i]|, see solveLeastSquares() of single matrix.
+ * Systems with linearly dependent columns are flagged as by solve()
+ */
+template <StreamType T, std::size_t R, std::size_t C> requires LeastSquaresDimension<R, C>
+std::size_t solveLeastSquares(const MatrixArray<T, R, C> &a, const VectorArray<T, R> &b, VectorArray<T, C> &x,
+                              bool *singular = nullptr)
+{
+    assert(a.size() == b.size());
+    x.resize(a.size());
+    return _OptimizerInternal::leastSquaresMatrixArray<T, R, C>(Streams(a.elements()).data, Streams(b).data,
+                                                                MutableStreams(x).data, singular, a.size());
+}
+
+/*
+ * Eigen decompositions of symmetric matrices:
+ * a[i] = vectors[i] * diag(values[i]) * vectors[i]^T,
+ * see decomposeSymmetricEigen() of single matrix
+ */
+template <StreamType T>
+void decomposeSymmetricEigen(const MatrixArray<T, 3, 3> &a, VectorArray<T, 3> &values, MatrixArray<T, 3, 3> &vectors)
+{
+    values.resize(a.size());
+    vectors.resize(a.size());
+    _OptimizerInternal::symmetricEigenMatrixArray<T>(Streams(a.elements()).data, MutableStreams(values).data,
+                                                     MutableStreams(vectors.elements()).data, a.size());
+}
+
+/*
+ * Singular value decompositions: a[i] = u[i] * diag(values[i]) * v[i]^T,
+ * see decomposeSVD() of single matrix
+ */
+template <StreamType T>
+void decomposeSVD(const MatrixArray<T, 3, 3> &a, MatrixArray<T, 3, 3> &u, VectorArray<T, 3> &values, MatrixArray<T, 3, 3> &v)
+{
+    u.resize(a.size());
+    values.resize(a.size());
+    v.resize(a.size());
+    _OptimizerInternal::svdMatrixArray<T>(Streams(a.elements()).data, MutableStreams(u.elements()).data,
+                                          MutableStreams(values).data, MutableStreams(v.elements()).data, a.size());
+}
+
+}
+}
@@ -0,0 +1,264 @@
+#pragma once
+/*
+ * File contains implementations of operations over many small square
+ * matrices stored element-interleaved (see matrix_array.hpp).
+ *
+ * Matrix NxN is spread over N * N element streams in row-major order,
+ * so one register holds the same element of Width matrices and every
+ * formula is evaluated for Width matrices at once. Fallbacks run the
+ * same kernels with Lanes<T, Scalar>, one matrix at a time.
+ * Results may alias operands.
+*/
+
+#include "simd.hpp"
+#include "vector_array_implementation.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// Loads element registers of Width matrices starting at matrix i
+template<typename L, typename Load, std::size_t N>
+void loadMatrices(const typename L::Type *const (&src)[N * N], std::size_t i, Load load,
+                  typename L::Register (&m)[N][N]) noexcept
+{
+    for (std::size_t r = 0; r < N; ++r)
+        for (std::size_t c = 0; c < N; ++c)
+            m[r][c] = load(src[r * N + c] + i);
+}
+
+template<typename L, typename Store, std::size_t N>
+void storeMatrices(typename L::Type *const (&dst)[N * N], std::size_t i, Store store,
+                   const typename L::Register (&m)[N][N]) noexcept
+{
+    for (std::size_t r = 0; r < N; ++r)
+        for (std::size_t c = 0; c < N; ++c)
+            store(dst[r * N + c] + i, m[r][c]);
+}
+
+// a * b - c * d
+template<typename L>
+typename L::Register mulSub(typename L::Register a, typename L::Register b,
+                            typename L::Register c, typename L::Register d) noexcept
+{
+    return L::sub(L::mul(a, b), L::mul(c, d));
+}
+
+/*
+ * Determinant and adjugate (transposed cofactors) of Width matrices,
+ * adjugate is skipped when it's nullptr
+ */
+template<typename L, std::size_t N>
+typename L::Register adjugate(const typename L::Register (&a)[N][N], typename L::Register (*adj)[N]) noexcept
+{
+    using Register = typename L::Register;
+    static_assert(N >= 2 && N <= 4, "Closed form is implemented for 2x2, 3x3 and 4x4 matrices");
+
+    if constexpr (N == 2)
+    {
+        if (adj)
+        {
+            adj[0][0] = a[1][1];
+            adj[0][1] = L::sub(L::zero(), a[0][1]);
+            adj[1][0] = L::sub(L::zero(), a[1][0]);
+            adj[1][1] = a[0][0];
+        }
+        return mulSub<L>(a[0][0], a[1][1], a[0][1], a[1][0]);
+    }
+    else if constexpr (N == 3)
+    {
+        const Register c00 = mulSub<L>(a[1][1], a[2][2], a[1][2], a[2][1]);
+        const Register c01 = mulSub<L>(a[1][2], a[2][0], a[1][0], a[2][2]);
+        const Register c02 = mulSub<L>(a[1][0], a[2][1], a[1][1], a[2][0]);
+        if (adj)
+        {
+            adj[0][0] = c00;
+            adj[1][0] = c01;
+            adj[2][0] = c02;
+            adj[0][1] = mulSub<L>(a[0][2], a[2][1], a[0][1], a[2][2]);
+            adj[1][1] = mulSub<L>(a[0][0], a[2][2], a[0][2], a[2][0]);
+            adj[2][1] = mulSub<L>(a[0][1], a[2][0], a[0][0], a[2][1]);
+            adj[0][2] = mulSub<L>(a[0][1], a[1][2], a[0][2], a[1][1]);
+            adj[1][2] = mulSub<L>(a[0][2], a[1][0], a[0][0], a[1][2]);
+            adj[2][2] = mulSub<L>(a[0][0], a[1][1], a[0][1], a[1][0]);
+        }
+        return L::fmadd(a[0][2], c02, L::fmadd(a[0][1], c01, L::mul(a[0][0], c00)));
+    }
+    else
+    {
+        // 2x2 minors of the top (s) and bottom (c) row pairs
+        const Register s0 = mulSub<L>(a[0][0], a[1][1], a[1][0], a[0][1]);
+        const Register s1 = mulSub<L>(a[0][0], a[1][2], a[1][0], a[0][2]);
+        const Register s2 = mulSub<L>(a[0][0], a[1][3], a[1][0], a[0][3]);
+        const Register s3 = mulSub<L>(a[0][1], a[1][2], a[1][1], a[0][2]);
+        const Register s4 = mulSub<L>(a[0][1], a[1][3], a[1][1], a[0][3]);
+        const Register s5 = mulSub<L>(a[0][2], a[1][3], a[1][2], a[0][3]);
+        const Register c5 = mulSub<L>(a[2][2], a[3][3], a[3][2], a[2][3]);
+        const Register c4 = mulSub<L>(a[2][1], a[3][3], a[3][1], a[2][3]);
+        const Register c3 = mulSub<L>(a[2][1], a[3][2], a[3][1], a[2][2]);
+        const Register c2 = mulSub<L>(a[2][0], a[3][3], a[3][0], a[2][3]);
+        const Register c1 = mulSub<L>(a[2][0], a[3][2], a[3][0], a[2][2]);
+        const Register c0 = mulSub<L>(a[2][0], a[3][1], a[3][0], a[2][1]);
+
+        // x * p - y * q + z * r
+        auto term = [](Register x, Register p, Register y, Register q, Register z, Register r) {
+            return L::fmadd(z, r, mulSub<L>(x, p, y, q));
+        };
+        if (adj)
+        {
+            const Register zero = L::zero();
+            auto neg = [zero](Register x) { return L::sub(zero, x); };
+            adj[0][0] = term(a[1][1], c5, a[1][2], c4, a[1][3], c3);
+            adj[0][1] = neg(term(a[0][1], c5, a[0][2], c4, a[0][3], c3));
+            adj[0][2] = term(a[3][1], s5, a[3][2], s4, a[3][3], s3);
+            adj[0][3] = neg(term(a[2][1], s5, a[2][2], s4, a[2][3], s3));
+            adj[1][0] = neg(term(a[1][0], c5, a[1][2], c2, a[1][3], c1));
+            adj[1][1] = term(a[0][0], c5, a[0][2], c2, a[0][3], c1);
+            adj[1][2] = neg(term(a[3][0], s5, a[3][2], s2, a[3][3], s1));
+            adj[1][3] = term(a[2][0], s5, a[2][2], s2, a[2][3], s1);
+            adj[2][0] = term(a[1][0], c4, a[1][1], c2, a[1][3], c0);
+            adj[2][1] = neg(term(a[0][0], c4, a[0][1], c2, a[0][3], c0));
+            adj[2][2] = term(a[3][0], s4, a[3][1], s2, a[3][3], s0);
+            adj[2][3] = neg(term(a[2][0], s4, a[2][1], s2, a[2][3], s0));
+            adj[3][0] = neg(term(a[1][0], c3, a[1][1], c1, a[1][2], c0));
+            adj[3][1] = term(a[0][0], c3, a[0][1], c1, a[0][2], c0);
+            adj[3][2] = neg(term(a[3][0], s3, a[3][1], s1, a[3][2], s0));
+            adj[3][3] = term(a[2][0], s3, a[2][1], s1, a[2][2], s0);
+        }
+        const Register det = L::add(term(s0, c5, s1, c4, s2, c3), term(s3, c2, s4, c1, s5, c0));
+        return det;
+    }
+}
+
+template<typename Isa, typename T, std::size_t N>
+void dotMatrixArrayIntrinImplementation(const T *const *a, const T *const *b, T *const *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *srcA[N * N], *srcB[N * N];
+    T *dst[N * N];
+    for (std::size_t k = 0; k < N * N; ++k)
+    {
+        srcA[k] = a[k];
+        srcB[k] = b[k];
+        dst[k] = result[k];
+    }
+
+    // rhs is kept in registers, lhs and result go row by row,
+    // so row r of lhs is loaded before row r of result overwrites it
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register rhs[N][N];
+        loadMatrices<L>(srcB, i, load, rhs);
+        for (std::size_t r = 0; r < N; ++r)
+        {
+            Register lhs[N], out[N];
+            for (std::size_t k = 0; k < N; ++k)
+                lhs[k] = load(srcA[r * N + k] + i);
+            for (std::size_t c = 0; c < N; ++c)
+            {
+                out[c] = L::mul(lhs[0], rhs[0][c]);
+                for (std::size_t k = 1; k < N; ++k)
+                    out[c] = L::fmadd(lhs[k], rhs[k][c], out[c]);
+            }
+            for (std::size_t c = 0; c < N; ++c)
+                store(dst[r * N + c] + i, out[c]);
+        }
+    });
+}
+
+template<typename Isa, typename T, std::size_t N>
+void transposeMatrixArrayIntrinImplementation(const T *const *a, T *const *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *src[N * N];
+    T *dst[N * N];
+    // transposition is a permutation of streams
+    for (std::size_t r = 0; r < N; ++r)
+        for (std::size_t c = 0; c < N; ++c)
+        {
+            src[r * N + c] = a[c * N + r];
+            dst[r * N + c] = result[r * N + c];
+        }
+
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register m[N][N];
+        loadMatrices<L>(src, i, load, m);
+        storeMatrices<L>(dst, i, store, m);
+    });
+}
+
+template<typename Isa, typename T, std::size_t N>
+void determinantMatrixArrayIntrinImplementation(const T *const *a, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *src[N * N];
+    for (std::size_t k = 0; k < N * N; ++k)
+        src[k] = a[k];
+
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register m[N][N];
+        loadMatrices<L>(src, i, load, m);
+        store(result + i, adjugate<L, N>(m, nullptr));
+    });
+}
+
+/*
+ * Inverse = adjugate / determinant, singular matrices get non-finite
+ * elements. Determinants are written, if "determinants" isn't nullptr
+ */
+template<typename Isa, typename T, std::size_t N>
+void inverseMatrixArrayIntrinImplementation(const T *const *a, T *const *result, T *determinants, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const T *src[N * N];
+    T *dst[N * N];
+    for (std::size_t k = 0; k < N * N; ++k)
+    {
+        src[k] = a[k];
+        dst[k] = result[k];
+    }
+
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        Register m[N][N], adj[N][N];
+        loadMatrices<L>(src, i, load, m);
+        const Register det = adjugate<L, N>(m, adj);
+        const Register inv = L::div(L::set1(T(1)), det);
+        for (std::size_t r = 0; r < N; ++r)
+            for (std::size_t c = 0; c < N; ++c)
+                adj[r][c] = L::mul(adj[r][c], inv);
+        storeMatrices<L>(dst, i, store, adj);
+        if (determinants)
+            store(determinants + i, det);
+    });
+}
+
+// ================================ Fallback ================================ //
+template<typename T, std::size_t N>
+void dotMatrixArrayFallbackImplementation(const T *const *a, const T *const *b, T *const *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    dotMatrixArrayIntrinImplementation<Scalar, T, N>(a, b, result, count);
+}
+
+template<typename T, std::size_t N>
+void transposeMatrixArrayFallbackImplementation(const T *const *a, T *const *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    transposeMatrixArrayIntrinImplementation<Scalar, T, N>(a, result, count);
+}
+
+template<typename T, std::size_t N>
+void determinantMatrixArrayFallbackImplementation(const T *const *a, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    determinantMatrixArrayIntrinImplementation<Scalar, T, N>(a, result, count);
+}
+
+template<typename T, std::size_t N>
+void inverseMatrixArrayFallbackImplementation(const T *const *a, T *const *result, T *determinants, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    inverseMatrixArrayIntrinImplementation<Scalar, T, N>(a, result, determinants, count);
+}
+
+}
@@ -0,0 +1,299 @@
+#pragma once
+/*
+ * File contains opt-in lazy evaluation of element-wise Matrix expressions
+ *
+ * Wrapping any operand with lazy() turns the whole expression into a tree
+ * of light nodes instead of a chain of temporaries. The tree is evaluated
+ * in one pass, when it is converted to a Matrix or passed to assign():
+ *
+ *  Matrix<float,64,64> r = lazy(a) * s + b - c;
+ *  assign(r, lazy(r) / 2.f - a);
+ *
+ * Floating-point expressions are evaluated by SIMD registers of the widest
+ * compiled-in instruction set, after Optimizer::init() detects it.
+ * Nodes keep references to matrices, so expression must not outlive them.
+ * Every element depends only on the same elements of operands, so result
+ * may alias any of them.
+*/
+
+#include "matrix.hpp"
+#include "simd.hpp"
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+namespace Lazy
+{
+
+#ifdef __SSE2__
+#define GEOMETRIX_EXPRESSION_SIMD
+#endif
+
+template <typename E>
+struct Expression;
+
+template <typename X>
+concept IsExpression = requires { typename X::ExpressionType; } &&
+                       std::is_base_of_v<Expression<typename X::ExpressionType>, X>;
+
+template <typename E>
+void assign(Matrix<typename E::Type, E::Rows, E::Columns> &result, const Expression<E> &expr);
+
+// Vectors (one-row matrices) are indexed by element, not by row
+template <typename M>
+auto &element(M &m, std::size_t i, std::size_t j) noexcept
+{
+    if constexpr (std::remove_const_t<M>::Rows == 1)
+        return m[j];
+    else
+        return m[i][j];
+}
+
+/*
+ * Base of all nodes, E - node type
+ * Rows and Columns are 0 for scalars, which match any shape
+ */
+template <typename E>
+struct Expression
+{
+    using ExpressionType = E;
+
+    const E &self() const noexcept { return static_cast<const E &>(*this); }
+
+    template <typename T, std::size_t R, std::size_t C>
+    operator Matrix<T, R, C>() const
+    {
+        static_assert(std::is_same_v<T, typename E::Type> && R == E::Rows && C == E::Columns,
+                      "Expression type doesn't match matrix");
+        Matrix<T, R, C> result;
+        assign(result, *this);
+        return result;
+    }
+};
+
+// Matrix operand
+template <typename T, std::size_t R, std::size_t C>
+struct Terminal : Expression<Terminal<T, R, C>>
+{
+    using Type = T;
+    static constexpr std::size_t Rows = R;
+    static constexpr std::size_t Columns = C;
+
+    explicit Terminal(const Matrix<T, R, C> &m) noexcept : matrix(m) {}
+
+    T at(std::size_t i, std::size_t j) const noexcept { return element(matrix, i, j); }
+
+    template <typename L>
+    typename L::Register load(std::size_t i, std::size_t j) const noexcept { return L::load(&element(matrix, i, j)); }
+    template <typename L>
+    typename L::Register loadPartial(std::size_t i, std::size_t j, std::size_t count) const noexcept
+    {
+        return L::loadPartial(&element(matrix, i, j), count);
+    }
+
+    const Matrix<T, R, C> &matrix;
+};
+
+// Scalar operand, broadcast to every element
+template <typename T>
+struct Scalar : Expression<Scalar<T>>
+{
+    using Type = T;
+    static constexpr std::size_t Rows = 0;
+    static constexpr std::size_t Columns = 0;
+
+    explicit Scalar(T v) noexcept : value(v) {}
+
+    T at(std::size_t, std::size_t) const noexcept { return value; }
+
+    template <typename L>
+    typename L::Register load(std::size_t, std::size_t) const noexcept { return L::set1(value); }
+    template <typename L>
+    typename L::Register loadPartial(std::size_t, std::size_t, std::size_t) const noexcept { return L::set1(value); }
+
+    T value;
+};
+
+// Element-wise operations, scalar and register versions
+struct Add
+{
+    template <typename T> static T apply(T a, T b) noexcept { return a + b; }
+    template <typename L, typename V> static V apply(V a, V b) noexcept { return L::add(a, b); }
+};
+
+struct Sub
+{
+    template <typename T> static T apply(T a, T b) noexcept { return a - b; }
+    template <typename L, typename V> static V apply(V a, V b) noexcept { return L::sub(a, b); }
+};
+
+struct Mul
+{
+    template <typename T> static T apply(T a, T b) noexcept { return a * b; }
+    template <typename L, typename V> static V apply(V a, V b) noexcept { return L::mul(a, b); }
+};
+
+struct Div
+{
+    template <typename T> static T apply(T a, T b) noexcept { return a / b; }
+    template <typename L, typename V> static V apply(V a, V b) noexcept { return L::div(a, b); }
+};
+
+template <typename Op, typename Lhs, typename Rhs>
+struct Binary : Expression<Binary<Op, Lhs, Rhs>>
+{
+    static_assert(std::is_same_v<typename Lhs::Type, typename Rhs::Type>, "Operand types don't match");
+    static_assert(Lhs::Rows == 0 || Rhs::Rows == 0 || (Lhs::Rows == Rhs::Rows && Lhs::Columns == Rhs::Columns),
+                  "Operand dimensions don't match");
+
+    using Type = typename Lhs::Type;
+    static constexpr std::size_t Rows = Lhs::Rows ? Lhs::Rows : Rhs::Rows;
+    static constexpr std::size_t Columns = Lhs::Rows ? Lhs::Columns : Rhs::Columns;
+
+    Binary(const Lhs &l, const Rhs &r) noexcept : lhs(l), rhs(r) {}
+
+    Type at(std::size_t i, std::size_t j) const noexcept { return Op::apply(lhs.at(i, j), rhs.at(i, j)); }
+
+    template <typename L>
+    typename L::Register load(std::size_t i, std::size_t j) const noexcept
+    {
+        return Op::template apply<L>(lhs.template load<L>(i, j), rhs.template load<L>(i, j));
+    }
+    template <typename L>
+    typename L::Register loadPartial(std::size_t i, std::size_t j, std::size_t count) const noexcept
+    {
+        return Op::template apply<L>(lhs.template loadPartial<L>(i, j, count), rhs.template loadPartial<L>(i, j, count));
+    }
+
+    Lhs lhs;
+    Rhs rhs;
+};
+
+template <typename E>
+struct Negate : Expression<Negate<E>>
+{
+    using Type = typename E::Type;
+    static constexpr std::size_t Rows = E::Rows;
+    static constexpr std::size_t Columns = E::Columns;
+
+    explicit Negate(const E &e) noexcept : expr(e) {}
+
+    Type at(std::size_t i, std::size_t j) const noexcept { return -expr.at(i, j); }
+
+    // flips the sign bit, so -(+0) is -0 as in at()
+    template <typename L>
+    typename L::Register load(std::size_t i, std::size_t j) const noexcept
+    {
+        return L::mulSign(expr.template load<L>(i, j), L::set1(Type(-0.)));
+    }
+    template <typename L>
+    typename L::Register loadPartial(std::size_t i, std::size_t j, std::size_t count) const noexcept
+    {
+        return L::mulSign(expr.template loadPartial<L>(i, j, count), L::set1(Type(-0.)));
+    }
+
+    E expr;
+};
+
+// Starts lazy expression
+template <typename T, std::size_t R, std::size_t C>
+Terminal<T, R, C> lazy(const Matrix<T, R, C> &m) noexcept
+{
+    return Terminal<T, R, C>(m);
+}
+
+/*
+ * Evaluate expression into result in one pass
+ */
+template <typename E>
+void assign(Matrix<typename E::Type, E::Rows, E::Columns> &result, const Expression<E> &expression)
+{
+    using T = typename E::Type;
+    const E &expr = expression.self();
+
+#ifdef GEOMETRIX_EXPRESSION_SIMD
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+    {
+        if (Optimizer::hasCompiledIsa())
+        {
+            using L = _Impl::Lanes<T, _Impl::CompiledIsa>;
+            constexpr std::size_t Full = E::Columns - E::Columns % L::Width;
+            constexpr std::size_t Tail = E::Columns % L::Width;
+            for (std::size_t i = 0; i < E::Rows; ++i)
+            {
+                for (std::size_t j = 0; j < Full; j += L::Width)
+                    L::store(&element(result, i, j), expr.template load<L>(i, j));
+                if constexpr (Tail != 0)
+                    L::storePartial(&element(result, i, Full), expr.template loadPartial<L>(i, Full, Tail), Tail);
+            }
+            return;
+        }
+    }
+#endif
+
+    for (std::size_t i = 0; i < E::Rows; ++i)
+        for (std::size_t j = 0; j < E::Columns; ++j)
+            element(result, i, j) = expr.at(i, j);
+}
+
+template <typename E>
+Matrix<typename E::Type, E::Rows, E::Columns> evaluate(const Expression<E> &expression)
+{
+    Matrix<typename E::Type, E::Rows, E::Columns> result;
+    assign(result, expression);
+    return result;
+}
+
+/*
+ * Operators, at least one operand is an expression,
+ * the other one may be a Matrix or a number
+ */
+template <typename T, typename X>
+auto operand(const X &x) noexcept
+{
+    if constexpr (IsExpression<X>)
+        return x;
+    else if constexpr (std::is_arithmetic_v<X>)
+        return Scalar<T>(static_cast<T>(x));
+    else
+        return Terminal<T, X::Rows, X::Columns>(x);
+}
+
+template <typename Lhs, typename Rhs>
+using OperandType = typename std::conditional_t<IsExpression<Lhs>, Lhs, Rhs>::Type;
+
+template <typename Lhs, typename Rhs>
+concept LazyOperands = IsExpression<Lhs> || IsExpression<Rhs>;
+
+template <typename Op, typename Lhs, typename Rhs>
+auto makeBinary(const Lhs &lhs, const Rhs &rhs) noexcept
+{
+    using T = OperandType<Lhs, Rhs>;
+    auto l = operand<T>(lhs);
+    auto r = operand<T>(rhs);
+    return Binary<Op, decltype(l), decltype(r)>(l, r);
+}
+
+template <typename Lhs, typename Rhs> requires LazyOperands<Lhs, Rhs>
+auto operator+(const Lhs &lhs, const Rhs &rhs) noexcept { return makeBinary<Add>(lhs, rhs); }
+
+template <typename Lhs, typename Rhs> requires LazyOperands<Lhs, Rhs>
+auto operator-(const Lhs &lhs, const Rhs &rhs) noexcept { return makeBinary<Sub>(lhs, rhs); }
+
+template <typename Lhs, typename Rhs> requires LazyOperands<Lhs, Rhs>
+auto operator*(const Lhs &lhs, const Rhs &rhs) noexcept { return makeBinary<Mul>(lhs, rhs); }
+
+template <typename Lhs, typename Rhs> requires LazyOperands<Lhs, Rhs>
+auto operator/(const Lhs &lhs, const Rhs &rhs) noexcept { return makeBinary<Div>(lhs, rhs); }
+
+template <typename E> requires IsExpression<E>
+Negate<E> operator-(const E &expr) noexcept { return Negate<E>(expr); }
+
+}
+}
+}
+
+#undef GEOMETRIX_EXPRESSION_SIMD
@@ -5,6 +5,9 @@
 */
 
 #include "immintrin.h"
+#include "simd.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <type_traits>
 
 
@@ -161,97 +164,814 @@ void divVecSingleIntrinImplementation(double (&a)[4], double b, double (&result)
 #endif
 
 
-// =================================== 4x4 Matrix ============================//
-void subMatrixFallbackImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+// =================================== RxC Matrix ============================//
+// Result may alias the first argument
+template<typename T, std::size_t R, std::size_t C>
+void subMatrixFallbackImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] -= b[i][j]); // a is the same address as result
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] - b[i][j]);
 }
 
-void addMatrixFallbackImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void addMatrixFallbackImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] += b[i][j]);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] + b[i][j]);
 }
 
-void mulMatrixFallbackImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void mulMatrixFallbackImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] *= b[i][j]);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] * b[i][j]);
 }
 
-void divMatrixFallbackImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void divMatrixFallbackImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] /= b[i][j]);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] / b[i][j]);
 }
 
-void subMatrixSingleFallbackImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void subMatrixSingleFallbackImplementation(const T (&a)[R][C], T b, T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] -= b);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] - b);
 }
 
-void addMatrixSingleFallbackImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void addMatrixSingleFallbackImplementation(const T (&a)[R][C], T b, T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] += b);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] + b);
 }
 
-void mulMatrixSingleFallbackImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void mulMatrixSingleFallbackImplementation(const T (&a)[R][C], T b, T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] *= b);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] * b);
 }
 
-void divMatrixSingleFallbackImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename T, std::size_t R, std::size_t C>
+void divMatrixSingleFallbackImplementation(const T (&a)[R][C], T b, T (&result)[R][C]) requires(std::is_floating_point_v<T>)
 {
-    for (int i = 4; i--;)
-        for (int j = 4; j--; a[i][j] /= b);
+    for (std::size_t i = R; i--;)
+        for (std::size_t j = C; j--; result[i][j] = a[i][j] / b);
 }
 
-#ifdef __AVX512F__
-void subMatrixIntrinImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+// Product of two square matrices, result must not alias arguments
+template<typename T, std::size_t N>
+void dotMatrixFallbackImplementation(const T (&a)[N][N], const T (&b)[N][N], T (&result)[N][N]) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = N; i--;)
+        for (std::size_t j = N; j--;)
+        {
+            T accum = 0;
+            for (std::size_t k = N; k--; accum += a[i][k] * b[k][j]);
+            result[i][j] = accum;
+        }
+}
+
+// Result must not alias the argument
+template<typename T, std::size_t N>
+void transposeMatrixFallbackImplementation(const T (&a)[N][N], T (&result)[N][N]) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = N; i--;)
+        for (std::size_t j = N; j--; result[j][i] = a[i][j]);
+}
+
+/*
+ * Closed-form inverse (adjugate over determinant) of 3x3 and 4x4 matrices.
+ * 4x4 cofactors are built from 2x2 determinants of the upper (s) and
+ * lower (c) row pairs. Returns determinant, result is meaningless if it
+ * is zero. Result must not alias the argument
+ */
+template<typename T, std::size_t N>
+T inverseMatrixFallbackImplementation(const T (&a)[N][N], T (&result)[N][N]) requires(std::is_floating_point_v<T> && (N == 3 || N == 4))
+{
+    if constexpr (N == 3)
+    {
+        const T c00 = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+        const T c10 = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+        const T c20 = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+        const T det = a[0][0] * c00 + a[0][1] * c10 + a[0][2] * c20;
+        const T inv = T(1) / det;
+
+        result[0][0] = c00 * inv;
+        result[0][1] = (a[0][2] * a[2][1] - a[0][1] * a[2][2]) * inv;
+        result[0][2] = (a[0][1] * a[1][2] - a[0][2] * a[1][1]) * inv;
+        result[1][0] = c10 * inv;
+        result[1][1] = (a[0][0] * a[2][2] - a[0][2] * a[2][0]) * inv;
+        result[1][2] = (a[0][2] * a[1][0] - a[0][0] * a[1][2]) * inv;
+        result[2][0] = c20 * inv;
+        result[2][1] = (a[0][1] * a[2][0] - a[0][0] * a[2][1]) * inv;
+        result[2][2] = (a[0][0] * a[1][1] - a[0][1] * a[1][0]) * inv;
+        return det;
+    }
+    else
+    {
+        const T s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+        const T s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+        const T s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+        const T s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+        const T s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+        const T s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+
+        const T c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+        const T c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+        const T c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+        const T c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+        const T c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+        const T c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+        const T det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        const T inv = T(1) / det;
+
+        result[0][0] = ( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * inv;
+        result[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * inv;
+        result[0][2] = ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * inv;
+        result[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * inv;
+
+        result[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * inv;
+        result[1][1] = ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * inv;
+        result[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * inv;
+        result[1][3] = ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * inv;
+
+        result[2][0] = ( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * inv;
+        result[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * inv;
+        result[2][2] = ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * inv;
+        result[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * inv;
+
+        result[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * inv;
+        result[3][1] = ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * inv;
+        result[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * inv;
+        result[3][3] = ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * inv;
+        return det;
+    }
+}
+
+/*
+ * Element-wise kernels over matrix storage, seen as a flat array of R*C
+ * elements. Full registers go first, the rest is handled by a partial
+ * load/store, so no memory past the matrix is touched.
+ */
+template<typename Isa, typename T, std::size_t Size, typename Op>
+void elementwiseIntrinImplementation(const T *a, const T *b, T *result, Op op) noexcept
+{
+    using L = Lanes<T, Isa>;
+    std::size_t i = 0;
+    for (; i + L::Width <= Size; i += L::Width)
+        L::store(result + i, op(L::load(a + i), L::load(b + i)));
+    if constexpr (Size % L::Width != 0)
+        L::storePartial(result + i, op(L::loadPartial(a + i, Size - i),
+                                       L::loadPartial(b + i, Size - i)), Size - i);
+}
+
+template<typename Isa, typename T, std::size_t Size, typename Op>
+void elementwiseSingleIntrinImplementation(const T *a, T b, T *result, Op op) noexcept
+{
+    using L = Lanes<T, Isa>;
+    const auto single = L::set1(b);
+    std::size_t i = 0;
+    for (; i + L::Width <= Size; i += L::Width)
+        L::store(result + i, op(L::load(a + i), single));
+    if constexpr (Size % L::Width != 0)
+        L::storePartial(result + i, op(L::loadPartial(a + i, Size - i), single), Size - i);
+}
+
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void subMatrixIntrinImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C])
 {
-     _mm512_store_ps(result, _mm512_sub_ps(_mm512_load_ps(a), _mm512_load_ps(b)));
+    elementwiseIntrinImplementation<Isa, T, R * C>(&a[0][0], &b[0][0], &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::sub(x, y); });
 }
 
-void addMatrixIntrinImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void addMatrixIntrinImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C])
 {
-     _mm512_store_ps(result, _mm512_add_ps(_mm512_load_ps(a), _mm512_load_ps(b)));
+    elementwiseIntrinImplementation<Isa, T, R * C>(&a[0][0], &b[0][0], &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::add(x, y); });
 }
 
-void mulMatrixIntrinImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void mulMatrixIntrinImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C])
 {
-     _mm512_store_ps(result, _mm512_mul_ps(_mm512_load_ps(a), _mm512_load_ps(b)));
+    elementwiseIntrinImplementation<Isa, T, R * C>(&a[0][0], &b[0][0], &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::mul(x, y); });
 }
 
-void divMatrixIntrinImplementation(float (&a)[4][4], float (&b)[4][4], float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void divMatrixIntrinImplementation(const T (&a)[R][C], const T (&b)[R][C], T (&result)[R][C])
 {
-     _mm512_store_ps(result, _mm512_div_ps(_mm512_load_ps(a), _mm512_load_ps(b)));
+    elementwiseIntrinImplementation<Isa, T, R * C>(&a[0][0], &b[0][0], &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::div(x, y); });
 }
 
-void subMatrixSingleIntrinImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void subMatrixSingleIntrinImplementation(const T (&a)[R][C], T b, T (&result)[R][C])
 {
-    _mm512_store_ps(result, _mm512_sub_ps(_mm512_load_ps(a), _mm512_set1_ps(b)));
+    elementwiseSingleIntrinImplementation<Isa, T, R * C>(&a[0][0], b, &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::sub(x, y); });
 }
 
-void addMatrixSingleIntrinImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void addMatrixSingleIntrinImplementation(const T (&a)[R][C], T b, T (&result)[R][C])
 {
-    _mm512_store_ps(result, _mm512_add_ps(_mm512_load_ps(a), _mm512_set1_ps(b)));
+    elementwiseSingleIntrinImplementation<Isa, T, R * C>(&a[0][0], b, &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::add(x, y); });
 }
 
-void mulMatrixSingleIntrinImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void mulMatrixSingleIntrinImplementation(const T (&a)[R][C], T b, T (&result)[R][C])
 {
-    _mm512_store_ps(result, _mm512_mul_ps(_mm512_load_ps(a), _mm512_set1_ps(b)));
+    elementwiseSingleIntrinImplementation<Isa, T, R * C>(&a[0][0], b, &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::mul(x, y); });
 }
 
-void divMatrixSingleIntrinImplementation(float (&a)[4][4], float b, float (&result)[4][4])
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+void divMatrixSingleIntrinImplementation(const T (&a)[R][C], T b, T (&result)[R][C])
 {
-    _mm512_store_ps(result, _mm512_div_ps(_mm512_load_ps(a), _mm512_set1_ps(b)));
+    elementwiseSingleIntrinImplementation<Isa, T, R * C>(&a[0][0], b, &result[0][0],
+        [](auto x, auto y) { return Lanes<T, Isa>::div(x, y); });
+}
+
+/*
+ * Matrix product by row combination: every row of the result is a sum of
+ * rhs rows scaled by broadcast lhs elements. Rhs rows stay in registers.
+ * Shapes, which fit registers better, have specializations below.
+ */
+template<typename Isa, typename T, std::size_t N>
+void dotMatrixIntrinImplementation(const T (&a)[N][N], const T (&b)[N][N], T (&result)[N][N])
+{
+    using L = Lanes<T, Isa>;
+    constexpr std::size_t Chunks = (N + L::Width - 1) / L::Width;
+    constexpr std::size_t Tail = N - (Chunks - 1) * L::Width;
+
+    typename L::Register rows[N][Chunks];
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        for (std::size_t c = 0; c + 1 < Chunks; ++c)
+            rows[k][c] = L::load(&b[k][c * L::Width]);
+        if constexpr (Tail == L::Width)
+            rows[k][Chunks - 1] = L::load(&b[k][(Chunks - 1) * L::Width]);
+        else
+            rows[k][Chunks - 1] = L::loadPartial(&b[k][(Chunks - 1) * L::Width], Tail);
+    }
+
+    for (std::size_t i = 0; i < N; ++i)
+        for (std::size_t c = 0; c < Chunks; ++c)
+        {
+            auto accum = L::mul(L::set1(a[i][0]), rows[0][c]);
+            for (std::size_t k = 1; k < N; ++k)
+                accum = L::fmadd(L::set1(a[i][k]), rows[k][c], accum);
+
+            if (c + 1 < Chunks || Tail == L::Width)
+                L::store(&result[i][c * L::Width], accum);
+            else
+                L::storePartial(&result[i][c * L::Width], accum, Tail);
+        }
+}
+
+// unused lanes of registers, which hold a row of C numbers
+template<typename T, typename Isa, std::size_t C>
+inline constexpr std::size_t DotWaste = (C + Lanes<T, Isa>::Width - 1) / Lanes<T, Isa>::Width * Lanes<T, Isa>::Width - C;
+
+/*
+ * Registers of fixed-size product, which waste the fewest lanes on rows
+ * of C numbers, wider ones win ties: 8 floats per row take AVX2, even
+ * if AVX-512 is available, as masked loads and stores are slower
+ */
+template<typename Isa, typename T, std::size_t C>
+struct DotIsa
+{
+    using Type = Isa;
+};
+
+template<typename T, std::size_t C>
+struct DotIsa<AVX2, T, C>
+{
+    using Type = std::conditional_t<(DotWaste<T, AVX2, C> <= DotWaste<T, SSE, C>), AVX2, SSE>;
+};
+
+template<typename T, std::size_t C>
+struct DotIsa<AVX512, T, C>
+{
+    using Narrower = typename DotIsa<AVX2, T, C>::Type;
+    using Type = std::conditional_t<(DotWaste<T, AVX512, C> <= DotWaste<T, Narrower, C>), AVX512, Narrower>;
+};
+
+/*
+ * Register tile of product of fixed-size matrices: Rows of result by
+ * Columns, which take Registers of L. Narrow results take more rows,
+ * so all accumulators (12 of 16 registers, 24 of 32) have independent sums
+ */
+template<typename Isa, typename L, std::size_t R, std::size_t C>
+struct DotTile
+{
+    static constexpr std::size_t Width = L::Width;
+    static constexpr std::size_t Accumulators = std::is_same_v<Isa, AVX512> ? 24 : 12;
+    static constexpr std::size_t Chunks = (C + Width - 1) / Width;
+    static constexpr std::size_t Rows = std::min(R, Accumulators / std::min<std::size_t>(Chunks, 2));
+    static constexpr std::size_t Registers = std::min(Chunks, Accumulators / Rows);
+    static constexpr std::size_t Columns = std::min(C, Registers * Width);
+};
+
+/*
+ * Rows x Columns block of result in i-k-j order: step k adds broadcast
+ * elements of k-th column of a block times k-th row of b block. Sizes are
+ * compile-time, so loops are unrolled and sums stay in registers. Narrow
+ * last register reads whole register, if b has enough numbers after
+ * the row, extra lanes are never stored
+ */
+template<typename L, std::size_t Rows, std::size_t Columns, std::size_t K, std::size_t C>
+void dotTile(const typename L::Type *a, const typename L::Type *b, typename L::Type *result) noexcept
+{
+    using Register = typename L::Register;
+    constexpr std::size_t Registers = (Columns + L::Width - 1) / L::Width;
+    constexpr std::size_t Tail = Columns - (Registers - 1) * L::Width;
+    // last rows of b, which are followed by less than Width - Tail numbers
+    constexpr std::size_t Overrun = (L::Width - Tail + C - 1) / C;
+    constexpr std::size_t FullRows = K > Overrun ? K - Overrun : 0;
+
+    Register acc[Rows][Registers];
+    for (std::size_t r = 0; r < Rows; ++r)
+        for (std::size_t j = 0; j < Registers; ++j)
+            acc[r][j] = L::zero();
+    auto step = [&](std::size_t k, bool partial) {
+        Register row[Registers];
+        for (std::size_t j = 0; j < Registers; ++j)
+            row[j] = partial && j + 1 == Registers ? L::loadPartial(b + k * C + j * L::Width, Tail)
+                                                   : L::load(b + k * C + j * L::Width);
+        for (std::size_t r = 0; r < Rows; ++r)
+        {
+            const Register x = L::set1(a[r * K + k]);
+            for (std::size_t j = 0; j < Registers; ++j)
+                acc[r][j] = L::fmadd(x, row[j], acc[r][j]);
+        }
+    };
+    for (std::size_t k = 0; k < FullRows; ++k)
+        step(k, false);
+    for (std::size_t k = FullRows; k < K; ++k)
+        step(k, true);
+
+    for (std::size_t r = 0; r < Rows; ++r)
+        for (std::size_t j = 0; j < Registers; ++j)
+            if (j + 1 < Registers || Tail == L::Width)
+                L::store(result + r * C + j * L::Width, acc[r][j]);
+            else
+                L::storePartial(result + r * C + j * L::Width, acc[r][j], Tail);
+}
+
+// Column block of result by tiles of Tile::Rows rows and the last narrow one
+template<typename L, typename Tile, std::size_t Columns, std::size_t R, std::size_t K, std::size_t C>
+void dotTileColumn(const typename L::Type *a, const typename L::Type *b, typename L::Type *result) noexcept
+{
+    std::size_t i = 0;
+    for (; i + Tile::Rows <= R; i += Tile::Rows)
+        dotTile<L, Tile::Rows, Columns, K, C>(a + i * K, b, result + i * C);
+    if constexpr (R % Tile::Rows != 0)
+        dotTile<L, R % Tile::Rows, Columns, K, C>(a + i * K, b, result + i * C);
+}
+
+/*
+ * Product of matrices of any fixed sizes, result must not alias arguments.
+ * Isa is the widest instruction set of the build (Scalar runs integer
+ * matrices), so there are no Optimizer tables for every size
+ */
+template<typename Isa, typename T, std::size_t R, std::size_t K, std::size_t C>
+void dotGenericIntrinImplementation(const T (&a)[R][K], const T (&b)[K][C], T (&result)[R][C]) noexcept
+{
+    using L = Lanes<T, typename DotIsa<Isa, T, C>::Type>;
+    using Tile = DotTile<Isa, L, R, C>;
+    std::size_t j = 0;
+    for (; j + Tile::Columns <= C; j += Tile::Columns)
+        dotTileColumn<L, Tile, Tile::Columns, R, K, C>(&a[0][0], &b[0][j], &result[0][j]);
+    if constexpr (C % Tile::Columns != 0)
+        dotTileColumn<L, Tile, C % Tile::Columns, R, K, C>(&a[0][0], &b[0][j], &result[0][j]);
+}
+
+// Transposition kernels exist only for the specializations below
+template<typename Isa, typename T, std::size_t N>
+void transposeMatrixIntrinImplementation(const T (&a)[N][N], T (&result)[N][N]);
+
+// Inverse kernels exist only for the specializations below
+template<typename Isa, typename T, std::size_t N>
+T inverseMatrixIntrinImplementation(const T (&a)[N][N], T (&result)[N][N]);
+
+#ifdef __SSE2__
+// whole 2x2 matrix in one register
+template<>
+inline void dotMatrixIntrinImplementation<SSE, float, 2>(const float (&a)[2][2], const float (&b)[2][2], float (&result)[2][2])
+{
+    const __m128 lhs = _mm_loadu_ps(&a[0][0]);
+    const __m128 rhs = _mm_loadu_ps(&b[0][0]);
+    const __m128 res = _mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2,2,0,0)), _mm_movelh_ps(rhs, rhs)),
+                                  _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(3,3,1,1)), _mm_movehl_ps(rhs, rhs)));
+    _mm_storeu_ps(&result[0][0], res);
+}
+
+/*
+ * 3x3 rows are 3 floats long, so rows are loaded and stored as overlapping
+ * 4-float chunks, the last row is shifted, to stay inside of the matrix
+ */
+template<>
+inline void dotMatrixIntrinImplementation<SSE, float, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&result)[3][3])
+{
+    const float *rhs = &b[0][0];
+    const __m128 row0 = _mm_loadu_ps(rhs);
+    const __m128 row1 = _mm_loadu_ps(rhs + 3);
+    __m128 row2 = _mm_loadu_ps(rhs + 5);
+    row2 = _mm_shuffle_ps(row2, row2, _MM_SHUFFLE(3,3,2,1));
+
+    __m128 res[3];
+    for (std::size_t i = 0; i < 3; ++i)
+        res[i] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[i][0]), row0),
+                                       _mm_mul_ps(_mm_set1_ps(a[i][1]), row1)),
+                            _mm_mul_ps(_mm_set1_ps(a[i][2]), row2));
+
+    float *out = &result[0][0];
+    _mm_storeu_ps(out, res[0]);
+    _mm_storeu_ps(out + 3, res[1]);
+    const __m128 tmp = _mm_shuffle_ps(res[1], res[2], _MM_SHUFFLE(0,0,2,2));
+    _mm_storeu_ps(out + 5, _mm_shuffle_ps(tmp, res[2], _MM_SHUFFLE(2,1,2,0)));
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, float, 2>(const float (&a)[2][2], float (&result)[2][2])
+{
+    const __m128 m = _mm_loadu_ps(&a[0][0]);
+    _mm_storeu_ps(&result[0][0], _mm_shuffle_ps(m, m, _MM_SHUFFLE(3,1,2,0)));
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, double, 2>(const double (&a)[2][2], double (&result)[2][2])
+{
+    const __m128d row0 = _mm_loadu_pd(a[0]);
+    const __m128d row1 = _mm_loadu_pd(a[1]);
+    _mm_storeu_pd(result[0], _mm_unpacklo_pd(row0, row1));
+    _mm_storeu_pd(result[1], _mm_unpackhi_pd(row0, row1));
+}
+
+// transpose by 2x2 blocks
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, double, 4>(const double (&a)[4][4], double (&result)[4][4])
+{
+    for (std::size_t i = 0; i < 4; i += 2)
+        for (std::size_t j = 0; j < 4; j += 2)
+        {
+            const __m128d row0 = _mm_loadu_pd(&a[i][j]);
+            const __m128d row1 = _mm_loadu_pd(&a[i + 1][j]);
+            _mm_storeu_pd(&result[j][i], _mm_unpacklo_pd(row0, row1));
+            _mm_storeu_pd(&result[j + 1][i], _mm_unpackhi_pd(row0, row1));
+        }
+}
+
+/*
+ * Blockwise inverse, 2x2 blocks A B / C D of the matrix are kept in one
+ * register each, X# notation is for adjugate of X:
+ *   M^-1 = 1/|M| * | (|D|A - B(D#C))#   (|B|C - D(A#B)#)# |
+ *                  | (|C|B - A(D#C)#)#  (|A|D - C(A#B))#  |
+ *   |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+ */
+template<>
+inline float inverseMatrixIntrinImplementation<SSE, float, 4>(const float (&a)[4][4], float (&result)[4][4])
+{
+    // 2x2 row-major block products: X*Y, X#*Y, X*Y#
+    constexpr auto mul2 = [](__m128 x, __m128 y)
+    {
+        return _mm_add_ps(_mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(3,0,3,0))),
+                          _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1,2,1,2))));
+    };
+    constexpr auto adjMul2 = [](__m128 x, __m128 y)
+    {
+        return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(0,0,3,3)), y),
+                          _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,2,1,1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1,0,3,2))));
+    };
+    constexpr auto mulAdj2 = [](__m128 x, __m128 y)
+    {
+        return _mm_sub_ps(_mm_mul_ps(x, _mm_shuffle_ps(y, y, _MM_SHUFFLE(0,3,0,3))),
+                          _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1,2,1,2))));
+    };
+
+    const __m128 r0 = _mm_loadu_ps(a[0]);
+    const __m128 r1 = _mm_loadu_ps(a[1]);
+    const __m128 r2 = _mm_loadu_ps(a[2]);
+    const __m128 r3 = _mm_loadu_ps(a[3]);
+
+    const __m128 A = _mm_movelh_ps(r0, r1);
+    const __m128 B = _mm_movehl_ps(r1, r0);
+    const __m128 C = _mm_movelh_ps(r2, r3);
+    const __m128 D = _mm_movehl_ps(r3, r2);
+
+    // (|A| |B| |C| |D|)
+    const __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2,0,2,0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3,1,3,1))),
+        _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3,1,3,1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2,0,2,0))));
+    const __m128 detA = _mm_shuffle_ps(detSub, detSub, 0x00);
+    const __m128 detB = _mm_shuffle_ps(detSub, detSub, 0x55);
+    const __m128 detC = _mm_shuffle_ps(detSub, detSub, 0xAA);
+    const __m128 detD = _mm_shuffle_ps(detSub, detSub, 0xFF);
+
+    const __m128 DC = adjMul2(D, C);
+    const __m128 AB = adjMul2(A, B);
+    __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), mul2(B, DC));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), mul2(C, AB));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), mulAdj2(D, AB));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), mulAdj2(A, DC));
+
+    __m128 tr = _mm_mul_ps(AB, _mm_shuffle_ps(DC, DC, _MM_SHUFFLE(3,1,2,0)));
+    tr = _mm_add_ps(tr, _mm_movehl_ps(tr, tr));
+    tr = _mm_add_ps(tr, _mm_shuffle_ps(tr, tr, 0x55));
+    tr = _mm_shuffle_ps(tr, tr, 0x00);
+    const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), tr);
+
+    // adjugate signs of the blocks are folded into reciprocal
+    const __m128 rDetM = _mm_div_ps(_mm_setr_ps(1.f, -1.f, -1.f, 1.f), detM);
+    X = _mm_mul_ps(X, rDetM);
+    Y = _mm_mul_ps(Y, rDetM);
+    Z = _mm_mul_ps(Z, rDetM);
+    W = _mm_mul_ps(W, rDetM);
+
+    // adjugate and block layout shuffles are combined
+    _mm_storeu_ps(result[0], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(1,3,1,3)));
+    _mm_storeu_ps(result[1], _mm_shuffle_ps(X, Y, _MM_SHUFFLE(0,2,0,2)));
+    _mm_storeu_ps(result[2], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(1,3,1,3)));
+    _mm_storeu_ps(result[3], _mm_shuffle_ps(Z, W, _MM_SHUFFLE(0,2,0,2)));
+    return _mm_cvtss_f32(detM);
+}
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+inline void dotMatrixIntrinImplementation<AVX2, double, 2>(const double (&a)[2][2], const double (&b)[2][2], double (&result)[2][2])
+{
+    const __m256d lhs = _mm256_loadu_pd(&a[0][0]);
+    const __m256d rhs = _mm256_loadu_pd(&b[0][0]);
+    const __m256d res = _mm256_fmadd_pd(_mm256_permute4x64_pd(lhs, _MM_SHUFFLE(2,2,0,0)),
+                                        _mm256_permute4x64_pd(rhs, _MM_SHUFFLE(1,0,1,0)),
+                                        _mm256_mul_pd(_mm256_permute4x64_pd(lhs, _MM_SHUFFLE(3,3,1,1)),
+                                                      _mm256_permute4x64_pd(rhs, _MM_SHUFFLE(3,2,3,2))));
+    _mm256_storeu_pd(&result[0][0], res);
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX2, double, 2>(const double (&a)[2][2], double (&result)[2][2])
+{
+    const __m256d m = _mm256_loadu_pd(&a[0][0]);
+    _mm256_storeu_pd(&result[0][0], _mm256_permute4x64_pd(m, _MM_SHUFFLE(3,1,2,0)));
+}
+
+// first 8 elements are permuted in one register, the last one is on diagonal
+template<>
+inline void transposeMatrixIntrinImplementation<AVX2, float, 3>(const float (&a)[3][3], float (&result)[3][3])
+{
+    const __m256 m = _mm256_loadu_ps(&a[0][0]);
+    _mm256_storeu_ps(&result[0][0], _mm256_permutevar8x32_ps(m, _mm256_setr_epi32(0, 3, 6, 1, 4, 7, 2, 5)));
+    result[2][2] = a[2][2];
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX2, double, 4>(const double (&a)[4][4], double (&result)[4][4])
+{
+    const __m256d row0 = _mm256_loadu_pd(a[0]);
+    const __m256d row1 = _mm256_loadu_pd(a[1]);
+    const __m256d row2 = _mm256_loadu_pd(a[2]);
+    const __m256d row3 = _mm256_loadu_pd(a[3]);
+
+    const __m256d t0 = _mm256_unpacklo_pd(row0, row1);
+    const __m256d t1 = _mm256_unpackhi_pd(row0, row1);
+    const __m256d t2 = _mm256_unpacklo_pd(row2, row3);
+    const __m256d t3 = _mm256_unpackhi_pd(row2, row3);
+
+    _mm256_storeu_pd(result[0], _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(result[1], _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(result[2], _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(result[3], _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+// two rows of the result per register, rhs rows are repeated in both lanes
+template<>
+inline void dotMatrixIntrinImplementation<AVX2, float, 4>(const float (&a)[4][4], const float (&b)[4][4], float (&result)[4][4])
+{
+    const __m256 rows[4] = {_mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[0])),
+                            _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[1])),
+                            _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[2])),
+                            _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[3]))};
+    for (std::size_t i = 0; i < 4; i += 2)
+    {
+        const __m256 lhs = _mm256_loadu_ps(a[i]);
+        __m256 res = _mm256_mul_ps(_mm256_permute_ps(lhs, 0x00), rows[0]);
+        res = _mm256_fmadd_ps(_mm256_permute_ps(lhs, 0x55), rows[1], res);
+        res = _mm256_fmadd_ps(_mm256_permute_ps(lhs, 0xAA), rows[2], res);
+        res = _mm256_fmadd_ps(_mm256_permute_ps(lhs, 0xFF), rows[3], res);
+        _mm256_storeu_ps(result[i], res);
+    }
+}
+
+// same blockwise scheme as SSE float version, 2x2 double blocks fill one register
+template<>
+inline double inverseMatrixIntrinImplementation<AVX2, double, 4>(const double (&a)[4][4], double (&result)[4][4])
+{
+    constexpr auto mul2 = [](__m256d x, __m256d y)
+    {
+        return _mm256_fmadd_pd(x, _mm256_permute4x64_pd(y, _MM_SHUFFLE(3,0,3,0)),
+                               _mm256_mul_pd(_mm256_permute_pd(x, 0b0101), _mm256_permute4x64_pd(y, _MM_SHUFFLE(1,2,1,2))));
+    };
+    constexpr auto adjMul2 = [](__m256d x, __m256d y)
+    {
+        return _mm256_fmsub_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(0,0,3,3)), y,
+                               _mm256_mul_pd(_mm256_permute4x64_pd(x, _MM_SHUFFLE(2,2,1,1)), _mm256_permute4x64_pd(y, _MM_SHUFFLE(1,0,3,2))));
+    };
+    constexpr auto mulAdj2 = [](__m256d x, __m256d y)
+    {
+        return _mm256_fmsub_pd(x, _mm256_permute4x64_pd(y, _MM_SHUFFLE(0,3,0,3)),
+                               _mm256_mul_pd(_mm256_permute_pd(x, 0b0101), _mm256_permute4x64_pd(y, _MM_SHUFFLE(1,2,1,2))));
+    };
+
+    const __m256d r0 = _mm256_loadu_pd(a[0]);
+    const __m256d r1 = _mm256_loadu_pd(a[1]);
+    const __m256d r2 = _mm256_loadu_pd(a[2]);
+    const __m256d r3 = _mm256_loadu_pd(a[3]);
+
+    const __m256d A = _mm256_permute2f128_pd(r0, r1, 0x20);
+    const __m256d B = _mm256_permute2f128_pd(r0, r1, 0x31);
+    const __m256d C = _mm256_permute2f128_pd(r2, r3, 0x20);
+    const __m256d D = _mm256_permute2f128_pd(r2, r3, 0x31);
+
+    // (|A| |C| |B| |D|)
+    const __m256d detSub = _mm256_fmsub_pd(_mm256_unpacklo_pd(r0, r2), _mm256_unpackhi_pd(r1, r3),
+                                           _mm256_mul_pd(_mm256_unpackhi_pd(r0, r2), _mm256_unpacklo_pd(r1, r3)));
+    const __m256d detA = _mm256_permute4x64_pd(detSub, 0x00);
+    const __m256d detC = _mm256_permute4x64_pd(detSub, 0x55);
+    const __m256d detB = _mm256_permute4x64_pd(detSub, 0xAA);
+    const __m256d detD = _mm256_permute4x64_pd(detSub, 0xFF);
+
+    const __m256d DC = adjMul2(D, C);
+    const __m256d AB = adjMul2(A, B);
+    __m256d X = _mm256_fmsub_pd(detD, A, mul2(B, DC));
+    __m256d W = _mm256_fmsub_pd(detA, D, mul2(C, AB));
+    __m256d Y = _mm256_fmsub_pd(detB, C, mulAdj2(D, AB));
+    __m256d Z = _mm256_fmsub_pd(detC, B, mulAdj2(A, DC));
+
+    __m256d tr = _mm256_mul_pd(AB, _mm256_permute4x64_pd(DC, _MM_SHUFFLE(3,1,2,0)));
+    tr = _mm256_add_pd(tr, _mm256_permute4x64_pd(tr, _MM_SHUFFLE(1,0,3,2)));
+    tr = _mm256_add_pd(tr, _mm256_permute_pd(tr, 0b0101));
+    const __m256d detM = _mm256_sub_pd(_mm256_fmadd_pd(detA, detD, _mm256_mul_pd(detB, detC)), tr);
+
+    const __m256d rDetM = _mm256_div_pd(_mm256_setr_pd(1., -1., -1., 1.), detM);
+    X = _mm256_mul_pd(X, rDetM);
+    Y = _mm256_mul_pd(Y, rDetM);
+    Z = _mm256_mul_pd(Z, rDetM);
+    W = _mm256_mul_pd(W, rDetM);
+
+    _mm256_storeu_pd(result[0], _mm256_permute4x64_pd(_mm256_unpackhi_pd(X, Y), _MM_SHUFFLE(1,3,0,2)));
+    _mm256_storeu_pd(result[1], _mm256_permute4x64_pd(_mm256_unpacklo_pd(X, Y), _MM_SHUFFLE(1,3,0,2)));
+    _mm256_storeu_pd(result[2], _mm256_permute4x64_pd(_mm256_unpackhi_pd(Z, W), _MM_SHUFFLE(1,3,0,2)));
+    _mm256_storeu_pd(result[3], _mm256_permute4x64_pd(_mm256_unpacklo_pd(Z, W), _MM_SHUFFLE(1,3,0,2)));
+    return _mm256_cvtsd_f64(detM);
+}
+#endif
+
+#ifdef __AVX512F__
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+/*
+ * Whole 3x3 matrix in one register: result = sum over k of
+ * (a[i][k] spread over row i) * (row k of b repeated for every row)
+ */
+template<>
+inline void dotMatrixIntrinImplementation<AVX512, float, 3>(const float (&a)[3][3], const float (&b)[3][3], float (&result)[3][3])
+{
+    constexpr __mmask16 mask = 0x1FF;
+    const __m512 lhs = _mm512_maskz_loadu_ps(mask, &a[0][0]);
+    const __m512 rhs = _mm512_maskz_loadu_ps(mask, &b[0][0]);
+
+    __m512 res = _mm512_mul_ps(
+        _mm512_permutexvar_ps(_mm512_setr_epi32(0,0,0,3,3,3,6,6,6,0,0,0,0,0,0,0), lhs),
+        _mm512_permutexvar_ps(_mm512_setr_epi32(0,1,2,0,1,2,0,1,2,0,0,0,0,0,0,0), rhs));
+    res = _mm512_fmadd_ps(
+        _mm512_permutexvar_ps(_mm512_setr_epi32(1,1,1,4,4,4,7,7,7,0,0,0,0,0,0,0), lhs),
+        _mm512_permutexvar_ps(_mm512_setr_epi32(3,4,5,3,4,5,3,4,5,0,0,0,0,0,0,0), rhs), res);
+    res = _mm512_fmadd_ps(
+        _mm512_permutexvar_ps(_mm512_setr_epi32(2,2,2,5,5,5,8,8,8,0,0,0,0,0,0,0), lhs),
+        _mm512_permutexvar_ps(_mm512_setr_epi32(6,7,8,6,7,8,6,7,8,0,0,0,0,0,0,0), rhs), res);
+
+    _mm512_mask_storeu_ps(&result[0][0], mask, res);
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+
+// first 8 elements of the result in one register, 9th element is done in scalar
+template<>
+inline void dotMatrixIntrinImplementation<AVX512, double, 3>(const double (&a)[3][3], const double (&b)[3][3], double (&result)[3][3])
+{
+    const double *lhs = &a[0][0];
+    const double *rhs = &b[0][0];
+    const __m512d lhsLo = _mm512_loadu_pd(lhs);
+    const __m512d lhsHi = _mm512_maskz_loadu_pd(1, lhs + 8);
+    const __m512d rhsLo = _mm512_loadu_pd(rhs);
+    const __m512d rhsHi = _mm512_maskz_loadu_pd(1, rhs + 8);
+
+    __m512d res = _mm512_mul_pd(
+        _mm512_permutex2var_pd(lhsLo, _mm512_setr_epi64(0,0,0,3,3,3,6,6), lhsHi),
+        _mm512_permutex2var_pd(rhsLo, _mm512_setr_epi64(0,1,2,0,1,2,0,1), rhsHi));
+    res = _mm512_fmadd_pd(
+        _mm512_permutex2var_pd(lhsLo, _mm512_setr_epi64(1,1,1,4,4,4,7,7), lhsHi),
+        _mm512_permutex2var_pd(rhsLo, _mm512_setr_epi64(3,4,5,3,4,5,3,4), rhsHi), res);
+    res = _mm512_fmadd_pd(
+        _mm512_permutex2var_pd(lhsLo, _mm512_setr_epi64(2,2,2,5,5,5,8,8), lhsHi),
+        _mm512_permutex2var_pd(rhsLo, _mm512_setr_epi64(6,7,8,6,7,8,6,7), rhsHi), res);
+
+    _mm512_storeu_pd(&result[0][0], res);
+    result[2][2] = a[2][0] * b[0][2] + a[2][1] * b[1][2] + a[2][2] * b[2][2];
+}
+
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+// two rows of the result per register
+template<>
+inline void dotMatrixIntrinImplementation<AVX512, double, 4>(const double (&a)[4][4], const double (&b)[4][4], double (&result)[4][4])
+{
+    __m512d rows[4];
+    for (std::size_t k = 0; k < 4; ++k)
+        rows[k] = _mm512_broadcast_f64x4(_mm256_loadu_pd(b[k]));
+
+    const __m512i spread[4] = {_mm512_setr_epi64(0,0,0,0,4,4,4,4),
+                               _mm512_setr_epi64(1,1,1,1,5,5,5,5),
+                               _mm512_setr_epi64(2,2,2,2,6,6,6,6),
+                               _mm512_setr_epi64(3,3,3,3,7,7,7,7)};
+    for (std::size_t i = 0; i < 4; i += 2)
+    {
+        const __m512d lhs = _mm512_loadu_pd(a[i]);
+        __m512d res = _mm512_mul_pd(_mm512_permutexvar_pd(spread[0], lhs), rows[0]);
+        for (std::size_t k = 1; k < 4; ++k)
+            res = _mm512_fmadd_pd(_mm512_permutexvar_pd(spread[k], lhs), rows[k], res);
+        _mm512_storeu_pd(result[i], res);
+    }
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+// whole 4x4 matrix in one register, one row per 128-bit lane
+template<>
+inline void dotMatrixIntrinImplementation<AVX512, float, 4>(const float (&a)[4][4], const float (&b)[4][4], float (&result)[4][4])
+{
+    const __m512 lhs = _mm512_loadu_ps(&a[0][0]);
+    __m512 res = _mm512_mul_ps(_mm512_permute_ps(lhs, 0x00), _mm512_broadcast_f32x4(_mm_loadu_ps(b[0])));
+    res = _mm512_fmadd_ps(_mm512_permute_ps(lhs, 0x55), _mm512_broadcast_f32x4(_mm_loadu_ps(b[1])), res);
+    res = _mm512_fmadd_ps(_mm512_permute_ps(lhs, 0xAA), _mm512_broadcast_f32x4(_mm_loadu_ps(b[2])), res);
+    res = _mm512_fmadd_ps(_mm512_permute_ps(lhs, 0xFF), _mm512_broadcast_f32x4(_mm_loadu_ps(b[3])), res);
+    _mm512_storeu_ps(&result[0][0], res);
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+template<>
+inline void transposeMatrixIntrinImplementation<AVX512, float, 3>(const float (&a)[3][3], float (&result)[3][3])
+{
+    constexpr __mmask16 mask = 0x1FF;
+    const __m512 m = _mm512_maskz_loadu_ps(mask, &a[0][0]);
+    _mm512_mask_storeu_ps(&result[0][0], mask,
+        _mm512_permutexvar_ps(_mm512_setr_epi32(0,3,6,1,4,7,2,5,8,0,0,0,0,0,0,0), m));
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX512, double, 3>(const double (&a)[3][3], double (&result)[3][3])
+{
+    const __m512d m = _mm512_loadu_pd(&a[0][0]);
+    _mm512_storeu_pd(&result[0][0], _mm512_permutexvar_pd(_mm512_setr_epi64(0,3,6,1,4,7,2,5), m));
+    result[2][2] = a[2][2];
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX512, double, 4>(const double (&a)[4][4], double (&result)[4][4])
+{
+    const __m512d lo = _mm512_loadu_pd(a[0]);
+    const __m512d hi = _mm512_loadu_pd(a[2]);
+    _mm512_storeu_pd(result[0], _mm512_permutex2var_pd(lo, _mm512_setr_epi64(0,4,8,12,1,5,9,13), hi));
+    _mm512_storeu_pd(result[2], _mm512_permutex2var_pd(lo, _mm512_setr_epi64(2,6,10,14,3,7,11,15), hi));
 }
 #endif
 
+/*
+ * Products of matrix arrays: result[i] = a[i] * b[i].
+ * Kernel is called directly, so there is one indirect call per batch
+ */
+template<typename T, std::size_t N>
+void dotMatrixBatchFallbackImplementation(const T (*a)[N][N], const T (*b)[N][N], T (*result)[N][N], std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        dotMatrixFallbackImplementation<T, N>(a[i], b[i], result[i]);
+}
+
+template<typename Isa, typename T, std::size_t N>
+void dotMatrixBatchIntrinImplementation(const T (*a)[N][N], const T (*b)[N][N], T (*result)[N][N], std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        dotMatrixIntrinImplementation<Isa, T, N>(a[i], b[i], result[i]);
+}
+
 }
 
 /*
@@ -0,0 +1,277 @@
+#pragma once
+/*
+ * File contains non-owning strided views of matrices and vectors
+ *
+ * MatrixView<T,R,C,Stride> sees "count" matrices in memory it doesn't own
+ * (mapped files, staging buffers, interleaved vertex formats): every one
+ * is R * C packed row-major numbers, the next one starts Stride bytes
+ * further. Stride is a compile-time constant or, for DynamicStride,
+ * given at run time. Views of const T are read-only. Single matrices are
+ * accessed through proxies, which convert to and from LA::Matrix.
+ *
+ * forEachBlock() runs batch kernels, which take arrays of matrices,
+ * over views. Packed views are passed as they are, strided ones are
+ * gathered into and scattered from small blocks, which stay in L1 cache.
+*/
+
+#include "matrix.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+// stride given at run time
+inline constexpr std::size_t DynamicStride = 0;
+
+template <typename T, std::size_t R, std::size_t C, std::size_t Stride = DynamicStride>
+class MatrixView
+{
+    using Byte = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+public:
+    using Type = std::remove_const_t<T>;
+    using Value = Matrix<Type, R, C>;
+    static constexpr std::size_t Rows = R;
+    static constexpr std::size_t Columns = C;
+    // bytes of packed matrix
+    static constexpr std::size_t PackedStride = R * C * sizeof(T);
+
+    static_assert(Stride == DynamicStride || (Stride >= PackedStride && Stride % alignof(T) == 0),
+                  "Stride must fit the matrix and keep its numbers aligned");
+
+    // Proxy to the matrix stored at index
+    class Reference
+    {
+    public:
+        explicit Reference(T *p) noexcept : _p(p) {}
+
+        operator Value() const noexcept { return read(_p); }
+        Reference &operator=(const Value &m) noexcept
+        {
+            write(_p, m);
+            return *this;
+        }
+        Reference &operator=(const Reference &r) noexcept { return *this = Value(r); }
+        T &operator()(std::size_t row, std::size_t column) const noexcept
+        {
+            assert(row < R && column < C);
+            return _p[row * C + column];
+        }
+        // numbers of vectors
+        T &operator[](std::size_t k) const noexcept
+        {
+            assert(k < R * C);
+            return _p[k];
+        }
+
+        template <typename U>
+        Reference &operator+=(const U &rhs) noexcept requires requires(Value m) { m += rhs; }
+        {
+            Value m = *this;
+            return *this = m += rhs;
+        }
+        template <typename U>
+        Reference &operator-=(const U &rhs) noexcept requires requires(Value m) { m -= rhs; }
+        {
+            Value m = *this;
+            return *this = m -= rhs;
+        }
+        template <typename U>
+        Reference &operator*=(const U &rhs) noexcept requires requires(Value m) { m *= rhs; }
+        {
+            Value m = *this;
+            return *this = m *= rhs;
+        }
+        template <typename U>
+        Reference &operator/=(const U &rhs) noexcept requires requires(Value m) { m /= rhs; }
+        {
+            Value m = *this;
+            return *this = m /= rhs;
+        }
+
+        friend bool operator==(const Reference &lhs, const Value &rhs) { return Value(lhs) == rhs; }
+        friend bool operator!=(const Reference &lhs, const Value &rhs) { return Value(lhs) != rhs; }
+
+    private:
+        T *_p;
+    };
+
+    MatrixView() noexcept = default;
+    // count matrices, the first one at data, packed ones for DynamicStride
+    MatrixView(T *data, std::size_t count) noexcept
+        : MatrixView(data, count, Stride == DynamicStride ? PackedStride : Stride)
+    {}
+    MatrixView(T *data, std::size_t count, std::size_t stride) noexcept : _data(data), _size(count), _stride(stride)
+    {
+        assert(Stride == DynamicStride || stride == Stride);
+        assert(stride >= PackedStride && stride % alignof(T) == 0);
+        assert(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0);
+    }
+    // Array of matrices, if they aren't padded
+    MatrixView(std::conditional_t<std::is_const_v<T>, const Value, Value> *aos, std::size_t count) noexcept
+        requires(sizeof(Value) == PackedStride && (Stride == DynamicStride || Stride == PackedStride))
+        : MatrixView(reinterpret_cast<T *>(aos), count, PackedStride)
+    {}
+    // Read-only view of the same matrices
+    template <std::size_t S>
+    MatrixView(const MatrixView<Type, R, C, S> &v) noexcept
+        requires(std::is_const_v<T> && (Stride == DynamicStride || S == Stride))
+        : MatrixView(v.data(), v.size(), v.stride())
+    {}
+
+    std::size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    std::size_t stride() const noexcept
+    {
+        if constexpr (Stride == DynamicStride)
+            return _stride;
+        else
+            return Stride;
+    }
+    // numbers of the first matrix
+    T *data() const noexcept { return _data; }
+    // matrices follow each other without gaps and may be used as array of Value
+    bool packed() const noexcept
+    {
+        return stride() == PackedStride && sizeof(Value) == PackedStride &&
+               reinterpret_cast<std::uintptr_t>(_data) % alignof(Value) == 0;
+    }
+
+    // numbers of matrix at index
+    T *element(std::size_t i) const noexcept
+    {
+        assert(i < _size);
+        return reinterpret_cast<T *>(reinterpret_cast<Byte *>(_data) + i * stride());
+    }
+    Value at(std::size_t i) const noexcept { return read(element(i)); }
+    void set(std::size_t i, const Value &m) const noexcept requires(!std::is_const_v<T>) { write(element(i), m); }
+    Reference operator[](std::size_t i) const noexcept requires(!std::is_const_v<T>) { return Reference(element(i)); }
+    Value operator[](std::size_t i) const noexcept requires(std::is_const_v<T>) { return at(i); }
+
+    // count matrices, starting from first
+    MatrixView subview(std::size_t first, std::size_t count) const noexcept
+    {
+        assert(first + count <= _size);
+        return MatrixView(count ? element(first) : _data, count, stride());
+    }
+
+    // Conversion from and to array of matrices
+    void assign(const Value *aos) const noexcept requires(!std::is_const_v<T>)
+    {
+        for (std::size_t i = 0; i < _size; ++i)
+            write(element(i), aos[i]);
+    }
+    void store(Value *aos) const noexcept
+    {
+        for (std::size_t i = 0; i < _size; ++i)
+            read(element(i), aos[i]);
+    }
+
+private:
+    // unpadded matrices are copied as a whole, without temporary copies
+    static void read(const T *p, Value &m) noexcept
+    {
+        if constexpr (sizeof(Value) == PackedStride)
+            std::memcpy(static_cast<void *>(&m), p, PackedStride);
+        else
+            for (std::size_t r = 0; r < R; ++r)
+                for (std::size_t c = 0; c < C; ++c)
+                    entry(m, r, c) = p[r * C + c];
+    }
+    static Value read(const T *p) noexcept
+    {
+        Value m;
+        read(p, m);
+        return m;
+    }
+    static void write(T *p, const Value &m) noexcept
+    {
+        if constexpr (sizeof(Value) == PackedStride)
+            std::memcpy(p, static_cast<const void *>(&m), PackedStride);
+        else
+            for (std::size_t r = 0; r < R; ++r)
+                for (std::size_t c = 0; c < C; ++c)
+                    p[r * C + c] = entry(m, r, c);
+    }
+    // one-row matrices are indexed by element
+    template <typename M>
+    static auto &entry(M &m, std::size_t row, std::size_t column) noexcept
+    {
+        if constexpr (R == 1)
+            return m[column];
+        else
+            return m[row][column];
+    }
+
+    T *_data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _stride = Stride == DynamicStride ? PackedStride : Stride;
+};
+
+template <typename T, std::size_t Dim, std::size_t Stride = DynamicStride>
+using VectorView = MatrixView<T, 1, Dim, Stride>;
+
+// bytes of one gathered block, two of them stay in L1 cache
+inline constexpr std::size_t ViewBlockBytes = 4096;
+
+/*
+ * Calls kernel(const In::Value *in, Out::Value *out, count) for blocks of
+ * matching matrices, every existing batch (transformPoints, add, convert, ...)
+ * runs over views this way. Views of the same size are processed at once,
+ * if both are packed. out may alias in only as the same view
+ */
+template <typename TIn, std::size_t RIn, std::size_t CIn, std::size_t SIn,
+          typename TOut, std::size_t ROut, std::size_t COut, std::size_t SOut, typename Kernel>
+void forEachBlock(const MatrixView<TIn, RIn, CIn, SIn> &in, const MatrixView<TOut, ROut, COut, SOut> &out, Kernel kernel)
+    requires(!std::is_const_v<TOut>)
+{
+    using InValue = typename MatrixView<TIn, RIn, CIn, SIn>::Value;
+    using OutValue = typename MatrixView<TOut, ROut, COut, SOut>::Value;
+    assert(in.size() == out.size());
+    const std::size_t count = in.size();
+    const bool inPacked = in.packed(), outPacked = out.packed();
+    if (inPacked && outPacked)
+    {
+        if (count)
+            kernel(reinterpret_cast<const InValue *>(in.data()), reinterpret_cast<OutValue *>(out.data()), count);
+        return;
+    }
+
+    constexpr std::size_t Block = std::max<std::size_t>(1, ViewBlockBytes / std::max(sizeof(InValue), sizeof(OutValue)));
+    InValue inBlock[Block];
+    OutValue outBlock[Block];
+    for (std::size_t i = 0; i < count; i += Block)
+    {
+        const std::size_t n = std::min(Block, count - i);
+        const InValue *src = inBlock;
+        if (inPacked)
+            src = reinterpret_cast<const InValue *>(in.element(i));
+        else
+            in.subview(i, n).store(inBlock);
+        OutValue *dst = outPacked ? reinterpret_cast<OutValue *>(out.element(i)) : outBlock;
+        kernel(src, dst, n);
+        if (!outPacked)
+            out.subview(i, n).assign(outBlock);
+    }
+}
+
+// Copies matrices of one view to another one, e.g. to packed array
+template <typename TIn, std::size_t R, std::size_t C, std::size_t SIn, typename T, std::size_t SOut>
+void copy(const MatrixView<TIn, R, C, SIn> &in, const MatrixView<T, R, C, SOut> &out) noexcept
+    requires(std::is_same_v<std::remove_const_t<TIn>, T>)
+{
+    assert(in.size() == out.size());
+    for (std::size_t i = 0; i < in.size(); ++i)
+        out.set(i, in.at(i));
+}
+
+}
+}
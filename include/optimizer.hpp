@@ -15,7 +15,20 @@
  */
 #include <stdint.h>
 #include "matrix_implementation.hpp"
+#include "transpose_implementation.hpp"
+#include "vector_array_implementation.hpp"
+#include "transform_implementation.hpp"
+#include "matrix_array_implementation.hpp"
+#include "eigen_implementation.hpp"
+#include "gemm_implementation.hpp"
+#include "quaternion_implementation.hpp"
+#include "affine_implementation.hpp"
+#include "skinning_implementation.hpp"
 #include "trigonometry_implementation.hpp"
+#include "integer_implementation.hpp"
+#include "conversion_implementation.hpp"
+#include "reduction_implementation.hpp"
+#include "solver_implementation.hpp"
 
 namespace _OptimizerInternal
 {
@@ -28,10 +41,76 @@ namespace _OptimizerInternal
     using TwoArgRetVecFP = void (*)(T (&)[4], T (&)[4], T(&)[4]);
     template<typename T>
     using TwoArgRetVecSingleFP = void (*)(T (&)[4], T, T(&)[4]);
+    template<typename T, std::size_t R, std::size_t C>
+    using TwoArgRetMatrixFP = void (*)(const T (&)[R][C], const T (&)[R][C], T(&)[R][C]);
+    template<typename T, std::size_t R, std::size_t C>
+    using TwoArgRetMatrixSingleFP = void (*)(const T (&)[R][C], T, T(&)[R][C]);
+    template<typename T, std::size_t N>
+    using OneArgRetMatrixFP = void (*)(const T (&)[N][N], T(&)[N][N]);
+    template<typename T, std::size_t N>
+    using InverseMatrixFP = T (*)(const T (&)[N][N], T(&)[N][N]);
+    template<typename T, std::size_t N>
+    using BatchArgRetMatrixFP = void (*)(const T (*)[N][N], const T (*)[N][N], T (*)[N][N], std::size_t);
+    template<typename T, std::size_t N>
+    using BatchOneArgRetMatrixFP = void (*)(const T (*)[N][N], T (*)[N][N], std::size_t);
     template<typename T>
-    using TwoArgRetMatrixFP = void (*)(T (&)[4][4], T (&)[4][4], T(&)[4][4]);
+    using TransposeBlockFP = void (*)(const T *, std::size_t, T *, std::size_t, std::size_t, std::size_t);
     template<typename T>
-    using TwoArgRetMatrixSingleFP = void (*)(T (&)[4][4], T, T(&)[4][4]);
+    using TwoArgRetStreamFP = void (*)(const T *, const T *, T *, std::size_t);
+    template<typename T>
+    using TwoArgRetStreamSingleFP = void (*)(const T *, T, T *, std::size_t);
+    template<typename T>
+    using OneArgRetStreamFP = void (*)(const T *, T *, std::size_t);
+    template<typename T>
+    using ThreeArgRetStreamFP = void (*)(const T *, const T *, const T *, T *, std::size_t);
+    template<typename T>
+    using AxpyStreamFP = void (*)(T, const T *, const T *, T *, std::size_t);
+    template<typename T>
+    using LerpStreamFP = void (*)(const T *, const T *, T, T *, std::size_t);
+    template<typename T>
+    using ClampStreamFP = void (*)(const T *, T, T, T *, std::size_t);
+    template<typename From, typename To>
+    using ConvertStreamFP = void (*)(const From *, To *, std::size_t);
+    template<typename T>
+    using TwoVecArgRetStreamFP = void (*)(const T *const *, const T *const *, T *, std::size_t);
+    template<typename T>
+    using TwoVecArgRetVecStreamFP = void (*)(const T *const *, const T *const *, T *const *, std::size_t);
+    template<typename T>
+    using OneVecArgRetStreamFP = void (*)(const T *const *, T *, std::size_t);
+    template<typename T>
+    using OneVecArgRetVecStreamFP = void (*)(const T *const *, T *const *, std::size_t);
+    template<typename T>
+    using TransformStreamFP = void (*)(const T (&)[4][4], const T *const *, T *const *, std::size_t);
+    template<typename T>
+    using TransformVectorsFP = void (*)(const T (&)[4][4], const T *, T *, std::size_t);
+    template<typename T>
+    using InverseVecStreamFP = void (*)(const T *const *, T *const *, T *, std::size_t);
+    template<typename T>
+    using GemmFP = void (*)(const T *, std::size_t, const T *, std::size_t, T *, std::size_t,
+                            std::size_t, std::size_t, std::size_t);
+    template<typename T>
+    using EigenVecStreamFP = void (*)(const T *const *, T *const *, T *const *, std::size_t);
+    template<typename T>
+    using SvdVecStreamFP = void (*)(const T *const *, T *const *, T *const *, T *const *, std::size_t);
+    template<typename T>
+    using SolveVecStreamFP = std::size_t (*)(const T *const *, const T *const *, T *const *, bool *, std::size_t);
+    template<typename T>
+    using QuaternionFP = void (*)(const T (&)[4], const T (&)[4], T (&)[4]);
+    template<typename T>
+    using SlerpQuaternionsFP = void (*)(const T *, const T *, const T *, bool, T *, std::size_t);
+    template<typename T>
+    using AffineFP = void (*)(const T (&)[3][4], const T (&)[3][4], T (&)[3][4]);
+    template<typename T>
+    using BatchAffineFP = void (*)(const T (*)[3][4], const T (*)[3][4], T (*)[3][4], std::size_t);
+    template<typename T>
+    using InverseAffineFP = T (*)(const T (&)[3][4], T (&)[3][4]);
+    template<typename T>
+    using ReduceStreamFP = void (*)(const T *, std::size_t, T *, T *);
+    template<typename T>
+    using CovarianceStreamFP = void (*)(const T *const *, const T *, std::size_t, T *);
+    template<typename T>
+    using SkinStreamFP = void (*)(const T *, const T *const *, const std::int32_t *const *, const T *const *,
+                                  const T *const *, T *const *, T *const *, std::size_t);
 
     //using TwoArgRetFP = std::array<T,4> (*)(T (&)[4], T (&)[4]);
 
@@ -59,14 +138,146 @@ namespace _OptimizerInternal
     TwoArgRetVecSingleFP<double> mulVecSingle4d = &_Impl::mulVecSingleFallbackImplementation;
     TwoArgRetVecSingleFP<double> divVecSingle4d = &_Impl::divVecSingleFallbackImplementation;
 
-    TwoArgRetMatrixFP<float> subTwoMatrix4 = &_Impl::subMatrixFallbackImplementation;
-    TwoArgRetMatrixFP<float> addTwoMatrix4 = &_Impl::addMatrixFallbackImplementation;
-    TwoArgRetMatrixFP<float> mulTwoMatrix4 = &_Impl::mulMatrixFallbackImplementation;
-    TwoArgRetMatrixFP<float> divTwoMatrix4 = &_Impl::divMatrixFallbackImplementation;
-    TwoArgRetMatrixSingleFP<float> subMatrixSingle4 = &_Impl::subMatrixSingleFallbackImplementation;
-    TwoArgRetMatrixSingleFP<float> addMatrixSingle4 = &_Impl::addMatrixSingleFallbackImplementation;
-    TwoArgRetMatrixSingleFP<float> mulMatrixSingle4 = &_Impl::mulMatrixSingleFallbackImplementation;
-    TwoArgRetMatrixSingleFP<float> divMatrixSingle4 = &_Impl::divMatrixSingleFallbackImplementation;
+    // Matrix<float|double, R, C> specializations dispatch table
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixFP<T,R,C> subTwoMatrix = &_Impl::subMatrixFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixFP<T,R,C> addTwoMatrix = &_Impl::addMatrixFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixFP<T,R,C> mulTwoMatrix = &_Impl::mulMatrixFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixFP<T,R,C> divTwoMatrix = &_Impl::divMatrixFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixSingleFP<T,R,C> subMatrixSingle = &_Impl::subMatrixSingleFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixSingleFP<T,R,C> addMatrixSingle = &_Impl::addMatrixSingleFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixSingleFP<T,R,C> mulMatrixSingle = &_Impl::mulMatrixSingleFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t R, std::size_t C>
+    TwoArgRetMatrixSingleFP<T,R,C> divMatrixSingle = &_Impl::divMatrixSingleFallbackImplementation<T,R,C>;
+    template<typename T, std::size_t N>
+    TwoArgRetMatrixFP<T,N,N> dotTwoMatrix = &_Impl::dotMatrixFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    BatchArgRetMatrixFP<T,N> dotMatrixBatch = &_Impl::dotMatrixBatchFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    OneArgRetMatrixFP<T,N> transposeMatrix = &_Impl::transposeMatrixFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    BatchOneArgRetMatrixFP<T,N> transposeMatrixBatch = &_Impl::transposeMatrixBatchFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    InverseMatrixFP<T,N> inverseMatrix = &_Impl::inverseMatrixFallbackImplementation<T,N>;
+
+    // VectorArray<float|double, Dim> component streams dispatch table
+    template<typename T>
+    TwoArgRetStreamFP<T> addStream = &_Impl::addStreamFallbackImplementation<T>;
+    template<typename T>
+    TwoArgRetStreamFP<T> subStream = &_Impl::subStreamFallbackImplementation<T>;
+    template<typename T>
+    TwoArgRetStreamFP<T> mulStream = &_Impl::mulStreamFallbackImplementation<T>;
+    template<typename T>
+    TwoArgRetStreamSingleFP<T> scaleStream = &_Impl::scaleStreamFallbackImplementation<T>;
+    template<typename T>
+    AxpyStreamFP<T> axpyStream = &_Impl::axpyStreamFallbackImplementation<T>;
+    template<typename T>
+    LerpStreamFP<T> lerpStream = &_Impl::lerpStreamFallbackImplementation<T>;
+    template<typename T>
+    ThreeArgRetStreamFP<T> fmaStream = &_Impl::fmaStreamFallbackImplementation<T>;
+    template<typename T>
+    TwoArgRetStreamFP<T> minStream = &_Impl::minStreamFallbackImplementation<T>;
+    template<typename T>
+    TwoArgRetStreamFP<T> maxStream = &_Impl::maxStreamFallbackImplementation<T>;
+    template<typename T>
+    ClampStreamFP<T> clampStream = &_Impl::clampStreamFallbackImplementation<T>;
+    template<typename T>
+    OneArgRetStreamFP<T> absStream = &_Impl::absStreamFallbackImplementation<T>;
+    template<typename T>
+    OneArgRetStreamFP<T> floorStream = &_Impl::floorStreamFallbackImplementation<T>;
+    template<typename T, std::size_t Dim>
+    TwoVecArgRetStreamFP<T> dotStream = &_Impl::dotStreamFallbackImplementation<T,Dim>;
+    template<typename T>
+    TwoVecArgRetVecStreamFP<T> crossStream = &_Impl::crossStreamFallbackImplementation<T>;
+    template<typename T, std::size_t Dim>
+    OneVecArgRetStreamFP<T> lengthStream = &_Impl::lengthStreamFallbackImplementation<T,Dim>;
+    template<typename T, std::size_t Dim>
+    OneVecArgRetVecStreamFP<T> normalizeStream = &_Impl::normalizeStreamFallbackImplementation<T,Dim>;
+
+    // transforms by Matrix<float|double,4,4>, Dim = 3 or 4
+    template<typename T, std::size_t Dim, _Impl::TransformMode Mode>
+    TransformStreamFP<T> transformStream = &_Impl::transformStreamFallbackImplementation<T,Dim,Mode>;
+    template<typename T, std::size_t Dim, _Impl::TransformMode Mode>
+    TransformVectorsFP<T> transformVectors = &_Impl::transformVectorsFallbackImplementation<T,Dim,Mode>;
+
+    // MatrixArray<float|double, N, N>, N = 2..4
+    template<typename T, std::size_t N>
+    TwoVecArgRetVecStreamFP<T> dotMatrixArray = &_Impl::dotMatrixArrayFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    OneVecArgRetVecStreamFP<T> transposeMatrixArray = &_Impl::transposeMatrixArrayFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    OneVecArgRetStreamFP<T> determinantMatrixArray = &_Impl::determinantMatrixArrayFallbackImplementation<T,N>;
+    template<typename T, std::size_t N>
+    InverseVecStreamFP<T> inverseMatrixArray = &_Impl::inverseMatrixArrayFallbackImplementation<T,N>;
+    // MatrixArray<float|double, 3, 3> decompositions by Jacobi sweeps
+    template<typename T>
+    EigenVecStreamFP<T> symmetricEigenMatrixArray = &_Impl::symmetricEigenMatrixArrayFallbackImplementation<T>;
+    template<typename T>
+    SvdVecStreamFP<T> svdMatrixArray = &_Impl::svdMatrixArrayFallbackImplementation<T>;
+    // MatrixArray<float|double, R, C> linear systems, N = 2..6 and least squares of C = 2..4, R = C..6
+    template<typename T, std::size_t N>
+    SolveVecStreamFP<T> solveMatrixArray = &_Impl::solveMatrixArrayFallbackImplementation<T,N>;
+    template<typename T, std::size_t R, std::size_t C>
+    SolveVecStreamFP<T> leastSquaresMatrixArray = &_Impl::leastSquaresMatrixArrayFallbackImplementation<T,R,C>;
+
+    // row-major products of DynamicMatrix<float|double>
+    template<typename T>
+    GemmFP<T> gemm = &_Impl::gemmFallbackImplementation<T>;
+    // strided transposes of DynamicMatrix and large Matrix<float|double, R, C>
+    template<typename T>
+    TransposeBlockFP<T> transposeBlock = &_Impl::transposeBlockFallbackImplementation<T>;
+
+    // Quaternion<float|double>
+    template<typename T>
+    QuaternionFP<T> mulQuaternion = &_Impl::mulQuaternionFallbackImplementation<T>;
+    template<typename T>
+    SlerpQuaternionsFP<T> slerpQuaternions = &_Impl::slerpQuaternionsFallbackImplementation<T>;
+
+    // Affine<float|double>, 3x4 rows
+    template<typename T>
+    AffineFP<T> composeAffine = &_Impl::composeAffineFallbackImplementation<T>;
+    template<typename T>
+    BatchAffineFP<T> composeAffineBatch = &_Impl::composeAffineBatchFallbackImplementation<T>;
+    template<typename T>
+    InverseAffineFP<T> inverseAffine = &_Impl::inverseAffineFallbackImplementation<T>;
+
+    // element-wise operations of 16, 32 and 64 bit integer arrays
+    template<typename T, _Impl::IntegerOp Op>
+    TwoArgRetStreamFP<T> integerStream = &_Impl::integerStreamFallbackImplementation<T,Op>;
+    template<typename T, _Impl::IntegerOp Op>
+    TwoArgRetStreamSingleFP<T> integerStreamSingle = &_Impl::integerStreamSingleFallbackImplementation<T,Op>;
+    // int16_t, uint16_t and int32_t arrays to float and back
+    template<typename T>
+    ConvertStreamFP<T,float> toFloatStream = &_Impl::toFloatStreamFallbackImplementation<T>;
+    template<typename T, _Impl::Rounding Mode>
+    ConvertStreamFP<float,T> fromFloatStream = &_Impl::fromFloatStreamFallbackImplementation<T,Mode>;
+    // float arrays to double and binary16 ones and back
+    inline ConvertStreamFP<float,double> floatToDoubleStream = &_Impl::floatToDoubleStreamFallbackImplementation;
+    template<_Impl::Rounding Mode>
+    ConvertStreamFP<double,float> doubleToFloatStream = &_Impl::doubleToFloatStreamFallbackImplementation<Mode>;
+    inline ConvertStreamFP<std::uint16_t,float> halfToFloatStream = &_Impl::halfToFloatStreamFallbackImplementation;
+    template<_Impl::Rounding Mode>
+    ConvertStreamFP<float,std::uint16_t> floatToHalfStream = &_Impl::floatToHalfStreamFallbackImplementation<Mode>;
+
+    // reductions of Vector<float|double, Dim> arrays, Stride = 1..4 numbers per vector
+    template<typename T, std::size_t Stride, _Impl::Summation Mode>
+    ReduceStreamFP<T> sumStream = &_Impl::sumStreamFallbackImplementation<T,Stride,Mode>;
+    template<typename T, std::size_t Stride>
+    ReduceStreamFP<T> boundsStream = &_Impl::boundsStreamFallbackImplementation<T,Stride>;
+    template<typename T, std::size_t Dim>
+    CovarianceStreamFP<T> covarianceStream = &_Impl::covarianceStreamFallbackImplementation<T,Dim>;
+
+    // skinning of VectorArray<float|double,3> vertices by bone palette
+    template<typename T>
+    SkinStreamFP<T> skinLinear = &_Impl::skinLinearFallbackImplementation<T>;
+    template<typename T>
+    SkinStreamFP<T> skinDualQuaternion = &_Impl::skinDualQuaternionFallbackImplementation<T>;
     //TwoArgRetFP<float> subTwoArr4x4 = &subFallbackImplementation;
 
     // current cpu features
@@ -212,6 +423,7 @@ public:
         CPU_X86_FMA3,
         CPU_X86_FMA4,
         CPU_X86_AVX2,
+        CPU_X86_F16C,
 
         //  SIMD: 512-bit
         CPU_X86_AVX512_F,
@@ -297,6 +509,7 @@ public:
 
             if (((info[2] & ((int)1 << 28)) != 0) && OS_AVX) features |= 1ull << CPU_X86_AVX;
             if ((info[2] & ((int)1 << 12)) != 0) features |= 1ull << CPU_X86_FMA3;
+            if (((info[2] & ((int)1 << 29)) != 0) && OS_AVX) features |= 1ull << CPU_X86_F16C;
 
             if ((info[2] & ((int)1 << 30)) != 0) features |= 1ull << CPU_X86_RDRAND;
         }
@@ -389,18 +602,145 @@ public:
             _OptimizerInternal::divTwoVec4d = &_Impl::divVecIntrinImplementation;
             _OptimizerInternal::divVecSingle4d = &_Impl::divVecSingleIntrinImplementation;
         }
+#endif
+        // matrices, wider instruction sets override narrower ones
+#ifdef __SSE2__
+        if (hasSseFeatures())
+        {
+            assignMatrixImplementation<_Impl::SSE, float, 2, 2>();
+            assignMatrixImplementation<_Impl::SSE, double, 2, 2>();
+            assignMatrixImplementation<_Impl::SSE, float, 3, 3>();
+            assignMatrixImplementation<_Impl::SSE, double, 3, 3>();
+            assignMatrixImplementation<_Impl::SSE, float, 4, 4>();
+            assignMatrixImplementation<_Impl::SSE, double, 4, 4>();
+            assignDotImplementation<_Impl::SSE, float, 2>();
+            assignDotImplementation<_Impl::SSE, double, 2>();
+            assignDotImplementation<_Impl::SSE, float, 4>();
+            assignDotImplementation<_Impl::SSE, float, 3>();
+            assignDotImplementation<_Impl::SSE, double, 3>();
+            assignDotImplementation<_Impl::SSE, double, 4>();
+            assignTransposeImplementation<_Impl::SSE, float, 2>();
+            assignTransposeImplementation<_Impl::SSE, double, 2>();
+            assignTransposeImplementation<_Impl::SSE, float, 4>();
+            assignTransposeImplementation<_Impl::SSE, double, 4>();
+            assignTransposeImplementation<_Impl::SSE, float, 8>();
+            assignTransposeImplementation<_Impl::SSE, double, 8>();
+            _OptimizerInternal::inverseMatrix<float,4> = &_Impl::inverseMatrixIntrinImplementation<_Impl::SSE,float,4>;
+            assignStreamImplementation<_Impl::SSE, float>();
+            assignStreamImplementation<_Impl::SSE, double>();
+            assignTransformImplementation<_Impl::SSE, float>();
+            assignTransformImplementation<_Impl::SSE, double>();
+            assignMatrixArrayImplementation<_Impl::SSE, float>();
+            assignMatrixArrayImplementation<_Impl::SSE, double>();
+            assignGemmImplementation<_Impl::SSE, float>();
+            assignGemmImplementation<_Impl::SSE, double>();
+            _OptimizerInternal::transposeBlock<float> = &_Impl::transposeBlockIntrinImplementation<_Impl::SSE,float>;
+            _OptimizerInternal::transposeBlock<double> = &_Impl::transposeBlockIntrinImplementation<_Impl::SSE,double>;
+            _OptimizerInternal::mulQuaternion<float> = &_Impl::mulQuaternionIntrinImplementation<_Impl::SSE,float>;
+            _OptimizerInternal::slerpQuaternions<float> = &_Impl::slerpQuaternionsIntrinImplementation<_Impl::SSE,float>;
+            assignAffineImplementation<_Impl::SSE, float>();
+            assignSkinningRowsImplementation<_Impl::SSE, float>();
+            assignSkinningImplementation<_Impl::SSE, double>();
+            assignIntegerImplementation<_Impl::SSE>();
+            assignFloatConversionImplementation<_Impl::SSE>();
+            assignPrecisionConversionImplementation<_Impl::SSE>();
+            assignReductionImplementation<_Impl::SSE, float>();
+            assignReductionImplementation<_Impl::SSE, double>();
+            assignSolverImplementation<_Impl::SSE, float>();
+            assignSolverImplementation<_Impl::SSE, double>();
+        }
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+        if (hasFeature(CPU_X86_AVX2) && hasFeature(CPU_X86_FMA3))
+        {
+            assignMatrixImplementation<_Impl::AVX2, double, 2, 2>();
+            assignMatrixImplementation<_Impl::AVX2, float, 3, 3>();
+            assignMatrixImplementation<_Impl::AVX2, double, 3, 3>();
+            assignMatrixImplementation<_Impl::AVX2, float, 4, 4>();
+            assignMatrixImplementation<_Impl::AVX2, double, 4, 4>();
+            assignDotImplementation<_Impl::AVX2, double, 2>();
+            assignDotImplementation<_Impl::AVX2, float, 4>();
+            assignDotImplementation<_Impl::AVX2, double, 3>();
+            assignDotImplementation<_Impl::AVX2, double, 4>();
+            assignTransposeImplementation<_Impl::AVX2, double, 2>();
+            assignTransposeImplementation<_Impl::AVX2, float, 3>();
+            assignTransposeImplementation<_Impl::AVX2, double, 4>();
+            assignTransposeImplementation<_Impl::AVX2, float, 8>();
+            assignTransposeImplementation<_Impl::AVX2, double, 8>();
+            _OptimizerInternal::inverseMatrix<double,4> = &_Impl::inverseMatrixIntrinImplementation<_Impl::AVX2,double,4>;
+            assignStreamImplementation<_Impl::AVX2, float>();
+            assignStreamImplementation<_Impl::AVX2, double>();
+            assignTransformImplementation<_Impl::AVX2, float>();
+            assignTransformImplementation<_Impl::AVX2, double>();
+            assignMatrixArrayImplementation<_Impl::AVX2, float>();
+            assignMatrixArrayImplementation<_Impl::AVX2, double>();
+            assignGemmImplementation<_Impl::AVX2, float>();
+            assignGemmImplementation<_Impl::AVX2, double>();
+            _OptimizerInternal::transposeBlock<float> = &_Impl::transposeBlockIntrinImplementation<_Impl::AVX2,float>;
+            _OptimizerInternal::transposeBlock<double> = &_Impl::transposeBlockIntrinImplementation<_Impl::AVX2,double>;
+            _OptimizerInternal::mulQuaternion<double> = &_Impl::mulQuaternionIntrinImplementation<_Impl::AVX2,double>;
+            _OptimizerInternal::slerpQuaternions<float> = &_Impl::slerpQuaternionsIntrinImplementation<_Impl::AVX2,float>;
+            assignAffineImplementation<_Impl::AVX2, double>();
+            assignSkinningRowsImplementation<_Impl::AVX2, double>();
+            assignIntegerImplementation<_Impl::AVX2>();
+            assignFloatConversionImplementation<_Impl::AVX2>();
+            assignPrecisionConversionImplementation<_Impl::AVX2>();
+            assignReductionImplementation<_Impl::AVX2, float>();
+            assignReductionImplementation<_Impl::AVX2, double>();
+            assignSolverImplementation<_Impl::AVX2, float>();
+            assignSolverImplementation<_Impl::AVX2, double>();
+#ifdef __F16C__
+            if (hasFeature(CPU_X86_F16C))
+                assignHalfConversionImplementation<_Impl::AVX2>();
+#endif
+        }
 #endif
 #if defined(__AVX512F__)
         if (hasFeature(CPU_X86_AVX512_F))
         {
-            _OptimizerInternal::subTwoMatrix4 = &_Impl::subMatrixIntrinImplementation;
-            _OptimizerInternal::subMatrixSingle4 = &_Impl::subMatrixSingleIntrinImplementation;
-            _OptimizerInternal::addTwoMatrix4 = &_Impl::addMatrixIntrinImplementation;
-            _OptimizerInternal::addMatrixSingle4 = &_Impl::addMatrixSingleIntrinImplementation;
-            _OptimizerInternal::mulTwoMatrix4 = &_Impl::mulMatrixIntrinImplementation;
-            _OptimizerInternal::mulMatrixSingle4 = &_Impl::mulMatrixSingleIntrinImplementation;
-            _OptimizerInternal::divTwoMatrix4 = &_Impl::divMatrixIntrinImplementation;
-            _OptimizerInternal::divMatrixSingle4 = &_Impl::divMatrixSingleIntrinImplementation;
+            assignMatrixImplementation<_Impl::AVX512, float, 3, 3>();
+            assignMatrixImplementation<_Impl::AVX512, double, 3, 3>();
+            assignMatrixImplementation<_Impl::AVX512, float, 4, 4>();
+            assignMatrixImplementation<_Impl::AVX512, double, 4, 4>();
+            assignDotImplementation<_Impl::AVX512, float, 3>();
+            assignDotImplementation<_Impl::AVX512, float, 4>();
+            assignDotImplementation<_Impl::AVX512, double, 3>();
+            assignDotImplementation<_Impl::AVX512, double, 4>();
+            assignTransposeImplementation<_Impl::AVX512, float, 3>();
+            assignTransposeImplementation<_Impl::AVX512, double, 3>();
+            assignTransposeImplementation<_Impl::AVX512, float, 4>();
+            assignTransposeImplementation<_Impl::AVX512, double, 4>();
+            assignTransposeImplementation<_Impl::AVX512, double, 8>();
+            assignStreamImplementation<_Impl::AVX512, float>();
+            assignStreamImplementation<_Impl::AVX512, double>();
+            assignTransformImplementation<_Impl::AVX512, float>();
+            assignTransformImplementation<_Impl::AVX512, double>();
+            assignMatrixArrayImplementation<_Impl::AVX512, float>();
+            assignMatrixArrayImplementation<_Impl::AVX512, double>();
+            assignGemmImplementation<_Impl::AVX512, float>();
+            assignGemmImplementation<_Impl::AVX512, double>();
+            _OptimizerInternal::transposeBlock<float> = &_Impl::transposeBlockIntrinImplementation<_Impl::AVX512,float>;
+            _OptimizerInternal::transposeBlock<double> = &_Impl::transposeBlockIntrinImplementation<_Impl::AVX512,double>;
+            _OptimizerInternal::slerpQuaternions<float> = &_Impl::slerpQuaternionsIntrinImplementation<_Impl::AVX512,float>;
+            assignIntegerImplementation<_Impl::AVX512,std::int32_t>();
+            assignIntegerImplementation<_Impl::AVX512,std::uint32_t>();
+            assignIntegerImplementation<_Impl::AVX512,std::int64_t>();
+            assignIntegerImplementation<_Impl::AVX512,std::uint64_t>();
+            assignFloatConversionImplementation<_Impl::AVX512>();
+            assignPrecisionConversionImplementation<_Impl::AVX512>();
+            assignReductionImplementation<_Impl::AVX512, float>();
+            assignReductionImplementation<_Impl::AVX512, double>();
+            assignSolverImplementation<_Impl::AVX512, float>();
+            assignSolverImplementation<_Impl::AVX512, double>();
+            assignHalfConversionImplementation<_Impl::AVX512>();
+#ifdef __AVX512BW__
+            // 16 bit lanes of zmm registers
+            if (hasFeature(CPU_X86_AVX512_BW))
+            {
+                assignIntegerImplementation<_Impl::AVX512,std::int16_t>();
+                assignIntegerImplementation<_Impl::AVX512,std::uint16_t>();
+            }
+#endif
         }
 #endif
 
@@ -408,7 +748,297 @@ public:
 
     static bool hasFeature(int mask)
     {
-        return _OptimizerInternal::features & (1 << mask);
+        return _OptimizerInternal::features & (1ull << mask);
+    }
+
+    // CPU runs _Impl::CompiledIsa, which kernels of compile-time sizes take instead of tables
+    static bool hasCompiledIsa()
+    {
+#if defined(__AVX512F__)
+        return hasFeature(CPU_X86_AVX512_F);
+#elif defined(__AVX2__) && defined(__FMA__)
+        return hasFeature(CPU_X86_AVX2) && hasFeature(CPU_X86_FMA3);
+#elif defined(__SSE2__)
+        return hasSseFeatures();
+#else
+        return false;
+#endif
+    }
+
+    // CPU runs _Impl::SSE lanes, which take FMA and SSE4.1 instructions where the compiler may use them
+    static bool hasSseFeatures()
+    {
+        bool available = hasFeature(CPU_X86_SSE2);
+#ifdef __FMA__
+        available = available && hasFeature(CPU_X86_FMA3);
+#endif
+#ifdef __SSE4_1__
+        available = available && hasFeature(CPU_X86_SSE41);
+#endif
+        return available;
+    }
+
+private:
+    // element-wise operations of Matrix<T,R,C> specialization
+    template<typename Isa, typename T, std::size_t R, std::size_t C>
+    static void assignMatrixImplementation()
+    {
+        _OptimizerInternal::subTwoMatrix<T,R,C> = &_Impl::subMatrixIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::addTwoMatrix<T,R,C> = &_Impl::addMatrixIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::mulTwoMatrix<T,R,C> = &_Impl::mulMatrixIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::divTwoMatrix<T,R,C> = &_Impl::divMatrixIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::subMatrixSingle<T,R,C> = &_Impl::subMatrixSingleIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::addMatrixSingle<T,R,C> = &_Impl::addMatrixSingleIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::mulMatrixSingle<T,R,C> = &_Impl::mulMatrixSingleIntrinImplementation<Isa,T,R,C>;
+        _OptimizerInternal::divMatrixSingle<T,R,C> = &_Impl::divMatrixSingleIntrinImplementation<Isa,T,R,C>;
+    }
+
+    // square matrix product, single and batched
+    template<typename Isa, typename T, std::size_t N>
+    static void assignDotImplementation()
+    {
+        _OptimizerInternal::dotTwoMatrix<T,N> = &_Impl::dotMatrixIntrinImplementation<Isa,T,N>;
+        _OptimizerInternal::dotMatrixBatch<T,N> = &_Impl::dotMatrixBatchIntrinImplementation<Isa,T,N>;
+    }
+
+    // square matrix transpose, single and batched
+    template<typename Isa, typename T, std::size_t N>
+    static void assignTransposeImplementation()
+    {
+        _OptimizerInternal::transposeMatrix<T,N> = &_Impl::transposeMatrixIntrinImplementation<Isa,T,N>;
+        _OptimizerInternal::transposeMatrixBatch<T,N> = &_Impl::transposeMatrixBatchIntrinImplementation<Isa,T,N>;
+    }
+
+    // bulk operations of VectorArray<T,Dim>, Dim = 2..4
+    template<typename Isa, typename T>
+    static void assignStreamImplementation()
+    {
+        _OptimizerInternal::addStream<T> = &_Impl::addStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::subStream<T> = &_Impl::subStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::mulStream<T> = &_Impl::mulStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::scaleStream<T> = &_Impl::scaleStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::axpyStream<T> = &_Impl::axpyStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::lerpStream<T> = &_Impl::lerpStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::fmaStream<T> = &_Impl::fmaStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::minStream<T> = &_Impl::minStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::maxStream<T> = &_Impl::maxStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::clampStream<T> = &_Impl::clampStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::absStream<T> = &_Impl::absStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::floorStream<T> = &_Impl::floorStreamIntrinImplementation<Isa,T>;
+        _OptimizerInternal::crossStream<T> = &_Impl::crossStreamIntrinImplementation<Isa,T>;
+        assignStreamImplementation<Isa,T,2>();
+        assignStreamImplementation<Isa,T,3>();
+        assignStreamImplementation<Isa,T,4>();
+    }
+
+    template<typename Isa, typename T, std::size_t Dim>
+    static void assignStreamImplementation()
+    {
+        _OptimizerInternal::dotStream<T,Dim> = &_Impl::dotStreamIntrinImplementation<Isa,T,Dim>;
+        _OptimizerInternal::lengthStream<T,Dim> = &_Impl::lengthStreamIntrinImplementation<Isa,T,Dim>;
+        _OptimizerInternal::normalizeStream<T,Dim> = &_Impl::normalizeStreamIntrinImplementation<Isa,T,Dim>;
+    }
+
+    // vector transforms by 4x4 matrix, every mode for 3D and 4D vectors
+    template<typename Isa, typename T>
+    static void assignTransformImplementation()
+    {
+        using enum _Impl::TransformMode;
+        assignTransformImplementation<Isa,T,3,Point>();
+        assignTransformImplementation<Isa,T,3,Direction>();
+        assignTransformImplementation<Isa,T,3,Projective>();
+        assignTransformImplementation<Isa,T,4,Point>();
+        assignTransformImplementation<Isa,T,4,Direction>();
+        assignTransformImplementation<Isa,T,4,Projective>();
+    }
+
+    template<typename Isa, typename T, std::size_t Dim, _Impl::TransformMode Mode>
+    static void assignTransformImplementation()
+    {
+        _OptimizerInternal::transformStream<T,Dim,Mode> = &_Impl::transformStreamIntrinImplementation<Isa,T,Dim,Mode>;
+        _OptimizerInternal::transformVectors<T,Dim,Mode> = &_Impl::transformVectorsIntrinImplementation<Isa,T,Dim,Mode>;
+    }
+
+    // element-interleaved batches of 2x2, 3x3 and 4x4 matrices, 3x3 decompositions
+    template<typename Isa, typename T>
+    static void assignMatrixArrayImplementation()
+    {
+        assignMatrixArrayImplementation<Isa,T,2>();
+        assignMatrixArrayImplementation<Isa,T,3>();
+        assignMatrixArrayImplementation<Isa,T,4>();
+        _OptimizerInternal::symmetricEigenMatrixArray<T> = &_Impl::symmetricEigenMatrixArrayIntrinImplementation<Isa,T>;
+        _OptimizerInternal::svdMatrixArray<T> = &_Impl::svdMatrixArrayIntrinImplementation<Isa,T>;
+    }
+
+    template<typename Isa, typename T, std::size_t N>
+    static void assignMatrixArrayImplementation()
+    {
+        _OptimizerInternal::dotMatrixArray<T,N> = &_Impl::dotMatrixArrayIntrinImplementation<Isa,T,N>;
+        _OptimizerInternal::transposeMatrixArray<T,N> = &_Impl::transposeMatrixArrayIntrinImplementation<Isa,T,N>;
+        _OptimizerInternal::determinantMatrixArray<T,N> = &_Impl::determinantMatrixArrayIntrinImplementation<Isa,T,N>;
+        _OptimizerInternal::inverseMatrixArray<T,N> = &_Impl::inverseMatrixArrayIntrinImplementation<Isa,T,N>;
+    }
+
+    // blocked products of dynamic-size matrices
+    template<typename Isa, typename T>
+    static void assignGemmImplementation()
+    {
+        _OptimizerInternal::gemm<T> = &_Impl::gemmIntrinImplementation<Isa,T>;
+    }
+
+    // affine transforms, Isa register holds one row
+    template<typename Isa, typename T>
+    static void assignAffineImplementation()
+    {
+        _OptimizerInternal::composeAffine<T> = &_Impl::composeAffineIntrinImplementation<Isa,T>;
+        _OptimizerInternal::composeAffineBatch<T> = &_Impl::composeAffineBatchIntrinImplementation<Isa,T>;
+        _OptimizerInternal::inverseAffine<T> = &_Impl::inverseAffineIntrinImplementation<Isa,T>;
+    }
+
+    // sums, bounds and covariance of vector arrays, every stride and dimension
+    template<typename Isa, typename T>
+    static void assignReductionImplementation()
+    {
+        assignReductionImplementation<Isa,T,1>();
+        assignReductionImplementation<Isa,T,2>();
+        assignReductionImplementation<Isa,T,3>();
+        assignReductionImplementation<Isa,T,4>();
+    }
+
+    template<typename Isa, typename T, std::size_t N>
+    static void assignReductionImplementation()
+    {
+        _OptimizerInternal::sumStream<T,N,_Impl::Summation::Fast> = &_Impl::sumStreamIntrinImplementation<Isa,T,N,_Impl::Summation::Fast>;
+        _OptimizerInternal::sumStream<T,N,_Impl::Summation::Compensated> = &_Impl::sumStreamIntrinImplementation<Isa,T,N,_Impl::Summation::Compensated>;
+        _OptimizerInternal::boundsStream<T,N> = &_Impl::boundsStreamIntrinImplementation<Isa,T,N>;
+        if constexpr (N > 1)
+            _OptimizerInternal::covarianceStream<T,N> = &_Impl::covarianceStreamIntrinImplementation<Isa,T,N>;
+    }
+
+    // batched linear systems and least squares, every supported size
+    template<typename Isa, typename T>
+    static void assignSolverImplementation()
+    {
+        assignSolverImplementation<Isa,T,2>();
+        assignSolverImplementation<Isa,T,3>();
+        assignSolverImplementation<Isa,T,4>();
+        assignSolverImplementation<Isa,T,5>();
+        assignSolverImplementation<Isa,T,6>();
+    }
+
+    template<typename Isa, typename T, std::size_t R>
+    static void assignSolverImplementation()
+    {
+        _OptimizerInternal::solveMatrixArray<T,R> = &_Impl::solveMatrixArrayIntrinImplementation<Isa,T,R>;
+        assignLeastSquaresImplementation<Isa,T,R,2>();
+        if constexpr (R >= 3)
+            assignLeastSquaresImplementation<Isa,T,R,3>();
+        if constexpr (R >= 4)
+            assignLeastSquaresImplementation<Isa,T,R,4>();
+    }
+
+    template<typename Isa, typename T, std::size_t R, std::size_t C>
+    static void assignLeastSquaresImplementation()
+    {
+        _OptimizerInternal::leastSquaresMatrixArray<T,R,C> = &_Impl::leastSquaresMatrixArrayIntrinImplementation<Isa,T,R,C>;
+    }
+
+    // linear and dual quaternion blend skinning, palette is read by gathers
+    template<typename Isa, typename T>
+    static void assignSkinningImplementation()
+    {
+        _OptimizerInternal::skinLinear<T> = &_Impl::skinLinearIntrinImplementation<Isa,T>;
+        _OptimizerInternal::skinDualQuaternion<T> = &_Impl::skinDualQuaternionIntrinImplementation<Isa,T>;
+    }
+
+    // the same with palette read by rows, Isa register holds one row
+    template<typename Isa, typename T>
+    static void assignSkinningRowsImplementation()
+    {
+        _OptimizerInternal::skinLinear<T> = &_Impl::skinLinearRowsIntrinImplementation<Isa,T>;
+        _OptimizerInternal::skinDualQuaternion<T> = &_Impl::skinDualQuaternionRowsIntrinImplementation<Isa,T>;
+    }
+
+    // element-wise integer operations, every fixed-width type and operation
+    template<typename Isa>
+    static void assignIntegerImplementation()
+    {
+        assignIntegerImplementation<Isa,std::int16_t>();
+        assignIntegerImplementation<Isa,std::uint16_t>();
+        assignIntegerImplementation<Isa,std::int32_t>();
+        assignIntegerImplementation<Isa,std::uint32_t>();
+        assignIntegerImplementation<Isa,std::int64_t>();
+        assignIntegerImplementation<Isa,std::uint64_t>();
+    }
+
+    template<typename Isa, typename T>
+    static void assignIntegerImplementation()
+    {
+        using enum _Impl::IntegerOp;
+        assignIntegerImplementation<Isa,T,Add>();
+        assignIntegerImplementation<Isa,T,Sub>();
+        assignIntegerImplementation<Isa,T,Mul>();
+        assignIntegerImplementation<Isa,T,And>();
+        assignIntegerImplementation<Isa,T,Or>();
+        assignIntegerImplementation<Isa,T,Xor>();
+        assignIntegerImplementation<Isa,T,ShiftLeft>();
+        assignIntegerImplementation<Isa,T,ShiftRight>();
+        assignIntegerImplementation<Isa,T,AddSaturate>();
+        assignIntegerImplementation<Isa,T,SubSaturate>();
+    }
+
+    template<typename Isa, typename T, _Impl::IntegerOp Op>
+    static void assignIntegerImplementation()
+    {
+        _OptimizerInternal::integerStream<T,Op> = &_Impl::integerStreamIntrinImplementation<Isa,T,Op>;
+        _OptimizerInternal::integerStreamSingle<T,Op> = &_Impl::integerStreamSingleIntrinImplementation<Isa,T,Op>;
+    }
+
+    // compact integer vectors to float vectors and back
+    template<typename Isa>
+    static void assignFloatConversionImplementation()
+    {
+        assignFloatConversionImplementation<Isa,std::int16_t>();
+        assignFloatConversionImplementation<Isa,std::uint16_t>();
+        assignFloatConversionImplementation<Isa,std::int32_t>();
+    }
+
+    template<typename Isa, typename T>
+    static void assignFloatConversionImplementation()
+    {
+        _OptimizerInternal::toFloatStream<T> = &_Impl::toFloatStreamIntrinImplementation<Isa,T>;
+        assignRoundingImplementation<Isa,T,_Impl::Rounding::Nearest>();
+        assignRoundingImplementation<Isa,T,_Impl::Rounding::Down>();
+        assignRoundingImplementation<Isa,T,_Impl::Rounding::Up>();
+        assignRoundingImplementation<Isa,T,_Impl::Rounding::TowardZero>();
+    }
+
+    template<typename Isa, typename T, _Impl::Rounding Mode>
+    static void assignRoundingImplementation()
+    {
+        _OptimizerInternal::fromFloatStream<T,Mode> = &_Impl::fromFloatStreamIntrinImplementation<Isa,T,Mode>;
+    }
+
+    // float arrays to double ones and back
+    template<typename Isa>
+    static void assignPrecisionConversionImplementation()
+    {
+        _OptimizerInternal::floatToDoubleStream = &_Impl::floatToDoubleStreamIntrinImplementation<Isa>;
+        _OptimizerInternal::doubleToFloatStream<_Impl::Rounding::Nearest> = &_Impl::doubleToFloatStreamIntrinImplementation<Isa,_Impl::Rounding::Nearest>;
+        _OptimizerInternal::doubleToFloatStream<_Impl::Rounding::Down> = &_Impl::doubleToFloatStreamIntrinImplementation<Isa,_Impl::Rounding::Down>;
+        _OptimizerInternal::doubleToFloatStream<_Impl::Rounding::Up> = &_Impl::doubleToFloatStreamIntrinImplementation<Isa,_Impl::Rounding::Up>;
+        _OptimizerInternal::doubleToFloatStream<_Impl::Rounding::TowardZero> = &_Impl::doubleToFloatStreamIntrinImplementation<Isa,_Impl::Rounding::TowardZero>;
+    }
+
+    // float arrays to binary16 ones and back
+    template<typename Isa>
+    static void assignHalfConversionImplementation()
+    {
+        _OptimizerInternal::halfToFloatStream = &_Impl::halfToFloatStreamIntrinImplementation<Isa>;
+        _OptimizerInternal::floatToHalfStream<_Impl::Rounding::Nearest> = &_Impl::floatToHalfStreamIntrinImplementation<Isa,_Impl::Rounding::Nearest>;
+        _OptimizerInternal::floatToHalfStream<_Impl::Rounding::Down> = &_Impl::floatToHalfStreamIntrinImplementation<Isa,_Impl::Rounding::Down>;
+        _OptimizerInternal::floatToHalfStream<_Impl::Rounding::Up> = &_Impl::floatToHalfStreamIntrinImplementation<Isa,_Impl::Rounding::Up>;
+        _OptimizerInternal::floatToHalfStream<_Impl::Rounding::TowardZero> = &_Impl::floatToHalfStreamIntrinImplementation<Isa,_Impl::Rounding::TowardZero>;
     }
 };
 }
@@ -0,0 +1,247 @@
+#pragma once
+/*
+ * File contains opt-in padded 3D vector
+ *
+ * PaddedVector3D<T> keeps x, y, z and zero fourth number in 16 (float) or
+ * 32 (double) aligned bytes, so it is one register and every operation
+ * is a few instructions. They are inlined for instruction set of the build
+ * instead of being dispatched by Optimizer, since a call per vector costs
+ * more than the operation; Optimizer::hasCompiledIsa() picks them or scalar
+ * lanes, so the build runs on CPUs without its instruction set too.
+ * Vector3D<T> stays tightly packed (12/24 bytes), as files and vertex
+ * buffers store it; toPadded() and fromPadded() convert arrays of them.
+*/
+
+#include "padded_vector_implementation.hpp"
+#include "vector_array.hpp"
+#include <cmath>
+#include <type_traits>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+namespace _PaddedVector
+{
+// f(ops) with SIMD lanes, where CPU has instruction set of the build, scalar ones otherwise
+template <typename T, typename F>
+decltype(auto) dispatch(F &&f) noexcept
+{
+    if constexpr (!std::is_base_of_v<_Impl::Padded3Scalar<T>, _Impl::Padded3<T>>)
+        if (Optimizer::hasCompiledIsa())
+            return f(_Impl::Padded3<T>{});
+    return f(_Impl::Padded3Scalar<T>{});
+}
+}
+
+template <StreamType T>
+class alignas(4 * sizeof(T)) PaddedVector3D
+{
+public:
+    using Type = T;
+    static constexpr std::size_t Size = 3;
+
+    // zero vector
+    PaddedVector3D() noexcept : _data{} {}
+    PaddedVector3D(T x, T y, T z) noexcept : _data{x, y, z, T(0)} {}
+    explicit PaddedVector3D(T d) noexcept : _data{d, d, d, T(0)} {}
+    explicit PaddedVector3D(const Vector3D<T> &v) noexcept : _data{v.x(), v.y(), v.z(), T(0)} {}
+
+    T &operator[](std::size_t pos) noexcept
+    {
+        assert(pos < Size);
+        return _data[pos];
+    }
+    const T &operator[](std::size_t pos) const noexcept
+    {
+        assert(pos < Size);
+        return _data[pos];
+    }
+    constexpr std::size_t size() const noexcept { return Size; }
+    // 4 numbers, the last one must stay zero
+    T *data() noexcept { return _data; }
+    const T *data() const noexcept { return _data; }
+
+    T &x() noexcept { return _data[0]; }
+    T &y() noexcept { return _data[1]; }
+    T &z() noexcept { return _data[2]; }
+    const T &x() const noexcept { return _data[0]; }
+    const T &y() const noexcept { return _data[1]; }
+    const T &z() const noexcept { return _data[2]; }
+    Vector3D<T> vector3() const noexcept { return Vector3D<T>(_data[0], _data[1], _data[2]); }
+
+    T length() const noexcept
+    {
+        return std::sqrt(_PaddedVector::dispatch<T>([this](auto ops) {
+            using Ops = decltype(ops);
+            return Ops::dot(Ops::load(_data), Ops::load(_data));
+        }));
+    }
+    PaddedVector3D &unit() noexcept
+    {
+        return *this *= T(1) / length();
+    }
+
+    PaddedVector3D operator-() const noexcept
+    {
+        PaddedVector3D result = *this;
+        return result.apply(*this, [](auto ops, auto a, auto) { return decltype(ops)::neg(a); });
+    }
+    PaddedVector3D &operator+=(const PaddedVector3D &v) noexcept
+    {
+        return apply(v, [](auto ops, auto a, auto b) { return decltype(ops)::add(a, b); });
+    }
+    PaddedVector3D &operator-=(const PaddedVector3D &v) noexcept
+    {
+        return apply(v, [](auto ops, auto a, auto b) { return decltype(ops)::sub(a, b); });
+    }
+    PaddedVector3D &operator*=(const PaddedVector3D &v) noexcept
+    {
+        return apply(v, [](auto ops, auto a, auto b) { return decltype(ops)::mul(a, b); });
+    }
+    PaddedVector3D &operator/=(const PaddedVector3D &v) noexcept
+    {
+        return apply(v, [](auto ops, auto a, auto b) { return decltype(ops)::div(a, b); });
+    }
+    PaddedVector3D &operator*=(T k) noexcept
+    {
+        return apply(*this, [k](auto ops, auto a, auto) { return decltype(ops)::scale(a, k); });
+    }
+    PaddedVector3D &operator/=(T k) noexcept
+    {
+        return apply(*this, [k](auto ops, auto a, auto) { return decltype(ops)::div(a, decltype(ops)::set(k, k, k)); });
+    }
+
+    friend bool operator==(const PaddedVector3D &lhs, const PaddedVector3D &rhs) noexcept
+    {
+        return _PaddedVector::dispatch<T>([&](auto ops) {
+            using Ops = decltype(ops);
+            return Ops::equal(Ops::load(lhs._data), Ops::load(rhs._data));
+        });
+    }
+    friend bool operator!=(const PaddedVector3D &lhs, const PaddedVector3D &rhs) noexcept { return !(lhs == rhs); }
+
+private:
+    // *this = op(ops, *this, v) for registers of *this and v
+    template <typename Op>
+    PaddedVector3D &apply(const PaddedVector3D &v, Op op) noexcept
+    {
+        _PaddedVector::dispatch<T>([&](auto ops) {
+            using Ops = decltype(ops);
+            Ops::store(_data, op(ops, Ops::load(_data), Ops::load(v._data)));
+        });
+        return *this;
+    }
+
+    T _data[4];
+};
+
+template <StreamType T>
+PaddedVector3D<T> operator+(PaddedVector3D<T> lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    return lhs += rhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator-(PaddedVector3D<T> lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    return lhs -= rhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator*(PaddedVector3D<T> lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator/(PaddedVector3D<T> lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    return lhs /= rhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator*(PaddedVector3D<T> lhs, T rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator*(T lhs, PaddedVector3D<T> rhs) noexcept
+{
+    return rhs *= lhs;
+}
+
+template <StreamType T>
+PaddedVector3D<T> operator/(PaddedVector3D<T> lhs, T rhs) noexcept
+{
+    return lhs /= rhs;
+}
+
+template <StreamType T>
+T dot(const PaddedVector3D<T> &lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    return _PaddedVector::dispatch<T>([&](auto ops) {
+        using Ops = decltype(ops);
+        return Ops::dot(Ops::load(lhs.data()), Ops::load(rhs.data()));
+    });
+}
+
+template <StreamType T>
+PaddedVector3D<T> cross(const PaddedVector3D<T> &lhs, const PaddedVector3D<T> &rhs) noexcept
+{
+    PaddedVector3D<T> result;
+    _PaddedVector::dispatch<T>([&](auto ops) {
+        using Ops = decltype(ops);
+        Ops::store(result.data(), Ops::cross(Ops::load(lhs.data()), Ops::load(rhs.data())));
+    });
+    return result;
+}
+
+// Unit vector of the same direction
+template <StreamType T>
+PaddedVector3D<T> normalize(PaddedVector3D<T> v) noexcept
+{
+    return v.unit();
+}
+
+/*
+ * Tightly packed vectors to padded ones and back. Every vector but
+ * the last one is moved by one register, which overruns into the next one
+ */
+template <StreamType T>
+void toPadded(const Vector3D<T> *in, PaddedVector3D<T> *out, std::size_t count) noexcept
+{
+    static_assert(sizeof(Vector3D<T>) == 3 * sizeof(T), "Vector3D must be tightly packed");
+    if (!count)
+        return;
+    const T *packed = reinterpret_cast<const T *>(in);
+    _PaddedVector::dispatch<T>([&](auto ops) {
+        using Ops = decltype(ops);
+        for (std::size_t i = 0; i + 1 < count; ++i)
+            Ops::store(out[i].data(), Ops::loadPacked(packed + 3 * i));
+    });
+    out[count - 1] = PaddedVector3D<T>(in[count - 1]);
+}
+
+template <StreamType T>
+void fromPadded(const PaddedVector3D<T> *in, Vector3D<T> *out, std::size_t count) noexcept
+{
+    if (!count)
+        return;
+    T *packed = reinterpret_cast<T *>(out);
+    _PaddedVector::dispatch<T>([&](auto ops) {
+        using Ops = decltype(ops);
+        for (std::size_t i = 0; i + 1 < count; ++i)
+            Ops::storePacked(packed + 3 * i, Ops::load(in[i].data()));
+    });
+    out[count - 1] = in[count - 1].vector3();
+}
+
+static_assert(sizeof(PaddedVector3D<float>) == 16 && alignof(PaddedVector3D<float>) == 16);
+static_assert(sizeof(PaddedVector3D<double>) == 32 && alignof(PaddedVector3D<double>) == 32);
+
+}
+}
@@ -0,0 +1,142 @@
+#pragma once
+/*
+ * File contains one-register operations of padded 3D vectors
+ * (see padded_vector.hpp).
+ *
+ * Padded3<T> keeps x, y, z in first three lanes of a register and zero
+ * in the fourth one, every operation keeps it zero, so sums over all
+ * lanes are sums over three. Cross product rotates lanes (y z x) by
+ * shuffles. float uses SSE, double uses AVX2, other builds and types
+ * run the same operations on arrays of 4 numbers, Padded3Scalar<T>.
+*/
+
+#include "immintrin.h"
+#include <cstddef>
+
+
+namespace _Impl
+{
+template<typename T>
+struct Padded3Scalar
+{
+    struct Register
+    {
+        T v[4];
+    };
+
+    static Register load(const T *p) noexcept { return {{p[0], p[1], p[2], T(0)}}; }
+    static void store(T *p, Register r) noexcept
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+            p[i] = r.v[i];
+    }
+    // reads 3 numbers, the fourth one isn't touched
+    static Register loadPacked(const T *p) noexcept { return load(p); }
+    // writes 4 numbers, the fourth one is zero
+    static void storePacked(T *p, Register r) noexcept { store(p, r); }
+
+    static Register set(T x, T y, T z) noexcept { return {{x, y, z, T(0)}}; }
+    static Register add(Register a, Register b) noexcept { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], T(0)}}; }
+    static Register sub(Register a, Register b) noexcept { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], T(0)}}; }
+    static Register mul(Register a, Register b) noexcept { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], T(0)}}; }
+    static Register div(Register a, Register b) noexcept { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], T(0)}}; }
+    static Register scale(Register a, T k) noexcept { return {{a.v[0] * k, a.v[1] * k, a.v[2] * k, T(0)}}; }
+    static Register neg(Register a) noexcept { return {{-a.v[0], -a.v[1], -a.v[2], T(0)}}; }
+    static T dot(Register a, Register b) noexcept { return a.v[0] * b.v[0] + a.v[1] * b.v[1] + a.v[2] * b.v[2]; }
+    static Register cross(Register a, Register b) noexcept
+    {
+        return {{a.v[1] * b.v[2] - a.v[2] * b.v[1],
+                 a.v[2] * b.v[0] - a.v[0] * b.v[2],
+                 a.v[0] * b.v[1] - a.v[1] * b.v[0], T(0)}};
+    }
+    static bool equal(Register a, Register b) noexcept { return a.v[0] == b.v[0] && a.v[1] == b.v[1] && a.v[2] == b.v[2]; }
+};
+
+template<typename T>
+struct Padded3 : Padded3Scalar<T> {};
+
+#ifdef __SSE2__
+template<>
+struct Padded3<float>
+{
+    using Register = __m128;
+
+    static Register load(const float *p) noexcept { return _mm_load_ps(p); }
+    static void store(float *p, Register r) noexcept { _mm_store_ps(p, r); }
+    // reads 4 numbers, the fourth one is dropped
+    static Register loadPacked(const float *p) noexcept { return _mm_and_ps(_mm_loadu_ps(p), xyz()); }
+    static void storePacked(float *p, Register r) noexcept { _mm_storeu_ps(p, r); }
+
+    static Register set(float x, float y, float z) noexcept { return _mm_setr_ps(x, y, z, 0.f); }
+    static Register add(Register a, Register b) noexcept { return _mm_add_ps(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_ps(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm_mul_ps(a, b); }
+    // 0 / 0 of the fourth lane is masked out
+    static Register div(Register a, Register b) noexcept { return _mm_and_ps(_mm_div_ps(a, b), xyz()); }
+    // inf * 0 of the fourth lane is masked out
+    static Register scale(Register a, float k) noexcept { return _mm_and_ps(_mm_mul_ps(a, _mm_set1_ps(k)), xyz()); }
+    static Register neg(Register a) noexcept { return _mm_xor_ps(a, _mm_setr_ps(-0.f, -0.f, -0.f, 0.f)); }
+    static float dot(Register a, Register b) noexcept
+    {
+        const __m128 m = _mm_mul_ps(a, b);
+        const __m128 s = _mm_add_ps(m, _mm_movehl_ps(m, m));
+        return _mm_cvtss_f32(_mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1,1,1,1))));
+    }
+    // (a * b.yzx - a.yzx * b).yzx
+    static Register cross(Register a, Register b) noexcept
+    {
+        const __m128 ayzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3,0,2,1));
+        const __m128 byzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3,0,2,1));
+        const __m128 c = _mm_sub_ps(_mm_mul_ps(a, byzx), _mm_mul_ps(ayzx, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3,0,2,1));
+    }
+    static bool equal(Register a, Register b) noexcept { return (_mm_movemask_ps(_mm_cmpeq_ps(a, b)) & 7) == 7; }
+
+private:
+    static Register xyz() noexcept { return _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)); }
+};
+#endif
+
+#ifdef __AVX2__
+template<>
+struct Padded3<double>
+{
+    using Register = __m256d;
+
+    static Register load(const double *p) noexcept { return _mm256_load_pd(p); }
+    static void store(double *p, Register r) noexcept { _mm256_store_pd(p, r); }
+    // reads 4 numbers, the fourth one is dropped
+    static Register loadPacked(const double *p) noexcept { return _mm256_and_pd(_mm256_loadu_pd(p), xyz()); }
+    static void storePacked(double *p, Register r) noexcept { _mm256_storeu_pd(p, r); }
+
+    static Register set(double x, double y, double z) noexcept { return _mm256_setr_pd(x, y, z, 0.); }
+    static Register add(Register a, Register b) noexcept { return _mm256_add_pd(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_pd(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm256_mul_pd(a, b); }
+    // 0 / 0 of the fourth lane is masked out
+    static Register div(Register a, Register b) noexcept { return _mm256_and_pd(_mm256_div_pd(a, b), xyz()); }
+    // inf * 0 of the fourth lane is masked out
+    static Register scale(Register a, double k) noexcept { return _mm256_and_pd(_mm256_mul_pd(a, _mm256_set1_pd(k)), xyz()); }
+    static Register neg(Register a) noexcept { return _mm256_xor_pd(a, _mm256_setr_pd(-0., -0., -0., 0.)); }
+    static double dot(Register a, Register b) noexcept
+    {
+        const __m256d m = _mm256_mul_pd(a, b);
+        const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+    }
+    // (a * b.yzx - a.yzx * b).yzx
+    static Register cross(Register a, Register b) noexcept
+    {
+        const __m256d ayzx = _mm256_permute4x64_pd(a, _MM_SHUFFLE(3,0,2,1));
+        const __m256d byzx = _mm256_permute4x64_pd(b, _MM_SHUFFLE(3,0,2,1));
+        const __m256d c = _mm256_sub_pd(_mm256_mul_pd(a, byzx), _mm256_mul_pd(ayzx, b));
+        return _mm256_permute4x64_pd(c, _MM_SHUFFLE(3,0,2,1));
+    }
+    static bool equal(Register a, Register b) noexcept { return (_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)) & 7) == 7; }
+
+private:
+    static Register xyz() noexcept { return _mm256_castsi256_pd(_mm256_setr_epi64x(-1, -1, -1, 0)); }
+};
+#endif
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+/*
+ * File contains thread pool, which splits bulk operations over cores
+ *
+ * Workers are started on the first use and live until the program exits,
+ * so repeated calls don't pay for thread creation. The calling thread
+ * takes part in the work. Tasks started from inside a task are run
+ * serially by its thread.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace Geometrix
+{
+namespace Parallel
+{
+
+class ThreadPool
+{
+public:
+    // hardware concurrency threads, including the caller
+    static ThreadPool &instance()
+    {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    explicit ThreadPool(unsigned workers)
+    {
+        _workers.reserve(workers);
+        for (unsigned i = 0; i < workers; ++i)
+            _workers.emplace_back([this] { work(); });
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+    }
+
+    // threads, which run tasks, including the caller
+    unsigned concurrency() const noexcept { return unsigned(_workers.size()) + 1; }
+
+    // Runs task(i) for i in [0, count) and waits for all of them
+    template <typename Task>
+    void run(std::size_t count, Task task)
+    {
+        if (count <= 1 || _workers.empty() || insideTask())
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                task(i);
+            return;
+        }
+
+        std::lock_guard single(_runMutex);
+        Job job{[&task](std::size_t i) { task(i); }, count};
+        {
+            std::lock_guard lock(_mutex);
+            _job = &job;
+            ++_generation;
+        }
+        _wake.notify_all();
+        const std::size_t done = job.execute();
+
+        std::unique_lock lock(_mutex);
+        job.finished += done;
+        _done.wait(lock, [&job] { return job.finished == job.count && !job.workers; });
+        _job = nullptr;
+    }
+
+private:
+    struct Job
+    {
+        std::function<void(std::size_t)> task;
+        std::size_t count;
+        std::atomic<std::size_t> next = 0;
+        // guarded by pool mutex
+        std::size_t finished = 0;
+        unsigned workers = 0;
+
+        // takes tasks until there are none, returns their count
+        std::size_t execute()
+        {
+            insideTask() = true;
+            std::size_t done = 0;
+            for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count; ++done)
+                task(i);
+            insideTask() = false;
+            return done;
+        }
+    };
+
+    static bool &insideTask() noexcept
+    {
+        static thread_local bool inside = false;
+        return inside;
+    }
+
+    void work()
+    {
+        std::size_t seen = 0;
+        std::unique_lock lock(_mutex);
+        for (;;)
+        {
+            _wake.wait(lock, [&] { return _stop || (_job && _generation != seen); });
+            if (_stop)
+                return;
+            seen = _generation;
+            Job &job = *_job;
+            ++job.workers;
+            lock.unlock();
+            const std::size_t done = job.execute();
+            lock.lock();
+            job.finished += done;
+            --job.workers;
+            _done.notify_all();
+        }
+    }
+
+    std::mutex _runMutex;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    Job *_job = nullptr;
+    std::size_t _generation = 0;
+    bool _stop = false;
+    std::vector<std::jthread> _workers;
+};
+
+/*
+ * Runs kernel(first, size) over [0, count) split into at most "threads"
+ * chunks of at least minChunk items, chunks start at multiples of
+ * "granularity". 0 threads means all threads of the pool
+ */
+template <typename Kernel>
+void parallelChunks(std::size_t count, unsigned threads, std::size_t minChunk, std::size_t granularity, Kernel kernel)
+{
+    ThreadPool &pool = ThreadPool::instance();
+    if (!threads)
+        threads = pool.concurrency();
+    const std::size_t chunks = std::min<std::size_t>(threads, (count + minChunk - 1) / minChunk);
+    if (chunks <= 1)
+    {
+        kernel(std::size_t(0), count);
+        return;
+    }
+
+    std::size_t chunk = (count + chunks - 1) / chunks;
+    chunk = (chunk + granularity - 1) / granularity * granularity;
+    pool.run((count + chunk - 1) / chunk, [&](std::size_t i) {
+        const std::size_t first = i * chunk;
+        kernel(first, std::min(chunk, count - first));
+    });
+}
+
+}
+}
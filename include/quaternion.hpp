@@ -0,0 +1,278 @@
+#pragma once
+/*
+ * File contains quaternion of rotation
+ *
+ * Quaternion<T> keeps imaginary x, y, z and real w parts in aligned
+ * Vector4D<T> storage, so it's 16 (float) or 32 (double) bytes against
+ * 36-64 bytes of rotation matrix. Rotation convention matches
+ * transform.hpp: matrix multiplies column vectors, q1 * q2 rotates
+ * by q2 first.
+ *
+ * Hamilton product and batch slerp are dispatched by Optimizer,
+ * batch rotation goes through transformDirections().
+*/
+
+#include "transform.hpp"
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <StreamType T>
+class Quaternion
+{
+public:
+    using Type = T;
+
+    // identity rotation
+    Quaternion() noexcept : _q(T(0), T(0), T(0), T(1)) {}
+    Quaternion(T x, T y, T z, T w) noexcept : _q(x, y, z, w) {}
+    explicit Quaternion(const Vector4D<T> &q) noexcept : _q(q) {}
+    Quaternion(const Vector3D<T> &imaginary, T real) noexcept
+        : _q(imaginary.x(), imaginary.y(), imaginary.z(), real)
+    {}
+    // rotation part of matrix, which must be orthonormal
+    explicit Quaternion(const Matrix<T, 3, 3> &m) noexcept { fromRotation(m); }
+    explicit Quaternion(const Matrix<T, 4, 4> &m) noexcept { fromRotation(m); }
+
+    // rotation by angle (radians) around axis of unit length
+    static Quaternion axisAngle(const Vector3D<T> &axis, T angle) noexcept
+    {
+        const T s = std::sin(angle / T(2));
+        return Quaternion(axis.x() * s, axis.y() * s, axis.z() * s, std::cos(angle / T(2)));
+    }
+
+    T &x() noexcept { return _q.x(); }
+    T &y() noexcept { return _q.y(); }
+    T &z() noexcept { return _q.z(); }
+    T &w() noexcept { return _q.w(); }
+    const T &x() const noexcept { return _q.x(); }
+    const T &y() const noexcept { return _q.y(); }
+    const T &z() const noexcept { return _q.z(); }
+    const T &w() const noexcept { return _q.w(); }
+    Vector3D<T> imaginary() const noexcept { return Vector3D<T>(x(), y(), z()); }
+    const Vector4D<T> &coefficients() const noexcept { return _q; }
+
+    T length() const noexcept { return _q.length(); }
+    Quaternion &unit() noexcept
+    {
+        _q.unit();
+        return *this;
+    }
+    Quaternion conjugate() const noexcept { return Quaternion(-x(), -y(), -z(), w()); }
+    // conjugate divided by squared length, equals conjugate for unit quaternions
+    Quaternion inverse() const noexcept
+    {
+        const T k = T(1) / dot(_q, _q);
+        return Quaternion(-x() * k, -y() * k, -z() * k, w() * k);
+    }
+
+    // Hamilton product, rotates by q first, then by this
+    Quaternion &operator*=(const Quaternion &q) noexcept
+    {
+        _OptimizerInternal::mulQuaternion<T>(_q, q._q, _q);
+        return *this;
+    }
+    Quaternion &operator*=(T k) noexcept
+    {
+        _q *= k;
+        return *this;
+    }
+    Quaternion &operator+=(const Quaternion &q) noexcept
+    {
+        _q += q._q;
+        return *this;
+    }
+    Quaternion &operator-=(const Quaternion &q) noexcept
+    {
+        _q -= q._q;
+        return *this;
+    }
+    Quaternion operator-() const noexcept { return Quaternion(-_q); }
+
+    /*
+     * Rotation of vector by unit quaternion:
+     *  t = 2 * cross(u, v), v' = v + w * t + cross(u, t)
+     */
+    Vector3D<T> rotate(const Vector3D<T> &v) const noexcept
+    {
+        const Vector3D<T> u = imaginary();
+        const Vector3D<T> t = cross(u, v) * T(2);
+        return v + t * w() + cross(u, t);
+    }
+
+    Matrix<T, 3, 3> matrix3() const noexcept
+    {
+        Matrix<T, 3, 3> m;
+        rotation(m);
+        return m;
+    }
+    Matrix<T, 4, 4> matrix4() const noexcept
+    {
+        Matrix<T, 4, 4> m(T(0));
+        rotation(m);
+        m[3][3] = T(1);
+        return m;
+    }
+
+    friend bool operator==(const Quaternion &lhs, const Quaternion &rhs) { return lhs._q == rhs._q; }
+    friend bool operator!=(const Quaternion &lhs, const Quaternion &rhs) { return lhs._q != rhs._q; }
+
+private:
+    // upper left 3x3 of m
+    template <typename M>
+    void rotation(M &m) const noexcept
+    {
+        const T xx = x() * x(), yy = y() * y(), zz = z() * z();
+        const T xy = x() * y(), xz = x() * z(), yz = y() * z();
+        const T xw = x() * w(), yw = y() * w(), zw = z() * w();
+        m[0][0] = T(1) - T(2) * (yy + zz);
+        m[0][1] = T(2) * (xy - zw);
+        m[0][2] = T(2) * (xz + yw);
+        m[1][0] = T(2) * (xy + zw);
+        m[1][1] = T(1) - T(2) * (xx + zz);
+        m[1][2] = T(2) * (yz - xw);
+        m[2][0] = T(2) * (xz - yw);
+        m[2][1] = T(2) * (yz + xw);
+        m[2][2] = T(1) - T(2) * (xx + yy);
+    }
+
+    // Shepperd's method: divides by the largest of 4 candidates
+    template <typename M>
+    void fromRotation(const M &m) noexcept
+    {
+        const T trace = m[0][0] + m[1][1] + m[2][2];
+        if (trace > T(0))
+        {
+            const T s = std::sqrt(trace + T(1)) * T(2);
+            _q = Vector4D<T>((m[2][1] - m[1][2]) / s, (m[0][2] - m[2][0]) / s, (m[1][0] - m[0][1]) / s, s / T(4));
+        }
+        else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+        {
+            const T s = std::sqrt(T(1) + m[0][0] - m[1][1] - m[2][2]) * T(2);
+            _q = Vector4D<T>(s / T(4), (m[0][1] + m[1][0]) / s, (m[0][2] + m[2][0]) / s, (m[2][1] - m[1][2]) / s);
+        }
+        else if (m[1][1] > m[2][2])
+        {
+            const T s = std::sqrt(T(1) + m[1][1] - m[0][0] - m[2][2]) * T(2);
+            _q = Vector4D<T>((m[0][1] + m[1][0]) / s, s / T(4), (m[1][2] + m[2][1]) / s, (m[0][2] - m[2][0]) / s);
+        }
+        else
+        {
+            const T s = std::sqrt(T(1) + m[2][2] - m[0][0] - m[1][1]) * T(2);
+            _q = Vector4D<T>((m[0][2] + m[2][0]) / s, (m[1][2] + m[2][1]) / s, s / T(4), (m[1][0] - m[0][1]) / s);
+        }
+    }
+
+    Vector4D<T> _q;
+};
+
+template <StreamType T>
+Quaternion<T> operator*(Quaternion<T> lhs, const Quaternion<T> &rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+Quaternion<T> operator*(Quaternion<T> lhs, T rhs) noexcept
+{
+    return lhs *= rhs;
+}
+
+template <StreamType T>
+Quaternion<T> operator+(Quaternion<T> lhs, const Quaternion<T> &rhs) noexcept
+{
+    return lhs += rhs;
+}
+
+template <StreamType T>
+Quaternion<T> operator-(Quaternion<T> lhs, const Quaternion<T> &rhs) noexcept
+{
+    return lhs -= rhs;
+}
+
+template <StreamType T>
+T dot(const Quaternion<T> &lhs, const Quaternion<T> &rhs) noexcept
+{
+    return dot(lhs.coefficients(), rhs.coefficients());
+}
+
+/*
+ * Normalized linear interpolation by the shortest arc,
+ * cheaper than slerp, but angular speed isn't constant
+ */
+template <StreamType T>
+Quaternion<T> nlerp(const Quaternion<T> &a, const Quaternion<T> &b, T t) noexcept
+{
+    const T wb = dot(a, b) < T(0) ? -t : t;
+    Quaternion<T> result = a * (T(1) - t) + b * wb;
+    return result.unit();
+}
+
+/*
+ * Spherical linear interpolation of unit quaternions by the shortest arc
+ */
+template <StreamType T>
+Quaternion<T> slerp(const Quaternion<T> &a, const Quaternion<T> &b, T t) noexcept
+{
+    Quaternion<T> result;
+    _Impl::slerpQuaternionFallback(&a.x(), &b.x(), t, &result.x());
+    return result;
+}
+
+namespace _Quaternion
+{
+template <StreamType T>
+const T *data(const Quaternion<T> *q) noexcept
+{
+    static_assert(sizeof(Quaternion<T>) == 4 * sizeof(T), "Quaternion components must be packed");
+    return reinterpret_cast<const T *>(q);
+}
+
+template <StreamType T>
+T *data(Quaternion<T> *q) noexcept
+{
+    return reinterpret_cast<T *>(q);
+}
+}
+
+/*
+ * Batch slerp of pairs a[i], b[i], output may alias input.
+ * Float version uses series approximation, its error is given at
+ * SlerpTerms (quaternion_implementation.hpp)
+ */
+template <StreamType T>
+void slerp(const Quaternion<T> *a, const Quaternion<T> *b, T t, Quaternion<T> *out, std::size_t count)
+{
+    _OptimizerInternal::slerpQuaternions<T>(_Quaternion::data(a), _Quaternion::data(b), &t, false,
+                                            _Quaternion::data(out), count);
+}
+
+// every pair has it's own t
+template <StreamType T>
+void slerp(const Quaternion<T> *a, const Quaternion<T> *b, const T *t, Quaternion<T> *out, std::size_t count)
+{
+    _OptimizerInternal::slerpQuaternions<T>(_Quaternion::data(a), _Quaternion::data(b), t, true,
+                                            _Quaternion::data(out), count);
+}
+
+/*
+ * Batch rotation of many vectors by one unit quaternion,
+ * output may alias input
+ */
+template <StreamType T>
+void rotate(const Quaternion<T> &q, const Vector3D<T> *in, Vector3D<T> *out, std::size_t count)
+{
+    transformDirections(q.matrix4(), in, out, count);
+}
+
+template <StreamType T>
+void rotate(const Quaternion<T> &q, const VectorArray<T, 3> &in, VectorArray<T, 3> &out)
+{
+    transformDirections(q.matrix4(), in, out);
+}
+
+}
+}
@@ -0,0 +1,204 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of quaternion
+ * operations (see quaternion.hpp).
+ *
+ * Quaternions are stored as 4 packed numbers: imaginary x, y, z and real w.
+ * Intrinsic versions keep whole quaternions in registers (see Quad) and
+ * evaluate every formula for Width / 4 of them at once.
+*/
+
+#include "simd.hpp"
+#include "transform_implementation.hpp"
+#include "vector_array_implementation.hpp"
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+
+namespace _Impl
+{
+/*
+ * Coefficients of sin(t * theta) / sin(theta) series in powers of
+ * (cos(theta) - 1), last term is scaled to compensate truncation
+ * (D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP").
+ * Scale is fitted for 14 terms. Float slerp error is below 3.2e-7 per
+ * component (1M random unit pairs against double acos/sin)
+ */
+inline constexpr std::size_t SlerpTerms = 14;
+inline constexpr double SlerpLastTermScale = 1.90659;
+
+template<typename T>
+constexpr T slerpSeriesA(std::size_t i)
+{
+    const T a = T(1) / T((i + 1) * (2 * i + 3));
+    return i + 1 == SlerpTerms ? a * T(SlerpLastTermScale) : a;
+}
+
+template<typename T>
+constexpr T slerpSeriesB(std::size_t i)
+{
+    const T b = T(i + 1) / T(2 * i + 3);
+    return i + 1 == SlerpTerms ? b * T(SlerpLastTermScale) : b;
+}
+
+// ================================ Fallback ================================ //
+template<typename T>
+void mulQuaternionFallbackImplementation(const T (&a)[4], const T (&b)[4], T (&result)[4]) requires(std::is_floating_point_v<T>)
+{
+    const T x = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    const T y = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+    const T z = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+    const T w = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+    result[0] = x;
+    result[1] = y;
+    result[2] = z;
+    result[3] = w;
+}
+
+// Exact spherical interpolation of unit quaternions by the shortest arc
+template<typename T>
+void slerpQuaternionFallback(const T *a, const T *b, T t, T *result)
+{
+    T d = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+    const T sign = d < T(0) ? T(-1) : T(1);
+    d *= sign;
+
+    T wa = T(1) - t, wb = t;
+    // nearly equal quaternions are interpolated linearly, sin(theta) is too small to divide by
+    if (d < T(1) - T(16) * std::numeric_limits<T>::epsilon())
+    {
+        const T theta = std::acos(d);
+        const T inv = T(1) / std::sin(theta);
+        wa = std::sin(wa * theta) * inv;
+        wb = std::sin(wb * theta) * inv;
+    }
+    wb *= sign;
+    const T x = wa * a[0] + wb * b[0], y = wa * a[1] + wb * b[1];
+    const T z = wa * a[2] + wb * b[2], w = wa * a[3] + wb * b[3];
+    result[0] = x;
+    result[1] = y;
+    result[2] = z;
+    result[3] = w;
+}
+
+/*
+ * Pair i is interpolated by t[i], if "perPair" is set, otherwise
+ * all pairs share t[0]. Result may alias operands
+ */
+template<typename T>
+void slerpQuaternionsFallbackImplementation(const T *a, const T *b, const T *t, bool perPair,
+                                            T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        slerpQuaternionFallback(a + i * 4, b + i * 4, t[perPair ? i : 0], result + i * 4);
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * Hamilton product of packed quaternions:
+ *  a * b = aw * b + ax * (bw, -bz, by, -bx) + ay * (bz, bw, -bx, -by) + az * (-by, bx, bw, -bz)
+ */
+template<typename T, typename Isa>
+struct Hamilton
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    using Register = typename L::Register;
+
+    Register signX, signY, signZ;
+
+    Hamilton() noexcept
+        : signX(pattern(1, -1, 1, -1)), signY(pattern(1, 1, -1, -1)), signZ(pattern(-1, 1, 1, -1))
+    {}
+
+    Register product(Register a, Register b) const noexcept
+    {
+        Register result = L::mul(Q::template splat<3>(a), b);
+        result = L::fmadd(Q::template splat<0>(a), L::mul(Q::template permute<_MM_SHUFFLE(0, 1, 2, 3)>(b), signX), result);
+        result = L::fmadd(Q::template splat<1>(a), L::mul(Q::template permute<_MM_SHUFFLE(1, 0, 3, 2)>(b), signY), result);
+        return L::fmadd(Q::template splat<2>(a), L::mul(Q::template permute<_MM_SHUFFLE(2, 3, 0, 1)>(b), signZ), result);
+    }
+
+private:
+    static Register pattern(T x, T y, T z, T w) noexcept
+    {
+        const T components[4] = {x, y, z, w};
+        alignas(sizeof(Register)) T values[L::Width];
+        for (std::size_t i = 0; i < L::Width; ++i)
+            values[i] = components[i % 4];
+        return L::load(values);
+    }
+};
+
+// Single quaternion, instruction set register must hold exactly one
+template<typename Isa, typename T>
+void mulQuaternionIntrinImplementation(const T (&a)[4], const T (&b)[4], T (&result)[4])
+{
+    using L = Lanes<T, Isa>;
+    static_assert(L::Width == 4, "Register must hold one quaternion");
+    const Hamilton<T, Isa> hamilton;
+    L::store(result, hamilton.product(L::load(a), L::load(b)));
+}
+
+/*
+ * Spherical interpolation without trigonometry: weights are evaluated
+ * by truncated series (see slerpSeriesA), its error is about float
+ * rounding, so it's used for float quaternions only
+ */
+template<typename Isa, typename T>
+void slerpQuaternionsIntrinImplementation(const T *a, const T *b, const T *t, bool perPair,
+                                          T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    constexpr std::size_t PerRegister = L::Width / 4;
+    using Register = typename L::Register;
+
+    Register seriesA[SlerpTerms], seriesB[SlerpTerms];
+    for (std::size_t k = 0; k < SlerpTerms; ++k)
+    {
+        seriesA[k] = L::set1(slerpSeriesA<T>(k));
+        seriesB[k] = L::set1(-slerpSeriesB<T>(k));
+    }
+    const Register one = L::set1(T(1));
+    const Register shared = L::set1(t[0]);
+
+    streamLoop<L>(count * 4, [&](std::size_t i, auto load, auto store) {
+        const Register qa = load(a + i), qb = load(b + i);
+        Register t1 = shared;
+        if (perPair)
+        {
+            // t of every quaternion goes over its components, the last register may be partial
+            const std::size_t first = i / 4;
+            T tail[PerRegister] = {};
+            const T *source = t + first;
+            if (first + PerRegister > count)
+            {
+                for (std::size_t j = 0; first + j < count; ++j)
+                    tail[j] = t[first + j];
+                source = tail;
+            }
+            t1 = Q::spread(source);
+        }
+
+        // shortest arc: series is evaluated for |cos(theta)|, sign goes to b weight
+        const Register cosine = sumQuad<T, Isa>(L::mul(qa, qb));
+        const Register cosineM1 = L::sub(L::abs(cosine), one);
+        const Register t0 = L::sub(one, t1);
+        const Register square0 = L::mul(t0, t0), square1 = L::mul(t1, t1);
+        // Horner scheme: t * (1 + f0 * (1 + f1 * (...))), fk = (ak * t^2 - bk) * (cos - 1)
+        Register weight0 = one, weight1 = one;
+        for (std::size_t k = SlerpTerms; k--;)
+        {
+            weight0 = L::fmadd(weight0, L::mul(L::fmadd(seriesA[k], square0, seriesB[k]), cosineM1), one);
+            weight1 = L::fmadd(weight1, L::mul(L::fmadd(seriesA[k], square1, seriesB[k]), cosineM1), one);
+        }
+        weight0 = L::mul(weight0, t0);
+        weight1 = L::mulSign(L::mul(weight1, t1), cosine);
+        store(result + i, L::fmadd(weight0, qa, L::mul(weight1, qb)));
+    });
+}
+
+}
@@ -0,0 +1,293 @@
+#pragma once
+/*
+ * File contains reductions of large vector arrays
+ *
+ *  sum(), mean()       - per-component sums, Summation::Compensated keeps
+ *                        the rounding error of every add (TwoSum)
+ *  centroid()          - mean of points, compensated
+ *  bounds()            - per-component min and max, NaN is skipped
+ *  covariance()        - population covariance matrix, by deviations from mean
+ *
+ * Every function takes arrays of Vector<float|double, Dim> or VectorArray
+ * streams. Kernels are dispatched by Optimizer. Inputs are cut into blocks
+ * of fixed size, blocks are reduced by threads of Parallel::ThreadPool
+ * and their partial results are added in block order, so results don't
+ * depend on thread count. "threads" limits worker count, 0 means hardware
+ * concurrency.
+*/
+
+#include "parallel.hpp"
+#include "vector_array.hpp"
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+// accuracy of sums: lane order adds or compensated ones
+using Summation = _Impl::Summation;
+
+template <StreamType T, std::size_t Dim>
+struct Bounds
+{
+    Vector<T, Dim> min;
+    Vector<T, Dim> max;
+
+    // no vectors were bounded, min is +inf and max is -inf
+    bool empty() const noexcept { return !(min[0] <= max[0]); }
+};
+
+namespace _Reduction
+{
+// vectors per block, partial results of blocks don't depend on threads
+inline constexpr std::size_t BlockSize = 4096;
+// blocks per thread at least, so thread start is paid off
+inline constexpr std::size_t MinBlocks = 4;
+// vectors copied to streams at once, when covariance of interleaved vectors is taken
+inline constexpr std::size_t StagingSize = 256;
+
+// numbers per vector of interleaved arrays
+template <StreamType T, std::size_t Dim>
+inline constexpr std::size_t Stride = sizeof(Vector<T, Dim>) / sizeof(T);
+
+/*
+ * Runs reduce(first, size, partial) for every block of "count" items,
+ * partial holds "width" numbers of the block, partials come in block order
+ */
+template <typename T, typename Reduce>
+std::vector<T> reduceBlocks(std::size_t count, std::size_t width, unsigned threads, Reduce reduce)
+{
+    const std::size_t blocks = count ? (count + BlockSize - 1) / BlockSize : 1;
+    std::vector<T> partials(blocks * width);
+    Parallel::parallelChunks(blocks, threads, MinBlocks, 1, [&](std::size_t first, std::size_t size) {
+        for (std::size_t b = first; b < first + size; ++b)
+            reduce(b * BlockSize, std::min(BlockSize, count - b * BlockSize), partials.data() + b * width);
+    });
+    return partials;
+}
+
+// partials hold Dim sums and Dim errors per block
+template <Summation Mode, StreamType T, std::size_t Dim>
+Vector<T, Dim> addPartials(const std::vector<T> &partials)
+{
+    using L = _Impl::Lanes<T, _Impl::Scalar>;
+    T sum[Dim] = {}, error[Dim] = {};
+    for (std::size_t b = 0; b < partials.size(); b += 2 * Dim)
+        for (std::size_t k = 0; k < Dim; ++k)
+        {
+            if constexpr (Mode == Summation::Compensated)
+            {
+                _Impl::twoSum<L>(sum[k], partials[b + k], error[k]);
+                error[k] += partials[b + Dim + k];
+            }
+            else
+                sum[k] += partials[b + k];
+        }
+    Vector<T, Dim> result;
+    for (std::size_t k = 0; k < Dim; ++k)
+        result[k] = sum[k] + error[k];
+    return result;
+}
+
+// partials hold Dim minimums and Dim maximums per block
+template <StreamType T, std::size_t Dim>
+Bounds<T, Dim> boundPartials(const std::vector<T> &partials)
+{
+    Bounds<T, Dim> result;
+    for (std::size_t k = 0; k < Dim; ++k)
+    {
+        result.min[k] = std::numeric_limits<T>::infinity();
+        result.max[k] = -std::numeric_limits<T>::infinity();
+    }
+    for (std::size_t b = 0; b < partials.size(); b += 2 * Dim)
+        for (std::size_t k = 0; k < Dim; ++k)
+        {
+            result.min[k] = partials[b + k] < result.min[k] ? partials[b + k] : result.min[k];
+            result.max[k] = partials[b + Dim + k] > result.max[k] ? partials[b + Dim + k] : result.max[k];
+        }
+    return result;
+}
+
+// partials hold upper triangles of Dim x Dim sums per block
+template <StreamType T, std::size_t Dim>
+Matrix<T, Dim, Dim> covariancePartials(const std::vector<T> &partials, std::size_t count)
+{
+    constexpr std::size_t Pairs = Dim * (Dim + 1) / 2;
+    T sum[Pairs] = {};
+    for (std::size_t b = 0; b < partials.size(); b += Pairs)
+        for (std::size_t p = 0; p < Pairs; ++p)
+            sum[p] += partials[b + p];
+    Matrix<T, Dim, Dim> result;
+    for (std::size_t r = 0, p = 0; r < Dim; ++r)
+        for (std::size_t c = r; c < Dim; ++c, ++p)
+            result[r][c] = result[c][r] = sum[p] / T(count);
+    return result;
+}
+
+template <Summation Mode, StreamType T, std::size_t Dim>
+Vector<T, Dim> sum(const Vector<T, Dim> *in, std::size_t count, unsigned threads)
+{
+    constexpr std::size_t S = Stride<T, Dim>;
+    static_assert(S <= 4, "Vector must be packed");
+    const T *data = reinterpret_cast<const T *>(in);
+    const auto partials = reduceBlocks<T>(count, 2 * Dim, threads, [=](std::size_t first, std::size_t size, T *partial) {
+        T sum[S], error[S];
+        _OptimizerInternal::sumStream<T, S, Mode>(data + first * S, size, sum, error);
+        for (std::size_t k = 0; k < Dim; ++k)
+        {
+            partial[k] = sum[k];
+            partial[Dim + k] = error[k];
+        }
+    });
+    return addPartials<Mode, T, Dim>(partials);
+}
+
+template <Summation Mode, StreamType T, std::size_t Dim>
+Vector<T, Dim> sum(const VectorArray<T, Dim> &in, unsigned threads)
+{
+    const Streams streams(in);
+    const auto partials = reduceBlocks<T>(in.size(), 2 * Dim, threads, [&](std::size_t first, std::size_t size, T *partial) {
+        for (std::size_t k = 0; k < Dim; ++k)
+            _OptimizerInternal::sumStream<T, 1, Mode>(streams.data[k] + first, size, partial + k, partial + Dim + k);
+    });
+    return addPartials<Mode, T, Dim>(partials);
+}
+}
+
+/*
+ * Per-component sums, count may be 0
+ */
+template <Summation Mode = Summation::Fast, StreamType T, std::size_t Dim>
+Vector<T, Dim> sum(const Vector<T, Dim> *in, std::size_t count, unsigned threads = 0)
+{
+    return _Reduction::sum<Mode>(in, count, threads);
+}
+
+template <Summation Mode = Summation::Fast, StreamType T, std::size_t Dim>
+Vector<T, Dim> sum(const VectorArray<T, Dim> &in, unsigned threads = 0)
+{
+    return _Reduction::sum<Mode>(in, threads);
+}
+
+/*
+ * Per-component means, count must not be 0
+ */
+template <Summation Mode = Summation::Fast, StreamType T, std::size_t Dim>
+Vector<T, Dim> mean(const Vector<T, Dim> *in, std::size_t count, unsigned threads = 0)
+{
+    assert(count && "Mean of no vectors");
+    return _Reduction::sum<Mode>(in, count, threads) / T(count);
+}
+
+template <Summation Mode = Summation::Fast, StreamType T, std::size_t Dim>
+Vector<T, Dim> mean(const VectorArray<T, Dim> &in, unsigned threads = 0)
+{
+    assert(in.size() && "Mean of no vectors");
+    return _Reduction::sum<Mode>(in, threads) / T(in.size());
+}
+
+/*
+ * Mean of points, compensated: far from origin plain sums of
+ * many points lose the digits, which tell points apart
+ */
+template <StreamType T, std::size_t Dim>
+Vector<T, Dim> centroid(const Vector<T, Dim> *points, std::size_t count, unsigned threads = 0)
+{
+    return mean<Summation::Compensated>(points, count, threads);
+}
+
+template <StreamType T, std::size_t Dim>
+Vector<T, Dim> centroid(const VectorArray<T, Dim> &points, unsigned threads = 0)
+{
+    return mean<Summation::Compensated>(points, threads);
+}
+
+/*
+ * Per-component min and max, NaN components are skipped,
+ * no vectors give empty bounds
+ */
+template <StreamType T, std::size_t Dim>
+Bounds<T, Dim> bounds(const Vector<T, Dim> *in, std::size_t count, unsigned threads = 0)
+{
+    constexpr std::size_t S = _Reduction::Stride<T, Dim>;
+    static_assert(S <= 4, "Vector must be packed");
+    const T *data = reinterpret_cast<const T *>(in);
+    const auto partials = _Reduction::reduceBlocks<T>(count, 2 * Dim, threads, [=](std::size_t first, std::size_t size, T *partial) {
+        T min[S], max[S];
+        _OptimizerInternal::boundsStream<T, S>(data + first * S, size, min, max);
+        for (std::size_t k = 0; k < Dim; ++k)
+        {
+            partial[k] = min[k];
+            partial[Dim + k] = max[k];
+        }
+    });
+    return _Reduction::boundPartials<T, Dim>(partials);
+}
+
+template <StreamType T, std::size_t Dim>
+Bounds<T, Dim> bounds(const VectorArray<T, Dim> &in, unsigned threads = 0)
+{
+    const Streams streams(in);
+    const auto partials = _Reduction::reduceBlocks<T>(in.size(), 2 * Dim, threads, [&](std::size_t first, std::size_t size, T *partial) {
+        for (std::size_t k = 0; k < Dim; ++k)
+            _OptimizerInternal::boundsStream<T, 1>(streams.data[k] + first, size, partial + k, partial + Dim + k);
+    });
+    return _Reduction::boundPartials<T, Dim>(partials);
+}
+
+/*
+ * Population covariance (divided by count) of Dim = 2..4 components,
+ * deviations are taken from the compensated mean, count must not be 0
+ */
+template <StreamType T, std::size_t Dim>
+Matrix<T, Dim, Dim> covariance(const Vector<T, Dim> *in, std::size_t count, unsigned threads = 0)
+{
+    static_assert(Dim >= 2 && Dim <= 4, "Covariance of 2..4 components");
+    constexpr std::size_t Pairs = Dim * (Dim + 1) / 2;
+    const Vector<T, Dim> center = mean<Summation::Compensated>(in, count, threads);
+    const auto partials = _Reduction::reduceBlocks<T>(count, Pairs, threads, [&](std::size_t first, std::size_t size, T *partial) {
+        // interleaved vectors are copied to streams by parts
+        T staging[Dim][_Reduction::StagingSize];
+        const T *streams[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            streams[k] = staging[k];
+        for (std::size_t p = 0; p < Pairs; ++p)
+            partial[p] = T(0);
+        for (std::size_t i = first; i < first + size; i += _Reduction::StagingSize)
+        {
+            const std::size_t n = std::min(_Reduction::StagingSize, first + size - i);
+            for (std::size_t j = 0; j < n; ++j)
+                for (std::size_t k = 0; k < Dim; ++k)
+                    staging[k][j] = in[i + j][k];
+            T sums[Pairs];
+            _OptimizerInternal::covarianceStream<T, Dim>(streams, &center[0], n, sums);
+            for (std::size_t p = 0; p < Pairs; ++p)
+                partial[p] += sums[p];
+        }
+    });
+    return _Reduction::covariancePartials<T, Dim>(partials, count);
+}
+
+template <StreamType T, std::size_t Dim>
+Matrix<T, Dim, Dim> covariance(const VectorArray<T, Dim> &in, unsigned threads = 0)
+{
+    static_assert(Dim >= 2 && Dim <= 4, "Covariance of 2..4 components");
+    constexpr std::size_t Pairs = Dim * (Dim + 1) / 2;
+    const Vector<T, Dim> center = mean<Summation::Compensated>(in, threads);
+    const Streams streams(in);
+    const auto partials = _Reduction::reduceBlocks<T>(in.size(), Pairs, threads, [&](std::size_t first, std::size_t size, T *partial) {
+        const T *block[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            block[k] = streams.data[k] + first;
+        _OptimizerInternal::covarianceStream<T, Dim>(block, &center[0], size, partial);
+    });
+    return _Reduction::covariancePartials<T, Dim>(partials, in.size());
+}
+
+}
+}
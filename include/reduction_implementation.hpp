@@ -0,0 +1,230 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of reductions of
+ * vector arrays (see reduction.hpp).
+ *
+ * Sum and bounds kernels take "count" vectors, whose components are
+ * Stride numbers apart: interleaved Vector<T,Dim> arrays or, with Stride 1,
+ * single VectorArray streams. Every step loads Chains registers, which
+ * is a multiple of Stride numbers, so every lane keeps one component and
+ * independent chains hide add latency. Lanes are folded in the end.
+ * Compensated sums carry the rounding error of every add (TwoSum) in
+ * error registers. Bounds skip NaN. Covariance kernel takes component
+ * streams and sums products of their deviations from mean.
+ * Fallbacks run the same kernels with Lanes<T, Scalar>.
+*/
+
+#include "simd.hpp"
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+
+namespace _Impl
+{
+enum class Summation
+{
+    Fast,           // one add per number, lane order
+    Compensated     // TwoSum error of every add is carried and added in the end
+};
+
+// sum + x, rounding error of the add is accumulated to error
+template<typename L>
+void twoSum(typename L::Register &sum, typename L::Register x, typename L::Register &error) noexcept
+{
+    const auto t = L::add(sum, x);
+    const auto bp = L::sub(t, sum);
+    error = L::add(error, L::add(L::sub(sum, L::sub(t, bp)), L::sub(x, bp)));
+    sum = t;
+}
+
+// independent accumulators, a multiple of Stride
+template<std::size_t Stride>
+inline constexpr std::size_t ReductionChains = Stride == 3 ? 3 : 4;
+
+// ================================ Intrinsic =============================== //
+/*
+ * sum[k] and error[k] of component k < Stride, result is sum[k] + error[k],
+ * error is 0 for Summation::Fast
+ */
+template<typename Isa, typename T, std::size_t Stride, Summation Mode>
+void sumStreamIntrinImplementation(const T *in, std::size_t count, T *sum, T *error)
+{
+    using L = Lanes<T, Isa>;
+    using ScalarL = Lanes<T, Scalar>;
+    constexpr std::size_t Chains = ReductionChains<Stride>;
+    constexpr std::size_t Step = Chains * L::Width;
+    static_assert(Chains % Stride == 0);
+
+    typename L::Register s[Chains], e[Chains];
+    for (std::size_t c = 0; c < Chains; ++c)
+        s[c] = e[c] = L::zero();
+    const std::size_t n = count * Stride;
+    std::size_t i = 0;
+    for (; i + Step <= n; i += Step)
+        for (std::size_t c = 0; c < Chains; ++c)
+        {
+            const auto x = L::load(in + i + c * L::Width);
+            if constexpr (Mode == Summation::Compensated)
+                twoSum<L>(s[c], x, e[c]);
+            else
+                s[c] = L::add(s[c], x);
+        }
+
+    alignas(64) T lanes[Chains][L::Width], errors[Chains][L::Width];
+    for (std::size_t c = 0; c < Chains; ++c)
+    {
+        L::store(lanes[c], s[c]);
+        L::store(errors[c], e[c]);
+    }
+    T total[Stride] = {}, correction[Stride] = {};
+    for (std::size_t c = 0; c < Chains; ++c)
+        for (std::size_t j = 0; j < L::Width; ++j)
+        {
+            const std::size_t k = (c * L::Width + j) % Stride;
+            if constexpr (Mode == Summation::Compensated)
+            {
+                twoSum<ScalarL>(total[k], lanes[c][j], correction[k]);
+                correction[k] += errors[c][j];
+            }
+            else
+                total[k] += lanes[c][j];
+        }
+    // i is a multiple of Stride, so the tail starts with component 0
+    for (; i < n; ++i)
+    {
+        if constexpr (Mode == Summation::Compensated)
+            twoSum<ScalarL>(total[i % Stride], in[i], correction[i % Stride]);
+        else
+            total[i % Stride] += in[i];
+    }
+    for (std::size_t k = 0; k < Stride; ++k)
+    {
+        sum[k] = total[k];
+        error[k] = correction[k];
+    }
+}
+
+// min[k] and max[k] of component k < Stride, NaN is skipped, no numbers give +inf and -inf
+template<typename Isa, typename T, std::size_t Stride>
+void boundsStreamIntrinImplementation(const T *in, std::size_t count, T *min, T *max)
+{
+    using L = Lanes<T, Isa>;
+    constexpr std::size_t Chains = ReductionChains<Stride>;
+    constexpr std::size_t Step = Chains * L::Width;
+    constexpr T Inf = std::numeric_limits<T>::infinity();
+
+    typename L::Register lo[Chains], hi[Chains];
+    for (std::size_t c = 0; c < Chains; ++c)
+    {
+        lo[c] = L::set1(Inf);
+        hi[c] = L::set1(-Inf);
+    }
+    const std::size_t n = count * Stride;
+    std::size_t i = 0;
+    for (; i + Step <= n; i += Step)
+        for (std::size_t c = 0; c < Chains; ++c)
+        {
+            // the second operand is taken, where the first one is NaN
+            const auto x = L::load(in + i + c * L::Width);
+            lo[c] = L::min(x, lo[c]);
+            hi[c] = L::max(x, hi[c]);
+        }
+
+    alignas(64) T lows[Chains][L::Width], highs[Chains][L::Width];
+    for (std::size_t c = 0; c < Chains; ++c)
+    {
+        L::store(lows[c], lo[c]);
+        L::store(highs[c], hi[c]);
+    }
+    T low[Stride], high[Stride];
+    for (std::size_t k = 0; k < Stride; ++k)
+    {
+        low[k] = Inf;
+        high[k] = -Inf;
+    }
+    for (std::size_t c = 0; c < Chains; ++c)
+        for (std::size_t j = 0; j < L::Width; ++j)
+        {
+            const std::size_t k = (c * L::Width + j) % Stride;
+            low[k] = lows[c][j] < low[k] ? lows[c][j] : low[k];
+            high[k] = highs[c][j] > high[k] ? highs[c][j] : high[k];
+        }
+    for (; i < n; ++i)
+    {
+        const std::size_t k = i % Stride;
+        low[k] = in[i] < low[k] ? in[i] : low[k];
+        high[k] = in[i] > high[k] ? in[i] : high[k];
+    }
+    for (std::size_t k = 0; k < Stride; ++k)
+    {
+        min[k] = low[k];
+        max[k] = high[k];
+    }
+}
+
+/*
+ * Sums of (in[r] - mean[r]) * (in[c] - mean[c]) over "count" vectors,
+ * result holds upper triangle r <= c row by row, Dim * (Dim + 1) / 2 numbers
+ */
+template<typename Isa, typename T, std::size_t Dim>
+void covarianceStreamIntrinImplementation(const T *const *in, const T *mean, std::size_t count, T *result)
+{
+    using L = Lanes<T, Isa>;
+    constexpr std::size_t Pairs = Dim * (Dim + 1) / 2;
+
+    typename L::Register m[Dim], accum[Pairs];
+    for (std::size_t k = 0; k < Dim; ++k)
+        m[k] = L::set1(mean[k]);
+    for (std::size_t p = 0; p < Pairs; ++p)
+        accum[p] = L::zero();
+    std::size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+    {
+        typename L::Register d[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            d[k] = L::sub(L::load(in[k] + i), m[k]);
+        for (std::size_t r = 0, p = 0; r < Dim; ++r)
+            for (std::size_t c = r; c < Dim; ++c, ++p)
+                accum[p] = L::fmadd(d[r], d[c], accum[p]);
+    }
+
+    alignas(64) T lanes[L::Width];
+    for (std::size_t p = 0; p < Pairs; ++p)
+    {
+        L::store(lanes, accum[p]);
+        T total = lanes[0];
+        for (std::size_t j = 1; j < L::Width; ++j)
+            total += lanes[j];
+        result[p] = total;
+    }
+    for (; i < count; ++i)
+    {
+        T d[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            d[k] = in[k][i] - mean[k];
+        for (std::size_t r = 0, p = 0; r < Dim; ++r)
+            for (std::size_t c = r; c < Dim; ++c, ++p)
+                result[p] += d[r] * d[c];
+    }
+}
+
+// ================================ Fallback ================================ //
+template<typename T, std::size_t Stride, Summation Mode>
+void sumStreamFallbackImplementation(const T *in, std::size_t count, T *sum, T *error) requires(std::is_floating_point_v<T>)
+{
+    sumStreamIntrinImplementation<Scalar, T, Stride, Mode>(in, count, sum, error);
+}
+
+template<typename T, std::size_t Stride>
+void boundsStreamFallbackImplementation(const T *in, std::size_t count, T *min, T *max) requires(std::is_floating_point_v<T>)
+{
+    boundsStreamIntrinImplementation<Scalar, T, Stride>(in, count, min, max);
+}
+
+template<typename T, std::size_t Dim>
+void covarianceStreamFallbackImplementation(const T *const *in, const T *mean, std::size_t count, T *result) requires(std::is_floating_point_v<T>)
+{
+    covarianceStreamIntrinImplementation<Scalar, T, Dim>(in, mean, count, result);
+}
+}
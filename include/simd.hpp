@@ -0,0 +1,446 @@
+#pragma once
+/*
+ * File contains thin wrappers over x86 SIMD registers, so the same kernel
+ * can be instantiated for SSE, AVX2 and AVX-512 instruction sets.
+ *
+ * Lanes<T, Isa> exposes register width and basic lane-wise operations for
+ * floating-point type T. Loads and stores are unaligned, partial versions
+ * touch only first "count" elements of memory. Gathers read lane k from
+ * base[offsets[k]], offsets hold Width numbers. Blends take b in lanes,
+ * where selector is negative, and a elsewhere. SSE lanes fuse, round and
+ * blend by FMA and SSE4.1 instructions, where the build enables them, so
+ * Optimizer::hasSseFeatures() checks those too. CompiledIsa names the widest
+ * instruction set of the build.
+*/
+
+#include "immintrin.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * GCC 12 reports the undefined passthrough register of some AVX-512
+ * intrinsics (min, max, sqrt, permutes, broadcasts, conversions and others
+ * with unmasked form built over a masked one) as uninitialized, once they are
+ * inlined into a caller. Wrappers calling such intrinsics are enclosed into
+ * these, nothing else is.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Wuninitialized\"") \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define GEOMETRIX_UNDEFINED_PASSTHROUGH_END _Pragma("GCC diagnostic pop")
+#else
+#define GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+#define GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+
+namespace _Impl
+{
+// instruction set tags
+struct SSE {};
+struct AVX2 {};
+struct AVX512 {};
+// one element per "register", lets fallbacks share kernels with SIMD versions
+struct Scalar {};
+
+template<typename T, typename Isa>
+struct Lanes;
+
+template<typename T>
+struct Lanes<T, Scalar>
+{
+    using Type = T;
+    using Register = T;
+    static constexpr std::size_t Width = 1;
+
+    static Register load(const T *p) noexcept { return *p; }
+    static void store(T *p, Register v) noexcept { *p = v; }
+    static void stream(T *p, Register v) noexcept { *p = v; }
+    static Register loadPartial(const T *p, std::size_t) noexcept { return *p; }
+    static void storePartial(T *p, Register v, std::size_t) noexcept { *p = v; }
+
+    static Register set1(T v) noexcept { return v; }
+    static Register zero() noexcept { return T(0); }
+    static Register add(Register a, Register b) noexcept { return a + b; }
+    static Register sub(Register a, Register b) noexcept { return a - b; }
+    static Register mul(Register a, Register b) noexcept { return a * b; }
+    static Register div(Register a, Register b) noexcept { return a / b; }
+    static Register min(Register a, Register b) noexcept { return a < b ? a : b; }
+    static Register max(Register a, Register b) noexcept { return a > b ? a : b; }
+    static Register sqrt(Register a) noexcept { return std::sqrt(a); }
+    static Register fmadd(Register a, Register b, Register c) noexcept { return a * b + c; }
+    static Register abs(Register a) noexcept { return std::abs(a); }
+    static Register floor(Register a) noexcept { return std::floor(a); }
+    // a with sign flipped, where b is negative
+    static Register mulSign(Register a, Register b) noexcept { return std::signbit(b) ? -a : a; }
+    static Register gather(const T *base, const std::int32_t *offsets) noexcept { return base[*offsets]; }
+    static Register blend(Register a, Register b, Register selector) noexcept { return std::signbit(selector) ? b : a; }
+};
+
+#ifdef __SSE2__
+template<>
+struct Lanes<float, SSE>
+{
+    using Type = float;
+    using Register = __m128;
+    static constexpr std::size_t Width = 4;
+
+    static Register load(const float *p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float *p, Register v) noexcept { _mm_storeu_ps(p, v); }
+    // non-temporal store, p must be aligned to register size
+    static void stream(float *p, Register v) noexcept { _mm_stream_ps(p, v); }
+    static Register loadPartial(const float *p, std::size_t count) noexcept
+    {
+        alignas(16) float tmp[Width] = {};
+        for (std::size_t i = count; i--; tmp[i] = p[i]);
+        return _mm_load_ps(tmp);
+    }
+    static void storePartial(float *p, Register v, std::size_t count) noexcept
+    {
+        alignas(16) float tmp[Width];
+        _mm_store_ps(tmp, v);
+        for (std::size_t i = count; i--; p[i] = tmp[i]);
+    }
+
+    static Register set1(float v) noexcept { return _mm_set1_ps(v); }
+    static Register zero() noexcept { return _mm_setzero_ps(); }
+    static Register add(Register a, Register b) noexcept { return _mm_add_ps(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_ps(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm_mul_ps(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm_div_ps(a, b); }
+    static Register min(Register a, Register b) noexcept { return _mm_min_ps(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm_max_ps(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm_sqrt_ps(a); }
+    // a * b + c
+    static Register fmadd(Register a, Register b, Register c) noexcept
+    {
+#ifdef __FMA__
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+    static Register abs(Register a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    // SSE4.1 builds run on CPUs with SSE4.1 only (Optimizer::hasSseFeatures()), SSE2 ones emulate
+    static Register floor(Register a) noexcept
+    {
+#ifdef __SSE4_1__
+        return _mm_floor_ps(a);
+#else
+        // numbers below 2^23 are rounded by adding it with their sign, bigger ones are integral
+        const Register sign = _mm_and_ps(a, _mm_set1_ps(-0.f)), big = _mm_set1_ps(8388608.f);
+        const Register magic = _mm_or_ps(sign, big);
+        Register r = _mm_sub_ps(_mm_add_ps(a, magic), magic);
+        r = _mm_or_ps(_mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, a), _mm_set1_ps(1.f))), sign);
+        const Register small = _mm_cmplt_ps(abs(a), big);
+        return _mm_or_ps(_mm_and_ps(small, r), _mm_andnot_ps(small, a));
+#endif
+    }
+    static Register mulSign(Register a, Register b) noexcept { return _mm_xor_ps(a, _mm_and_ps(b, _mm_set1_ps(-0.f))); }
+    static Register gather(const float *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm_setr_ps(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept
+    {
+#ifdef __SSE4_1__
+        return _mm_blendv_ps(a, b, selector);
+#else
+        const Register mask = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(selector), 31));
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+#endif
+    }
+};
+
+template<>
+struct Lanes<double, SSE>
+{
+    using Type = double;
+    using Register = __m128d;
+    static constexpr std::size_t Width = 2;
+
+    static Register load(const double *p) noexcept { return _mm_loadu_pd(p); }
+    static void store(double *p, Register v) noexcept { _mm_storeu_pd(p, v); }
+    static void stream(double *p, Register v) noexcept { _mm_stream_pd(p, v); }
+    static Register loadPartial(const double *p, std::size_t count) noexcept
+    {
+        return count ? _mm_load_sd(p) : _mm_setzero_pd();
+    }
+    static void storePartial(double *p, Register v, std::size_t count) noexcept
+    {
+        if (count)
+            _mm_store_sd(p, v);
+    }
+
+    static Register set1(double v) noexcept { return _mm_set1_pd(v); }
+    static Register zero() noexcept { return _mm_setzero_pd(); }
+    static Register add(Register a, Register b) noexcept { return _mm_add_pd(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm_sub_pd(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm_mul_pd(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm_div_pd(a, b); }
+    static Register min(Register a, Register b) noexcept { return _mm_min_pd(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm_max_pd(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm_sqrt_pd(a); }
+    static Register fmadd(Register a, Register b, Register c) noexcept
+    {
+#ifdef __FMA__
+        return _mm_fmadd_pd(a, b, c);
+#else
+        return _mm_add_pd(_mm_mul_pd(a, b), c);
+#endif
+    }
+    static Register abs(Register a) noexcept { return _mm_andnot_pd(_mm_set1_pd(-0.), a); }
+    static Register floor(Register a) noexcept
+    {
+#ifdef __SSE4_1__
+        return _mm_floor_pd(a);
+#else
+        const Register sign = _mm_and_pd(a, _mm_set1_pd(-0.)), big = _mm_set1_pd(4503599627370496.);
+        const Register magic = _mm_or_pd(sign, big);
+        Register r = _mm_sub_pd(_mm_add_pd(a, magic), magic);
+        r = _mm_or_pd(_mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, a), _mm_set1_pd(1.))), sign);
+        const Register small = _mm_cmplt_pd(abs(a), big);
+        return _mm_or_pd(_mm_and_pd(small, r), _mm_andnot_pd(small, a));
+#endif
+    }
+    static Register mulSign(Register a, Register b) noexcept { return _mm_xor_pd(a, _mm_and_pd(b, _mm_set1_pd(-0.))); }
+    static Register gather(const double *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm_setr_pd(base[offsets[0]], base[offsets[1]]);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept
+    {
+#ifdef __SSE4_1__
+        return _mm_blendv_pd(a, b, selector);
+#else
+        const __m128i sign = _mm_srai_epi32(_mm_castpd_si128(selector), 31);
+        const Register mask = _mm_castsi128_pd(_mm_shuffle_epi32(sign, _MM_SHUFFLE(3, 3, 1, 1)));
+        return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+#endif
+    }
+};
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+struct Lanes<float, AVX2>
+{
+    using Type = float;
+    using Register = __m256;
+    static constexpr std::size_t Width = 8;
+
+    static __m256i mask(std::size_t count) noexcept
+    {
+        return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)),
+                                  _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    }
+
+    static Register load(const float *p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float *p, Register v) noexcept { _mm256_storeu_ps(p, v); }
+    static void stream(float *p, Register v) noexcept { _mm256_stream_ps(p, v); }
+    static Register loadPartial(const float *p, std::size_t count) noexcept
+    {
+        return _mm256_maskload_ps(p, mask(count));
+    }
+    static void storePartial(float *p, Register v, std::size_t count) noexcept
+    {
+        _mm256_maskstore_ps(p, mask(count), v);
+    }
+
+    static Register set1(float v) noexcept { return _mm256_set1_ps(v); }
+    static Register zero() noexcept { return _mm256_setzero_ps(); }
+    static Register add(Register a, Register b) noexcept { return _mm256_add_ps(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_ps(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm256_mul_ps(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm256_div_ps(a, b); }
+    static Register min(Register a, Register b) noexcept { return _mm256_min_ps(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm256_max_ps(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm256_sqrt_ps(a); }
+    static Register fmadd(Register a, Register b, Register c) noexcept { return _mm256_fmadd_ps(a, b, c); }
+    static Register abs(Register a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static Register floor(Register a) noexcept { return _mm256_floor_ps(a); }
+    static Register mulSign(Register a, Register b) noexcept { return _mm256_xor_ps(a, _mm256_and_ps(b, _mm256_set1_ps(-0.f))); }
+    static Register gather(const float *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets)), 4);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept { return _mm256_blendv_ps(a, b, selector); }
+};
+
+template<>
+struct Lanes<double, AVX2>
+{
+    using Type = double;
+    using Register = __m256d;
+    static constexpr std::size_t Width = 4;
+
+    static __m256i mask(std::size_t count) noexcept
+    {
+        return _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(count)),
+                                  _mm256_setr_epi64x(0, 1, 2, 3));
+    }
+
+    static Register load(const double *p) noexcept { return _mm256_loadu_pd(p); }
+    static void store(double *p, Register v) noexcept { _mm256_storeu_pd(p, v); }
+    static void stream(double *p, Register v) noexcept { _mm256_stream_pd(p, v); }
+    static Register loadPartial(const double *p, std::size_t count) noexcept
+    {
+        return _mm256_maskload_pd(p, mask(count));
+    }
+    static void storePartial(double *p, Register v, std::size_t count) noexcept
+    {
+        _mm256_maskstore_pd(p, mask(count), v);
+    }
+
+    static Register set1(double v) noexcept { return _mm256_set1_pd(v); }
+    static Register zero() noexcept { return _mm256_setzero_pd(); }
+    static Register add(Register a, Register b) noexcept { return _mm256_add_pd(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm256_sub_pd(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm256_mul_pd(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm256_div_pd(a, b); }
+    static Register min(Register a, Register b) noexcept { return _mm256_min_pd(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm256_max_pd(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm256_sqrt_pd(a); }
+    static Register fmadd(Register a, Register b, Register c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+    static Register abs(Register a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.), a); }
+    static Register floor(Register a) noexcept { return _mm256_floor_pd(a); }
+    static Register mulSign(Register a, Register b) noexcept { return _mm256_xor_pd(a, _mm256_and_pd(b, _mm256_set1_pd(-0.))); }
+    static Register gather(const double *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm256_i32gather_pd(base, _mm_loadu_si128(reinterpret_cast<const __m128i *>(offsets)), 8);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept { return _mm256_blendv_pd(a, b, selector); }
+};
+#endif
+
+#ifdef __AVX512F__
+template<>
+struct Lanes<float, AVX512>
+{
+    using Type = float;
+    using Register = __m512;
+    static constexpr std::size_t Width = 16;
+
+    static __mmask16 mask(std::size_t count) noexcept
+    {
+        return static_cast<__mmask16>((1u << count) - 1u);
+    }
+
+    static Register load(const float *p) noexcept { return _mm512_loadu_ps(p); }
+    static void store(float *p, Register v) noexcept { _mm512_storeu_ps(p, v); }
+    static void stream(float *p, Register v) noexcept { _mm512_stream_ps(p, v); }
+    static Register loadPartial(const float *p, std::size_t count) noexcept
+    {
+        return _mm512_maskz_loadu_ps(mask(count), p);
+    }
+    static void storePartial(float *p, Register v, std::size_t count) noexcept
+    {
+        _mm512_mask_storeu_ps(p, mask(count), v);
+    }
+
+    static Register set1(float v) noexcept { return _mm512_set1_ps(v); }
+    static Register zero() noexcept { return _mm512_setzero_ps(); }
+    static Register add(Register a, Register b) noexcept { return _mm512_add_ps(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm512_sub_ps(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm512_mul_ps(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm512_div_ps(a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register min(Register a, Register b) noexcept { return _mm512_min_ps(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm512_max_ps(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm512_sqrt_ps(a); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+    static Register fmadd(Register a, Register b, Register c) noexcept { return _mm512_fmadd_ps(a, b, c); }
+    static Register abs(Register a) noexcept { return _mm512_abs_ps(a); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register floor(Register a) noexcept { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+    static Register mulSign(Register a, Register b) noexcept
+    {
+        const __m512i sign = _mm512_and_si512(_mm512_castps_si512(b), _mm512_set1_epi32(INT32_MIN));
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), sign));
+    }
+    static Register gather(const float *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm512_i32gather_ps(_mm512_loadu_si512(offsets), base, 4);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept
+    {
+        return _mm512_mask_blend_ps(_mm512_cmplt_epi32_mask(_mm512_castps_si512(selector), _mm512_setzero_si512()), a, b);
+    }
+};
+
+template<>
+struct Lanes<double, AVX512>
+{
+    using Type = double;
+    using Register = __m512d;
+    static constexpr std::size_t Width = 8;
+
+    static __mmask8 mask(std::size_t count) noexcept
+    {
+        return static_cast<__mmask8>((1u << count) - 1u);
+    }
+
+    static Register load(const double *p) noexcept { return _mm512_loadu_pd(p); }
+    static void store(double *p, Register v) noexcept { _mm512_storeu_pd(p, v); }
+    static void stream(double *p, Register v) noexcept { _mm512_stream_pd(p, v); }
+    static Register loadPartial(const double *p, std::size_t count) noexcept
+    {
+        return _mm512_maskz_loadu_pd(mask(count), p);
+    }
+    static void storePartial(double *p, Register v, std::size_t count) noexcept
+    {
+        _mm512_mask_storeu_pd(p, mask(count), v);
+    }
+
+    static Register set1(double v) noexcept { return _mm512_set1_pd(v); }
+    static Register zero() noexcept { return _mm512_setzero_pd(); }
+    static Register add(Register a, Register b) noexcept { return _mm512_add_pd(a, b); }
+    static Register sub(Register a, Register b) noexcept { return _mm512_sub_pd(a, b); }
+    static Register mul(Register a, Register b) noexcept { return _mm512_mul_pd(a, b); }
+    static Register div(Register a, Register b) noexcept { return _mm512_div_pd(a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register min(Register a, Register b) noexcept { return _mm512_min_pd(a, b); }
+    static Register max(Register a, Register b) noexcept { return _mm512_max_pd(a, b); }
+    static Register sqrt(Register a) noexcept { return _mm512_sqrt_pd(a); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+    static Register fmadd(Register a, Register b, Register c) noexcept { return _mm512_fmadd_pd(a, b, c); }
+    static Register abs(Register a) noexcept { return _mm512_abs_pd(a); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static Register floor(Register a) noexcept { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+    static Register mulSign(Register a, Register b) noexcept
+    {
+        const __m512i sign = _mm512_and_si512(_mm512_castpd_si512(b), _mm512_set1_epi64(INT64_MIN));
+        return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), sign));
+    }
+    static Register gather(const double *base, const std::int32_t *offsets) noexcept
+    {
+        return _mm512_i32gather_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(offsets)), base, 8);
+    }
+    static Register blend(Register a, Register b, Register selector) noexcept
+    {
+        return _mm512_mask_blend_pd(_mm512_cmplt_epi64_mask(_mm512_castpd_si512(selector), _mm512_setzero_si512()), a, b);
+    }
+};
+#endif
+
+/*
+ * Widest instruction set, which compiler is allowed to use. Kernels of
+ * compile-time sizes, which can't have Optimizer tables per size, use it
+ * when Optimizer::hasCompiledIsa() and Scalar otherwise
+ */
+#if defined(__AVX512F__)
+using CompiledIsa = AVX512;
+#elif defined(__AVX2__) && defined(__FMA__)
+using CompiledIsa = AVX2;
+#elif defined(__SSE2__)
+using CompiledIsa = SSE;
+#else
+using CompiledIsa = Scalar;
+#endif
+
+}
@@ -0,0 +1,184 @@
+#pragma once
+/*
+ * File contains skinning of mesh vertices by a palette of bone transforms
+ *
+ * Vertices are VectorArray<T,3> streams, every vertex is influenced by up to
+ * 4 bones, which are kept in SkinInfluences<T> as index and weight streams.
+ * Unused influences have zero weight.
+ *
+ *  skinLinear(palette, influences, ...)          - blend of Affine<T> bones
+ *  skinDualQuaternion(palette, influences, ...)  - blend of DualQuaternion<T> bones,
+ *                                                  keeps volume of twisted joints
+ *
+ * Kernels are dispatched by Optimizer. Large meshes are split into chunks,
+ * which are skinned by threads of Parallel::ThreadPool.
+*/
+
+#include "dual_quaternion.hpp"
+#include "parallel.hpp"
+#include <cstdint>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <StreamType T>
+class SkinInfluences
+{
+public:
+    static constexpr std::size_t Count = _Impl::BonesPerVertex;
+
+    SkinInfluences() noexcept = default;
+    explicit SkinInfluences(std::size_t size) { resize(size); }
+
+    std::size_t size() const noexcept { return _weights.size(); }
+    void resize(std::size_t size)
+    {
+        _weights.resize(size);
+        _bones.resize(size);
+    }
+
+    // Influences of vertex i
+    void set(std::size_t i, const std::int32_t (&bones)[Count], const T (&weights)[Count]) noexcept
+    {
+        for (std::size_t k = 0; k < Count; ++k)
+        {
+            _bones.stream(k)[i] = bones[k];
+            _weights.stream(k)[i] = weights[k];
+        }
+    }
+
+    // Weight and bone index streams, stream k holds k-th influence of all vertices
+    VectorArray<T, Count> &weights() noexcept { return _weights; }
+    const VectorArray<T, Count> &weights() const noexcept { return _weights; }
+    VectorArray<std::int32_t, Count> &bones() noexcept { return _bones; }
+    const VectorArray<std::int32_t, Count> &bones() const noexcept { return _bones; }
+
+    // every bone index, including ones of zero weight, must be in palette
+    bool valid(std::size_t boneCount) const noexcept
+    {
+        for (std::size_t k = 0; k < Count; ++k)
+            for (std::size_t i = 0; i < size(); ++i)
+                if (_bones.stream(k)[i] < 0 || static_cast<std::size_t>(_bones.stream(k)[i]) >= boneCount)
+                    return false;
+        return true;
+    }
+
+private:
+    VectorArray<T, Count> _weights;
+    VectorArray<std::int32_t, Count> _bones;
+};
+
+namespace _Skinning
+{
+// vertices per thread at least, so thread start is paid off
+inline constexpr std::size_t MinChunk = 4096;
+// chunks start at cache line boundary of every stream
+inline constexpr std::size_t ChunkGranularity = 64;
+
+template <StreamType T>
+const T *data(const DualQuaternion<T> *q) noexcept
+{
+    static_assert(sizeof(DualQuaternion<T>) == _Impl::DualQuaternionBoneSize * sizeof(T),
+                  "DualQuaternion components must be packed");
+    return reinterpret_cast<const T *>(q);
+}
+
+template <StreamType T>
+void skin(_OptimizerInternal::SkinStreamFP<T> kernel, const T *palette, const SkinInfluences<T> &influences,
+          const VectorArray<T, 3> &positions, const VectorArray<T, 3> *normals,
+          VectorArray<T, 3> &skinnedPositions, VectorArray<T, 3> *skinnedNormals, unsigned threads)
+{
+    assert(influences.size() == positions.size());
+    assert(!normals || normals->size() == positions.size());
+    const std::size_t count = positions.size();
+    skinnedPositions.resize(count);
+    if (normals)
+        skinnedNormals->resize(count);
+
+    const Streams weights(influences.weights());
+    const Streams bones(influences.bones());
+    const Streams in(positions);
+    const MutableStreams out(skinnedPositions);
+    Parallel::parallelChunks(count, threads, MinChunk, ChunkGranularity, [&](std::size_t first, std::size_t size) {
+        const T *w[SkinInfluences<T>::Count];
+        const std::int32_t *b[SkinInfluences<T>::Count];
+        for (std::size_t k = 0; k < SkinInfluences<T>::Count; ++k)
+        {
+            w[k] = weights.data[k] + first;
+            b[k] = bones.data[k] + first;
+        }
+        const T *p[3], *n[3];
+        T *pOut[3], *nOut[3];
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            p[k] = in.data[k] + first;
+            pOut[k] = out.data[k] + first;
+            if (normals)
+            {
+                n[k] = normals->stream(k) + first;
+                nOut[k] = skinnedNormals->stream(k) + first;
+            }
+        }
+        kernel(palette, w, b, p, normals ? n : nullptr, pOut, normals ? nOut : nullptr, size);
+    });
+}
+}
+
+/*
+ * Linear blend skinning: vertex is transformed by weighted sum of bone
+ * matrices. Normals are transformed by its linear part and aren't
+ * renormalized. Outputs are resized to positions size and may alias inputs.
+ * "threads" limits worker count, 0 means hardware concurrency
+ */
+template <StreamType T>
+void skinLinear(const Affine<T> *palette, std::size_t boneCount, const SkinInfluences<T> &influences,
+                const VectorArray<T, 3> &positions, VectorArray<T, 3> &skinnedPositions, unsigned threads = 0)
+{
+    assert(influences.valid(boneCount));
+    (void)boneCount;
+    _Skinning::skin<T>(_OptimizerInternal::skinLinear<T>, &_Affine::data(palette)[0][0][0], influences,
+                       positions, nullptr, skinnedPositions, nullptr, threads);
+}
+
+template <StreamType T>
+void skinLinear(const Affine<T> *palette, std::size_t boneCount, const SkinInfluences<T> &influences,
+                const VectorArray<T, 3> &positions, const VectorArray<T, 3> &normals,
+                VectorArray<T, 3> &skinnedPositions, VectorArray<T, 3> &skinnedNormals, unsigned threads = 0)
+{
+    assert(influences.valid(boneCount));
+    (void)boneCount;
+    _Skinning::skin<T>(_OptimizerInternal::skinLinear<T>, &_Affine::data(palette)[0][0][0], influences,
+                       positions, &normals, skinnedPositions, &skinnedNormals, threads);
+}
+
+/*
+ * Dual quaternion skinning: blended unit dual quaternions of bones, so the
+ * transform stays rigid and joints don't collapse. Palette entries must
+ * be unit, otherwise the same as skinLinear()
+ */
+template <StreamType T>
+void skinDualQuaternion(const DualQuaternion<T> *palette, std::size_t boneCount, const SkinInfluences<T> &influences,
+                        const VectorArray<T, 3> &positions, VectorArray<T, 3> &skinnedPositions, unsigned threads = 0)
+{
+    assert(influences.valid(boneCount));
+    (void)boneCount;
+    _Skinning::skin<T>(_OptimizerInternal::skinDualQuaternion<T>, _Skinning::data(palette), influences,
+                       positions, nullptr, skinnedPositions, nullptr, threads);
+}
+
+template <StreamType T>
+void skinDualQuaternion(const DualQuaternion<T> *palette, std::size_t boneCount, const SkinInfluences<T> &influences,
+                        const VectorArray<T, 3> &positions, const VectorArray<T, 3> &normals,
+                        VectorArray<T, 3> &skinnedPositions, VectorArray<T, 3> &skinnedNormals, unsigned threads = 0)
+{
+    assert(influences.valid(boneCount));
+    (void)boneCount;
+    _Skinning::skin<T>(_OptimizerInternal::skinDualQuaternion<T>, _Skinning::data(palette), influences,
+                       positions, &normals, skinnedPositions, &skinnedNormals, threads);
+}
+
+}
+}
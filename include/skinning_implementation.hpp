@@ -0,0 +1,291 @@
+#pragma once
+/*
+ * File contains implementations of mesh skinning (see skinning.hpp).
+ *
+ * Vertices come as component streams, every vertex is influenced by
+ * BonesPerVertex bones given by index and weight streams. Bone palette is
+ * a packed array of 3x4 affine rows (linear blend) or of real and dual
+ * quaternions (dual quaternion blend). Palette entries of Width vertices are
+ * blended into one register per element, either by gathers or by rows
+ * (see blendRows), then every formula is evaluated for Width vertices
+ * at once. Fallbacks run the gather kernels with Lanes<T, Scalar>.
+ * Normals are skipped, if their streams are nullptr. Results may alias operands.
+*/
+
+#include "simd.hpp"
+#include "transform_implementation.hpp"
+#include "vector_array_implementation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace _Impl
+{
+inline constexpr std::size_t BonesPerVertex = 4;
+// numbers per palette entry
+inline constexpr std::size_t AffineBoneSize = 12;
+inline constexpr std::size_t DualQuaternionBoneSize = 8;
+
+/*
+ * Offsets of palette entries for Width vertices from vertex i, lanes past
+ * "count" point to the first entry, so their gathers stay in bounds
+ */
+template<typename L>
+void boneOffsets(const std::int32_t *const *bones, std::size_t i, std::size_t count, std::size_t stride,
+                 std::int32_t (&offsets)[BonesPerVertex][L::Width]) noexcept
+{
+    const std::int32_t scale = static_cast<std::int32_t>(stride);
+    const std::size_t n = count - i < L::Width ? count - i : L::Width;
+    for (std::size_t k = 0; k < BonesPerVertex; ++k)
+    {
+        for (std::size_t j = 0; j < n; ++j)
+            offsets[k][j] = bones[k][i + j] * scale;
+        for (std::size_t j = n; j < L::Width; ++j)
+            offsets[k][j] = 0;
+    }
+}
+
+// a x b of register triples
+template<typename L>
+void crossLanes(const typename L::Register (&a)[3], const typename L::Register (&b)[3],
+                typename L::Register (&result)[3]) noexcept
+{
+    result[0] = L::sub(L::mul(a[1], b[2]), L::mul(a[2], b[1]));
+    result[1] = L::sub(L::mul(a[2], b[0]), L::mul(a[0], b[2]));
+    result[2] = L::sub(L::mul(a[0], b[1]), L::mul(a[1], b[0]));
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * Blended palette entries of Width vertices from vertex i, one register
+ * per entry element. Dual quaternions join the sum with the sign, which
+ * puts their real part in the hemisphere of the first bone, so blending
+ * goes by the shortest arc
+ */
+template<typename L, bool Hemisphere, std::size_t Size, typename Load>
+void blendGathered(const typename L::Type *palette, const typename L::Type *const *weights,
+                   const std::int32_t *const *bones, std::size_t i, std::size_t count, Load load,
+                   typename L::Register (&q)[Size]) noexcept
+{
+    using Register = typename L::Register;
+    alignas(64) std::int32_t offsets[BonesPerVertex][L::Width];
+    boneOffsets<L>(bones, i, count, Size, offsets);
+
+    Register pivot[Size];
+    for (std::size_t e = 0; e < Size; ++e)
+        pivot[e] = L::gather(palette + e, offsets[0]);
+    const Register w0 = load(weights[0] + i);
+    for (std::size_t e = 0; e < Size; ++e)
+        q[e] = L::mul(w0, pivot[e]);
+    for (std::size_t k = 1; k < BonesPerVertex; ++k)
+    {
+        Register bone[Size];
+        for (std::size_t e = 0; e < Size; ++e)
+            bone[e] = L::gather(palette + e, offsets[k]);
+        Register w = load(weights[k] + i);
+        if constexpr (Hemisphere)
+            w = L::mulSign(w, L::fmadd(pivot[3], bone[3], L::fmadd(pivot[2], bone[2], L::fmadd(pivot[1], bone[1], L::mul(pivot[0], bone[0])))));
+        for (std::size_t e = 0; e < Size; ++e)
+            q[e] = L::fmadd(w, bone[e], q[e]);
+    }
+}
+
+/*
+ * The same for instruction sets with 4 lanes: every vertex blends rows of
+ * its bones, loaded as they are, then rows of 4 vertices are transposed
+ * into element registers. Takes contiguous loads instead of gathers,
+ * which are microcoded on many CPUs
+ */
+template<typename Isa, typename T, bool Hemisphere, std::size_t Size>
+void blendRows(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+               std::size_t i, std::size_t count, typename Lanes<T, Isa>::Register (&q)[Size]) noexcept
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    using Register = typename L::Register;
+    static_assert(L::Width == 4, "Register must hold one row");
+    constexpr std::size_t Rows = Size / 4;
+
+    // rows[r][j] is row r of vertex j, lanes past "count" repeat vertex i
+    const std::size_t n = count - i < L::Width ? count - i : L::Width;
+    Register rows[Rows][4];
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+        const std::size_t v = i + (j < n ? j : 0);
+        const T *bone = palette + bones[0][v] * Size;
+        const Register w0 = L::set1(weights[0][v]);
+        const Register pivot = L::load(bone);
+        for (std::size_t r = 0; r < Rows; ++r)
+            rows[r][j] = L::mul(w0, L::load(bone + r * 4));
+        for (std::size_t k = 1; k < BonesPerVertex; ++k)
+        {
+            bone = palette + bones[k][v] * Size;
+            Register w = L::set1(weights[k][v]);
+            const Register real = L::load(bone);
+            if constexpr (Hemisphere)
+                w = L::mulSign(w, sumQuad<T, Isa>(L::mul(pivot, real)));
+            rows[0][j] = L::fmadd(w, real, rows[0][j]);
+            for (std::size_t r = 1; r < Rows; ++r)
+                rows[r][j] = L::fmadd(w, L::load(bone + r * 4), rows[r][j]);
+        }
+    }
+    for (std::size_t r = 0; r < Rows; ++r)
+    {
+        Q::transpose(rows[r]);
+        for (std::size_t c = 0; c < 4; ++c)
+            q[r * 4 + c] = rows[r][c];
+    }
+}
+
+/*
+ * Linear blend: weighted sum of bone matrices m (row-major 3x4 elements)
+ * is applied to Width vertices. Normals are multiplied by its linear part
+ * without renormalization, that's exact for rotations and uniform scale
+ */
+template<typename L, typename Load, typename Store>
+void applyBlendedAffine(const typename L::Register (&m)[AffineBoneSize], std::size_t i, Load load, Store store,
+                        const typename L::Type *const *positions, const typename L::Type *const *normals,
+                        typename L::Type *const *skinnedPositions, typename L::Type *const *skinnedNormals) noexcept
+{
+    using Register = typename L::Register;
+    const Register x = load(positions[0] + i), y = load(positions[1] + i), z = load(positions[2] + i);
+    Register nx, ny, nz;
+    if (normals)
+    {
+        nx = load(normals[0] + i);
+        ny = load(normals[1] + i);
+        nz = load(normals[2] + i);
+    }
+    for (std::size_t r = 0; r < 3; ++r)
+        store(skinnedPositions[r] + i, L::fmadd(m[r * 4 + 2], z, L::fmadd(m[r * 4 + 1], y, L::fmadd(m[r * 4], x, m[r * 4 + 3]))));
+    if (normals)
+        for (std::size_t r = 0; r < 3; ++r)
+            store(skinnedNormals[r] + i, L::fmadd(m[r * 4 + 2], nz, L::fmadd(m[r * 4 + 1], ny, L::mul(m[r * 4], nx))));
+}
+
+/*
+ * Dual quaternion blend (L. Kavan et al., "Skinning with Dual Quaternions"):
+ * the sum q is divided by length of its real part (r, d), then
+ *  p' = p + 2 * r.xyz x (r.xyz x p + r.w * p) + t,
+ *  t = 2 * (r.w * d.xyz - d.w * r.xyz + r.xyz x d.xyz)
+ */
+template<typename L, typename Load, typename Store>
+void applyBlendedDualQuaternion(typename L::Register (&q)[DualQuaternionBoneSize], std::size_t i, Load load, Store store,
+                                const typename L::Type *const *positions, const typename L::Type *const *normals,
+                                typename L::Type *const *skinnedPositions, typename L::Type *const *skinnedNormals) noexcept
+{
+    using T = typename L::Type;
+    using Register = typename L::Register;
+    const Register length2 = L::fmadd(q[3], q[3], L::fmadd(q[2], q[2], L::fmadd(q[1], q[1], L::mul(q[0], q[0]))));
+    const Register inv = L::div(L::set1(T(1)), L::sqrt(length2));
+    for (std::size_t e = 0; e < DualQuaternionBoneSize; ++e)
+        q[e] = L::mul(q[e], inv);
+    const Register r[3] = {q[0], q[1], q[2]}, d[3] = {q[4], q[5], q[6]};
+    const Register rw = q[3], dw = q[7], two = L::set1(T(2));
+
+    // rotated v = v + 2 * r x (r x v + rw * v)
+    auto rotate = [&](const Register (&v)[3], Register (&result)[3]) {
+        Register c[3], cc[3];
+        crossLanes<L>(r, v, c);
+        for (std::size_t k = 0; k < 3; ++k)
+            c[k] = L::fmadd(rw, v[k], c[k]);
+        crossLanes<L>(r, c, cc);
+        for (std::size_t k = 0; k < 3; ++k)
+            result[k] = L::fmadd(two, cc[k], v[k]);
+    };
+
+    Register t[3];
+    crossLanes<L>(r, d, t);
+    for (std::size_t k = 0; k < 3; ++k)
+        t[k] = L::mul(two, L::sub(L::fmadd(rw, d[k], t[k]), L::mul(dw, r[k])));
+
+    const Register p[3] = {load(positions[0] + i), load(positions[1] + i), load(positions[2] + i)};
+    Register n[3];
+    if (normals)
+        for (std::size_t k = 0; k < 3; ++k)
+            n[k] = load(normals[k] + i);
+    Register result[3];
+    rotate(p, result);
+    for (std::size_t k = 0; k < 3; ++k)
+        store(skinnedPositions[k] + i, L::add(result[k], t[k]));
+    if (normals)
+    {
+        rotate(n, result);
+        for (std::size_t k = 0; k < 3; ++k)
+            store(skinnedNormals[k] + i, result[k]);
+    }
+}
+
+template<typename Isa, typename T>
+void skinLinearIntrinImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                    const T *const *positions, const T *const *normals,
+                                    T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        typename L::Register m[AffineBoneSize];
+        blendGathered<L, false>(palette, weights, bones, i, count, load, m);
+        applyBlendedAffine<L>(m, i, load, store, positions, normals, skinnedPositions, skinnedNormals);
+    });
+}
+
+template<typename Isa, typename T>
+void skinLinearRowsIntrinImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                        const T *const *positions, const T *const *normals,
+                                        T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        typename L::Register m[AffineBoneSize];
+        blendRows<Isa, T, false>(palette, weights, bones, i, count, m);
+        applyBlendedAffine<L>(m, i, load, store, positions, normals, skinnedPositions, skinnedNormals);
+    });
+}
+
+template<typename Isa, typename T>
+void skinDualQuaternionIntrinImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                            const T *const *positions, const T *const *normals,
+                                            T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        typename L::Register q[DualQuaternionBoneSize];
+        blendGathered<L, true>(palette, weights, bones, i, count, load, q);
+        applyBlendedDualQuaternion<L>(q, i, load, store, positions, normals, skinnedPositions, skinnedNormals);
+    });
+}
+
+template<typename Isa, typename T>
+void skinDualQuaternionRowsIntrinImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                                const T *const *positions, const T *const *normals,
+                                                T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        typename L::Register q[DualQuaternionBoneSize];
+        blendRows<Isa, T, true>(palette, weights, bones, i, count, q);
+        applyBlendedDualQuaternion<L>(q, i, load, store, positions, normals, skinnedPositions, skinnedNormals);
+    });
+}
+
+// ================================ Fallback ================================ //
+template<typename T>
+void skinLinearFallbackImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                      const T *const *positions, const T *const *normals,
+                                      T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    skinLinearIntrinImplementation<Scalar, T>(palette, weights, bones, positions, normals,
+                                              skinnedPositions, skinnedNormals, count);
+}
+
+template<typename T>
+void skinDualQuaternionFallbackImplementation(const T *palette, const T *const *weights, const std::int32_t *const *bones,
+                                              const T *const *positions, const T *const *normals,
+                                              T *const *skinnedPositions, T *const *skinnedNormals, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    skinDualQuaternionIntrinImplementation<Scalar, T>(palette, weights, bones, positions, normals,
+                                                      skinnedPositions, skinnedNormals, count);
+}
+
+}
@@ -0,0 +1,210 @@
+#pragma once
+/*
+ * File contains implementations of batched solvers of small linear systems
+ * (see solve() and solveLeastSquares() of matrix_array.hpp).
+ *
+ * Matrices come as element streams in row-major order, right-hand sides
+ * and solutions as component streams, one register holds the same number
+ * of Width systems. There are no branches: partial pivoting swaps rows
+ * by blends, lane by lane, so every system of a register is eliminated
+ * with its own pivots. Systems, which have no unique solution, get zero
+ * solutions and are reported by flags. Fallbacks run the same kernels
+ * with Lanes<T, Scalar>, one system at a time.
+*/
+
+#include "simd.hpp"
+#include "vector_array_implementation.hpp"
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+
+
+namespace _Impl
+{
+/*
+ * Stores solution registers of systems i.. and flags them. status is
+ * positive for solvable systems, NaN in solution makes it NaN. Flagged
+ * solutions are zeroed. Returns count of flagged systems
+ */
+template<typename L, std::size_t N, typename Store>
+std::size_t storeSolutions(typename L::Type *const *x, bool *singular, std::size_t i, std::size_t count,
+                           Store store, const typename L::Register (&solution)[N], typename L::Register status)
+{
+    using T = typename L::Type;
+    // inf and NaN turn into NaN
+    auto check = L::mul(solution[0], L::zero());
+    for (std::size_t k = 1; k < N; ++k)
+        check = L::add(check, L::mul(solution[k], L::zero()));
+    alignas(64) T lanes[L::Width];
+    L::store(lanes, L::add(status, check));
+
+    for (std::size_t k = 0; k < N; ++k)
+        store(x[k] + i, solution[k]);
+    const std::size_t n = count - i < L::Width ? count - i : L::Width;
+    std::size_t flagged = 0;
+    for (std::size_t j = 0; j < n; ++j)
+    {
+        const bool bad = !(lanes[j] > T(0));
+        if (bad)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+                x[k][i + j] = T(0);
+            ++flagged;
+        }
+        if (singular)
+            singular[i + j] = bad;
+    }
+    return flagged;
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * a[i] * x[i] = b[i] by Gaussian elimination with partial pivoting,
+ * singular[i] marks pivot not above N * eps * max |a[i]|, that is rows,
+ * which are linearly dependent up to rounding, may be nullptr.
+ * Returns count of singular systems
+ */
+template<typename Isa, typename T, std::size_t N>
+std::size_t solveMatrixArrayIntrinImplementation(const T *const *a, const T *const *b, T *const *x, bool *singular, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    const Register tolerance = L::set1(T(N) * std::numeric_limits<T>::epsilon());
+    std::size_t flagged = 0;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        // augmented matrix [a | b]
+        Register m[N][N + 1];
+        Register scale = L::zero();
+        for (std::size_t r = 0; r < N; ++r)
+        {
+            for (std::size_t c = 0; c < N; ++c)
+            {
+                m[r][c] = load(a[r * N + c] + i);
+                scale = L::max(L::abs(m[r][c]), scale);
+            }
+            m[r][N] = load(b[r] + i);
+        }
+
+        Register pivots = L::set1(std::numeric_limits<T>::infinity());
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            // rows with bigger |m[r][k]| are swapped up, so row k ends with the largest
+            for (std::size_t r = k + 1; r < N; ++r)
+            {
+                const Register swap = L::sub(L::abs(m[k][k]), L::abs(m[r][k]));
+                for (std::size_t c = k; c <= N; ++c)
+                {
+                    const Register top = m[k][c];
+                    m[k][c] = L::blend(top, m[r][c], swap);
+                    m[r][c] = L::blend(m[r][c], top, swap);
+                }
+            }
+            pivots = L::min(L::abs(m[k][k]), pivots);
+            const Register inv = L::div(L::set1(T(1)), m[k][k]);
+            for (std::size_t r = k + 1; r < N; ++r)
+            {
+                const Register l = L::mul(m[r][k], inv);
+                for (std::size_t c = k + 1; c <= N; ++c)
+                    m[r][c] = L::sub(m[r][c], L::mul(l, m[k][c]));
+            }
+        }
+
+        Register solution[N];
+        for (std::size_t r = N; r--;)
+        {
+            Register accum = m[r][N];
+            for (std::size_t c = r + 1; c < N; ++c)
+                accum = L::sub(accum, L::mul(m[r][c], solution[c]));
+            solution[r] = L::div(accum, m[r][r]);
+        }
+        // pivots of dependent rows are rounding residues of elimination
+        const Register margin = L::sub(pivots, L::mul(tolerance, scale));
+        flagged += storeSolutions<L>(x, singular, i, count, store, solution, margin);
+    });
+    return flagged;
+}
+
+/*
+ * Least squares solutions of a[i] * x[i] = b[i], a[i] is R x C, R >= C,
+ * by modified Gram-Schmidt QR of [a | b]. singular[i] marks columns,
+ * which are linearly dependent up to rounding. Returns count of them
+ */
+template<typename Isa, typename T, std::size_t R, std::size_t C>
+std::size_t leastSquaresMatrixArrayIntrinImplementation(const T *const *a, const T *const *b, T *const *x, bool *singular, std::size_t count)
+{
+    static_assert(R >= C);
+    using L = Lanes<T, Isa>;
+    using Register = typename L::Register;
+    // column norm shrunk to this part of the original one is a dependent column
+    const Register tolerance = L::set1(T(R) * std::numeric_limits<T>::epsilon());
+    std::size_t flagged = 0;
+    streamLoop<L>(count, [&](std::size_t i, auto load, auto store) {
+        // columns of a are orthonormalized into q
+        Register q[C][R], rhs[R], upper[C][C], z[C];
+        for (std::size_t r = 0; r < R; ++r)
+        {
+            for (std::size_t c = 0; c < C; ++c)
+                q[c][r] = load(a[r * C + c] + i);
+            rhs[r] = load(b[r] + i);
+        }
+
+        Register margin = L::set1(std::numeric_limits<T>::infinity());
+        for (std::size_t j = 0; j < C; ++j)
+        {
+            Register original = L::mul(q[j][0], q[j][0]);
+            for (std::size_t r = 1; r < R; ++r)
+                original = L::fmadd(q[j][r], q[j][r], original);
+            for (std::size_t k = 0; k < j; ++k)
+            {
+                Register projection = L::mul(q[k][0], q[j][0]);
+                for (std::size_t r = 1; r < R; ++r)
+                    projection = L::fmadd(q[k][r], q[j][r], projection);
+                upper[k][j] = projection;
+                for (std::size_t r = 0; r < R; ++r)
+                    q[j][r] = L::sub(q[j][r], L::mul(projection, q[k][r]));
+            }
+            Register norm = L::mul(q[j][0], q[j][0]);
+            for (std::size_t r = 1; r < R; ++r)
+                norm = L::fmadd(q[j][r], q[j][r], norm);
+            norm = L::sqrt(norm);
+            upper[j][j] = norm;
+            margin = L::min(L::sub(norm, L::mul(tolerance, L::sqrt(original))), margin);
+
+            const Register inv = L::div(L::set1(T(1)), norm);
+            for (std::size_t r = 0; r < R; ++r)
+                q[j][r] = L::mul(q[j][r], inv);
+            Register projection = L::mul(q[j][0], rhs[0]);
+            for (std::size_t r = 1; r < R; ++r)
+                projection = L::fmadd(q[j][r], rhs[r], projection);
+            z[j] = projection;
+            for (std::size_t r = 0; r < R; ++r)
+                rhs[r] = L::sub(rhs[r], L::mul(projection, q[j][r]));
+        }
+
+        Register solution[C];
+        for (std::size_t r = C; r--;)
+        {
+            Register accum = z[r];
+            for (std::size_t c = r + 1; c < C; ++c)
+                accum = L::sub(accum, L::mul(upper[r][c], solution[c]));
+            solution[r] = L::div(accum, upper[r][r]);
+        }
+        flagged += storeSolutions<L>(x, singular, i, count, store, solution, margin);
+    });
+    return flagged;
+}
+
+// ================================ Fallback ================================ //
+template<typename T, std::size_t N>
+std::size_t solveMatrixArrayFallbackImplementation(const T *const *a, const T *const *b, T *const *x, bool *singular, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    return solveMatrixArrayIntrinImplementation<Scalar, T, N>(a, b, x, singular, count);
+}
+
+template<typename T, std::size_t R, std::size_t C>
+std::size_t leastSquaresMatrixArrayFallbackImplementation(const T *const *a, const T *const *b, T *const *x, bool *singular, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    return leastSquaresMatrixArrayIntrinImplementation<Scalar, T, R, C>(a, b, x, singular, count);
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+/*
+ * File contains bulk transforms of many vectors by one 4x4 matrix
+ *
+ * Matrix multiplies column vectors (v' = M * v), translation is in the
+ * last column, like in invertAffine(). Vectors are given as arrays of
+ * Vector3D/Vector4D, as VectorArray streams or as strided VectorView
+ * of external buffers:
+ *
+ *  transformPoints(m, in, out, count)            - w = 1
+ *  transformDirections(m, in, out, count)        - w = 0, no translation
+ *  transformPointsProjective(m, in, out, count)  - w = 1, divided by result w
+ *
+ * 4D vectors keep their own w, except for directions.
+ * Output may alias input. Dispatched by Optimizer.
+*/
+
+#include "matrix_view.hpp"
+#include "vector_array.hpp"
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+namespace _Transform
+{
+template <_Impl::TransformMode Mode, StreamType T, std::size_t Dim>
+void vectors(const Matrix<T, 4, 4> &m, const Vector<T, Dim> *in, Vector<T, Dim> *out, std::size_t count)
+{
+    static_assert(Dim == 3 || Dim == 4, "Only 3D and 4D vectors are transformed by 4x4 matrix");
+    static_assert(sizeof(Vector<T, Dim>) == Dim * sizeof(T), "Vector components must be packed");
+    _OptimizerInternal::transformVectors<T, Dim, Mode>(m, reinterpret_cast<const T *>(in),
+                                                       reinterpret_cast<T *>(out), count);
+}
+
+template <_Impl::TransformMode Mode, StreamType T, std::size_t Dim>
+void streams(const Matrix<T, 4, 4> &m, const VectorArray<T, Dim> &in, VectorArray<T, Dim> &out)
+{
+    static_assert(Dim == 3 || Dim == 4, "Only 3D and 4D vectors are transformed by 4x4 matrix");
+    out.resize(in.size());
+    _OptimizerInternal::transformStream<T, Dim, Mode>(m, Streams(in).data, MutableStreams(out).data, in.size());
+}
+
+template <_Impl::TransformMode Mode, StreamType T, std::size_t Dim, typename TIn, std::size_t SIn, std::size_t SOut>
+void views(const Matrix<T, 4, 4> &m, const VectorView<TIn, Dim, SIn> &in, const VectorView<T, Dim, SOut> &out)
+{
+    forEachBlock(in, out, [&m](const Vector<T, Dim> *a, Vector<T, Dim> *result, std::size_t count) {
+        vectors<Mode>(m, a, result, count);
+    });
+}
+}
+
+/*
+ * Arrays of vectors
+ */
+template <StreamType T, std::size_t Dim>
+void transformPoints(const Matrix<T, 4, 4> &m, const Vector<T, Dim> *in, Vector<T, Dim> *out, std::size_t count)
+{
+    _Transform::vectors<_Impl::TransformMode::Point>(m, in, out, count);
+}
+
+template <StreamType T, std::size_t Dim>
+void transformDirections(const Matrix<T, 4, 4> &m, const Vector<T, Dim> *in, Vector<T, Dim> *out, std::size_t count)
+{
+    _Transform::vectors<_Impl::TransformMode::Direction>(m, in, out, count);
+}
+
+template <StreamType T, std::size_t Dim>
+void transformPointsProjective(const Matrix<T, 4, 4> &m, const Vector<T, Dim> *in, Vector<T, Dim> *out, std::size_t count)
+{
+    _Transform::vectors<_Impl::TransformMode::Projective>(m, in, out, count);
+}
+
+/*
+ * Structure of arrays, out is resized to in size
+ */
+template <StreamType T, std::size_t Dim>
+void transformPoints(const Matrix<T, 4, 4> &m, const VectorArray<T, Dim> &in, VectorArray<T, Dim> &out)
+{
+    _Transform::streams<_Impl::TransformMode::Point>(m, in, out);
+}
+
+template <StreamType T, std::size_t Dim>
+void transformDirections(const Matrix<T, 4, 4> &m, const VectorArray<T, Dim> &in, VectorArray<T, Dim> &out)
+{
+    _Transform::streams<_Impl::TransformMode::Direction>(m, in, out);
+}
+
+template <StreamType T, std::size_t Dim>
+void transformPointsProjective(const Matrix<T, 4, 4> &m, const VectorArray<T, Dim> &in, VectorArray<T, Dim> &out)
+{
+    _Transform::streams<_Impl::TransformMode::Projective>(m, in, out);
+}
+
+/*
+ * Strided views, e.g. positions of interleaved vertices, out may be in
+ */
+template <StreamType T, std::size_t Dim, typename TIn, std::size_t SIn, std::size_t SOut>
+void transformPoints(const Matrix<T, 4, 4> &m, const VectorView<TIn, Dim, SIn> &in, const VectorView<T, Dim, SOut> &out)
+    requires(std::is_same_v<std::remove_const_t<TIn>, T>)
+{
+    _Transform::views<_Impl::TransformMode::Point>(m, in, out);
+}
+
+template <StreamType T, std::size_t Dim, typename TIn, std::size_t SIn, std::size_t SOut>
+void transformDirections(const Matrix<T, 4, 4> &m, const VectorView<TIn, Dim, SIn> &in, const VectorView<T, Dim, SOut> &out)
+    requires(std::is_same_v<std::remove_const_t<TIn>, T>)
+{
+    _Transform::views<_Impl::TransformMode::Direction>(m, in, out);
+}
+
+template <StreamType T, std::size_t Dim, typename TIn, std::size_t SIn, std::size_t SOut>
+void transformPointsProjective(const Matrix<T, 4, 4> &m, const VectorView<TIn, Dim, SIn> &in, const VectorView<T, Dim, SOut> &out)
+    requires(std::is_same_v<std::remove_const_t<TIn>, T>)
+{
+    _Transform::views<_Impl::TransformMode::Projective>(m, in, out);
+}
+
+}
+}
@@ -0,0 +1,512 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of transforming
+ * many vectors by one 4x4 matrix (column vectors, v' = M * v).
+ *
+ * Vectors come either as component streams (see vector_array.hpp) or as
+ * array of structures with Dim packed components. Matrix elements are
+ * broadcast to registers once per call. Outputs larger than
+ * StreamingStoreBytes are written by non-temporal stores, so they don't
+ * evict the rest of the working set from cache.
+*/
+
+#include "simd.hpp"
+#include "vector_array_implementation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+namespace _Impl
+{
+/*
+ * Point      - w is 1, result is not divided
+ * Direction  - w is 0, translation is ignored
+ * Projective - w is 1 for 3D vectors, result is divided by its w
+ * 4D vectors use their own w, except for directions
+ */
+enum class TransformMode { Point, Direction, Projective };
+
+// output size, starting from which non-temporal stores are used
+inline constexpr std::size_t StreamingStoreBytes = std::size_t(4) << 20;
+
+// ================================ Fallback ================================ //
+template<typename T, std::size_t Dim, TransformMode Mode>
+void transformVectorFallback(const T (&m)[4][4], const T *v, T *result)
+{
+    T in[4] = {v[0], v[1], v[2], Mode == TransformMode::Direction ? T(0) : T(1)};
+    if constexpr (Dim == 4 && Mode != TransformMode::Direction)
+        in[3] = v[3];
+
+    T out[4];
+    for (std::size_t r = 0; r < 4; ++r)
+        out[r] = m[r][0] * in[0] + m[r][1] * in[1] + m[r][2] * in[2] + m[r][3] * in[3];
+    if constexpr (Mode == TransformMode::Projective)
+    {
+        const T inv = T(1) / out[3];
+        for (std::size_t r = 0; r < 4; ++r)
+            out[r] *= inv;
+    }
+    for (std::size_t k = 0; k < Dim; ++k)
+        result[k] = out[k];
+}
+
+template<typename T, std::size_t Dim, TransformMode Mode>
+void transformStreamFallbackImplementation(const T (&m)[4][4], const T *const *in, T *const *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        T v[Dim], out[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            v[k] = in[k][i];
+        transformVectorFallback<T,Dim,Mode>(m, v, out);
+        for (std::size_t k = 0; k < Dim; ++k)
+            result[k][i] = out[k];
+    }
+}
+
+template<typename T, std::size_t Dim, TransformMode Mode>
+void transformVectorsFallbackImplementation(const T (&m)[4][4], const T *in, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i, in += Dim, result += Dim)
+    {
+        T v[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            v[k] = in[k];
+        transformVectorFallback<T,Dim,Mode>(m, v, result);
+    }
+}
+
+// ================================ Intrinsic =============================== //
+template<typename L>
+bool useStreamingStores(const typename L::Type *p, std::size_t bytes)
+{
+    return bytes >= StreamingStoreBytes && reinterpret_cast<std::uintptr_t>(p) % sizeof(typename L::Register) == 0;
+}
+
+/*
+ * Matrix elements broadcast to registers, every register of operands
+ * holds one component of Width vectors
+ */
+template<typename L, std::size_t Dim, TransformMode Mode>
+struct TransformRows
+{
+    using T = typename L::Type;
+    using Register = typename L::Register;
+    static constexpr std::size_t Rows = Dim == 4 || Mode == TransformMode::Projective ? 4 : 3;
+
+    explicit TransformRows(const T (&m)[4][4]) noexcept
+    {
+        for (std::size_t r = 0; r < Rows; ++r)
+            for (std::size_t k = 0; k < 4; ++k)
+                c[r][k] = L::set1(m[r][k]);
+    }
+
+    void apply(const Register (&v)[Dim], Register (&out)[Rows]) const noexcept
+    {
+        for (std::size_t r = 0; r < Rows; ++r)
+        {
+            if constexpr (Dim == 4 && Mode != TransformMode::Direction)
+                out[r] = L::fmadd(c[r][3], v[3], L::mul(c[r][0], v[0]));
+            else if constexpr (Mode != TransformMode::Direction)
+                out[r] = L::fmadd(c[r][0], v[0], c[r][3]);
+            else
+                out[r] = L::mul(c[r][0], v[0]);
+            out[r] = L::fmadd(c[r][2], v[2], L::fmadd(c[r][1], v[1], out[r]));
+        }
+        if constexpr (Mode == TransformMode::Projective)
+        {
+            const Register inv = L::div(L::set1(T(1)), out[3]);
+            for (std::size_t r = 0; r < Dim; ++r)
+                out[r] = L::mul(out[r], inv);
+        }
+    }
+
+    Register c[Rows][4];
+};
+
+// Component streams, 3-4 fused multiply-adds per output component
+template<typename Isa, typename T, std::size_t Dim, TransformMode Mode>
+void transformStreamIntrinImplementation(const T (&m)[4][4], const T *const *in, T *const *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Rows = TransformRows<L, Dim, Mode>;
+    using Register = typename L::Register;
+    const Rows rows(m);
+
+    // local copies, so stores can't alias stream pointers
+    const T *src[Dim];
+    T *dst[Dim];
+    bool streaming = true;
+    for (std::size_t k = 0; k < Dim; ++k)
+    {
+        src[k] = in[k];
+        dst[k] = result[k];
+        streaming = streaming && useStreamingStores<L>(dst[k], count * Dim * sizeof(T));
+    }
+
+    auto kernel = [&](std::size_t i, auto load, auto store) {
+        Register v[Dim], out[Rows::Rows];
+        for (std::size_t k = 0; k < Dim; ++k)
+            v[k] = load(src[k] + i);
+        rows.apply(v, out);
+        for (std::size_t k = 0; k < Dim; ++k)
+            store(dst[k] + i, out[k]);
+    };
+
+    std::size_t i = 0;
+    if (streaming)
+    {
+        for (; i + L::Width <= count; i += L::Width)
+            kernel(i, [](const T *p) { return L::load(p); }, [](T *p, Register v) { L::stream(p, v); });
+        _mm_sfence();
+    }
+    streamLoop<L>(count, kernel, i);
+}
+
+/*
+ * Packed 4D vectors, every register holds Width / 4 whole vectors.
+ * splat<K> broadcasts component K and permute<Mask> reorders components
+ * (_MM_SHUFFLE order) within every vector, spread broadcasts p[k] over
+ * components of vector k. Registers of exactly one vector can be transposed.
+ * Transform result is sum of matrix columns, scaled by broadcast components
+ */
+template<typename T, typename Isa>
+struct Quad;
+
+#ifdef __SSE2__
+template<>
+struct Quad<float, SSE>
+{
+    static __m128 columns(const float *p) noexcept { return _mm_loadu_ps(p); }
+    template<int K>
+    static __m128 splat(__m128 v) noexcept { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(K, K, K, K)); }
+    template<int Mask>
+    static __m128 permute(__m128 v) noexcept { return _mm_shuffle_ps(v, v, Mask); }
+    static __m128 spread(const float *p) noexcept { return _mm_set1_ps(p[0]); }
+    static void transpose(__m128 (&v)[4]) noexcept { _MM_TRANSPOSE4_PS(v[0], v[1], v[2], v[3]); }
+};
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+struct Quad<float, AVX2>
+{
+    static __m256 columns(const float *p) noexcept { return _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(p)); }
+    template<int K>
+    static __m256 splat(__m256 v) noexcept { return _mm256_permute_ps(v, K * 0x55); }
+    template<int Mask>
+    static __m256 permute(__m256 v) noexcept { return _mm256_permute_ps(v, Mask); }
+    static __m256 spread(const float *p) noexcept { return _mm256_setr_m128(_mm_set1_ps(p[0]), _mm_set1_ps(p[1])); }
+};
+
+template<>
+struct Quad<double, AVX2>
+{
+    static __m256d columns(const double *p) noexcept { return _mm256_loadu_pd(p); }
+    template<int K>
+    static __m256d splat(__m256d v) noexcept { return _mm256_permute4x64_pd(v, K * 0x55); }
+    template<int Mask>
+    static __m256d permute(__m256d v) noexcept { return _mm256_permute4x64_pd(v, Mask); }
+    static __m256d spread(const double *p) noexcept { return _mm256_set1_pd(p[0]); }
+    static void transpose(__m256d (&v)[4]) noexcept
+    {
+        const __m256d t0 = _mm256_unpacklo_pd(v[0], v[1]), t1 = _mm256_unpackhi_pd(v[0], v[1]);
+        const __m256d t2 = _mm256_unpacklo_pd(v[2], v[3]), t3 = _mm256_unpackhi_pd(v[2], v[3]);
+        v[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+        v[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+        v[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+        v[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+template<>
+struct Quad<float, AVX512>
+{
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static __m512 columns(const float *p) noexcept { return _mm512_broadcast_f32x4(_mm_loadu_ps(p)); }
+    template<int K>
+    static __m512 splat(__m512 v) noexcept { return _mm512_permute_ps(v, K * 0x55); }
+    template<int Mask>
+    static __m512 permute(__m512 v) noexcept { return _mm512_permute_ps(v, Mask); }
+    static __m512 spread(const float *p) noexcept
+    {
+        const __m512i index = _mm512_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+        return _mm512_permutexvar_ps(index, _mm512_castps128_ps512(_mm_loadu_ps(p)));
+    }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+};
+
+template<>
+struct Quad<double, AVX512>
+{
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static __m512d columns(const double *p) noexcept { return _mm512_broadcast_f64x4(_mm256_loadu_pd(p)); }
+    template<int K>
+    static __m512d splat(__m512d v) noexcept { return _mm512_permutex_pd(v, K * 0x55); }
+    template<int Mask>
+    static __m512d permute(__m512d v) noexcept { return _mm512_permutex_pd(v, Mask); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+    static __m512d spread(const double *p) noexcept
+    {
+        return _mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_set1_pd(p[0])), _mm256_set1_pd(p[1]), 1);
+    }
+};
+#endif
+
+template<typename T, typename Isa>
+concept HasQuad = requires { Quad<T, Isa>::columns(static_cast<const T *>(nullptr)); };
+
+// Sum of components of every packed vector, broadcast over them
+template<typename T, typename Isa>
+typename Lanes<T, Isa>::Register sumQuad(typename Lanes<T, Isa>::Register v) noexcept
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    v = L::add(v, Q::template permute<_MM_SHUFFLE(2, 3, 0, 1)>(v));
+    return L::add(v, Q::template permute<_MM_SHUFFLE(1, 0, 3, 2)>(v));
+}
+
+template<typename Isa, typename T, TransformMode Mode>
+void transformQuadIntrinImplementation(const T (&m)[4][4], const T *in, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using Q = Quad<T, Isa>;
+    using Register = typename L::Register;
+
+    T transposed[4][4];
+    for (std::size_t r = 0; r < 4; ++r)
+        for (std::size_t k = 0; k < 4; ++k)
+            transposed[k][r] = m[r][k];
+    const Register c0 = Q::columns(transposed[0]), c1 = Q::columns(transposed[1]);
+    const Register c2 = Q::columns(transposed[2]), c3 = Q::columns(transposed[3]);
+
+    auto kernel = [&](std::size_t i, auto load, auto store) {
+        const Register v = load(in + i);
+        Register out = L::fmadd(c2, Q::template splat<2>(v),
+                       L::fmadd(c1, Q::template splat<1>(v), L::mul(c0, Q::template splat<0>(v))));
+        if constexpr (Mode != TransformMode::Direction)
+            out = L::fmadd(c3, Q::template splat<3>(v), out);
+        if constexpr (Mode == TransformMode::Projective)
+            out = L::div(out, Q::template splat<3>(out));
+        store(result + i, out);
+    };
+
+    const std::size_t elements = count * 4;
+    std::size_t i = 0;
+    if (useStreamingStores<L>(result, elements * sizeof(T)))
+    {
+        for (; i + L::Width <= elements; i += L::Width)
+            kernel(i, [](const T *p) { return L::load(p); }, [](T *p, Register v) { L::stream(p, v); });
+        _mm_sfence();
+    }
+    streamLoop<L>(elements, kernel, i);
+}
+
+/*
+ * Lane shuffles for packed 3D vectors: blend by compile-time mask
+ * and permute by index table
+ */
+template<typename T, typename Isa>
+struct Shuffle;
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+struct Shuffle<float, AVX2>
+{
+    using Index = std::int32_t;
+    static constexpr std::size_t IndexPerLane = 1;
+
+    template<unsigned Mask>
+    static __m256 blend(__m256 a, __m256 b) noexcept { return _mm256_blend_ps(a, b, Mask); }
+    static __m256 permute(__m256 v, const Index *idx) noexcept
+    {
+        return _mm256_permutevar8x32_ps(v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx)));
+    }
+};
+
+template<>
+struct Shuffle<double, AVX2>
+{
+    // doubles are permuted as pairs of 32-bit lanes
+    using Index = std::int32_t;
+    static constexpr std::size_t IndexPerLane = 2;
+
+    template<unsigned Mask>
+    static __m256d blend(__m256d a, __m256d b) noexcept { return _mm256_blend_pd(a, b, Mask); }
+    static __m256d permute(__m256d v, const Index *idx) noexcept
+    {
+        const __m256i i = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(idx));
+        return _mm256_castps_pd(_mm256_permutevar8x32_ps(_mm256_castpd_ps(v), i));
+    }
+};
+#endif
+
+#ifdef __AVX512F__
+template<>
+struct Shuffle<float, AVX512>
+{
+    using Index = std::int32_t;
+    static constexpr std::size_t IndexPerLane = 1;
+
+    template<unsigned Mask>
+    static __m512 blend(__m512 a, __m512 b) noexcept { return _mm512_mask_blend_ps(__mmask16(Mask), a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static __m512 permute(__m512 v, const Index *idx) noexcept
+    {
+        return _mm512_permutexvar_ps(_mm512_loadu_si512(idx), v);
+    }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+};
+
+template<>
+struct Shuffle<double, AVX512>
+{
+    using Index = std::int64_t;
+    static constexpr std::size_t IndexPerLane = 1;
+
+    template<unsigned Mask>
+    static __m512d blend(__m512d a, __m512d b) noexcept { return _mm512_mask_blend_pd(__mmask8(Mask), a, b); }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+    static __m512d permute(__m512d v, const Index *idx) noexcept
+    {
+        return _mm512_permutexvar_pd(_mm512_loadu_si512(idx), v);
+    }
+    GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+};
+#endif
+
+template<typename T, typename Isa>
+concept HasShuffle = requires { Shuffle<T, Isa>::IndexPerLane; };
+
+/*
+ * Width packed 3D vectors occupy 3 registers. Lane j of register r holds
+ * component (r * Width + j) % 3 of vector (r * Width + j) / 3, so every
+ * component is 2 blends and one permute away from its own register
+ */
+template<typename Isa, typename T>
+struct Packed3
+{
+    using L = Lanes<T, Isa>;
+    using S = Shuffle<T, Isa>;
+    using Register = typename L::Register;
+    using Index = typename S::Index;
+    static constexpr std::size_t Width = L::Width;
+    static_assert(Width % 3 != 0);
+
+    // lanes of register r, which hold component c
+    static constexpr unsigned mask(std::size_t c, std::size_t r)
+    {
+        unsigned m = 0;
+        for (std::size_t j = 0; j < Width; ++j)
+            if ((r * Width + j) % 3 == c)
+                m |= 1u << j;
+        return m;
+    }
+
+    // vector, which lane j holds after blending component c
+    static constexpr std::size_t vector(std::size_t c, std::size_t j)
+    {
+        for (std::size_t r = 0;; ++r)
+            if ((r * Width + j) % 3 == c)
+                return (r * Width + j) / 3;
+    }
+
+    struct Tables
+    {
+        Index gather[3][Width * S::IndexPerLane];
+        Index scatter[3][Width * S::IndexPerLane];
+    };
+
+    static constexpr Tables tables = [] {
+        Tables t{};
+        for (std::size_t c = 0; c < 3; ++c)
+            for (std::size_t j = 0; j < Width; ++j)
+                for (std::size_t p = 0; p < S::IndexPerLane; ++p)
+                {
+                    // lane j goes to lane vector(c, j) and back
+                    t.gather[c][vector(c, j) * S::IndexPerLane + p] = Index(j * S::IndexPerLane + p);
+                    t.scatter[c][j * S::IndexPerLane + p] = Index(vector(c, j) * S::IndexPerLane + p);
+                }
+        return t;
+    }();
+
+    template<std::size_t C>
+    static Register component(Register r0, Register r1, Register r2) noexcept
+    {
+        const Register t = S::template blend<mask(C, 2)>(S::template blend<mask(C, 1)>(r0, r1), r2);
+        return S::permute(t, tables.gather[C]);
+    }
+
+    template<std::size_t R>
+    static Register merge(Register u0, Register u1, Register u2) noexcept
+    {
+        return S::template blend<mask(2, R)>(S::template blend<mask(1, R)>(u0, u1), u2);
+    }
+
+    static void load(const T *p, Register (&v)[3]) noexcept
+    {
+        const Register r0 = L::load(p), r1 = L::load(p + Width), r2 = L::load(p + 2 * Width);
+        v[0] = component<0>(r0, r1, r2);
+        v[1] = component<1>(r0, r1, r2);
+        v[2] = component<2>(r0, r1, r2);
+    }
+
+    template<typename Store>
+    static void store(T *p, const Register *v, Store store) noexcept
+    {
+        const Register u0 = S::permute(v[0], tables.scatter[0]);
+        const Register u1 = S::permute(v[1], tables.scatter[1]);
+        const Register u2 = S::permute(v[2], tables.scatter[2]);
+        store(p, merge<0>(u0, u1, u2));
+        store(p + Width, merge<1>(u0, u1, u2));
+        store(p + 2 * Width, merge<2>(u0, u1, u2));
+    }
+};
+
+template<typename Isa, typename T, TransformMode Mode>
+void transformPacked3IntrinImplementation(const T (&m)[4][4], const T *in, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    using P = Packed3<Isa, T>;
+    using Rows = TransformRows<L, 3, Mode>;
+    using Register = typename L::Register;
+    const Rows rows(m);
+
+    auto kernel = [&](std::size_t i, auto store) {
+        Register v[3], out[Rows::Rows];
+        P::load(in + i * 3, v);
+        rows.apply(v, out);
+        P::store(result + i * 3, out, store);
+    };
+
+    std::size_t i = 0;
+    if (useStreamingStores<L>(result, count * 3 * sizeof(T)))
+    {
+        for (; i + L::Width <= count; i += L::Width)
+            kernel(i, [](T *p, Register v) { L::stream(p, v); });
+        _mm_sfence();
+    }
+    for (; i + L::Width <= count; i += L::Width)
+        kernel(i, [](T *p, Register v) { L::store(p, v); });
+    transformVectorsFallbackImplementation<T, 3, Mode>(m, in + i * 3, result + i * 3, count - i);
+}
+
+/*
+ * Packed vectors: 4D by column broadcasts, 3D by lane shuffles,
+ * instruction sets without them use fallback
+ */
+template<typename Isa, typename T, std::size_t Dim, TransformMode Mode>
+void transformVectorsIntrinImplementation(const T (&m)[4][4], const T *in, T *result, std::size_t count)
+{
+    if constexpr (Dim == 4 && HasQuad<T, Isa>)
+        transformQuadIntrinImplementation<Isa, T, Mode>(m, in, result, count);
+    else if constexpr (Dim == 3 && HasShuffle<T, Isa>)
+        transformPacked3IntrinImplementation<Isa, T, Mode>(m, in, result, count);
+    else
+        transformVectorsFallbackImplementation<T, Dim, Mode>(m, in, result, count);
+}
+
+}
@@ -0,0 +1,310 @@
+#pragma once
+/*
+ * File contains in-register and cache-oblivious transposes of float
+ * and double matrices.
+ *
+ * transposeTile<Isa, T, N> transposes N x N tile (4 or 8) of a strided
+ * matrix by unpacks and lane permutes, without going through memory
+ * element by element. 8x8 tiles without a kernel of their own are four
+ * 4x4 ones. transposeBlockIntrinImplementation halves the longer side of
+ * a matrix until both sides are small blocks, so every level of cache is
+ * used fully without knowing its size, then transposes the leaf by tiles
+ * and its ragged edges element by element.
+*/
+
+#include "matrix_implementation.hpp"
+#include "simd.hpp"
+#include <cstddef>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// rows and columns of leaf blocks: rows of power-of-two strides share
+// L1 cache sets, so leaves stay small enough not to evict each other
+inline constexpr std::size_t TransposeLeaf = 16;
+
+// Largest tile of instruction set
+template<typename Isa, typename T>
+inline constexpr std::size_t TransposeTileSize = std::is_same_v<Isa, Scalar> ? 1 : 4;
+template<typename T>
+inline constexpr std::size_t TransposeTileSize<AVX2, T> = 8;
+template<typename T>
+inline constexpr std::size_t TransposeTileSize<AVX512, T> = 8;
+
+// b[j][i] = a[i][j] for N x N tile, strides are in elements
+template<typename Isa, typename T, std::size_t N>
+void transposeTile(const T *a, std::size_t lda, T *b, std::size_t ldb) noexcept
+{
+    if constexpr (N == 8 && !std::is_same_v<Isa, Scalar>)
+    {
+        transposeTile<Isa, T, 4>(a, lda, b, ldb);
+        transposeTile<Isa, T, 4>(a + 4, lda, b + 4 * ldb, ldb);
+        transposeTile<Isa, T, 4>(a + 4 * lda, lda, b + 4, ldb);
+        transposeTile<Isa, T, 4>(a + 4 * lda + 4, lda, b + 4 * ldb + 4, ldb);
+    }
+    else
+        for (std::size_t i = 0; i < N; ++i)
+            for (std::size_t j = 0; j < N; ++j)
+                b[j * ldb + i] = a[i * lda + j];
+}
+
+#ifdef __SSE2__
+template<>
+inline void transposeTile<SSE, float, 4>(const float *a, std::size_t lda, float *b, std::size_t ldb) noexcept
+{
+    const __m128 t0 = _mm_unpacklo_ps(_mm_loadu_ps(a), _mm_loadu_ps(a + lda));
+    const __m128 t1 = _mm_unpacklo_ps(_mm_loadu_ps(a + 2 * lda), _mm_loadu_ps(a + 3 * lda));
+    const __m128 t2 = _mm_unpackhi_ps(_mm_loadu_ps(a), _mm_loadu_ps(a + lda));
+    const __m128 t3 = _mm_unpackhi_ps(_mm_loadu_ps(a + 2 * lda), _mm_loadu_ps(a + 3 * lda));
+    _mm_storeu_ps(b, _mm_movelh_ps(t0, t1));
+    _mm_storeu_ps(b + ldb, _mm_movehl_ps(t1, t0));
+    _mm_storeu_ps(b + 2 * ldb, _mm_movelh_ps(t2, t3));
+    _mm_storeu_ps(b + 3 * ldb, _mm_movehl_ps(t3, t2));
+}
+
+// by 2x2 blocks
+template<>
+inline void transposeTile<SSE, double, 4>(const double *a, std::size_t lda, double *b, std::size_t ldb) noexcept
+{
+    for (std::size_t i = 0; i < 4; i += 2)
+        for (std::size_t j = 0; j < 4; j += 2)
+        {
+            const __m128d row0 = _mm_loadu_pd(a + i * lda + j);
+            const __m128d row1 = _mm_loadu_pd(a + (i + 1) * lda + j);
+            _mm_storeu_pd(b + j * ldb + i, _mm_unpacklo_pd(row0, row1));
+            _mm_storeu_pd(b + (j + 1) * ldb + i, _mm_unpackhi_pd(row0, row1));
+        }
+}
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+inline void transposeTile<AVX2, float, 4>(const float *a, std::size_t lda, float *b, std::size_t ldb) noexcept
+{
+    transposeTile<SSE, float, 4>(a, lda, b, ldb);
+}
+
+template<>
+inline void transposeTile<AVX2, double, 4>(const double *a, std::size_t lda, double *b, std::size_t ldb) noexcept
+{
+    const __m256d row0 = _mm256_loadu_pd(a);
+    const __m256d row1 = _mm256_loadu_pd(a + lda);
+    const __m256d row2 = _mm256_loadu_pd(a + 2 * lda);
+    const __m256d row3 = _mm256_loadu_pd(a + 3 * lda);
+
+    const __m256d t0 = _mm256_unpacklo_pd(row0, row1);
+    const __m256d t1 = _mm256_unpackhi_pd(row0, row1);
+    const __m256d t2 = _mm256_unpacklo_pd(row2, row3);
+    const __m256d t3 = _mm256_unpackhi_pd(row2, row3);
+
+    _mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(b + ldb, _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(b + 2 * ldb, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(b + 3 * ldb, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+/*
+ * Pairs of rows are interleaved, then pairs of pairs, so every 128-bit
+ * lane holds 4 numbers of one column, lanes are swapped at last
+ */
+template<>
+inline void transposeTile<AVX2, float, 8>(const float *a, std::size_t lda, float *b, std::size_t ldb) noexcept
+{
+    __m256 r[8], t[8];
+    for (std::size_t i = 0; i < 8; ++i)
+        r[i] = _mm256_loadu_ps(a + i * lda);
+    for (std::size_t i = 0; i < 8; i += 2)
+    {
+        t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (std::size_t i = 0; i < 8; i += 4)
+    {
+        r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1,0,1,0));
+        r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3,2,3,2));
+        r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1,0,1,0));
+        r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3,2,3,2));
+    }
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        _mm256_storeu_ps(b + i * ldb, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+        _mm256_storeu_ps(b + (i + 4) * ldb, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+    }
+}
+#endif
+
+#if defined(__AVX512F__)
+template<>
+inline void transposeTile<AVX512, float, 4>(const float *a, std::size_t lda, float *b, std::size_t ldb) noexcept
+{
+    transposeTile<SSE, float, 4>(a, lda, b, ldb);
+}
+
+template<>
+inline void transposeTile<AVX512, double, 4>(const double *a, std::size_t lda, double *b, std::size_t ldb) noexcept
+{
+    transposeTile<AVX2, double, 4>(a, lda, b, ldb);
+}
+
+template<>
+inline void transposeTile<AVX512, float, 8>(const float *a, std::size_t lda, float *b, std::size_t ldb) noexcept
+{
+    transposeTile<AVX2, float, 8>(a, lda, b, ldb);
+}
+
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+/*
+ * Pairs of rows are interleaved, then 128-bit lanes of two pairs are
+ * gathered, so a register holds halves of two columns, which are joined
+ */
+template<>
+inline void transposeTile<AVX512, double, 8>(const double *a, std::size_t lda, double *b, std::size_t ldb) noexcept
+{
+    __m512d r[8], t[8];
+    for (std::size_t i = 0; i < 8; ++i)
+        r[i] = _mm512_loadu_pd(a + i * lda);
+    for (std::size_t i = 0; i < 8; i += 2)
+    {
+        t[i] = _mm512_unpacklo_pd(r[i], r[i + 1]);
+        t[i + 1] = _mm512_unpackhi_pd(r[i], r[i + 1]);
+    }
+    // columns 0|4 and 2|6 of unpacklo, 1|5 and 3|7 of unpackhi
+    const __m512i even = _mm512_setr_epi64(0, 1, 8, 9, 4, 5, 12, 13);
+    const __m512i odd = _mm512_setr_epi64(2, 3, 10, 11, 6, 7, 14, 15);
+    for (std::size_t i = 0; i < 8; i += 4)
+    {
+        r[i] = _mm512_permutex2var_pd(t[i], even, t[i + 2]);
+        r[i + 1] = _mm512_permutex2var_pd(t[i + 1], even, t[i + 3]);
+        r[i + 2] = _mm512_permutex2var_pd(t[i], odd, t[i + 2]);
+        r[i + 3] = _mm512_permutex2var_pd(t[i + 1], odd, t[i + 3]);
+    }
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        _mm512_storeu_pd(b + i * ldb, _mm512_shuffle_f64x2(r[i], r[i + 4], _MM_SHUFFLE(1,0,1,0)));
+        _mm512_storeu_pd(b + (i + 4) * ldb, _mm512_shuffle_f64x2(r[i], r[i + 4], _MM_SHUFFLE(3,2,3,2)));
+    }
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+#endif
+
+// ============================ Fixed matrices ============================= //
+#ifdef __SSE2__
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, float, 4>(const float (&a)[4][4], float (&result)[4][4])
+{
+    transposeTile<SSE, float, 4>(&a[0][0], 4, &result[0][0], 4);
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, float, 8>(const float (&a)[8][8], float (&result)[8][8])
+{
+    transposeTile<SSE, float, 8>(&a[0][0], 8, &result[0][0], 8);
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<SSE, double, 8>(const double (&a)[8][8], double (&result)[8][8])
+{
+    transposeTile<SSE, double, 8>(&a[0][0], 8, &result[0][0], 8);
+}
+#endif
+
+#if defined(__AVX2__) && defined(__FMA__)
+template<>
+inline void transposeMatrixIntrinImplementation<AVX2, float, 8>(const float (&a)[8][8], float (&result)[8][8])
+{
+    transposeTile<AVX2, float, 8>(&a[0][0], 8, &result[0][0], 8);
+}
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX2, double, 8>(const double (&a)[8][8], double (&result)[8][8])
+{
+    transposeTile<AVX2, double, 8>(&a[0][0], 8, &result[0][0], 8);
+}
+#endif
+
+#if defined(__AVX512F__)
+GEOMETRIX_UNDEFINED_PASSTHROUGH_BEGIN
+// whole matrix in one register
+template<>
+inline void transposeMatrixIntrinImplementation<AVX512, float, 4>(const float (&a)[4][4], float (&result)[4][4])
+{
+    const __m512 m = _mm512_loadu_ps(&a[0][0]);
+    _mm512_storeu_ps(&result[0][0], _mm512_permutexvar_ps(_mm512_setr_epi32(0,4,8,12,1,5,9,13,2,6,10,14,3,7,11,15), m));
+}
+GEOMETRIX_UNDEFINED_PASSTHROUGH_END
+
+template<>
+inline void transposeMatrixIntrinImplementation<AVX512, double, 8>(const double (&a)[8][8], double (&result)[8][8])
+{
+    transposeTile<AVX512, double, 8>(&a[0][0], 8, &result[0][0], 8);
+}
+#endif
+
+/*
+ * Transposes of matrix arrays: result[i] = a[i]^T.
+ * Kernel is called directly, so there is one indirect call per batch
+ */
+template<typename T, std::size_t N>
+void transposeMatrixBatchFallbackImplementation(const T (*a)[N][N], T (*result)[N][N], std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        transposeMatrixFallbackImplementation<T, N>(a[i], result[i]);
+}
+
+template<typename Isa, typename T, std::size_t N>
+void transposeMatrixBatchIntrinImplementation(const T (*a)[N][N], T (*result)[N][N], std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        transposeMatrixIntrinImplementation<Isa, T, N>(a[i], result[i]);
+}
+
+// ============================ Strided matrices =========================== //
+/*
+ * b = a^T for rows x columns matrix a, strides are in elements,
+ * b must not overlap a. Splits keep tiles whole
+ */
+template<typename Isa, typename T>
+void transposeBlockIntrinImplementation(const T *a, std::size_t lda, T *b, std::size_t ldb,
+                                        std::size_t rows, std::size_t columns) noexcept
+{
+    constexpr std::size_t Tile = TransposeTileSize<Isa, T>;
+    if (rows > TransposeLeaf || columns > TransposeLeaf)
+    {
+        if (rows >= columns)
+        {
+            const std::size_t half = (rows / 2 + Tile - 1) / Tile * Tile;
+            transposeBlockIntrinImplementation<Isa, T>(a, lda, b, ldb, half, columns);
+            transposeBlockIntrinImplementation<Isa, T>(a + half * lda, lda, b + half, ldb, rows - half, columns);
+        }
+        else
+        {
+            const std::size_t half = (columns / 2 + Tile - 1) / Tile * Tile;
+            transposeBlockIntrinImplementation<Isa, T>(a, lda, b, ldb, rows, half);
+            transposeBlockIntrinImplementation<Isa, T>(a + half, lda, b + half * ldb, ldb, rows, columns - half);
+        }
+        return;
+    }
+
+    const std::size_t fullRows = rows / Tile * Tile, fullColumns = columns / Tile * Tile;
+    for (std::size_t i = 0; i < fullRows; i += Tile)
+    {
+        for (std::size_t j = 0; j < fullColumns; j += Tile)
+            transposeTile<Isa, T, Tile>(a + i * lda + j, lda, b + j * ldb + i, ldb);
+        for (std::size_t k = i; k < i + Tile; ++k)
+            for (std::size_t j = fullColumns; j < columns; ++j)
+                b[j * ldb + k] = a[k * lda + j];
+    }
+    for (std::size_t i = fullRows; i < rows; ++i)
+        for (std::size_t j = 0; j < columns; ++j)
+            b[j * ldb + i] = a[i * lda + j];
+}
+
+template<typename T>
+void transposeBlockFallbackImplementation(const T *a, std::size_t lda, T *b, std::size_t ldb,
+                                          std::size_t rows, std::size_t columns) noexcept requires(std::is_floating_point_v<T>)
+{
+    transposeBlockIntrinImplementation<Scalar, T>(a, lda, b, ldb, rows, columns);
+}
+
+}
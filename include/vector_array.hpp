@@ -0,0 +1,493 @@
+#pragma once
+/*
+ * File contains structure-of-arrays container of vectors
+ *
+ * VectorArray<T,Dim> keeps every component in its own aligned stream
+ * (all x, then all y, ...), so bulk operations process as many vectors
+ * per instruction, as SIMD register fits, without any shuffles.
+ * Single vectors are accessed through proxies, which convert
+ * to and from LA::Vector.
+ *
+ * Bulk operations of float and double arrays are dispatched
+ * by Optimizer, results may alias operands.
+*/
+
+#include "matrix.hpp"
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+namespace Geometrix
+{
+namespace LA
+{
+
+template <typename T, std::size_t Dim>
+class VectorArray
+{
+public:
+    static_assert(Dim > 0, "VectorArray of zero-dimensional vectors");
+    static_assert(std::is_trivially_copyable_v<T>, "VectorArray stores plain numbers only");
+
+    using Type = T;
+    using Value = Vector<T, Dim>;
+    static constexpr std::size_t Dimension = Dim;
+    // streams start at cache line boundary
+    static constexpr std::size_t Alignment = 64;
+
+    // Proxy to the vector stored at index
+    class Reference
+    {
+    public:
+        Reference(VectorArray &array, std::size_t index) noexcept : _array(array), _index(index) {}
+
+        operator Value() const noexcept { return _array.at(_index); }
+        Reference &operator=(const Value &v) noexcept
+        {
+            _array.set(_index, v);
+            return *this;
+        }
+        Reference &operator=(const Reference &r) noexcept { return *this = Value(r); }
+        T &operator[](std::size_t k) const noexcept { return _array.stream(k)[_index]; }
+
+        friend bool operator==(const Reference &lhs, const Value &rhs) { return Value(lhs) == rhs; }
+        friend bool operator!=(const Reference &lhs, const Value &rhs) { return Value(lhs) != rhs; }
+        friend bool operator==(const Value &lhs, const Reference &rhs) { return lhs == Value(rhs); }
+        friend bool operator!=(const Value &lhs, const Reference &rhs) { return lhs != Value(rhs); }
+
+    private:
+        VectorArray &_array;
+        std::size_t _index;
+    };
+
+    VectorArray() noexcept = default;
+    explicit VectorArray(std::size_t size) { resize(size); }
+    VectorArray(std::size_t size, const Value &v)
+    {
+        resize(size);
+        for (std::size_t i = 0; i < size; ++i)
+            set(i, v);
+    }
+    // From array of structures
+    VectorArray(const Value *aos, std::size_t count) { assign(aos, count); }
+    explicit VectorArray(const std::vector<Value> &aos) { assign(aos.data(), aos.size()); }
+
+    VectorArray(const VectorArray &a)
+    {
+        reserve(a._size);
+        _size = a._size;
+        for (std::size_t k = 0; k < Dim && _size; ++k)
+            std::memcpy(stream(k), a.stream(k), _size * sizeof(T));
+    }
+    VectorArray(VectorArray &&a) noexcept : _data(a._data), _size(a._size), _capacity(a._capacity)
+    {
+        a._data = nullptr;
+        a._size = a._capacity = 0;
+    }
+    VectorArray &operator=(const VectorArray &a)
+    {
+        if (this != &a)
+        {
+            _size = 0;
+            reserve(a._size);
+            _size = a._size;
+            for (std::size_t k = 0; k < Dim && _size; ++k)
+                std::memcpy(stream(k), a.stream(k), _size * sizeof(T));
+        }
+        return *this;
+    }
+    VectorArray &operator=(VectorArray &&a) noexcept
+    {
+        if (this != &a)
+        {
+            release();
+            _data = a._data;
+            _size = a._size;
+            _capacity = a._capacity;
+            a._data = nullptr;
+            a._size = a._capacity = 0;
+        }
+        return *this;
+    }
+    ~VectorArray() { release(); }
+
+    std::size_t size() const noexcept { return _size; }
+    std::size_t capacity() const noexcept { return _capacity; }
+    bool empty() const noexcept { return _size == 0; }
+
+    // Component streams, stream(0) is x, stream(1) is y ...
+    T *stream(std::size_t k) noexcept
+    {
+        assert(k < Dim);
+        return _data + k * _capacity;
+    }
+    const T *stream(std::size_t k) const noexcept
+    {
+        assert(k < Dim);
+        return _data + k * _capacity;
+    }
+    T *x() noexcept { return stream(0); }
+    const T *x() const noexcept { return stream(0); }
+    T *y() noexcept requires(Dim > 1) { return stream(1); }
+    const T *y() const noexcept requires(Dim > 1) { return stream(1); }
+    T *z() noexcept requires(Dim > 2) { return stream(2); }
+    const T *z() const noexcept requires(Dim > 2) { return stream(2); }
+    T *w() noexcept requires(Dim > 3) { return stream(3); }
+    const T *w() const noexcept requires(Dim > 3) { return stream(3); }
+
+    Value at(std::size_t i) const noexcept
+    {
+        assert(i < _size);
+        Value v;
+        for (std::size_t k = 0; k < Dim; ++k)
+            v[k] = stream(k)[i];
+        return v;
+    }
+    void set(std::size_t i, const Value &v) noexcept
+    {
+        assert(i < _size);
+        for (std::size_t k = 0; k < Dim; ++k)
+            stream(k)[i] = v[k];
+    }
+    Reference operator[](std::size_t i) noexcept
+    {
+        assert(i < _size);
+        return Reference(*this, i);
+    }
+    Value operator[](std::size_t i) const noexcept { return at(i); }
+
+    // Keeps stored vectors, new ones are uninitialized
+    void reserve(std::size_t capacity)
+    {
+        constexpr std::size_t Granularity = Alignment / sizeof(T) ? Alignment / sizeof(T) : 1;
+        if (capacity <= _capacity)
+            return;
+        capacity = (capacity + Granularity - 1) / Granularity * Granularity;
+
+        T *data = static_cast<T *>(::operator new(capacity * Dim * sizeof(T), std::align_val_t(Alignment)));
+        for (std::size_t k = 0; k < Dim && _size; ++k)
+            std::memcpy(data + k * capacity, stream(k), _size * sizeof(T));
+        release();
+        _data = data;
+        _capacity = capacity;
+    }
+    void resize(std::size_t size)
+    {
+        if (size > _capacity)
+            reserve(size > 2 * _capacity ? size : 2 * _capacity);
+        _size = size;
+    }
+    void push_back(const Value &v)
+    {
+        resize(_size + 1);
+        set(_size - 1, v);
+    }
+    void clear() noexcept { _size = 0; }
+
+    // Conversion from and to array of structures
+    void assign(const Value *aos, std::size_t count)
+    {
+        _size = 0;
+        resize(count);
+        for (std::size_t i = 0; i < count; ++i)
+            set(i, aos[i]);
+    }
+    void store(Value *aos) const noexcept
+    {
+        for (std::size_t i = 0; i < _size; ++i)
+            aos[i] = at(i);
+    }
+    std::vector<Value> toAoS() const
+    {
+        std::vector<Value> result(_size);
+        store(result.data());
+        return result;
+    }
+
+private:
+    void release() noexcept
+    {
+        if (_data)
+            ::operator delete(_data, std::align_val_t(Alignment));
+        _data = nullptr;
+    }
+
+    T *_data = nullptr;
+    std::size_t _size = 0;
+    std::size_t _capacity = 0;
+};
+
+template <typename T>
+concept StreamType = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/*
+ * Bulk element-wise operations,
+ * result is resized to operands size
+ */
+template <StreamType T, std::size_t Dim>
+void add(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs, VectorArray<T, Dim> &result)
+{
+    assert(lhs.size() == rhs.size());
+    result.resize(lhs.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::addStream<T>(lhs.stream(k), rhs.stream(k), result.stream(k), lhs.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void sub(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs, VectorArray<T, Dim> &result)
+{
+    assert(lhs.size() == rhs.size());
+    result.resize(lhs.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::subStream<T>(lhs.stream(k), rhs.stream(k), result.stream(k), lhs.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void mul(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs, VectorArray<T, Dim> &result)
+{
+    assert(lhs.size() == rhs.size());
+    result.resize(lhs.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::mulStream<T>(lhs.stream(k), rhs.stream(k), result.stream(k), lhs.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void scale(const VectorArray<T, Dim> &lhs, std::type_identity_t<T> rhs, VectorArray<T, Dim> &result)
+{
+    result.resize(lhs.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::scaleStream<T>(lhs.stream(k), rhs, result.stream(k), lhs.size());
+}
+
+/*
+ * Fused element-wise operations (see matrix.hpp), one pass per stream
+ * without temporaries, result is resized to operands size
+ */
+// result = a * x + y
+template <StreamType T, std::size_t Dim>
+void axpy(std::type_identity_t<T> a, const VectorArray<T, Dim> &x, const VectorArray<T, Dim> &y, VectorArray<T, Dim> &result)
+{
+    assert(x.size() == y.size());
+    result.resize(x.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::axpyStream<T>(a, x.stream(k), y.stream(k), result.stream(k), x.size());
+}
+
+// result = a + t * (b - a)
+template <StreamType T, std::size_t Dim>
+void lerp(const VectorArray<T, Dim> &a, const VectorArray<T, Dim> &b, std::type_identity_t<T> t, VectorArray<T, Dim> &result)
+{
+    assert(a.size() == b.size());
+    result.resize(a.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::lerpStream<T>(a.stream(k), b.stream(k), t, result.stream(k), a.size());
+}
+
+// result = a * b + c
+template <StreamType T, std::size_t Dim>
+void fma(const VectorArray<T, Dim> &a, const VectorArray<T, Dim> &b, const VectorArray<T, Dim> &c, VectorArray<T, Dim> &result)
+{
+    assert(a.size() == b.size() && a.size() == c.size());
+    result.resize(a.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::fmaStream<T>(a.stream(k), b.stream(k), c.stream(k), result.stream(k), a.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void min(const VectorArray<T, Dim> &a, const VectorArray<T, Dim> &b, VectorArray<T, Dim> &result)
+{
+    assert(a.size() == b.size());
+    result.resize(a.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::minStream<T>(a.stream(k), b.stream(k), result.stream(k), a.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void max(const VectorArray<T, Dim> &a, const VectorArray<T, Dim> &b, VectorArray<T, Dim> &result)
+{
+    assert(a.size() == b.size());
+    result.resize(a.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::maxStream<T>(a.stream(k), b.stream(k), result.stream(k), a.size());
+}
+
+// component k between lo[k] and hi[k], e.g. inside a box
+template <StreamType T, std::size_t Dim>
+void clamp(const VectorArray<T, Dim> &v, const Vector<T, Dim> &lo, const Vector<T, Dim> &hi, VectorArray<T, Dim> &result)
+{
+    result.resize(v.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::clampStream<T>(v.stream(k), lo[k], hi[k], result.stream(k), v.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void clamp(const VectorArray<T, Dim> &v, std::type_identity_t<T> lo, std::type_identity_t<T> hi, VectorArray<T, Dim> &result)
+{
+    clamp(v, Vector<T, Dim>(lo), Vector<T, Dim>(hi), result);
+}
+
+template <StreamType T, std::size_t Dim>
+void abs(const VectorArray<T, Dim> &v, VectorArray<T, Dim> &result)
+{
+    result.resize(v.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::absStream<T>(v.stream(k), result.stream(k), v.size());
+}
+
+template <StreamType T, std::size_t Dim>
+void floor(const VectorArray<T, Dim> &v, VectorArray<T, Dim> &result)
+{
+    result.resize(v.size());
+    for (std::size_t k = 0; k < Dim; ++k)
+        _OptimizerInternal::floorStream<T>(v.stream(k), result.stream(k), v.size());
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> operator+(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    VectorArray<T, Dim> result;
+    add(lhs, rhs, result);
+    return result;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> operator-(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    VectorArray<T, Dim> result;
+    sub(lhs, rhs, result);
+    return result;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> operator*(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    VectorArray<T, Dim> result;
+    mul(lhs, rhs, result);
+    return result;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> operator*(const VectorArray<T, Dim> &lhs, T rhs)
+{
+    VectorArray<T, Dim> result;
+    scale(lhs, rhs, result);
+    return result;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> operator*(T lhs, const VectorArray<T, Dim> &rhs)
+{
+    return rhs * lhs;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> &operator+=(VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    add(lhs, rhs, lhs);
+    return lhs;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> &operator-=(VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    sub(lhs, rhs, lhs);
+    return lhs;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> &operator*=(VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs)
+{
+    mul(lhs, rhs, lhs);
+    return lhs;
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> &operator*=(VectorArray<T, Dim> &lhs, T rhs)
+{
+    scale(lhs, rhs, lhs);
+    return lhs;
+}
+
+// Component stream pointers of array
+template <typename T, std::size_t Dim>
+struct Streams
+{
+    explicit Streams(const VectorArray<T, Dim> &a) noexcept
+    {
+        for (std::size_t k = 0; k < Dim; ++k)
+            data[k] = a.stream(k);
+    }
+    const T *data[Dim];
+};
+
+template <typename T, std::size_t Dim>
+struct MutableStreams
+{
+    explicit MutableStreams(VectorArray<T, Dim> &a) noexcept
+    {
+        for (std::size_t k = 0; k < Dim; ++k)
+            data[k] = a.stream(k);
+    }
+    T *data[Dim];
+};
+
+/*
+ * Per-vector dot products, result must hold lhs.size() numbers
+ */
+template <StreamType T, std::size_t Dim>
+void dot(const VectorArray<T, Dim> &lhs, const VectorArray<T, Dim> &rhs, T *result)
+{
+    assert(lhs.size() == rhs.size());
+    _OptimizerInternal::dotStream<T, Dim>(Streams(lhs).data, Streams(rhs).data, result, lhs.size());
+}
+
+/*
+ * Per-vector cross products of 3D vectors
+ */
+template <StreamType T>
+void cross(const VectorArray<T, 3> &lhs, const VectorArray<T, 3> &rhs, VectorArray<T, 3> &result)
+{
+    assert(lhs.size() == rhs.size());
+    result.resize(lhs.size());
+    _OptimizerInternal::crossStream<T>(Streams(lhs).data, Streams(rhs).data, MutableStreams(result).data, lhs.size());
+}
+
+template <StreamType T>
+VectorArray<T, 3> cross(const VectorArray<T, 3> &lhs, const VectorArray<T, 3> &rhs)
+{
+    VectorArray<T, 3> result;
+    cross(lhs, rhs, result);
+    return result;
+}
+
+/*
+ * Per-vector lengths, result must hold a.size() numbers
+ */
+template <StreamType T, std::size_t Dim>
+void length(const VectorArray<T, Dim> &a, T *result)
+{
+    _OptimizerInternal::lengthStream<T, Dim>(Streams(a).data, result, a.size());
+}
+
+/*
+ * Normalizes every vector, zero vectors become NaN
+ */
+template <StreamType T, std::size_t Dim>
+void normalize(const VectorArray<T, Dim> &a, VectorArray<T, Dim> &result)
+{
+    result.resize(a.size());
+    _OptimizerInternal::normalizeStream<T, Dim>(Streams(a).data, MutableStreams(result).data, a.size());
+}
+
+template <StreamType T, std::size_t Dim>
+VectorArray<T, Dim> normalize(const VectorArray<T, Dim> &a)
+{
+    VectorArray<T, Dim> result;
+    normalize(a, result);
+    return result;
+}
+
+}
+}
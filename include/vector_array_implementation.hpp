@@ -0,0 +1,352 @@
+#pragma once
+/*
+ * File contains fallback and Intrinsic implementations of bulk operations
+ * over structure-of-arrays vector streams (see vector_array.hpp).
+ *
+ * Vector of dimension Dim is spread over Dim component streams, every
+ * kernel processes "count" vectors. Component streams are passed as
+ * arrays of pointers. Results may alias operands.
+ *
+ * Fused kernels (axpy, lerp, fma) take one pass and one rounding per FMA
+ * where the build has it. min and max take the second operand, where
+ * one of them is NaN, as x86 instructions do, so clamp gives lo for NaN.
+*/
+
+#include "simd.hpp"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace _Impl
+{
+// ================================ Fallback ================================ //
+template<typename T>
+void addStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] + b[i];
+}
+
+template<typename T>
+void subStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] - b[i];
+}
+
+template<typename T>
+void mulStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] * b[i];
+}
+
+template<typename T>
+void scaleStreamFallbackImplementation(const T *a, T b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] * b;
+}
+
+// result = a * x + y
+template<typename T>
+void axpyStreamFallbackImplementation(T a, const T *x, const T *y, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a * x[i] + y[i];
+}
+
+// result = a + t * (b - a)
+template<typename T>
+void lerpStreamFallbackImplementation(const T *a, const T *b, T t, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] + t * (b[i] - a[i]);
+}
+
+// result = a * b + c
+template<typename T>
+void fmaStreamFallbackImplementation(const T *a, const T *b, const T *c, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] * b[i] + c[i];
+}
+
+// min and max take the second operand, where one of them is NaN, like x86 instructions do
+template<typename T>
+void minStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] < b[i] ? a[i] : b[i];
+}
+
+template<typename T>
+void maxStreamFallbackImplementation(const T *a, const T *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] > b[i] ? a[i] : b[i];
+}
+
+// NaN gives lo
+template<typename T>
+void clampStreamFallbackImplementation(const T *a, T lo, T hi, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T v = a[i] > lo ? a[i] : lo;
+        result[i] = v < hi ? v : hi;
+    }
+}
+
+template<typename T>
+void absStreamFallbackImplementation(const T *a, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = std::abs(a[i]);
+}
+
+template<typename T>
+void floorStreamFallbackImplementation(const T *a, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = std::floor(a[i]);
+}
+
+template<typename T, std::size_t Dim>
+void dotStreamFallbackImplementation(const T *const *a, const T *const *b, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        T accum = a[0][i] * b[0][i];
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum += a[k][i] * b[k][i];
+        result[i] = accum;
+    }
+}
+
+template<typename T>
+void crossStreamFallbackImplementation(const T *const *a, const T *const *b, T *const *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const T x = a[1][i] * b[2][i] - a[2][i] * b[1][i];
+        const T y = a[2][i] * b[0][i] - a[0][i] * b[2][i];
+        const T z = a[0][i] * b[1][i] - a[1][i] * b[0][i];
+        result[0][i] = x;
+        result[1][i] = y;
+        result[2][i] = z;
+    }
+}
+
+template<typename T, std::size_t Dim>
+void lengthStreamFallbackImplementation(const T *const *a, T *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        T accum = a[0][i] * a[0][i];
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum += a[k][i] * a[k][i];
+        result[i] = std::sqrt(accum);
+    }
+}
+
+template<typename T, std::size_t Dim>
+void normalizeStreamFallbackImplementation(const T *const *a, T *const *result, std::size_t count) requires(std::is_floating_point_v<T>)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        T accum = a[0][i] * a[0][i];
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum += a[k][i] * a[k][i];
+        const T inv = T(1) / std::sqrt(accum);
+        for (std::size_t k = 0; k < Dim; ++k)
+            result[k][i] = a[k][i] * inv;
+    }
+}
+
+// ================================ Intrinsic =============================== //
+/*
+ * Runs kernel(offset, load, store) over full registers from "first" element
+ * and then over the tail, load/store functions are partial for the tail
+ */
+template<typename L, typename Kernel>
+void streamLoop(std::size_t count, Kernel kernel, std::size_t first = 0)
+{
+    std::size_t i = first;
+    for (; i + L::Width <= count; i += L::Width)
+        kernel(i, [](const typename L::Type *p) { return L::load(p); },
+                  [](typename L::Type *p, typename L::Register v) { L::store(p, v); });
+    if (const std::size_t tail = count - i)
+        kernel(i, [tail](const typename L::Type *p) { return L::loadPartial(p, tail); },
+                  [tail](typename L::Type *p, typename L::Register v) { L::storePartial(p, v, tail); });
+}
+
+template<typename Isa, typename T>
+void addStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::add(load(a + i), load(b + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void subStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::sub(load(a + i), load(b + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void mulStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::mul(load(a + i), load(b + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void scaleStreamIntrinImplementation(const T *a, T b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    const auto scale = L::set1(b);
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::mul(load(a + i), scale));
+    });
+}
+
+template<typename Isa, typename T>
+void axpyStreamIntrinImplementation(T a, const T *x, const T *y, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    const auto scale = L::set1(a);
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::fmadd(scale, load(x + i), load(y + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void lerpStreamIntrinImplementation(const T *a, const T *b, T t, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    const auto factor = L::set1(t);
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        const auto from = load(a + i);
+        store(result + i, L::fmadd(factor, L::sub(load(b + i), from), from));
+    });
+}
+
+template<typename Isa, typename T>
+void fmaStreamIntrinImplementation(const T *a, const T *b, const T *c, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::fmadd(load(a + i), load(b + i), load(c + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void minStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::min(load(a + i), load(b + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void maxStreamIntrinImplementation(const T *a, const T *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::max(load(a + i), load(b + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void clampStreamIntrinImplementation(const T *a, T lo, T hi, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    const auto low = L::set1(lo), high = L::set1(hi);
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::min(L::max(load(a + i), low), high));
+    });
+}
+
+template<typename Isa, typename T>
+void absStreamIntrinImplementation(const T *a, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::abs(load(a + i)));
+    });
+}
+
+template<typename Isa, typename T>
+void floorStreamIntrinImplementation(const T *a, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        store(result + i, L::floor(load(a + i)));
+    });
+}
+
+template<typename Isa, typename T, std::size_t Dim>
+void dotStreamIntrinImplementation(const T *const *a, const T *const *b, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        auto accum = L::mul(load(a[0] + i), load(b[0] + i));
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum = L::fmadd(load(a[k] + i), load(b[k] + i), accum);
+        store(result + i, accum);
+    });
+}
+
+template<typename Isa, typename T>
+void crossStreamIntrinImplementation(const T *const *a, const T *const *b, T *const *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        const auto ax = load(a[0] + i), ay = load(a[1] + i), az = load(a[2] + i);
+        const auto bx = load(b[0] + i), by = load(b[1] + i), bz = load(b[2] + i);
+        store(result[0] + i, L::sub(L::mul(ay, bz), L::mul(az, by)));
+        store(result[1] + i, L::sub(L::mul(az, bx), L::mul(ax, bz)));
+        store(result[2] + i, L::sub(L::mul(ax, by), L::mul(ay, bx)));
+    });
+}
+
+template<typename Isa, typename T, std::size_t Dim>
+void lengthStreamIntrinImplementation(const T *const *a, T *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        auto accum = L::mul(load(a[0] + i), load(a[0] + i));
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum = L::fmadd(load(a[k] + i), load(a[k] + i), accum);
+        store(result + i, L::sqrt(accum));
+    });
+}
+
+template<typename Isa, typename T, std::size_t Dim>
+void normalizeStreamIntrinImplementation(const T *const *a, T *const *result, std::size_t count)
+{
+    using L = Lanes<T, Isa>;
+    streamLoop<L>(count, [=](std::size_t i, auto load, auto store) {
+        typename L::Register v[Dim];
+        for (std::size_t k = 0; k < Dim; ++k)
+            v[k] = load(a[k] + i);
+        auto accum = L::mul(v[0], v[0]);
+        for (std::size_t k = 1; k < Dim; ++k)
+            accum = L::fmadd(v[k], v[k], accum);
+        const auto inv = L::div(L::set1(T(1)), L::sqrt(accum));
+        for (std::size_t k = 0; k < Dim; ++k)
+            store(result[k] + i, L::mul(v[k], inv));
+    });
+}
+
+}
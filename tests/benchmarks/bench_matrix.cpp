@@ -0,0 +1,1440 @@
+#include "../utility_benchmark.hpp"
+#include "../../include/affine.hpp"
+#include "../../include/conversion.hpp"
+#include "../../include/dynamic_matrix.hpp"
+#include "../../include/geometry.hpp"
+#include "../../include/integer_matrix.hpp"
+#include "../../include/matrix.hpp"
+#include "../../include/matrix_array.hpp"
+#include "../../include/matrix_expression.hpp"
+#include "../../include/matrix_view.hpp"
+#include "../../include/optimizer.hpp"
+#include "../../include/padded_vector.hpp"
+#include "../../include/quaternion.hpp"
+#include "../../include/reduction.hpp"
+#include "../../include/skinning.hpp"
+#include "../../include/transform.hpp"
+#include "../../include/vector_array.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+
+
+using namespace Geometrix;
+//========================== matrix throughput tests ==========================//
+
+inline constexpr std::size_t batchSize = 4096;
+inline constexpr std::size_t runCount = 1000;
+
+template<typename T, std::size_t Dim>
+std::vector<LA::Matrix<T,Dim,Dim>> randomMatrices(std::random_device &r, std::size_t count = batchSize)
+{
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    std::vector<LA::Matrix<T,Dim,Dim>> data(count);
+    for (auto &m : data)
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                m[i][j] = dist(r);
+    return data;
+}
+
+// runs func runCount times, every run processes "items" of "unit"
+template<typename Func, typename TimeScale = std::chrono::microseconds>
+void throughputBench(Func func, const char* name, std::size_t items = batchSize, const char* unit = "products")
+{
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (std::size_t run = 0; run < runCount; ++run)
+        func();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<TimeScale>(endTime - startTime);
+    auto seconds = std::chrono::duration<double>(endTime - startTime).count();
+    std::cout << name << ": " << duration.count() << " " << TimeScaleStr<TimeScale> << ", "
+              << double(items * runCount) / seconds / 1e6 << " M " << unit << "/s" << std::endl;
+}
+
+template<typename T, std::size_t Dim>
+void dotThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Matrix product " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    const auto lhs = randomMatrices<T,Dim>(r);
+    const auto rhs = randomMatrices<T,Dim>(r);
+    std::vector<LA::Matrix<T,Dim,Dim>> result(batchSize);
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::dot(lhs[i], rhs[i]);
+    }, "single products");
+    throughputBench([&]{
+        LA::dot(lhs.data(), rhs.data(), result.data(), batchSize);
+    }, "batched products");
+}
+
+// products uploaded column by column (OpenGL/Vulkan convention)
+template<typename T, std::size_t Dim>
+void columnMajorThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Column-major product " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    const auto lhs = randomMatrices<T,Dim>(r);
+    const auto rhs = randomMatrices<T,Dim>(r);
+    std::vector<LA::ColumnMajorMatrix<T,Dim,Dim>> cmLhs, cmRhs;
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        cmLhs.emplace_back(lhs[i]);
+        cmRhs.emplace_back(rhs[i]);
+    }
+    std::vector<T> upload(batchSize * Dim * Dim);
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            const auto m = LA::transpose(LA::dot(lhs[i], rhs[i]));
+            std::copy_n(&m[0][0], Dim * Dim, upload.data() + i * Dim * Dim);
+        }
+    }, "row-major products + transpose");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            const auto m = LA::dot(cmLhs[i], cmRhs[i]);
+            std::copy_n(m.data(), Dim * Dim, upload.data() + i * Dim * Dim);
+        }
+    }, "column-major products");
+}
+
+// previous generic product, kept as a baseline
+template<typename T, std::size_t Dim>
+LA::Matrix<T,Dim,Dim> naiveDot(const LA::Matrix<T,Dim,Dim> &lhs, const LA::Matrix<T,Dim,Dim> &rhs)
+{
+    LA::Matrix<T,Dim,Dim> res(T(0));
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--;)
+            for (std::size_t k = Dim; k--; res[i][j] += lhs[i][k] * rhs[k][j]);
+    return res;
+}
+
+template<typename T, std::size_t Dim>
+void genericDotThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Generic matrix product " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    // the same work for every size, operands stay in cache
+    const std::size_t count = std::min(batchSize, batchSize * 16 / (Dim * Dim));
+    const auto lhs = randomMatrices<T,Dim>(r, count);
+    const auto rhs = randomMatrices<T,Dim>(r, count);
+    std::vector<LA::Matrix<T,Dim,Dim>> result(count);
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = naiveDot(lhs[i], rhs[i]);
+    }, "naive products", count);
+    throughputBench([&]{
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = LA::dot(lhs[i], rhs[i]);
+    }, "dot products", count);
+}
+
+template<typename T>
+void genericDotTests(std::random_device &r, const char* type)
+{
+    genericDotThroughput<T,2>(r, type);
+    genericDotThroughput<T,3>(r, type);
+    genericDotThroughput<T,4>(r, type);
+    genericDotThroughput<T,5>(r, type);
+    genericDotThroughput<T,6>(r, type);
+    genericDotThroughput<T,8>(r, type);
+    genericDotThroughput<T,12>(r, type);
+    genericDotThroughput<T,16>(r, type);
+    genericDotThroughput<T,24>(r, type);
+    genericDotThroughput<T,32>(r, type);
+}
+
+// previous generic determinant, kept as a baseline
+template<typename T, std::size_t Dim>
+T cofactorDeterminant(const LA::Matrix<T,Dim,Dim> &m)
+{
+    if constexpr (Dim <= 3)
+        return LA::determinant(m);
+    else
+    {
+        T result = 0, sign = 1;
+        for (std::size_t i = 0; i < Dim; ++i, sign = -sign)
+            result += sign * m[0][i] * cofactorDeterminant(LA::submatrix(m, 0, i));
+        return result;
+    }
+}
+
+template<typename T, std::size_t Dim>
+void determinantThroughput(std::random_device &r, const char* type, std::size_t count)
+{
+    std::cout << std::endl << "=========== Determinant " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    const auto data = randomMatrices<T,Dim>(r);
+    volatile T sink = 0;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        sink = sink + cofactorDeterminant(data[i % batchSize]);
+    const auto middle = std::chrono::high_resolution_clock::now();
+    for (std::size_t i = 0; i < count; ++i)
+        sink = sink + LA::determinant(LA::decomposeLU(data[i % batchSize]));
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const auto cofactor = std::chrono::duration_cast<std::chrono::microseconds>(middle - start);
+    const auto lu = std::chrono::duration_cast<std::chrono::microseconds>(end - middle);
+    std::cout << "cofactor expansion: " << cofactor.count() << " " << TimeScaleStr<std::chrono::microseconds> << std::endl;
+    std::cout << "LU decomposition: " << lu.count() << " " << TimeScaleStr<std::chrono::microseconds> << std::endl;
+    std::cout << float(cofactor.count()) / float(lu.count()) << " times faster" << std::endl;
+}
+
+void determinantTests(std::random_device &r)
+{
+    determinantThroughput<double,4>(r, "double", 1000000);
+    determinantThroughput<double,6>(r, "double", 100000);
+    determinantThroughput<double,8>(r, "double", 1000);
+}
+
+// a * s + b - c / s, eager operators against one lazy pass
+template<typename T, std::size_t Dim>
+void expressionThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Chained expression " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    auto a = std::make_unique<LA::Matrix<T,Dim,Dim>>();
+    auto b = std::make_unique<LA::Matrix<T,Dim,Dim>>();
+    auto c = std::make_unique<LA::Matrix<T,Dim,Dim>>();
+    auto result = std::make_unique<LA::Matrix<T,Dim,Dim>>();
+    for (std::size_t i = 0; i < Dim; ++i)
+        for (std::size_t j = 0; j < Dim; ++j)
+        {
+            (*a)[i][j] = dist(r);
+            (*b)[i][j] = dist(r);
+            (*c)[i][j] = dist(r);
+        }
+    const T s = dist(r);
+
+    throughputBench([&]{
+        *result = *a * s + *b - *c / s;
+    }, "eager operators", Dim * Dim, "elements");
+    throughputBench([&]{
+        LA::Lazy::assign(*result, LA::Lazy::lazy(*a) * s + *b - LA::Lazy::lazy(*c) / s);
+    }, "lazy expression", Dim * Dim, "elements");
+}
+
+void expressionTests(std::random_device &r)
+{
+    expressionThroughput<float,128>(r, "float");
+    expressionThroughput<double,128>(r, "double");
+}
+
+// previous layout of Vector4D: same data, but element-wise copy operations
+struct ElementwiseVector4D
+{
+    ElementwiseVector4D() noexcept {}
+    ElementwiseVector4D(const ElementwiseVector4D &v) noexcept
+    {
+        for (std::size_t i = 4; i--; data[i] = v.data[i]);
+    }
+    ElementwiseVector4D &operator=(const ElementwiseVector4D &v) noexcept
+    {
+        for (std::size_t i = 4; i--; data[i] = v.data[i]);
+        return *this;
+    }
+    alignas(16) float data[4];
+};
+
+template<typename V>
+[[gnu::noinline]] float byValue(V v, V w)
+{
+    return reinterpret_cast<const float *>(&v)[1] + reinterpret_cast<const float *>(&w)[2];
+}
+
+template<typename V>
+void copyThroughput(const char* name)
+{
+    std::cout << std::endl << "=========== Copy " << name << " ===========" << std::endl;
+    constexpr std::size_t count = 1 << 16;
+    std::vector<V> source(count);
+    std::vector<V> target;
+
+    throughputBench([&]{
+        target = source;
+    }, "vector copy", count, "elements");
+    throughputBench([&]{
+        std::vector<V> grow;
+        for (std::size_t size = 1; size <= count; size *= 2)
+            grow.resize(size);
+    }, "vector resize", count, "elements");
+    volatile float sink = 0;
+    throughputBench([&]{
+        for (std::size_t i = 0; i + 1 < count; ++i)
+            sink = sink + byValue(source[i], source[i + 1]);
+    }, "by-value call", count, "calls");
+}
+
+void copyTests()
+{
+    copyThroughput<LA::Vector4D<float>>("Vector4D<float>");
+    copyThroughput<ElementwiseVector4D>("element-wise copied vector");
+}
+
+// array of structures loops, kept out of line, so runs are not merged
+template<typename T>
+[[gnu::noinline]] void addAoS(const LA::Vector3D<T> *a, const LA::Vector3D<T> *b, LA::Vector3D<T> *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] + b[i];
+}
+
+template<typename T>
+[[gnu::noinline]] void dotAoS(const LA::Vector3D<T> *a, const LA::Vector3D<T> *b, T *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = LA::dot(a[i], b[i]);
+}
+
+template<typename T>
+[[gnu::noinline]] void normalizeAoS(const LA::Vector3D<T> *a, LA::Vector3D<T> *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = LA::norm(a[i], T(1));
+}
+
+// a + b, dot and normalize of array of structures against structure of arrays
+template<typename T>
+void vectorArrayThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Vector3D " << type << " AoS vs SoA ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    std::uniform_real_distribution<T> dist(T(1), T(10));
+    std::vector<LA::Vector3D<T>> a(count), b(count), sum(count), unit(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            a[i][k] = dist(r);
+            b[i][k] = dist(r);
+        }
+    std::vector<T> dots(count);
+    const LA::VectorArray<T,3> sa(a), sb(b);
+    LA::VectorArray<T,3> ssum(count), sunit(count);
+
+    throughputBench([&]{
+        addAoS(a.data(), b.data(), sum.data(), count);
+    }, "AoS add", count, "vectors");
+    throughputBench([&]{
+        LA::add(sa, sb, ssum);
+    }, "SoA add", count, "vectors");
+    throughputBench([&]{
+        dotAoS(a.data(), b.data(), dots.data(), count);
+    }, "AoS dot", count, "vectors");
+    throughputBench([&]{
+        LA::dot(sa, sb, dots.data());
+    }, "SoA dot", count, "vectors");
+    throughputBench([&]{
+        normalizeAoS(a.data(), unit.data(), count);
+    }, "AoS normalize", count, "vectors");
+    throughputBench([&]{
+        LA::normalize(sa, sunit);
+    }, "SoA normalize", count, "vectors");
+}
+
+template<typename V>
+[[gnu::noinline]] void crossVectors(const V *a, const V *b, V *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = LA::cross(a[i], b[i]);
+}
+
+// the same loops over padded vectors
+template<typename T>
+[[gnu::noinline]] void addPadded(const LA::PaddedVector3D<T> *a, const LA::PaddedVector3D<T> *b,
+                                 LA::PaddedVector3D<T> *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = a[i] + b[i];
+}
+
+template<typename T>
+[[gnu::noinline]] void dotPadded(const LA::PaddedVector3D<T> *a, const LA::PaddedVector3D<T> *b, T *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = LA::dot(a[i], b[i]);
+}
+
+template<typename T>
+[[gnu::noinline]] void normalizePadded(const LA::PaddedVector3D<T> *a, LA::PaddedVector3D<T> *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = LA::normalize(a[i]);
+}
+
+// dependent chain of single vector operations, which loops can't vectorize
+template<typename T>
+[[gnu::noinline]] LA::Vector3D<T> chainAoS(const LA::Vector3D<T> *a, const LA::Vector3D<T> *b, std::size_t count)
+{
+    LA::Vector3D<T> v = a[0];
+    for (std::size_t i = 0; i < count; ++i)
+        v = LA::unit(LA::cross(v, a[i]) + b[i]);
+    return v;
+}
+
+template<typename T>
+[[gnu::noinline]] LA::PaddedVector3D<T> chainPadded(const LA::PaddedVector3D<T> *a, const LA::PaddedVector3D<T> *b,
+                                                    std::size_t count)
+{
+    LA::PaddedVector3D<T> v = a[0];
+    for (std::size_t i = 0; i < count; ++i)
+        v = LA::normalize(LA::cross(v, a[i]) + b[i]);
+    return v;
+}
+
+template<typename T>
+[[gnu::noinline]] void toPaddedArray(const LA::Vector3D<T> *in, LA::PaddedVector3D<T> *out, std::size_t count)
+{
+    LA::toPadded(in, out, count);
+}
+
+template<typename T>
+[[gnu::noinline]] void fromPaddedArray(const LA::PaddedVector3D<T> *in, LA::Vector3D<T> *out, std::size_t count)
+{
+    LA::fromPadded(in, out, count);
+}
+
+// packed Vector3D against PaddedVector3D, conversions between them
+template<typename T>
+void paddedVectorThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Vector3D " << type << " packed vs padded ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    std::uniform_real_distribution<T> dist(T(1), T(10));
+    std::vector<LA::Vector3D<T>> a(count), b(count), result(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            a[i][k] = dist(r);
+            b[i][k] = dist(r);
+        }
+    std::vector<T> dots(count);
+    std::vector<LA::PaddedVector3D<T>> pa(count), pb(count), presult(count);
+    LA::toPadded(a.data(), pa.data(), count);
+    LA::toPadded(b.data(), pb.data(), count);
+
+    throughputBench([&]{
+        addAoS(a.data(), b.data(), result.data(), count);
+    }, "packed add", count, "vectors");
+    throughputBench([&]{
+        addPadded(pa.data(), pb.data(), presult.data(), count);
+    }, "padded add", count, "vectors");
+    throughputBench([&]{
+        dotAoS(a.data(), b.data(), dots.data(), count);
+    }, "packed dot", count, "vectors");
+    throughputBench([&]{
+        dotPadded(pa.data(), pb.data(), dots.data(), count);
+    }, "padded dot", count, "vectors");
+    throughputBench([&]{
+        crossVectors(a.data(), b.data(), result.data(), count);
+    }, "packed cross", count, "vectors");
+    throughputBench([&]{
+        crossVectors(pa.data(), pb.data(), presult.data(), count);
+    }, "padded cross", count, "vectors");
+    throughputBench([&]{
+        normalizeAoS(a.data(), result.data(), count);
+    }, "packed normalize", count, "vectors");
+    throughputBench([&]{
+        normalizePadded(pa.data(), presult.data(), count);
+    }, "padded normalize", count, "vectors");
+    throughputBench([&]{
+        result[0] = chainAoS(a.data(), b.data(), count);
+    }, "packed dependent chain", count, "vectors");
+    throughputBench([&]{
+        presult[0] = chainPadded(pa.data(), pb.data(), count);
+    }, "padded dependent chain", count, "vectors");
+    throughputBench([&]{
+        toPaddedArray(a.data(), presult.data(), count);
+    }, "packed to padded", count, "vectors");
+    throughputBench([&]{
+        fromPaddedArray(pa.data(), result.data(), count);
+    }, "padded to packed", count, "vectors");
+}
+
+void vectorArrayTests(std::random_device &r)
+{
+    vectorArrayThroughput<float>(r, "float");
+    vectorArrayThroughput<double>(r, "double");
+}
+
+void paddedVectorTests(std::random_device &r)
+{
+    paddedVectorThroughput<float>(r, "float");
+    paddedVectorThroughput<double>(r, "double");
+}
+
+// integer operators vector by vector, the way it had to be done before
+template<typename V>
+[[gnu::noinline]] void mulPerVector(const V *a, const V *b, V *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        result[i] = a[i];
+        result[i] *= b[i];
+    }
+}
+
+template<typename V>
+[[gnu::noinline]] void xorPerVector(const V *a, const V *b, V *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        result[i] = a[i];
+        result[i] ^= b[i];
+    }
+}
+
+template<typename V>
+[[gnu::noinline]] void shiftPerVector(const V *a, const V *counts, V *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        result[i] = a[i];
+        result[i] <<= counts[i];
+    }
+}
+
+template<typename V>
+void integerThroughput(std::random_device &r, const char* type)
+{
+    using T = typename V::Type;
+    std::cout << std::endl << "=========== " << type << " operators vs batches ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    constexpr std::size_t N = sizeof(V) / sizeof(T);
+    std::uniform_int_distribution<std::uint64_t> dist;
+    std::vector<V> a(count), b(count), counts(count), result(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            a[i][k] = T(dist(r));
+            b[i][k] = T(dist(r));
+            counts[i][k] = T(dist(r) % (sizeof(T) * 8));
+        }
+
+    throughputBench([&]{
+        xorPerVector(a.data(), b.data(), result.data(), count);
+    }, "xor per vector", count, "vectors");
+    throughputBench([&]{
+        LA::bitXor(a.data(), b.data(), result.data(), count);
+    }, "xor batch", count, "vectors");
+    throughputBench([&]{
+        mulPerVector(a.data(), b.data(), result.data(), count);
+    }, "mul per vector", count, "vectors");
+    throughputBench([&]{
+        LA::mul(a.data(), b.data(), result.data(), count);
+    }, "mul batch", count, "vectors");
+    throughputBench([&]{
+        shiftPerVector(a.data(), counts.data(), result.data(), count);
+    }, "variable shift per vector", count, "vectors");
+    throughputBench([&]{
+        LA::shiftLeft(a.data(), counts.data(), result.data(), count);
+    }, "variable shift batch", count, "vectors");
+}
+
+void integerTests(std::random_device &r)
+{
+    integerThroughput<LA::Vector4D<std::int32_t>>(r, "Vector4D<int32_t>");
+    integerThroughput<LA::Vector3D<std::uint64_t>>(r, "Vector3D<uint64_t>");
+    integerThroughput<LA::Vector4D<std::int64_t>>(r, "Vector4D<int64_t>");
+}
+
+// points moved by offsets one by one, as size_t based points had to be
+template<typename P>
+[[gnu::noinline]] void translatePerPoint(const P *points, const P *offsets, P *result, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        result[i] = points[i] + offsets[i];
+}
+
+template<typename P>
+[[gnu::noinline]] void roundPerPoint(const LA::Vector2D<float> *in, P *out, std::size_t count)
+{
+    using T = typename P::Type;
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 2; ++k)
+            out[i][k] = T(std::clamp(std::nearbyint(in[i][k]), float(std::numeric_limits<T>::lowest()),
+                                     float(std::numeric_limits<T>::max())));
+}
+
+template<typename P>
+void compactPointThroughput(std::random_device &r, const char* type)
+{
+    using T = typename P::Type;
+    std::cout << std::endl << "=========== " << type << " points ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    std::uniform_int_distribution<int> dist(-1000, 1000);
+    std::vector<P> points(count), offsets(count), result(count);
+    std::vector<LA::Vector2D<float>> floats(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        points[i] = P(T(dist(r)), T(dist(r)));
+        offsets[i] = P(T(dist(r)), T(dist(r)));
+        floats[i] = LA::Vector2D<float>(dist(r) * 0.37f, dist(r) * 0.37f);
+    }
+
+    throughputBench([&]{
+        translatePerPoint(points.data(), offsets.data(), result.data(), count);
+    }, "translate per point", count, "points");
+    if constexpr (LA::IntegerStreamType<T>)
+    {
+        throughputBench([&]{
+            LA::add(points.data(), offsets.data(), result.data(), count);
+        }, "translate batch", count, "points");
+        throughputBench([&]{
+            LA::add<LA::Overflow::Saturate>(points.data(), offsets.data(), result.data(), count);
+        }, "saturating translate batch", count, "points");
+    }
+    if constexpr (LA::FloatConvertibleType<T>)
+    {
+        throughputBench([&]{
+            roundPerPoint(floats.data(), result.data(), count);
+        }, "float to point per point", count, "points");
+        throughputBench([&]{
+            LA::convert(floats.data(), result.data(), count);
+        }, "float to point batch", count, "points");
+    }
+}
+
+void compactPointTests(std::random_device &r)
+{
+    compactPointThroughput<Point2D>(r, "Point2D (size_t)");
+    compactPointThroughput<Point2D32>(r, "Point2D32");
+    compactPointThroughput<Point2D16>(r, "Point2D16");
+}
+
+// point clouds converted one point at a time, by conversion operator
+template<typename From, typename To>
+[[gnu::noinline]] void convertPerPoint(const LA::Vector3D<From> *in, LA::Vector3D<To> *out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = LA::Vector3D<To>(in[i]);
+}
+
+[[gnu::noinline]] void halfPerPoint(const LA::Vector4D<float> *in, LA::Matrix<LA::Half,1,4> *out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 4; ++k)
+            out[i][k] = LA::Half(in[i][k]);
+}
+
+void conversionTests(std::random_device &r)
+{
+    std::cout << std::endl << "=========== Bulk conversions ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    std::uniform_real_distribution<double> dist(-1000., 1000.);
+    std::vector<LA::Vector3D<double>> wide(count);
+    std::vector<LA::Vector3D<float>> narrow(count);
+    std::vector<LA::Vector4D<float>> colors(count);
+    std::vector<LA::Matrix<LA::Half,1,4>> halves(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        wide[i] = LA::Vector3D<double>(dist(r), dist(r), dist(r));
+        colors[i] = LA::Vector4D<float>(float(dist(r)), float(dist(r)), float(dist(r)), 1.f);
+    }
+
+    throughputBench([&]{
+        convertPerPoint(wide.data(), narrow.data(), count);
+    }, "double to float per point", count, "points");
+    throughputBench([&]{
+        LA::convert(wide.data(), narrow.data(), count);
+    }, "double to float batch", count, "points");
+    throughputBench([&]{
+        LA::convert<LA::Rounding::Down>(wide.data(), narrow.data(), count);
+    }, "double to float batch, rounded down", count, "points");
+    throughputBench([&]{
+        convertPerPoint(narrow.data(), wide.data(), count);
+    }, "float to double per point", count, "points");
+    throughputBench([&]{
+        LA::convert(narrow.data(), wide.data(), count);
+    }, "float to double batch", count, "points");
+    throughputBench([&]{
+        halfPerPoint(colors.data(), halves.data(), count);
+    }, "float to binary16 per vector", count, "vectors");
+    throughputBench([&]{
+        LA::convert(colors.data(), halves.data(), count);
+    }, "float to binary16 batch", count, "vectors");
+    throughputBench([&]{
+        LA::convert(halves.data(), colors.data(), count);
+    }, "binary16 to float batch", count, "vectors");
+}
+
+// particle step by the operators, every expression is a pass over memory
+template<typename T>
+[[gnu::noinline]] void particleStepOperators(LA::VectorArray<T,3> &p, LA::VectorArray<T,3> &v, const LA::VectorArray<T,3> &a,
+                                             T dt, T lo, T hi)
+{
+    v += a * dt;
+    p += v * dt;
+    for (std::size_t i = 0; i < p.size(); ++i)
+        p.set(i, LA::clamp(p.at(i), lo, hi));
+}
+
+template<typename T>
+[[gnu::noinline]] void particleStepPerPoint(LA::Vector3D<T> *p, LA::Vector3D<T> *v, const LA::Vector3D<T> *a,
+                                            std::size_t count, T dt, T lo, T hi)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        v[i] += a[i] * dt;
+        p[i] = LA::clamp(p[i] + v[i] * dt, lo, hi);
+    }
+}
+
+template<typename T>
+void particleThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Particle step " << type << " ===========" << std::endl;
+    constexpr std::size_t count = 1 << 14;
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    std::vector<LA::Vector3D<T>> points(count), velocities(count), accelerations(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        points[i] = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+        velocities[i] = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+        accelerations[i] = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+    }
+    LA::VectorArray<T,3> p(points), v(velocities), a(accelerations);
+    const T dt = T(1e-3), lo = T(-100), hi = T(100);
+
+    throughputBench([&]{
+        particleStepPerPoint(points.data(), velocities.data(), accelerations.data(), count, dt, lo, hi);
+    }, "particle step per point", count, "particles");
+    throughputBench([&]{
+        LA::axpy(dt, accelerations.data(), velocities.data(), velocities.data(), count);
+        LA::axpy(dt, velocities.data(), points.data(), points.data(), count);
+        LA::clamp(points.data(), lo, hi, points.data(), count);
+    }, "particle step fused", count, "particles");
+    throughputBench([&]{
+        particleStepOperators(p, v, a, dt, lo, hi);
+    }, "particle step array operators", count, "particles");
+    throughputBench([&]{
+        LA::axpy(dt, a, v, v);
+        LA::axpy(dt, v, p, p);
+        LA::clamp(p, lo, hi, p);
+    }, "particle step array fused", count, "particles");
+}
+
+void fusedTests(std::random_device &r)
+{
+    particleThroughput<float>(r, "float");
+    particleThroughput<double>(r, "double");
+}
+
+// statistics of points the way callers wrote them
+template<typename T>
+[[gnu::noinline]] LA::Vector3D<T> sumPerPoint(const LA::Vector3D<T> *points, std::size_t count)
+{
+    LA::Vector3D<T> sum(T(0));
+    for (std::size_t i = 0; i < count; ++i)
+        sum += points[i];
+    return sum;
+}
+
+template<typename T>
+[[gnu::noinline]] LA::Bounds<T,3> boundsPerPoint(const LA::Vector3D<T> *points, std::size_t count)
+{
+    LA::Bounds<T,3> box{LA::Vector3D<T>(std::numeric_limits<T>::infinity()), LA::Vector3D<T>(-std::numeric_limits<T>::infinity())};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        box.min = LA::min(points[i], box.min);
+        box.max = LA::max(points[i], box.max);
+    }
+    return box;
+}
+
+template<typename T>
+[[gnu::noinline]] LA::Matrix<T,3,3> covariancePerPoint(const LA::Vector3D<T> *points, std::size_t count)
+{
+    const LA::Vector3D<T> mean = sumPerPoint(points, count) / T(count);
+    LA::Matrix<T,3,3> result(T(0));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const LA::Vector3D<T> d = points[i] - mean;
+        for (std::size_t r = 0; r < 3; ++r)
+            for (std::size_t c = 0; c < 3; ++c)
+                result[r][c] += d[r] * d[c];
+    }
+    return result / T(count);
+}
+
+template<typename T>
+void reductionThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Reductions " << type << " ===========" << std::endl;
+    constexpr std::size_t count = 1 << 18;
+    std::uniform_real_distribution<T> dist(T(-100), T(100));
+    std::vector<LA::Vector3D<T>> points(count);
+    for (auto &p : points)
+        p = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+    const LA::VectorArray<T,3> soa(points);
+    volatile T sink;
+
+    throughputBench([&]{
+        sink = sumPerPoint(points.data(), count)[0];
+    }, "sum per point", count, "points");
+    throughputBench([&]{
+        sink = LA::sum(points.data(), count)[0];
+    }, "sum", count, "points");
+    throughputBench([&]{
+        sink = LA::sum<LA::Summation::Compensated>(points.data(), count)[0];
+    }, "sum compensated", count, "points");
+    throughputBench([&]{
+        sink = LA::sum(soa)[0];
+    }, "sum of streams", count, "points");
+    throughputBench([&]{
+        sink = boundsPerPoint(points.data(), count).max[0];
+    }, "bounds per point", count, "points");
+    throughputBench([&]{
+        sink = LA::bounds(points.data(), count).max[0];
+    }, "bounds", count, "points");
+    throughputBench([&]{
+        sink = covariancePerPoint(points.data(), count)[0][1];
+    }, "covariance per point", count, "points");
+    throughputBench([&]{
+        sink = LA::covariance(points.data(), count)[0][1];
+    }, "covariance", count, "points");
+    throughputBench([&]{
+        sink = LA::covariance(soa)[0][1];
+    }, "covariance of streams", count, "points");
+    (void)sink;
+}
+
+void reductionTests(std::random_device &r)
+{
+    reductionThroughput<float>(r, "float");
+    reductionThroughput<double>(r, "double");
+}
+
+// interleaved vertex format, positions are 8 numbers apart
+template<typename T>
+struct BenchVertex
+{
+    T position[3];
+    T normal[3];
+    T uv[2];
+};
+
+// positions copied out of vertices, transformed and copied back, the way it had to be done before
+template<typename T>
+[[gnu::noinline]] void transformStaged(const LA::Matrix<T,4,4> &m, BenchVertex<T> *vertices, std::vector<LA::Vector3D<T>> &staging)
+{
+    for (std::size_t i = 0; i < staging.size(); ++i)
+        staging[i] = LA::Vector3D<T>{vertices[i].position[0], vertices[i].position[1], vertices[i].position[2]};
+    LA::transformPoints(m, staging.data(), staging.data(), staging.size());
+    for (std::size_t i = 0; i < staging.size(); ++i)
+        for (std::size_t k = 0; k < 3; ++k)
+            vertices[i].position[k] = staging[i][k];
+}
+
+// one matrix-vector product per point, the way it had to be done before
+template<typename T>
+[[gnu::noinline]] void transformPerPoint(const LA::Matrix<T,4,4> &m, const LA::Vector3D<T> *in, LA::Vector3D<T> *out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const LA::Vector4D<T> v{in[i][0], in[i][1], in[i][2], T(1)};
+        out[i] = LA::Vector3D<T>{LA::dot(m[0], v), LA::dot(m[1], v), LA::dot(m[2], v)};
+    }
+}
+
+template<typename T>
+void transformThroughput(std::random_device &r, const char* type, std::size_t count)
+{
+    std::cout << std::endl << "=========== Transform " << count << " points " << type << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    LA::Matrix<T,4,4> m;
+    for (std::size_t i = 0; i < 4; ++i)
+        for (std::size_t j = 0; j < 4; ++j)
+            m[i][j] = dist(r);
+    std::vector<LA::Vector3D<T>> in3(count), out3(count);
+    std::vector<LA::Vector4D<T>> in4(count), out4(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 4; ++k)
+        {
+            if (k < 3)
+                in3[i][k] = dist(r);
+            in4[i][k] = dist(r);
+        }
+    const LA::VectorArray<T,3> soa(in3);
+    LA::VectorArray<T,3> soaOut(count);
+
+    throughputBench([&]{
+        transformPerPoint(m, in3.data(), out3.data(), count);
+    }, "per-point products", count, "points");
+    throughputBench([&]{
+        LA::transformPoints(m, in3.data(), out3.data(), count);
+    }, "Vector3D array", count, "points");
+    throughputBench([&]{
+        LA::transformPoints(m, in4.data(), out4.data(), count);
+    }, "Vector4D array", count, "points");
+    throughputBench([&]{
+        LA::transformPoints(m, soa, soaOut);
+    }, "VectorArray<3>", count, "points");
+    throughputBench([&]{
+        LA::transformPointsProjective(m, soa, soaOut);
+    }, "VectorArray<3> projective", count, "points");
+
+    std::vector<BenchVertex<T>> vertices(count);
+    std::vector<LA::Vector3D<T>> staging(count);
+    for (std::size_t i = 0; i < count; ++i)
+        for (std::size_t k = 0; k < 3; ++k)
+            vertices[i].position[k] = in3[i][k];
+    const LA::VectorView<T,3,sizeof(BenchVertex<T>)> positions(vertices.data()->position, count);
+    throughputBench([&]{
+        transformStaged(m, vertices.data(), staging);
+    }, "interleaved vertices, staging copy", count, "points");
+    throughputBench([&]{
+        LA::transformPoints(m, positions, positions);
+    }, "interleaved vertices, VectorView in place", count, "points");
+}
+
+void transformTests(std::random_device &r)
+{
+    transformThroughput<float>(r, "float", 1 << 12);
+    transformThroughput<float>(r, "float", 1 << 19);
+    transformThroughput<double>(r, "double", 1 << 12);
+}
+
+// products and inverses one by one against element-interleaved batch
+template<typename T, std::size_t Dim>
+void matrixArrayThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Matrix array " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    const auto lhs = randomMatrices<T,Dim>(r);
+    const auto rhs = randomMatrices<T,Dim>(r);
+    std::vector<LA::Matrix<T,Dim,Dim>> result(batchSize);
+    const LA::MatrixArray<T,Dim,Dim> batchLhs(lhs), batchRhs(rhs);
+    LA::MatrixArray<T,Dim,Dim> batchResult(batchSize);
+    std::vector<T> determinants(batchSize);
+
+    throughputBench([&]{
+        LA::dot(lhs.data(), rhs.data(), result.data(), batchSize);
+    }, "batched products");
+    throughputBench([&]{
+        LA::dot(batchLhs, batchRhs, batchResult);
+    }, "matrix array products");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::invert(lhs[i], nullptr);
+    }, "single inverses", batchSize, "inverses");
+    throughputBench([&]{
+        LA::invert(batchLhs, batchResult, determinants.data());
+    }, "matrix array inverses", batchSize, "inverses");
+}
+
+void matrixArrayTests(std::random_device &r)
+{
+    matrixArrayThroughput<float,3>(r, "float");
+    matrixArrayThroughput<float,4>(r, "float");
+    matrixArrayThroughput<double,4>(r, "double");
+}
+
+// max |q * diag(values) * v^T - a| / max |a| over the batch
+template<typename T>
+T reconstructionError(const LA::MatrixArray<T,3,3> &a, const LA::MatrixArray<T,3,3> &q,
+                      const LA::VectorArray<T,3> &values, const LA::MatrixArray<T,3,3> &v)
+{
+    T error = T(0);
+    for (std::size_t n = 0; n < a.size(); ++n)
+    {
+        const auto m = a.at(n), left = q.at(n), right = v.at(n);
+        T norm = T(0), residual = T(0);
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                T sum = T(0);
+                for (std::size_t k = 0; k < 3; ++k)
+                    sum += left[i][k] * values.stream(k)[n] * right[j][k];
+                norm = std::max(norm, std::abs(m[i][j]));
+                residual = std::max(residual, std::abs(sum - m[i][j]));
+            }
+        error = std::max(error, residual / norm);
+    }
+    return error;
+}
+
+// Jacobi eigen and singular value decompositions one by one against batch
+template<typename T>
+void decompositionThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Eigen and SVD " << type << " 3x3 ===========" << std::endl;
+    const auto general = randomMatrices<T,3>(r);
+    auto symmetric = general;
+    for (auto &m : symmetric)
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < i; ++j)
+                m[i][j] = m[j][i];
+    const LA::MatrixArray<T,3,3> batchGeneral(general), batchSymmetric(symmetric);
+    LA::MatrixArray<T,3,3> u(batchSize), v(batchSize);
+    LA::VectorArray<T,3> values(batchSize);
+    std::vector<LA::SymmetricEigenDecomposition<T,3>> eigen(batchSize);
+    std::vector<LA::SingularValueDecomposition<T,3>> svd(batchSize);
+
+    LA::decomposeSymmetricEigen(batchSymmetric, values, v);
+    std::cout << "eigen max relative reconstruction error: " << reconstructionError(batchSymmetric, v, values, v) << std::endl;
+    LA::decomposeSVD(batchGeneral, u, values, v);
+    std::cout << "SVD max relative reconstruction error: " << reconstructionError(batchGeneral, u, values, v) << std::endl;
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            eigen[i] = LA::decomposeSymmetricEigen(symmetric[i]);
+    }, "single eigen decompositions", batchSize, "decompositions");
+    throughputBench([&]{
+        LA::decomposeSymmetricEigen(batchSymmetric, values, v);
+    }, "matrix array eigen decompositions", batchSize, "decompositions");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            svd[i] = LA::decomposeSVD(general[i]);
+    }, "single SVD", batchSize, "decompositions");
+    throughputBench([&]{
+        LA::decomposeSVD(batchGeneral, u, values, v);
+    }, "matrix array SVD", batchSize, "decompositions");
+}
+
+void decompositionTests(std::random_device &r)
+{
+    decompositionThroughput<float>(r, "float");
+    decompositionThroughput<double>(r, "double");
+}
+
+// inversion and LU solves one by one against batched elimination
+template<typename T, std::size_t N>
+void solverThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Solve " << type << " " << N << "x" << N << " ===========" << std::endl;
+    const auto a = randomMatrices<T,N>(r);
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    std::vector<LA::Vector<T,N>> b(batchSize), x(batchSize);
+    for (auto &v : b)
+        for (std::size_t k = 0; k < N; ++k)
+            v[k] = dist(r);
+    const LA::MatrixArray<T,N,N> batchA(a);
+    const LA::VectorArray<T,N> batchB(b);
+    LA::VectorArray<T,N> batchX(batchSize);
+    std::unique_ptr<bool[]> singular(new bool[batchSize]);
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+        {
+            const auto inverse = LA::invert(a[i]);
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                x[i][k] = T(0);
+                for (std::size_t j = 0; j < N; ++j)
+                    x[i][k] += inverse[k][j] * b[i][j];
+            }
+        }
+    }, "invert and multiply", batchSize, "systems");
+    throughputBench([&]{
+        bool ok;
+        for (std::size_t i = 0; i < batchSize; ++i)
+            x[i] = LA::solve(a[i], b[i], &ok);
+    }, "single LU solves", batchSize, "systems");
+    throughputBench([&]{
+        LA::solve(batchA, batchB, batchX, singular.get());
+    }, "matrix array solves", batchSize, "systems");
+}
+
+// least squares fits one by one against batch
+template<typename T>
+void leastSquaresThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Least squares " << type << " 6x3 ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-10), T(10));
+    std::vector<LA::Matrix<T,6,3>> a(batchSize);
+    std::vector<LA::Vector<T,6>> b(batchSize);
+    std::vector<LA::Vector<T,3>> x(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+        for (std::size_t row = 0; row < 6; ++row)
+        {
+            for (std::size_t c = 0; c < 3; ++c)
+                a[i][row][c] = dist(r);
+            b[i][row] = dist(r);
+        }
+    const LA::MatrixArray<T,6,3> batchA(a);
+    const LA::VectorArray<T,6> batchB(b);
+    LA::VectorArray<T,3> batchX(batchSize);
+    std::unique_ptr<bool[]> singular(new bool[batchSize]);
+
+    throughputBench([&]{
+        bool ok;
+        for (std::size_t i = 0; i < batchSize; ++i)
+            x[i] = LA::solveLeastSquares(a[i], b[i], &ok);
+    }, "single least squares", batchSize, "systems");
+    throughputBench([&]{
+        LA::solveLeastSquares(batchA, batchB, batchX, singular.get());
+    }, "matrix array least squares", batchSize, "systems");
+}
+
+void solverTests(std::random_device &r)
+{
+    solverThroughput<float,3>(r, "float");
+    solverThroughput<double,3>(r, "double");
+    solverThroughput<float,6>(r, "float");
+    solverThroughput<double,6>(r, "double");
+    leastSquaresThroughput<float>(r, "float");
+    leastSquaresThroughput<double>(r, "double");
+}
+
+// previous transpose, kept as a baseline
+template<typename T, std::size_t Dim>
+[[gnu::noinline]] void naiveTranspose(const LA::Matrix<T,Dim,Dim> &m, LA::Matrix<T,Dim,Dim> &result)
+{
+    for (std::size_t i = Dim; i--;)
+        for (std::size_t j = Dim; j--; result[j][i] = m[i][j]);
+}
+
+template<typename T, std::size_t Dim>
+void transposeThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Matrix transpose " << type << " " << Dim << "x" << Dim << " ===========" << std::endl;
+    const auto data = randomMatrices<T,Dim>(r);
+    std::vector<LA::Matrix<T,Dim,Dim>> result(batchSize);
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            naiveTranspose(data[i], result[i]);
+    }, "element loop", batchSize, "transposes");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::transpose(data[i]);
+    }, "single transposes", batchSize, "transposes");
+    throughputBench([&]{
+        LA::transpose(data.data(), result.data(), batchSize);
+    }, "batched transposes", batchSize, "transposes");
+}
+
+// previous dynamic matrix transpose by 32x32 blocks, kept as a baseline
+template<typename T>
+[[gnu::noinline]] void blockedTranspose(const LA::DynamicMatrix<T> &m, LA::DynamicMatrix<T> &result)
+{
+    constexpr std::size_t Block = 32;
+    for (std::size_t i0 = 0; i0 < m.rows(); i0 += Block)
+        for (std::size_t j0 = 0; j0 < m.columns(); j0 += Block)
+            for (std::size_t i = i0; i < std::min(i0 + Block, m.rows()); ++i)
+                for (std::size_t j = j0; j < std::min(j0 + Block, m.columns()); ++j)
+                    result[j][i] = m[i][j];
+}
+
+template<typename T>
+void dynamicTransposeThroughput(std::random_device &r, const char* type, std::size_t rows, std::size_t columns)
+{
+    std::cout << std::endl << "=========== Dynamic matrix transpose " << type << " " << rows << "x" << columns << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+    LA::DynamicMatrix<T> m(rows, columns), result(columns, rows);
+    for (std::size_t i = 0; i < rows; ++i)
+        for (std::size_t j = 0; j < columns; ++j)
+            m[i][j] = dist(r);
+
+    throughputBench([&]{
+        blockedTranspose(m, result);
+    }, "32x32 blocks", rows * columns, "elements");
+    throughputBench([&]{
+        LA::transpose(m, result);
+    }, "cache-oblivious", rows * columns, "elements");
+}
+
+void transposeTests(std::random_device &r)
+{
+    transposeThroughput<float,4>(r, "float");
+    transposeThroughput<double,4>(r, "double");
+    transposeThroughput<float,8>(r, "float");
+    transposeThroughput<double,8>(r, "double");
+    transposeThroughput<float,16>(r, "float");
+    transposeThroughput<double,16>(r, "double");
+    dynamicTransposeThroughput<float>(r, "float", 1000, 1000);
+    dynamicTransposeThroughput<double>(r, "double", 1000, 1000);
+    dynamicTransposeThroughput<float>(r, "float", 1024, 1024);
+    dynamicTransposeThroughput<double>(r, "double", 1024, 1024);
+    dynamicTransposeThroughput<float>(r, "float", 64, 8192);
+}
+
+template<typename T>
+[[gnu::noinline]] void naiveProduct(const LA::DynamicMatrix<T> &a, const LA::DynamicMatrix<T> &b, LA::DynamicMatrix<T> &c)
+{
+    for (std::size_t i = 0; i < a.rows(); ++i)
+        for (std::size_t j = 0; j < b.columns(); ++j)
+        {
+            T sum = T(0);
+            for (std::size_t k = 0; k < a.columns(); ++k)
+                sum += a[i][k] * b[k][j];
+            c[i][j] = sum;
+        }
+}
+
+// blocked product of dynamic matrices against i-j-k loop
+template<typename T>
+void dynamicMatrixThroughput(std::random_device &r, const char* type, std::size_t size, bool naive)
+{
+    std::cout << std::endl << "=========== Dynamic matrix " << type << " " << size << "x" << size << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+    LA::DynamicMatrix<T> a(size, size), b(size, size), c(size, size);
+    for (std::size_t i = 0; i < size; ++i)
+        for (std::size_t j = 0; j < size; ++j)
+        {
+            a[i][j] = dist(r);
+            b[i][j] = dist(r);
+        }
+
+    const std::size_t madds = size * size * size;
+    if (naive)
+        throughputBench([&]{
+            naiveProduct(a, b, c);
+        }, "i-j-k loop", madds, "multiply-adds");
+    throughputBench([&]{
+        LA::dot(a, b, c, 1);
+    }, "blocked, 1 thread", madds, "multiply-adds");
+    throughputBench([&]{
+        LA::dot(a, b, c);
+    }, "blocked, all threads", madds, "multiply-adds");
+}
+
+void dynamicMatrixTests(std::random_device &r)
+{
+    dynamicMatrixThroughput<float>(r, "float", 128, true);
+    dynamicMatrixThroughput<double>(r, "double", 128, true);
+    dynamicMatrixThroughput<float>(r, "float", 384, false);
+    dynamicMatrixThroughput<double>(r, "double", 384, false);
+}
+
+template<typename T>
+[[gnu::noinline]] void rotatePerVector(const LA::Quaternion<T> &q, const LA::Vector3D<T> *in, LA::Vector3D<T> *out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+        out[i] = q.rotate(in[i]);
+}
+
+// composition and interpolation of rotations as quaternions against 3x3 matrices
+template<typename T>
+void quaternionThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Quaternion " << type << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+    std::vector<LA::Quaternion<T>> a(batchSize), b(batchSize), result(batchSize);
+    std::vector<LA::Vector3D<T>> vectors(batchSize), rotated(batchSize);
+    std::vector<T> t(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        a[i] = LA::Quaternion<T>(dist(r), dist(r), dist(r), dist(r)).unit();
+        b[i] = LA::Quaternion<T>(dist(r), dist(r), dist(r), dist(r)).unit();
+        vectors[i] = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+        t[i] = (dist(r) + T(1)) / T(2);
+    }
+    std::vector<LA::Matrix<T,3,3>> ma(batchSize), mb(batchSize), mresult(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        ma[i] = a[i].matrix3();
+        mb[i] = b[i].matrix3();
+    }
+
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            mresult[i] = LA::dot(ma[i], mb[i]);
+    }, "3x3 matrix compositions", batchSize, "compositions");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = a[i] * b[i];
+    }, "quaternion compositions", batchSize, "compositions");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::slerp(a[i], b[i], t[i]);
+    }, "single slerps", batchSize, "slerps");
+    throughputBench([&]{
+        LA::slerp(a.data(), b.data(), t.data(), result.data(), batchSize);
+    }, "batch slerps", batchSize, "slerps");
+    throughputBench([&]{
+        rotatePerVector(a[0], vectors.data(), rotated.data(), batchSize);
+    }, "per-vector rotations", batchSize, "vectors");
+    throughputBench([&]{
+        LA::rotate(a[0], vectors.data(), rotated.data(), batchSize);
+    }, "batch rotations", batchSize, "vectors");
+}
+
+void quaternionTests(std::random_device &r)
+{
+    quaternionThroughput<float>(r, "float");
+    quaternionThroughput<double>(r, "double");
+}
+
+// scene graph nodes as 3x4 affine transforms against full 4x4 matrices
+template<typename T>
+void affineThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Affine " << type << " ===========" << std::endl;
+    std::vector<LA::Matrix<T,4,4>> lhs = randomMatrices<T,4>(r), rhs = randomMatrices<T,4>(r), result(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        for (std::size_t j = 0; j < 4; ++j)
+            lhs[i][3][j] = rhs[i][3][j] = T(j == 3);
+        lhs[i][0][0] += T(40); // keeps linear part invertible
+        lhs[i][1][1] += T(40);
+        lhs[i][2][2] += T(40);
+    }
+    std::vector<LA::Affine<T>> affineLhs(batchSize), affineRhs(batchSize), affineResult(batchSize);
+    for (std::size_t i = 0; i < batchSize; ++i)
+    {
+        affineLhs[i] = LA::Affine<T>(lhs[i]);
+        affineRhs[i] = LA::Affine<T>(rhs[i]);
+    }
+
+    throughputBench([&]{
+        LA::dot(lhs.data(), rhs.data(), result.data(), batchSize);
+    }, "4x4 batched products", batchSize, "compositions");
+    throughputBench([&]{
+        LA::compose(affineLhs.data(), affineRhs.data(), affineResult.data(), batchSize);
+    }, "affine batched compositions", batchSize, "compositions");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::invert(lhs[i], nullptr);
+    }, "4x4 inverses", batchSize, "inverses");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            result[i] = LA::invertAffine(lhs[i], nullptr);
+    }, "4x4 invertAffine", batchSize, "inverses");
+    throughputBench([&]{
+        for (std::size_t i = 0; i < batchSize; ++i)
+            affineResult[i] = LA::invert(affineLhs[i], nullptr);
+    }, "affine inverses", batchSize, "inverses");
+}
+
+void affineTests(std::random_device &r)
+{
+    affineThroughput<float>(r, "float");
+    affineThroughput<double>(r, "double");
+}
+
+void dotTests(std::random_device &r)
+{
+    dotThroughput<float,4>(r, "float");
+    dotThroughput<double,4>(r, "double");
+    dotThroughput<float,3>(r, "float");
+    dotThroughput<double,3>(r, "double");
+    columnMajorThroughput<float,4>(r, "float");
+    columnMajorThroughput<double,4>(r, "double");
+}
+
+// synthetic character mesh: 4 influences of 64 bones per vertex
+inline constexpr std::size_t meshVertices = 50000;
+inline constexpr std::size_t meshBones = 64;
+
+// linear blend of array-of-structures vertices by Affine operators
+template<typename T>
+[[gnu::noinline]] void skinPerVertex(const LA::Affine<T> *palette, const LA::SkinInfluences<T> &influences,
+                                     const LA::Vector3D<T> *in, LA::Vector3D<T> *out, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        LA::Affine<T> m(LA::Matrix<T,3,3>(T(0)));
+        for (std::size_t k = 0; k < LA::SkinInfluences<T>::Count; ++k)
+        {
+            const auto &bone = palette[influences.bones().stream(k)[i]];
+            const T w = influences.weights().stream(k)[i];
+            for (std::size_t r = 0; r < 3; ++r)
+                m[r] += bone[r] * w;
+        }
+        out[i] = m.transformPoint(in[i]);
+    }
+}
+
+template<typename T>
+void skinningThroughput(std::random_device &r, const char* type)
+{
+    std::cout << std::endl << "=========== Skinning " << type << " ===========" << std::endl;
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+    std::uniform_int_distribution<std::int32_t> bone(0, meshBones - 1);
+    std::vector<LA::DualQuaternion<T>> dualPalette;
+    std::vector<LA::Affine<T>> palette;
+    for (std::size_t i = 0; i < meshBones; ++i)
+    {
+        LA::Vector3D<T> axis(dist(r), dist(r), dist(r));
+        axis.unit();
+        dualPalette.emplace_back(LA::Quaternion<T>::axisAngle(axis, dist(r) * T(3)), LA::Vector3D<T>(dist(r), dist(r), dist(r)));
+        palette.push_back(dualPalette.back().affine());
+    }
+    LA::SkinInfluences<T> influences(meshVertices);
+    std::vector<LA::Vector3D<T>> aos(meshVertices), aosOut(meshVertices);
+    for (std::size_t i = 0; i < meshVertices; ++i)
+    {
+        const std::int32_t bones[4] = {bone(r), bone(r), bone(r), bone(r)};
+        T weights[4] = {std::abs(dist(r)), std::abs(dist(r)), std::abs(dist(r)), std::abs(dist(r))};
+        const T sum = weights[0] + weights[1] + weights[2] + weights[3];
+        for (T &w : weights)
+            w /= sum;
+        influences.set(i, bones, weights);
+        aos[i] = LA::Vector3D<T>(dist(r), dist(r), dist(r));
+    }
+    const LA::VectorArray<T,3> positions(aos), normals(aos);
+    LA::VectorArray<T,3> skinned, skinnedNormals;
+
+    throughputBench([&]{
+        skinPerVertex(palette.data(), influences, aos.data(), aosOut.data(), meshVertices);
+    }, "per-vertex linear blend", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinLinear(palette.data(), meshBones, influences, positions, skinned, 1);
+    }, "linear blend, 1 thread", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinLinear(palette.data(), meshBones, influences, positions, normals, skinned, skinnedNormals, 1);
+    }, "linear blend with normals, 1 thread", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinLinear(palette.data(), meshBones, influences, positions, normals, skinned, skinnedNormals);
+    }, "linear blend with normals, all threads", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinDualQuaternion(dualPalette.data(), meshBones, influences, positions, skinned, 1);
+    }, "dual quaternion, 1 thread", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinDualQuaternion(dualPalette.data(), meshBones, influences, positions, normals, skinned, skinnedNormals, 1);
+    }, "dual quaternion with normals, 1 thread", meshVertices, "vertices");
+    throughputBench([&]{
+        LA::skinDualQuaternion(dualPalette.data(), meshBones, influences, positions, normals, skinned, skinnedNormals);
+    }, "dual quaternion with normals, all threads", meshVertices, "vertices");
+}
+
+void skinningTests(std::random_device &r)
+{
+    skinningThroughput<float>(r, "float");
+    skinningThroughput<double>(r, "double");
+}
+
+int main()
+{
+    std::random_device r;
+    std::cout << "=========== Fallback implementations ===========" << std::endl;
+    dotTests(r);
+    expressionTests(r);
+    vectorArrayTests(r);
+    transformTests(r);
+    matrixArrayTests(r);
+    decompositionTests(r);
+    dynamicMatrixTests(r);
+    transposeTests(r);
+    quaternionTests(r);
+    affineTests(r);
+    skinningTests(r);
+    Optimizer::init();
+    std::cout << std::endl << "=========== Optimized implementations ===========" << std::endl;
+    dotTests(r);
+    expressionTests(r);
+    vectorArrayTests(r);
+    transformTests(r);
+    matrixArrayTests(r);
+    decompositionTests(r);
+    dynamicMatrixTests(r);
+    transposeTests(r);
+    quaternionTests(r);
+    affineTests(r);
+    skinningTests(r);
+    determinantTests(r);
+    genericDotTests<float>(r, "float");
+    genericDotTests<double>(r, "double");
+    paddedVectorTests(r);
+    integerTests(r);
+    compactPointTests(r);
+    conversionTests(r);
+    fusedTests(r);
+    reductionTests(r);
+    solverTests(r);
+    copyTests();
+    return 0;
+}
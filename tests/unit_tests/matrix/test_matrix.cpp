@@ -1,7 +1,29 @@
+#include "../../../include/affine.hpp"
+#include "../../../include/conversion.hpp"
+#include "../../../include/dual_quaternion.hpp"
+#include "../../../include/dynamic_matrix.hpp"
+#include "../../../include/geometry.hpp"
+#include "../../../include/integer_matrix.hpp"
 #include "../../../include/matrix.hpp"
+#include "../../../include/matrix_array.hpp"
+#include "../../../include/matrix_expression.hpp"
+#include "../../../include/matrix_view.hpp"
 #include "../../../include/optimizer.hpp"
+#include "../../../include/padded_vector.hpp"
+#include "../../../include/quaternion.hpp"
+#include "../../../include/reduction.hpp"
+#include "../../../include/skinning.hpp"
+#include "../../../include/transform.hpp"
+#include "../../../include/vector_array.hpp"
 #include "../../test_generator.hpp"
+#include "../../utility_accuracy.hpp"
+#include <bit>
+#include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
 
 
 class MatrixOperatorTester
@@ -133,16 +155,2774 @@ public:
     }
 };
 
+class MatrixProductTester
+{
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Matrix<T, Dim, Dim> sequence(T start)
+    {
+        Geometrix::LA::Matrix<T, Dim, Dim> m;
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                m[i][j] = start + T(i * Dim + j) * (j % 2 ? -1 : 1);
+        return m;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void dotOp()
+    {
+        std::cout << "Matrix product test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        const auto lhs = sequence<T, Dim>(1);
+        const auto rhs = sequence<T, Dim>(-2);
+        Geometrix::LA::Matrix<T, Dim, Dim> expected;
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+            {
+                T accum = 0;
+                for (std::size_t k = 0; k < Dim; ++k)
+                    accum += lhs[i][k] * rhs[k][j];
+                expected[i][j] = accum;
+            }
+
+        assert(Geometrix::LA::dot(lhs, rhs) == expected);
+    }
+
+    // small integers, so products are exact in any order of sums
+    template<typename T, std::size_t R, std::size_t C>
+    static Geometrix::LA::Matrix<T, R, C> pattern(std::size_t seed)
+    {
+        Geometrix::LA::Matrix<T, R, C> m;
+        T *data = reinterpret_cast<T *>(&m);
+        for (std::size_t i = 0; i < R * C; ++i)
+            data[i] = T(int((i * 7 + seed) % 11) - 5);
+        return m;
+    }
+
+    template<typename T, std::size_t R, std::size_t K, std::size_t C>
+    static void shapeDotOp()
+    {
+        std::cout << "Matrix product test, with shapes: " << R << "x" << K << " and " << K << "x" << C << std::endl;
+        const auto lhs = pattern<T, R, K>(3);
+        const auto rhs = pattern<T, K, C>(8);
+        const T *a = reinterpret_cast<const T *>(&lhs);
+        const T *b = reinterpret_cast<const T *>(&rhs);
+
+        const auto result = Geometrix::LA::dot(lhs, rhs);
+        [[maybe_unused]] const T *c = reinterpret_cast<const T *>(&result);
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+            {
+                T accum = 0;
+                for (std::size_t k = 0; k < K; ++k)
+                    accum += a[i * K + k] * b[k * C + j];
+                assert(c[i * C + j] == accum);
+            }
+    }
+
+    template<typename T, std::size_t Dim>
+    static void dotBatchOp()
+    {
+        std::cout << "Batched matrix product test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        constexpr std::size_t Count = 5;
+        Geometrix::LA::Matrix<T, Dim, Dim> lhs[Count], rhs[Count], result[Count];
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+            lhs[i] = sequence<T, Dim>(T(i));
+            rhs[i] = sequence<T, Dim>(T(3) - T(i));
+        }
+
+        Geometrix::LA::dot(lhs, rhs, result, Count);
+        for (std::size_t i = 0; i < Count; ++i)
+            assert(result[i] == Geometrix::LA::dot(lhs[i], rhs[i]));
+    }
+
+    template<typename T, std::size_t Dim>
+    static void transposeOp()
+    {
+        std::cout << "Matrix transpose test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        const auto m = sequence<T, Dim>(3);
+        [[maybe_unused]] const auto result = Geometrix::LA::transpose(m);
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                assert(result[j][i] == m[i][j]);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        dotOp<T,2>();
+        dotOp<T,3>();
+        dotOp<T,4>();
+        dotOp<T,5>();
+        dotOp<T,8>();
+
+        shapeDotOp<T,8,8,8>();
+        shapeDotOp<T,16,16,16>();
+        shapeDotOp<T,32,32,32>();
+        shapeDotOp<T,7,13,19>();
+        shapeDotOp<T,25,3,33>();
+        shapeDotOp<T,1,6,9>();
+        shapeDotOp<T,9,6,1>();
+        shapeDotOp<T,2,31,2>();
+
+        dotBatchOp<T,3>();
+        dotBatchOp<T,4>();
+
+        transposeOp<T,2>();
+        transposeOp<T,3>();
+        transposeOp<T,4>();
+        transposeOp<T,5>();
+    }
+};
+
+class MatrixLayoutTester
+{
+    template<typename T, std::size_t R, std::size_t C>
+    static void accessOp()
+    {
+        std::cout << "Column-major matrix access test, with dimensions: " << R << "x" << C << std::endl;
+        using namespace Geometrix::LA;
+        const auto m = numbers<T, R, C>(1, T(9));
+        ColumnMajorMatrix<T, R, C> cm(m);
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+            {
+                assert(cm(i, j) == m[i][j]);
+                // columns one after another
+                assert(cm.data()[j * R + i] == m[i][j]);
+                assert(cm.column(j)[i] == m[i][j]);
+            }
+        assert((Matrix<T, R, C>(cm) == m));
+        // transpose is the storage itself
+        assert(&transpose(cm) == &cm.transposed() && (transpose(cm) == transpose(m)));
+
+        cm.column(0) = Vector<T, R>(T(2));
+        cm(R - 1, C - 1) = T(-3);
+        assert(cm(0, 0) == T(2) && cm(R - 1, 0) == T(2) && cm(R - 1, C - 1) == T(-3));
+
+        ColumnMajorMatrix<T, R, C> twice(m);
+        twice += ColumnMajorMatrix<T, R, C>(m);
+        assert((Matrix<T, R, C>(twice) == m * T(2)));
+        assert((twice - ColumnMajorMatrix<T, R, C>(m) == ColumnMajorMatrix<T, R, C>(m)));
+        assert(-twice * T(-1) == twice);
+    }
+
+    template<typename T, std::size_t R, std::size_t K, std::size_t C>
+    static void productOp()
+    {
+        std::cout << "Column-major matrix product test, with dimensions: " << R << "x" << K << " * " << K << "x" << C << std::endl;
+        using namespace Geometrix::LA;
+        const auto a = numbers<T, R, K>(2, T(9));
+        const auto b = numbers<T, K, C>(3, T(9));
+        [[maybe_unused]] const auto p = dot(ColumnMajorMatrix<T, R, K>(a), ColumnMajorMatrix<T, K, C>(b));
+        assert((Matrix<T, R, C>(p) == dot(a, b)));
+
+        Vector<T, K> v;
+        for (std::size_t k = 0; k < K; ++k)
+            v[k] = T(int(k) - 1);
+        [[maybe_unused]] const Vector<T, R> mv = dot(ColumnMajorMatrix<T, R, K>(a), v);
+        for (std::size_t i = 0; i < R; ++i)
+        {
+            T e = T(0);
+            for (std::size_t k = 0; k < K; ++k)
+                e += a[i][k] * v[k];
+            assert(mv[i] == e);
+        }
+    }
+
+    template<typename T, std::size_t Dim>
+    static void inverseOp()
+    {
+        std::cout << "Column-major matrix inverse test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        using namespace Geometrix::LA;
+        const auto m = numbers<T, Dim, Dim>(4, T(9));
+        const ColumnMajorMatrix<T, Dim, Dim> cm(m);
+        assert(approxEqual(determinant(cm), determinant(m)));
+        if constexpr (Dim > 2)
+            assert((Matrix<T, Dim - 1, Dim - 1>(submatrix(cm, 1, Dim - 1)) == submatrix(m, 1, Dim - 1)));
+        else
+            assert(submatrix(cm, 0, 1) == submatrix(m, 0, 1));
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            bool correct = false;
+            const auto inverse = invert(cm, &correct);
+            assert(correct);
+            const auto expected = invert(m);
+            for (std::size_t i = 0; i < Dim; ++i)
+                for (std::size_t j = 0; j < Dim; ++j)
+                    // transposed matrices are computed in other order, float rounds differently
+                    assert(approxEqual(inverse(i, j), expected[i][j]));
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        accessOp<T, 4, 4>();
+        accessOp<T, 3, 3>();
+        accessOp<T, 2, 3>();
+        accessOp<T, 3, 2>();
+        productOp<T, 4, 4, 4>();
+        productOp<T, 3, 3, 3>();
+        productOp<T, 2, 2, 2>();
+        productOp<T, 3, 4, 2>();
+        inverseOp<T, 2>();
+        inverseOp<T, 3>();
+        inverseOp<T, 4>();
+        inverseOp<T, 5>();
+    }
+};
+
+class MatrixTransposeTester
+{
+    template<typename T, std::size_t R, std::size_t C>
+    static void fixedOp()
+    {
+        std::cout << "Matrix transpose test, with dimensions: " << R << "x" << C << std::endl;
+        using namespace Geometrix::LA;
+        const auto m = numbers<T, R, C, true>(1);
+        [[maybe_unused]] const Matrix<T, C, R> t = transpose(m);
+        for (std::size_t i = 0; i < R; ++i)
+            for (std::size_t j = 0; j < C; ++j)
+                assert(t[j][i] == m[i][j]);
+        assert((transpose(t) == m));
+    }
+
+    template<typename T, std::size_t Dim>
+    static void batchOp(std::size_t count)
+    {
+        std::cout << "Matrix batch transpose test, with dimensions: " << Dim << "x" << Dim << " and count " << count << std::endl;
+        using namespace Geometrix::LA;
+        std::vector<Matrix<T, Dim, Dim>> m(count), t(count + 1, Matrix<T, Dim, Dim>(T(-1)));
+        for (std::size_t i = 0; i < count; ++i)
+            m[i] = numbers<T, Dim, Dim, true>(i);
+        transpose(m.data(), t.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert((t[i] == transpose(m[i])));
+        // nothing is written past count
+        assert((t[count] == Matrix<T, Dim, Dim>(T(-1))));
+    }
+
+    template<typename T>
+    static void dynamicOp(std::size_t rows, std::size_t columns)
+    {
+        std::cout << "Dynamic matrix transpose test, with dimensions: " << rows << "x" << columns << std::endl;
+        Geometrix::LA::DynamicMatrix<T> m(rows, columns);
+        for (std::size_t i = 0; i < rows; ++i)
+            for (std::size_t j = 0; j < columns; ++j)
+                m[i][j] = T(i * columns + j);
+        const auto t = Geometrix::LA::transpose(m);
+        assert(t.rows() == columns && t.columns() == rows);
+        for (std::size_t i = 0; i < rows; ++i)
+            for (std::size_t j = 0; j < columns; ++j)
+                assert(t[j][i] == m[i][j]);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        fixedOp<T, 2, 2>();
+        fixedOp<T, 3, 3>();
+        fixedOp<T, 4, 4>();
+        fixedOp<T, 5, 7>();
+        fixedOp<T, 8, 8>();
+        fixedOp<T, 8, 12>();
+        fixedOp<T, 16, 16>();
+        fixedOp<T, 13, 37>();
+        fixedOp<T, 40, 24>();
+        batchOp<T, 3>(7);
+        batchOp<T, 4>(0);
+        batchOp<T, 4>(33);
+        batchOp<T, 5>(9);
+        batchOp<T, 8>(17);
+        batchOp<T, 12>(3);
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            dynamicOp<T>(1, 1);
+            dynamicOp<T>(3, 200);
+            dynamicOp<T>(64, 64);
+            dynamicOp<T>(67, 129);
+            dynamicOp<T>(300, 70);
+        }
+    }
+};
+
+class MatrixInverseTester
+{
+    template<typename T, std::size_t Dim>
+    static bool nearlyEqual(const Geometrix::LA::Matrix<T, Dim, Dim> &lhs, const Geometrix::LA::Matrix<T, Dim, Dim> &rhs)
+    {
+        constexpr T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-10);
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                if (std::abs(lhs[i][j] - rhs[i][j]) > eps)
+                    return false;
+        return true;
+    }
+
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Matrix<T, Dim, Dim> identity()
+    {
+        Geometrix::LA::Matrix<T, Dim, Dim> m(T{0});
+        for (std::size_t i = 0; i < Dim; ++i)
+            m[i][i] = 1;
+        return m;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void invertOp()
+    {
+        std::cout << "Matrix inverse test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        Geometrix::LA::Matrix<T, Dim, Dim> m;
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                m[i][j] = (i == j) ? T(Dim + 2) : T(i + 2 * j) / T(4) - T(1);
+
+        bool correct = false;
+        [[maybe_unused]] const auto inv = Geometrix::LA::invert(m, &correct);
+        assert(correct);
+        assert(nearlyEqual(Geometrix::LA::dot(m, inv), identity<T, Dim>()));
+
+        Geometrix::LA::Matrix<T, Dim, Dim> singular(T{1});
+        Geometrix::LA::invert(singular, &correct);
+        assert(!correct);
+    }
+
+    template<typename T>
+    static void invertTransformOp()
+    {
+        std::cout << "Affine and rigid transform inverse test" << std::endl;
+        const T c = std::cos(T(0.5)), s = std::sin(T(0.5));
+        T rigidData[4][4] = {{c, -s, 0, 3},
+                             {s,  c, 0, -2},
+                             {0,  0, 1, 5},
+                             {0,  0, 0, 1}};
+        const Geometrix::LA::Matrix<T, 4, 4> rigid(rigidData);
+        assert(nearlyEqual(Geometrix::LA::dot(rigid, Geometrix::LA::invertRigid(rigid)), identity<T, 4>()));
+
+        T affineData[4][4] = {{2, 1, 0, 1},
+                              {0, 3, 1, -4},
+                              {1, 0, 4, 2},
+                              {0, 0, 0, 1}};
+        const Geometrix::LA::Matrix<T, 4, 4> affine(affineData);
+        bool correct = false;
+        [[maybe_unused]] const auto inv = Geometrix::LA::invertAffine(affine, &correct);
+        assert(correct);
+        assert(nearlyEqual(Geometrix::LA::dot(affine, inv), identity<T, 4>()));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        invertOp<T,3>();
+        invertOp<T,4>();
+        invertTransformOp<T>();
+    }
+};
+
+class MatrixDecompositionTester
+{
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Matrix<T, Dim, Dim> product(const Geometrix::LA::Matrix<T, Dim, Dim> &lhs, const Geometrix::LA::Matrix<T, Dim, Dim> &rhs)
+    {
+        Geometrix::LA::Matrix<T, Dim, Dim> result(T{0});
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                for (std::size_t j = 0; j < Dim; ++j)
+                    result[i][j] += lhs[i][k] * rhs[k][j];
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static bool isIdentity(const Geometrix::LA::Matrix<T, Dim, Dim> &m)
+    {
+        constexpr T eps = std::is_same_v<T, float> ? T(1e-4) : T(1e-10);
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                if (std::abs(m[i][j] - T(i == j)) > eps)
+                    return false;
+        return true;
+    }
+
+    // non-symmetric, pivoting is required, as diagonal is small
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Matrix<T, Dim, Dim> general()
+    {
+        Geometrix::LA::Matrix<T, Dim, Dim> m;
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                m[i][j] = (i == j) ? T(0.5) : T((i * 7 + j * 3) % 11) / T(5) - T(1);
+        return m;
+    }
+
+    // B^T * B + Dim * I
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Matrix<T, Dim, Dim> positiveDefinite()
+    {
+        const auto b = general<T, Dim>();
+        auto m = product(Geometrix::LA::transpose(b), b);
+        for (std::size_t i = 0; i < Dim; ++i)
+            m[i][i] += T(Dim);
+        return m;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void luOp()
+    {
+        std::cout << "LU decomposition test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        const auto m = general<T, Dim>();
+        [[maybe_unused]] const auto lu = Geometrix::LA::decomposeLU(m);
+        assert(!lu.singular());
+        assert(isIdentity(product(m, Geometrix::LA::invert(lu))));
+
+        Geometrix::LA::Vector<T, Dim> b;
+        for (std::size_t i = 0; i < Dim; ++i)
+            b[i] = T(i) - T(2);
+        bool correct = false;
+        const auto x = Geometrix::LA::solve(m, b, &correct);
+        assert(correct);
+        for (std::size_t i = 0; i < Dim; ++i)
+        {
+            T residual = -b[i];
+            for (std::size_t j = 0; j < Dim; ++j)
+                residual += m[i][j] * x[j];
+            assert(std::abs(residual) < (std::is_same_v<T, float> ? T(1e-4) : T(1e-10)));
+        }
+
+        Geometrix::LA::Matrix<T, Dim, Dim> singular(T{1});
+        assert(Geometrix::LA::decomposeLU(singular).singular());
+        Geometrix::LA::solve(singular, b, &correct);
+        assert(!correct);
+        // inverse of singular matrix is zero solution
+        correct = true;
+        [[maybe_unused]] const auto singularInverse = Geometrix::LA::invert(singular, &correct);
+        assert(!correct);
+        if constexpr (Dim > 4)
+            assert((singularInverse == Geometrix::LA::Matrix<T, Dim, Dim>(T(0))));
+    }
+
+    template<typename T, std::size_t Dim>
+    static void choleskyOp()
+    {
+        std::cout << "Cholesky decomposition test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        const auto m = positiveDefinite<T, Dim>();
+        const auto chol = Geometrix::LA::decomposeCholesky(m);
+        assert(chol.positive);
+        assert(isIdentity(product(m, Geometrix::LA::invert(chol))));
+
+        [[maybe_unused]] const T luDet = Geometrix::LA::determinant(Geometrix::LA::decomposeLU(m));
+        [[maybe_unused]] const T cholDet = Geometrix::LA::determinant(chol);
+        assert(std::abs(luDet - cholDet) <= std::abs(cholDet) * (std::is_same_v<T, float> ? T(1e-4) : T(1e-10)));
+
+        assert(!Geometrix::LA::decomposeCholesky(general<T, Dim>()).positive);
+    }
+
+    template<typename T, std::size_t Dim>
+    static void determinantOp()
+    {
+        std::cout << "LU determinant test, with dimensions: " << Dim << "x" << Dim << std::endl;
+        const auto m = general<T, Dim>();
+        [[maybe_unused]] const T expected = Geometrix::LA::determinant(m);
+        [[maybe_unused]] const T result = Geometrix::LA::determinant(Geometrix::LA::decomposeLU(m));
+        assert(std::abs(result - expected) <= std::abs(expected) * (std::is_same_v<T, float> ? T(1e-4) : T(1e-10)));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        determinantOp<T,3>();
+        determinantOp<T,4>();
+
+        luOp<T,3>();
+        luOp<T,4>();
+        luOp<T,7>();
+        luOp<T,20>();
+
+        choleskyOp<T,3>();
+        choleskyOp<T,4>();
+        choleskyOp<T,7>();
+        choleskyOp<T,20>();
+    }
+};
+
+class MatrixExpressionTester
+{
+    template<typename T, std::size_t Row, std::size_t Col>
+    static void chainOp()
+    {
+        using namespace Geometrix::LA::Lazy;
+        std::cout << "Lazy matrix expression test, with dimensions: " << Row << "x" << Col << std::endl;
+        Geometrix::LA::Matrix<T, Row, Col> a, b, c;
+        for (std::size_t i = 0; i < Row; ++i)
+            for (std::size_t j = 0; j < Col; ++j)
+            {
+                element(a, i, j) = T(i + j);
+                element(b, i, j) = T(i * Col + j) + T(1);
+                element(c, i, j) = T(2);
+            }
+        const T s = 3;
+
+        [[maybe_unused]] const Geometrix::LA::Matrix<T, Row, Col> eager = (a * s + b - c) / T(2) - b * c;
+        [[maybe_unused]] const Geometrix::LA::Matrix<T, Row, Col> result = (lazy(a) * s + b - c) / T(2) - lazy(b) * c;
+        assert(result == eager);
+
+        // result aliases operand
+        Geometrix::LA::Matrix<T, Row, Col> inplace = a;
+        assign(inplace, -lazy(inplace) + T(1) * a);
+        assert((inplace == Geometrix::LA::Matrix<T, Row, Col>(T{0})));
+
+        // negation keeps signed zero, as eager one does
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            [[maybe_unused]] const Geometrix::LA::Matrix<T, Row, Col> negZero = -lazy(Geometrix::LA::Matrix<T, Row, Col>(T{0}));
+            for (std::size_t i = 0; i < Row; ++i)
+                for (std::size_t j = 0; j < Col; ++j)
+                    assert(std::signbit(element(negZero, i, j)));
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        chainOp<T,1,4>();
+        chainOp<T,3,3>();
+        chainOp<T,4,4>();
+        chainOp<T,5,7>();
+        chainOp<T,16,33>();
+    }
+};
+
+class VectorArrayTester
+{
+    template<typename T, std::size_t Dim>
+    static std::vector<Geometrix::LA::Vector<T, Dim>> sequence(std::size_t count, T start)
+    {
+        std::vector<Geometrix::LA::Vector<T, Dim>> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                result[i][k] = start + T(i % 7) - T(k * 2) + T(0.25);
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void accessOp(std::size_t count)
+    {
+        std::cout << "Vector array access test, with dimension " << Dim << " and size " << count << std::endl;
+        const auto aos = sequence<T, Dim>(count, 1);
+        Geometrix::LA::VectorArray<T, Dim> soa(aos);
+        assert(soa.size() == count);
+        assert((reinterpret_cast<std::uintptr_t>(soa.x()) % Geometrix::LA::VectorArray<T, Dim>::Alignment == 0));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(soa[i] == aos[i]);
+            assert(soa.x()[i] == aos[i][0]);
+        }
+        assert(soa.toAoS() == aos);
+
+        // proxy writes through
+        Geometrix::LA::VectorArray<T, Dim> copy = soa;
+        copy[count - 1][Dim - 1] = T(-1);
+        assert(copy.stream(Dim - 1)[count - 1] == T(-1));
+        copy[0] = Geometrix::LA::Vector<T, Dim>(T(5));
+        assert((copy.at(0) == Geometrix::LA::Vector<T, Dim>(T(5))));
+        assert(soa[0] == aos[0] && aos[0] == soa[0]);
+
+        // growth keeps stored vectors
+        copy.push_back(aos[0]);
+        assert(copy.size() == count + 1 && copy[count] == aos[0]);
+        assert(count < 2 || copy[1] == aos[1]);
+    }
+
+    template<typename T, std::size_t Dim>
+    static void bulkOp(std::size_t count)
+    {
+        std::cout << "Vector array bulk operations test, with dimension " << Dim << " and size " << count << std::endl;
+        const auto a = sequence<T, Dim>(count, 1);
+        const auto b = sequence<T, Dim>(count, -3);
+        const Geometrix::LA::VectorArray<T, Dim> sa(a), sb(b);
+        const T s = T(1.5);
+
+        const auto sum = sa + sb, diff = sa - sb, prod = sa * sb, scaled = sa * s;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(sum[i] == a[i] + b[i]);
+            assert(diff[i] == a[i] - b[i]);
+            assert(prod[i] == a[i] * b[i]);
+            assert(scaled[i] == a[i] * s);
+        }
+
+        std::vector<T> dots(count), lengths(count);
+        Geometrix::LA::dot(sa, sb, dots.data());
+        Geometrix::LA::length(sa, lengths.data());
+        const auto unit = Geometrix::LA::normalize(sa);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(approxEqual(dots[i], Geometrix::LA::dot(a[i], b[i])));
+            assert(approxEqual(lengths[i], T(a[i].length())));
+            for (std::size_t k = 0; k < Dim; ++k)
+                assert(approxEqual(unit[i][k], a[i][k] / T(a[i].length())));
+        }
+
+        if constexpr (Dim == 3)
+        {
+            const auto crossed = Geometrix::LA::cross(sa, sb);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(crossed[i] == Geometrix::LA::cross(a[i], b[i]));
+        }
+
+        // result aliases operand
+        auto inplace = sa;
+        inplace += sb;
+        inplace *= s;
+        for (std::size_t i = 0; i < count; ++i)
+            assert(inplace[i] == (a[i] + b[i]) * s);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        for (std::size_t count : {1, 7, 16, 35})
+        {
+            accessOp<T,2>(count);
+            accessOp<T,3>(count);
+            accessOp<T,4>(count);
+            bulkOp<T,2>(count);
+            bulkOp<T,3>(count);
+            bulkOp<T,4>(count);
+        }
+    }
+};
+
+class FusedVectorTester
+{
+    // dyadic numbers, so fused and separate roundings agree
+    template<typename T, std::size_t Dim>
+    static std::vector<Geometrix::LA::Vector<T, Dim>> sequence(std::size_t count, T start)
+    {
+        std::vector<Geometrix::LA::Vector<T, Dim>> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                result[i][k] = start + T(int(i % 9) - int(k * 3)) / T(std::is_floating_point_v<T> ? 4 : 1);
+        return result;
+    }
+
+    template<typename T>
+    static bool same(T a, T b)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+            return std::isnan(a) ? std::isnan(b) : a == b && std::signbit(a) == std::signbit(b);
+        else
+            return a == b;
+    }
+
+    template<typename T, std::size_t Dim>
+    static bool same(const Geometrix::LA::Vector<T, Dim> &a, const Geometrix::LA::Vector<T, Dim> &b)
+    {
+        for (std::size_t k = 0; k < Dim; ++k)
+            if (!same(a[k], b[k]))
+                return false;
+        return true;
+    }
+
+    template<typename T>
+    static void singleOp()
+    {
+        std::cout << "Fused vector operations test" << std::endl;
+        using namespace Geometrix::LA;
+        const Vector3D<T> a(T(1), T(-2), T(6)), b(T(3), T(2), T(-2)), c(T(-1), T(0), T(1));
+        assert(lerp(a, b, T(0)) == a && lerp(a, b, T(1)) == b);
+        assert(fma(a, b, c) == Vector3D<T>(T(2), T(-4), T(-11)));
+        assert(min(a, b) == Vector3D<T>(T(1), T(-2), T(-2)) && max(a, b) == Vector3D<T>(T(3), T(2), T(6)));
+        assert(clamp(a, T(-1), T(2)) == Vector3D<T>(T(1), T(-1), T(2)));
+        assert(clamp(a, c, Vector3D<T>(T(3), T(2), T(4))) == Vector3D<T>(T(1), T(0), T(4)));
+        assert(abs(a) == Vector3D<T>(T(1), T(2), T(6)));
+        const Vector4D<T> p(T(1), T(-2), T(6), T(-7)), q(T(4), T(2), T(-2), T(-8));
+        assert((abs(p) == Vector4D<T>(T(1), T(2), T(6), T(7))));
+        assert((max(p, q) == Vector4D<T>(T(4), T(2), T(6), T(-7))));
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            assert(lerp(a, b, T(0.5)) == Vector3D<T>(T(2), T(0), T(2)));
+            assert((lerp(p, q, 0.25) == Vector4D<T>(T(1.75), T(-1), T(4), T(-7.25))));
+            const T nan = std::numeric_limits<T>::quiet_NaN(), inf = std::numeric_limits<T>::infinity();
+            const auto f = floor(Vector4D<T>(T(-0.5), -T(0), T(2.75), T(-3)));
+            assert((same(f, Vector4D<T>(T(-1), -T(0), T(2), T(-3)))));
+            assert(same(floor(Vector2D<T>(inf, T(1e20))), Vector2D<T>(inf, T(1e20))));
+            // NaN takes the second operand
+            assert(same(min(Vector2D<T>(nan, T(1)), Vector2D<T>(T(2), nan)), Vector2D<T>(T(2), nan)));
+            assert(same(clamp(Vector2D<T>(nan, -inf), T(-1), T(1)), Vector2D<T>(T(-1), T(-1))));
+            // sign bit is cleared, the same as by arrays
+            const Vector4D<T> signs(-T(0), -nan, -inf, T(-3));
+            Vector4D<T> bulk;
+            abs(&signs, &bulk, 1);
+            assert((same(abs(signs), Vector4D<T>(T(0), nan, inf, T(3))) && same(abs(signs), bulk)));
+            assert(!std::signbit(abs(signs)[1]));
+            // kernels round halves below 2^23 and keep signed zeros, infinities and NaN
+            const Vector4D<T> edges[2] = {{T(-0.5), -T(0), T(-8388607.5), T(8388607.5)}, {-inf, T(-1e20), T(-2.5), nan}};
+            Vector4D<T> floors[2];
+            floor(edges, floors, 2);
+            assert((same(floors[0], Vector4D<T>(T(-1), -T(0), T(-8388608), T(8388607)))));
+            assert((same(floors[1], Vector4D<T>(-inf, T(-1e20), T(-3), nan))));
+        }
+    }
+
+    template<typename T, std::size_t Dim>
+    static void arrayOp(std::size_t count)
+    {
+        std::cout << "Fused vector array operations test, with dimension " << Dim << " and size " << count << std::endl;
+        using namespace Geometrix::LA;
+        using V = Vector<T, Dim>;
+        const auto a = sequence<T, Dim>(count, T(1)), b = sequence<T, Dim>(count, T(-3)), c = sequence<T, Dim>(count, T(2));
+        std::vector<V> result(count + 1);
+        const V sentinel(T(7));
+        result[count] = sentinel;
+        const T s = std::is_floating_point_v<T> ? T(0.5) : T(3);
+        const T lo = T(-2), hi = T(std::is_floating_point_v<T> ? 1.5 : 1);
+
+        axpy(s, a.data(), b.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], fma(V(s), a[i], b[i])));
+        lerp(a.data(), b.data(), s, result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], lerp(a[i], b[i], s)));
+        fma(a.data(), b.data(), c.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], fma(a[i], b[i], c[i])));
+        min(a.data(), b.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], min(a[i], b[i])));
+        max(a.data(), b.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], max(a[i], b[i])));
+        clamp(b.data(), lo, hi, result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], clamp(b[i], lo, hi)));
+        abs(b.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(result[i], abs(b[i])));
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            floor(b.data(), result.data(), count);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(result[i], floor(b[i])));
+        }
+        // nothing is written past the last vector
+        assert(same(result[count], sentinel));
+
+        // result aliases operands: x = 2 * x + x
+        auto inplace = a;
+        axpy(T(2), inplace.data(), inplace.data(), inplace.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(same(inplace[i], a[i] * T(3)));
+
+        if constexpr (StreamType<T>)
+        {
+            const VectorArray<T, Dim> sa(a), sb(b), sc(c);
+            VectorArray<T, Dim> sr;
+            axpy(s, sa, sb, sr);
+            assert(sr.size() == count);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), fma(V(s), a[i], b[i])));
+            lerp(sa, sb, s, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), lerp(a[i], b[i], s)));
+            fma(sa, sb, sc, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), fma(a[i], b[i], c[i])));
+            min(sa, sb, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), min(a[i], b[i])));
+            max(sa, sb, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), max(a[i], b[i])));
+            V low(lo), high(hi);
+            low[0] = T(0);
+            clamp(sb, low, high, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), clamp(b[i], low, high)));
+            abs(sb, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), abs(b[i])));
+            floor(sb, sr);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(same(sr.at(i), floor(b[i])));
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        singleOp<T>();
+        for (std::size_t count : {0, 1, 7, 16, 35})
+        {
+            arrayOp<T, 2>(count);
+            arrayOp<T, 3>(count);
+            arrayOp<T, 4>(count);
+        }
+    }
+};
+
+class TransformTester
+{
+    // reference transform, w - homogeneous coordinate of 3D vectors
+    template<typename T, std::size_t Dim>
+    static Geometrix::LA::Vector<T, Dim> expected(const Geometrix::LA::Matrix<T, 4, 4> &m,
+                                                  Geometrix::LA::Vector<T, Dim> v, T w, bool divide)
+    {
+        T in[4] = {v[0], v[1], v[2], Dim == 4 && w != T(0) ? v[Dim - 1] : w};
+        T out[4];
+        for (std::size_t r = 0; r < 4; ++r)
+        {
+            out[r] = 0;
+            for (std::size_t k = 0; k < 4; ++k)
+                out[r] += m[r][k] * in[k];
+        }
+        Geometrix::LA::Vector<T, Dim> result;
+        for (std::size_t k = 0; k < Dim; ++k)
+            result[k] = divide ? out[k] / out[3] : out[k];
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void check([[maybe_unused]] const std::vector<Geometrix::LA::Vector<T, Dim>> &result,
+                      const std::vector<Geometrix::LA::Vector<T, Dim>> &expect)
+    {
+        for (std::size_t i = 0; i < expect.size(); ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                assert(approxEqual(result[i][k], expect[i][k]));
+    }
+
+    template<typename T, std::size_t Dim>
+    static void transformOp(std::size_t count)
+    {
+        std::cout << "Vector transform test, with dimension " << Dim << " and count " << count << std::endl;
+        Geometrix::LA::Matrix<T, 4, 4> m;
+        for (std::size_t i = 0; i < 4; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                m[i][j] = T(i * 4 + j) / T(8) - T(j == 3 ? 0 : 1);
+        m[3][3] = T(20); // keeps w away from zero
+
+        std::vector<Geometrix::LA::Vector<T, Dim>> in(count), out(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                in[i][k] = T(i % 13) / T(4) - T(k) + (k == 3 ? T(2) : T(0));
+        std::vector<Geometrix::LA::Vector<T, Dim>> points(count), directions(count), projected(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            points[i] = expected<T, Dim>(m, in[i], T(1), false);
+            directions[i] = expected<T, Dim>(m, in[i], T(0), false);
+            projected[i] = expected<T, Dim>(m, in[i], T(1), true);
+        }
+
+        Geometrix::LA::transformPoints(m, in.data(), out.data(), count);
+        check<T, Dim>(out, points);
+        Geometrix::LA::transformDirections(m, in.data(), out.data(), count);
+        check<T, Dim>(out, directions);
+        Geometrix::LA::transformPointsProjective(m, in.data(), out.data(), count);
+        check<T, Dim>(out, projected);
+
+        const Geometrix::LA::VectorArray<T, Dim> soa(in);
+        Geometrix::LA::VectorArray<T, Dim> soaOut;
+        Geometrix::LA::transformPoints(m, soa, soaOut);
+        check<T, Dim>(soaOut.toAoS(), points);
+        Geometrix::LA::transformDirections(m, soa, soaOut);
+        check<T, Dim>(soaOut.toAoS(), directions);
+        Geometrix::LA::transformPointsProjective(m, soa, soaOut);
+        check<T, Dim>(soaOut.toAoS(), projected);
+
+        // in place
+        out = in;
+        Geometrix::LA::transformPoints(m, out.data(), out.data(), count);
+        check<T, Dim>(out, points);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        // the last count is large enough for non-temporal stores
+        const std::size_t large = _Impl::StreamingStoreBytes / (3 * sizeof(T)) + 7;
+        for (std::size_t count : {std::size_t(1), std::size_t(5), std::size_t(37), std::size_t(300), large})
+        {
+            transformOp<T,3>(count);
+            transformOp<T,4>(count);
+        }
+    }
+};
+
+class MatrixArrayTester
+{
+    template<typename T>
+    static constexpr T tolerance = T(1e-3);
+
+    template<typename T, std::size_t Dim>
+    static bool near(const Geometrix::LA::Matrix<T, Dim, Dim> &a, const Geometrix::LA::Matrix<T, Dim, Dim> &b)
+    {
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                if (!approxEqual(a[i][j], b[i][j], tolerance<T>))
+                    return false;
+        return true;
+    }
+
+    // diagonally dominant, so invertible
+    template<typename T, std::size_t Dim>
+    static std::vector<Geometrix::LA::Matrix<T, Dim, Dim>> sequence(std::size_t count, T start)
+    {
+        std::vector<Geometrix::LA::Matrix<T, Dim, Dim>> result(count);
+        for (std::size_t n = 0; n < count; ++n)
+            for (std::size_t i = 0; i < Dim; ++i)
+                for (std::size_t j = 0; j < Dim; ++j)
+                    result[n][i][j] = i == j ? T(4 * Dim) + T(n % 5) : start + T((n + i * Dim + j) % 7) / T(3);
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void batchOp(std::size_t count)
+    {
+        std::cout << "Matrix array test, with dimensions: " << Dim << "x" << Dim << " and size " << count << std::endl;
+        const auto a = sequence<T, Dim>(count, T(1));
+        const auto b = sequence<T, Dim>(count, T(-2));
+        const Geometrix::LA::MatrixArray<T, Dim, Dim> sa(a), sb(b);
+        assert(sa.toAoS() == a);
+
+        const auto products = Geometrix::LA::dot(sa, sb);
+        const auto transposed = Geometrix::LA::transpose(sa);
+        std::vector<T> determinants(count), inverseDeterminants(count);
+        Geometrix::LA::determinant(sa, determinants.data());
+        const auto inverses = Geometrix::LA::invert(sa, inverseDeterminants.data());
+        Geometrix::LA::Matrix<T, Dim, Dim> identity(T(0));
+        for (std::size_t i = 0; i < Dim; ++i)
+            identity[i][i] = T(1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(near(products[i], Geometrix::LA::dot(a[i], b[i])));
+            assert(transposed[i] == Geometrix::LA::transpose(a[i]));
+            assert(approxEqual(determinants[i], Geometrix::LA::determinant(a[i]), tolerance<T>));
+            assert(inverseDeterminants[i] == determinants[i]);
+            assert(near(Geometrix::LA::dot(inverses[i], a[i]), identity));
+        }
+
+        // results alias operands, proxy writes through
+        auto inplace = sa;
+        Geometrix::LA::transpose(inplace, inplace);
+        Geometrix::LA::dot(inplace, sb, inplace);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(inplace.at(i), Geometrix::LA::dot(Geometrix::LA::transpose(a[i]), b[i])));
+        inplace[count - 1] = Geometrix::LA::Matrix<T, Dim, Dim>(T(0));
+        inplace[0](0, 0) = T(1);
+        Geometrix::LA::invert(inplace, inplace, determinants.data());
+        assert(determinants[count - 1] == T(0));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        for (std::size_t count : {1, 7, 16, 35})
+        {
+            batchOp<T,2>(count);
+            batchOp<T,3>(count);
+            batchOp<T,4>(count);
+        }
+    }
+};
+
+class EigenDecompositionTester
+{
+    template<typename T>
+    static constexpr T eps = std::is_same_v<T, float> ? T(2e-5) : T(1e-12);
+
+    template<typename T>
+    static Geometrix::LA::Matrix<T, 3, 3> matrix(const T (&a)[3][3])
+    {
+        Geometrix::LA::Matrix<T, 3, 3> m;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                m[i][j] = a[i][j];
+        return m;
+    }
+
+    template<typename T>
+    static T maxNorm(const Geometrix::LA::Matrix<T, 3, 3> &m)
+    {
+        T result = T(0);
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                result = std::max(result, std::abs(m[i][j]));
+        return result;
+    }
+
+    // columns are orthonormal
+    template<typename T>
+    static bool orthogonal(const Geometrix::LA::Matrix<T, 3, 3> &q)
+    {
+        const auto p = Geometrix::LA::dot(Geometrix::LA::transpose(q), q);
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                if (std::abs(p[i][j] - T(i == j)) > 4 * eps<T>)
+                    return false;
+        return true;
+    }
+
+    // q * diag(values) * v^T == a
+    template<typename T>
+    static bool reconstructs(const Geometrix::LA::Matrix<T, 3, 3> &a, const Geometrix::LA::Matrix<T, 3, 3> &q,
+                             const T (&values)[3], const Geometrix::LA::Matrix<T, 3, 3> &v)
+    {
+        auto scaled = q;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                scaled[i][j] *= values[j];
+        return maxNorm<T>(Geometrix::LA::dot(scaled, Geometrix::LA::transpose(v)) - a) <= 8 * eps<T> * (T(1) + maxNorm(a));
+    }
+
+    template<typename T>
+    static void checkEigen([[maybe_unused]] const Geometrix::LA::Matrix<T, 3, 3> &a, [[maybe_unused]] const T (&values)[3], [[maybe_unused]] const Geometrix::LA::Matrix<T, 3, 3> &vectors)
+    {
+        assert(values[0] >= values[1] && values[1] >= values[2]);
+        assert(orthogonal(vectors));
+        assert(Geometrix::LA::determinant(vectors) > T(0));
+        assert(reconstructs(a, vectors, values, vectors));
+    }
+
+    template<typename T>
+    static void checkSVD([[maybe_unused]] const Geometrix::LA::Matrix<T, 3, 3> &a, [[maybe_unused]] const Geometrix::LA::Matrix<T, 3, 3> &u,
+                         [[maybe_unused]] const T (&values)[3], [[maybe_unused]] const Geometrix::LA::Matrix<T, 3, 3> &v)
+    {
+        assert(values[0] >= values[1] && values[1] >= values[2] && values[2] >= T(0));
+        assert(orthogonal(u));
+        assert(orthogonal(v));
+        assert(Geometrix::LA::determinant(v) > T(0));
+        assert(reconstructs(a, u, values, v));
+    }
+
+    // degenerate cases first: zero, repeated and unsorted eigenvalues, rank 1, reflection
+    template<typename T>
+    static std::vector<Geometrix::LA::Matrix<T, 3, 3>> samples(std::size_t count)
+    {
+        std::vector<Geometrix::LA::Matrix<T, 3, 3>> result(count, Geometrix::LA::Matrix<T, 3, 3>(T(0)));
+        std::uint32_t seed = 12345;
+        auto random = [&seed]() {
+            seed = seed * 1664525u + 1013904223u;
+            return T(seed >> 8) / T(1 << 24) * T(8) - T(4);
+        };
+        for (std::size_t n = 0; n < count; ++n)
+        {
+            auto &m = result[n];
+            switch (n)
+            {
+            case 0:
+                break;
+            case 1:
+                m[0][0] = m[1][1] = m[2][2] = T(2);
+                break;
+            case 2:
+                m[0][0] = T(1), m[1][1] = T(3), m[2][2] = T(-2);
+                break;
+            case 3:
+                for (std::size_t i = 0; i < 3; ++i)
+                    for (std::size_t j = 0; j < 3; ++j)
+                        m[i][j] = T(i + 1) * T(3 - j);
+                break;
+            case 4:
+                m[0][1] = m[1][0] = T(1), m[2][2] = T(-1);
+                break;
+            default:
+                for (std::size_t i = 0; i < 3; ++i)
+                    for (std::size_t j = 0; j < 3; ++j)
+                        m[i][j] = random();
+            }
+        }
+        return result;
+    }
+
+    template<typename T>
+    static Geometrix::LA::Matrix<T, 3, 3> symmetric(const Geometrix::LA::Matrix<T, 3, 3> &m)
+    {
+        auto s = m;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < i; ++j)
+                s[i][j] = s[j][i];
+        return s;
+    }
+
+    template<typename T>
+    static void singleOp()
+    {
+        std::cout << "Symmetric eigen and singular value decompositions test of single matrices" << std::endl;
+        for (const auto &m : samples<T>(40))
+        {
+            // lower triangle is ignored
+            const auto eigen = Geometrix::LA::decomposeSymmetricEigen(m);
+            checkEigen(symmetric(m), eigen.values, matrix(eigen.vectors));
+            const auto svd = Geometrix::LA::decomposeSVD(m);
+            checkSVD(m, matrix(svd.u), svd.values, matrix(svd.v));
+        }
+    }
+
+    template<typename T>
+    static void batchOp(std::size_t count)
+    {
+        std::cout << "Symmetric eigen and singular value decompositions test with size " << count << std::endl;
+        const auto m = samples<T>(count);
+        const Geometrix::LA::MatrixArray<T, 3, 3> a(m);
+        Geometrix::LA::MatrixArray<T, 3, 3> u, v;
+        Geometrix::LA::VectorArray<T, 3> values;
+        Geometrix::LA::decomposeSymmetricEigen(a, values, v);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const T lambda[3] = {values.stream(0)[i], values.stream(1)[i], values.stream(2)[i]};
+            checkEigen(symmetric(m[i]), lambda, v.at(i));
+        }
+        Geometrix::LA::decomposeSVD(a, u, values, v);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const T sigma[3] = {values.stream(0)[i], values.stream(1)[i], values.stream(2)[i]};
+            checkSVD(m[i], u.at(i), sigma, v.at(i));
+        }
+
+        // outputs alias input
+        auto inplace = a;
+        Geometrix::LA::decomposeSVD(inplace, inplace, values, v);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const T sigma[3] = {values.stream(0)[i], values.stream(1)[i], values.stream(2)[i]};
+            checkSVD(m[i], inplace.at(i), sigma, v.at(i));
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        singleOp<T>();
+        for (std::size_t count : {1, 5, 33})
+            batchOp<T>(count);
+    }
+};
+
+class LinearSolverTester
+{
+    template<typename T>
+    static constexpr T tolerance = std::is_same_v<T, float> ? T(1e-4) : T(1e-11);
+
+    // diagonally dominant, so the systems are well conditioned
+    template<typename T, std::size_t R, std::size_t C>
+    static std::vector<Geometrix::LA::Matrix<T, R, C>> matrices(std::size_t count)
+    {
+        std::vector<Geometrix::LA::Matrix<T, R, C>> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = numbers<T, R, C>(i, T(3));
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static std::vector<Geometrix::LA::Vector<T, Dim>> vectors(std::size_t count)
+    {
+        std::vector<Geometrix::LA::Vector<T, Dim>> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+            result[i] = numbers<T, 1, Dim>(i + 5000);
+        return result;
+    }
+
+    template<typename T, std::size_t N>
+    static void solveOp(std::size_t count)
+    {
+        std::cout << "Batched linear systems test, with dimensions: " << N << "x" << N << " and size " << count << std::endl;
+        using namespace Geometrix::LA;
+        auto m = matrices<T, N, N>(count);
+        const auto rhs = vectors<T, N>(count);
+        // the second system has dependent rows, the third has zero matrix,
+        // the fourth has a row, which is dependent up to rounding
+        if (count > 1)
+            for (std::size_t c = 0; c < N; ++c)
+                m[1][N - 1][c] = m[1][0][c] * T(2);
+        if (count > 2)
+            m[2] = Matrix<T, N, N>(T(0));
+        if (count > 3)
+            for (std::size_t c = 0; c < N; ++c)
+                m[3][N - 1][c] = m[3][0][c] * T(0.3) + (N > 2 ? m[3][1][c] * T(0.7) : T(0));
+        const MatrixArray<T, N, N> a(m);
+        const VectorArray<T, N> b(rhs);
+        VectorArray<T, N> x;
+        // one flag past count, which solve() must leave alone
+        const auto singular = std::make_unique<bool[]>(count + 1);
+        singular[count] = true;
+        [[maybe_unused]] const std::size_t flagged = solve(a, b, x, singular.get());
+        assert(x.size() == count);
+        assert(flagged == std::min<std::size_t>(count > 0 ? count - 1 : 0, 3));
+        assert(singular[count]);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bool correctness = false;
+            auto expected = solve(m[i], rhs[i], &correctness);
+            // LU takes only exact zero pivots
+            if (i == 3)
+            {
+                correctness = false;
+                expected = Vector<T, N>(T(0));
+            }
+            assert(singular[i] == !correctness);
+            const auto result = x.at(i);
+            for (std::size_t k = 0; k < N; ++k)
+                assert(correctness ? approxEqual(result[k], expected[k], tolerance<T>) : result[k] == T(0));
+            if (!correctness)
+                continue;
+            // residual of the original system
+            for (std::size_t r = 0; r < N; ++r)
+            {
+                T accum = T(0);
+                for (std::size_t c = 0; c < N; ++c)
+                    accum += m[i][r][c] * result[c];
+                assert(approxEqual(accum, rhs[i][r], tolerance<T>));
+            }
+        }
+
+        // solution overwrites right-hand sides, no flags
+        auto inplace = b;
+        assert(solve(a, inplace, inplace) == flagged);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(inplace.at(i) == x.at(i));
+    }
+
+    template<typename T, std::size_t R, std::size_t C>
+    static void leastSquaresOp(std::size_t count)
+    {
+        std::cout << "Batched least squares test, with dimensions: " << R << "x" << C << " and size " << count << std::endl;
+        using namespace Geometrix::LA;
+        auto m = matrices<T, R, C>(count);
+        const auto solutions = vectors<T, C>(count);
+        auto rhs = vectors<T, R>(count);
+        // even systems are consistent: b = A * x
+        for (std::size_t i = 0; i < count; i += 2)
+            for (std::size_t r = 0; r < R; ++r)
+            {
+                rhs[i][r] = T(0);
+                for (std::size_t c = 0; c < C; ++c)
+                    rhs[i][r] += m[i][r][c] * solutions[i][c];
+            }
+        // the second system has dependent columns
+        if (count > 1)
+            for (std::size_t r = 0; r < R; ++r)
+                m[1][r][C - 1] = m[1][r][0] * T(-3);
+        const MatrixArray<T, R, C> a(m);
+        const VectorArray<T, R> b(rhs);
+        VectorArray<T, C> x;
+        const auto singular = std::make_unique<bool[]>(count);
+        assert(solveLeastSquares(a, b, x, singular.get()) == std::size_t(count > 1));
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            bool correctness = false;
+            [[maybe_unused]] const auto single = solveLeastSquares(m[i], rhs[i], &correctness);
+            assert(singular[i] == !correctness && correctness == (i != 1));
+            const auto result = x.at(i);
+            for (std::size_t k = 0; k < C; ++k)
+                assert(correctness ? approxEqual(result[k], single[k], tolerance<T>) : result[k] == T(0) && single[k] == T(0));
+            if (!correctness)
+                continue;
+            if (i % 2 == 0)
+                for (std::size_t k = 0; k < C; ++k)
+                    assert(approxEqual(result[k], solutions[i][k], tolerance<T>));
+            // residual is orthogonal to columns: A^T * (A * x - b) = 0
+            T residual[R];
+            for (std::size_t r = 0; r < R; ++r)
+            {
+                residual[r] = -rhs[i][r];
+                for (std::size_t c = 0; c < C; ++c)
+                    residual[r] += m[i][r][c] * result[c];
+            }
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                T accum = T(0);
+                for (std::size_t r = 0; r < R; ++r)
+                    accum += m[i][r][c] * residual[r];
+                assert(approxEqual(accum, T(0), tolerance<T>));
+            }
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        for (std::size_t count : {0, 1, 3, 17, 40})
+        {
+            solveOp<T, 2>(count);
+            solveOp<T, 3>(count);
+            solveOp<T, 4>(count);
+            solveOp<T, 5>(count);
+            solveOp<T, 6>(count);
+            leastSquaresOp<T, 3, 2>(count);
+            leastSquaresOp<T, 6, 3>(count);
+            leastSquaresOp<T, 4, 4>(count);
+            leastSquaresOp<T, 6, 4>(count);
+        }
+    }
+};
+
+class DynamicMatrixTester
+{
+    template<typename T>
+    static Geometrix::LA::DynamicMatrix<T> sequence(std::size_t rows, std::size_t columns, T start)
+    {
+        Geometrix::LA::DynamicMatrix<T> m(rows, columns);
+        for (std::size_t i = 0; i < rows; ++i)
+            for (std::size_t j = 0; j < columns; ++j)
+                m[i][j] = start + T((i * 7 + j * 13) % 17) / T(8) - T(1);
+        return m;
+    }
+
+    template<typename T>
+    static void productOp(std::size_t m, std::size_t n, std::size_t k, unsigned threads)
+    {
+        std::cout << "Dynamic matrix product test, with dimensions: " << m << "x" << k << " * " << k << "x" << n
+                  << " and " << threads << " threads" << std::endl;
+        const auto a = sequence<T>(m, k, T(0.5));
+        const auto b = sequence<T>(k, n, T(-0.25));
+        const auto c = Geometrix::LA::dot(a, b, threads);
+        assert(c.rows() == m && c.columns() == n);
+        [[maybe_unused]] const T eps = (std::is_same_v<T, float> ? T(1e-6) : T(1e-14)) * T(4 * k + 1);
+        for (std::size_t i = 0; i < m; ++i)
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                double expected = 0;
+                for (std::size_t p = 0; p < k; ++p)
+                    expected += double(a[i][p]) * double(b[p][j]);
+                assert(std::abs(double(c[i][j]) - expected) <= eps * (1 + std::abs(expected)));
+            }
+    }
+
+    template<typename T>
+    static void conversionOp()
+    {
+        std::cout << "Dynamic matrix conversion test" << std::endl;
+        Geometrix::LA::Matrix<T, 3, 4> fixed;
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                fixed[i][j] = T(i * 4 + j);
+        const Geometrix::LA::DynamicMatrix<T> m(fixed);
+        assert(m.rows() == 3 && m.columns() == 4 && m.stride() % (64 / sizeof(T)) == 0);
+        assert((m.template toMatrix<3, 4>() == fixed));
+
+        const auto t = Geometrix::LA::transpose(sequence<T>(45, 70, T(0)));
+        const auto tt = Geometrix::LA::transpose(t);
+        assert(t.rows() == 70 && t.columns() == 45 && t[69][44] == tt[44][69]);
+        assert(tt == sequence<T>(45, 70, T(0)));
+        assert(Geometrix::LA::dot(Geometrix::LA::DynamicMatrix<T>::identity(45), tt) == tt);
+        assert(Geometrix::LA::dot(Geometrix::LA::DynamicMatrix<T>(4, 0), Geometrix::LA::DynamicMatrix<T>(0, 5)) ==
+               Geometrix::LA::DynamicMatrix<T>(4, 5));
+    }
+
+    // plane z = 2x - 3y + 0.5 by normal equations (A^T * A) x = A^T * z
+    template<typename T>
+    static void leastSquaresOp()
+    {
+        std::cout << "Dynamic matrix least squares test" << std::endl;
+        constexpr std::size_t count = 5000;
+        Geometrix::LA::VectorArray<T, 3> rows(count);
+        Geometrix::LA::DynamicMatrix<T> z(count, 1);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const T x = T(i % 100) / T(10), y = T(i / 100) / T(10);
+            rows[i] = Geometrix::LA::Vector<T, 3>(x, y, T(1));
+            z[i][0] = T(2) * x - T(3) * y + T(0.5);
+        }
+        const Geometrix::LA::DynamicMatrix<T> a(rows);
+        const auto at = Geometrix::LA::transpose(a);
+        const auto normal = Geometrix::LA::dot(at, a).template toMatrix<3, 3>();
+        const auto rhs = Geometrix::LA::dot(at, z);
+        const Geometrix::LA::Vector<T, 3> b(rhs[0][0], rhs[1][0], rhs[2][0]);
+        [[maybe_unused]] const auto x = Geometrix::LA::solve(Geometrix::LA::decomposeCholesky(normal), b);
+        [[maybe_unused]] const T eps = std::is_same_v<T, float> ? T(1e-3) : T(1e-9);
+        assert(std::abs(x[0] - T(2)) < eps && std::abs(x[1] + T(3)) < eps && std::abs(x[2] - T(0.5)) < eps);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        conversionOp<T>();
+        leastSquaresOp<T>();
+        productOp<T>(1, 1, 1, 1);
+        productOp<T>(7, 5, 3, 1);
+        productOp<T>(5, 3, 0, 1);
+        productOp<T>(37, 53, 29, 1);
+        productOp<T>(131, 70, 300, 4);
+        productOp<T>(9, 2100, 40, 3);
+    }
+};
+
+class PaddedVectorTester
+{
+    template<typename T>
+    static constexpr T tolerance = T(1e-5);
+
+    template<typename T>
+    static bool near(const Geometrix::LA::PaddedVector3D<T> &a, const Geometrix::LA::Vector3D<T> &b)
+    {
+        return approxEqual(a.x(), b.x(), tolerance<T>) && approxEqual(a.y(), b.y(), tolerance<T>) && approxEqual(a.z(), b.z(), tolerance<T>) && a.data()[3] == T(0);
+    }
+
+    template<typename T>
+    static void operatorOp()
+    {
+        std::cout << "Padded 3D vector operators test" << std::endl;
+        using Padded = Geometrix::LA::PaddedVector3D<T>;
+        const Geometrix::LA::Vector3D<T> a(T(1.5), T(-2), T(3.25)), b(T(-0.5), T(4), T(2));
+        const Padded pa(a), pb(b);
+
+        assert(pa.vector3() == a && pa == Padded(T(1.5), T(-2), T(3.25)) && pa != pb);
+        assert(near(pa + pb, a + b));
+        assert(near(pa - pb, a - b));
+        assert(near(pa * pb, a * b));
+        assert(near(pa / pb, a / b));
+        assert(near(pa * T(3), a * T(3)));
+        assert(near(T(3) * pa, a * T(3)));
+        assert(near(pa / T(4), a / T(4)));
+        assert(near(-pa, -a));
+        assert(approxEqual(Geometrix::LA::dot(pa, pb), Geometrix::LA::dot(a, b), tolerance<T>));
+        assert(near(Geometrix::LA::cross(pa, pb), Geometrix::LA::cross(a, b)));
+        assert(approxEqual(pa.length(), T(a.length()), tolerance<T>));
+        assert(near(Geometrix::LA::normalize(pa), Geometrix::LA::unit(a)));
+        assert(approxEqual(Geometrix::LA::normalize(pa).length(), T(1), tolerance<T>));
+        assert(Padded().length() == T(0));
+
+        // padding lane stays zero and signed zero is kept, as in Vector3D
+        constexpr T inf = std::numeric_limits<T>::infinity();
+        [[maybe_unused]] const Padded infinite = Padded(T(1), T(1), T(1)) * inf;
+        assert(infinite.data()[3] == T(0) && infinite.length() == inf);
+        [[maybe_unused]] const Padded negZero = -Padded();
+        assert(std::signbit(negZero.x()) && std::signbit(negZero.y()) && std::signbit(negZero.z()) && !std::signbit(negZero.data()[3]));
+    }
+
+    template<typename T>
+    static void conversionOp(std::size_t count)
+    {
+        std::cout << "Padded 3D vector conversion test, with size " << count << std::endl;
+        std::vector<Geometrix::LA::Vector3D<T>> packed(count), back(count + 1, Geometrix::LA::Vector3D<T>(T(7)));
+        for (std::size_t i = 0; i < count; ++i)
+            packed[i] = Geometrix::LA::Vector3D<T>(T(i), T(-1) - T(i), T(0.5) * T(i));
+        std::vector<Geometrix::LA::PaddedVector3D<T>> padded(count);
+
+        Geometrix::LA::toPadded(packed.data(), padded.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(padded[i].vector3() == packed[i] && padded[i].data()[3] == T(0));
+        Geometrix::LA::fromPadded(padded.data(), back.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(back[i] == packed[i]);
+        // nothing is written past the last vector
+        assert(back[count] == Geometrix::LA::Vector3D<T>(T(7)));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        operatorOp<T>();
+        conversionOp<T>(0);
+        conversionOp<T>(1);
+        conversionOp<T>(2);
+        conversionOp<T>(37);
+    }
+};
+
+class IntegerMatrixTester
+{
+    using Op = _Impl::IntegerOp;
+
+    // wrapping arithmetic and shifts, counts of bit width or more included
+    template<Op O, typename T>
+    static T expected(T a, T b)
+    {
+        using U = std::make_unsigned_t<T>;
+        // 16 bit numbers would be promoted to int
+        using W = std::common_type_t<U, unsigned>;
+        constexpr U Bits = sizeof(T) * 8;
+        constexpr T Max = std::numeric_limits<T>::max(), Min = std::numeric_limits<T>::lowest();
+        if constexpr (O == Op::Add)
+            return T(W(a) + W(b));
+        else if constexpr (O == Op::Sub)
+            return T(W(a) - W(b));
+        else if constexpr (O == Op::Mul)
+            return T(W(a) * W(b));
+        else if constexpr (O == Op::And)
+            return a & b;
+        else if constexpr (O == Op::Or)
+            return a | b;
+        else if constexpr (O == Op::Xor)
+            return a ^ b;
+        else if constexpr (O == Op::ShiftLeft)
+            return U(b) < Bits ? T(W(U(a)) << U(b)) : T(0);
+        else if constexpr (O == Op::ShiftRight)
+        {
+            if (U(b) < Bits)
+                return T(a >> U(b));
+            return std::is_signed_v<T> && a < 0 ? T(-1) : T(0);
+        }
+        else if constexpr (O == Op::AddSaturate)
+        {
+            if (b > 0 && a > Max - b)
+                return Max;
+            if (std::is_signed_v<T> && b < 0 && a < Min - b)
+                return Min;
+            return T(a + b);
+        }
+        else
+        {
+            if (std::is_signed_v<T> ? b < 0 && a > Max + b : false)
+                return Max;
+            if (std::is_signed_v<T> ? b > 0 && a < Min + b : a < b)
+                return Min;
+            return T(a - b);
+        }
+    }
+
+    template<Op O, typename M, typename Fn, typename FnSingle>
+    static void check(const std::vector<M> &a, const std::vector<M> &b, typename M::Type single, Fn fn, FnSingle fnSingle)
+    {
+        using T = typename M::Type;
+        constexpr std::size_t N = sizeof(M) / sizeof(T);
+        std::vector<M> result(a.size() + 1);
+        const T guard = numbers<T, 1, 1, true>(1000);
+        std::fill_n(reinterpret_cast<T *>(&result.back()), N, guard);
+
+        fn(a.data(), b.data(), result.data(), a.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
+            for (std::size_t j = 0; j < N; ++j)
+                assert(reinterpret_cast<const T *>(&result[i])[j] ==
+                       expected<O>(reinterpret_cast<const T *>(&a[i])[j], reinterpret_cast<const T *>(&b[i])[j]));
+        fnSingle(a.data(), single, result.data(), a.size());
+        for (std::size_t i = 0; i < a.size(); ++i)
+            for (std::size_t j = 0; j < N; ++j)
+                assert(reinterpret_cast<const T *>(&result[i])[j] == expected<O>(reinterpret_cast<const T *>(&a[i])[j], single));
+        // nothing is written past the last matrix
+        for (std::size_t j = 0; j < N; ++j)
+            assert(reinterpret_cast<const T *>(&result.back())[j] == guard);
+    }
+
+    template<typename M>
+    static void batchOp(std::size_t count)
+    {
+        using T = typename M::Type;
+        constexpr std::size_t N = sizeof(M) / sizeof(T);
+        constexpr std::size_t Bits = sizeof(T) * 8;
+        std::cout << "Integer batch operations test, " << N << " numbers of " << Bits << " bits, with size " << count << std::endl;
+        std::vector<M> a(count), b(count), counts(count);
+        // both signs and all bits
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            a[i] = numbers<T, M::Rows, M::Columns, true>(i);
+            b[i] = numbers<T, M::Rows, M::Columns, true>(i + count);
+        }
+        // mostly valid counts, every 8th one is the bit width or more
+        for (std::size_t i = 0; i < count * N; ++i)
+            reinterpret_cast<T *>(counts.data())[i] = T(i % 8 ? i % Bits : Bits + i % 3);
+        const T single = numbers<T, 1, 1, true>(7);
+        using namespace Geometrix::LA;
+        check<Op::Add>(a, b, single, [](auto... x) { add(x...); }, [](auto... x) { add(x...); });
+        check<Op::Sub>(a, b, single, [](auto... x) { sub(x...); }, [](auto... x) { sub(x...); });
+        check<Op::Mul>(a, b, single, [](auto... x) { mul(x...); }, [](auto... x) { mul(x...); });
+        check<Op::And>(a, b, single, [](auto... x) { bitAnd(x...); }, [](auto... x) { bitAnd(x...); });
+        check<Op::Or>(a, b, single, [](auto... x) { bitOr(x...); }, [](auto... x) { bitOr(x...); });
+        check<Op::Xor>(a, b, single, [](auto... x) { bitXor(x...); }, [](auto... x) { bitXor(x...); });
+        check<Op::AddSaturate>(a, b, single, [](auto... x) { add<Overflow::Saturate>(x...); },
+                               [](auto... x) { add<Overflow::Saturate>(x...); });
+        check<Op::SubSaturate>(a, b, single, [](auto... x) { sub<Overflow::Saturate>(x...); },
+                               [](auto... x) { sub<Overflow::Saturate>(x...); });
+        // small numbers don't saturate
+        check<Op::AddSaturate>(counts, counts, T(3), [](auto... x) { add<Overflow::Saturate>(x...); },
+                               [](auto... x) { add<Overflow::Saturate>(x...); });
+        for (T n : {T(0), T(1), T(Bits - 1), T(Bits)})
+        {
+            check<Op::ShiftLeft>(a, counts, n, [](auto... x) { shiftLeft(x...); }, [](auto... x) { shiftLeft(x...); });
+            check<Op::ShiftRight>(a, counts, n, [](auto... x) { shiftRight(x...); }, [](auto... x) { shiftRight(x...); });
+        }
+
+        // ~ and operands aliasing result
+        std::vector<M> result(count);
+        bitNot(a.data(), result.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(result[i] == ~M(a[i]));
+        add(result.data(), a.data(), result.data(), count);
+        for (std::size_t i = 0; i < count * N; ++i)
+            assert(reinterpret_cast<const T *>(result.data())[i] == T(-1));
+    }
+
+    template<typename T>
+    static void operatorOp()
+    {
+        std::cout << "Integer batch operations match operators test" << std::endl;
+        using V = Geometrix::LA::Vector4D<T>;
+        const V a(T(-7), T(12), T(T(1) << (sizeof(T) * 4)), T(-1)), b(T(3), T(5), T(9), T(1));
+        V result[1];
+        Geometrix::LA::bitAnd(&a, &b, result, 1);
+        assert(result[0] == (V(a) &= b));
+        Geometrix::LA::bitOr(&a, &b, result, 1);
+        assert(result[0] == (V(a) |= b));
+        Geometrix::LA::bitXor(&a, &b, result, 1);
+        assert(result[0] == (V(a) ^= b));
+        Geometrix::LA::shiftLeft(&a, &b, result, 1);
+        assert(result[0] == (V(a) <<= b));
+        Geometrix::LA::shiftRight(&a, &b, result, 1);
+        assert(result[0] == (V(a) >>= b));
+        Geometrix::LA::shiftRight(&a, T(2), result, 1);
+        assert(result[0] == (V(a) >>= T(2)));
+        // arithmetic shift of signed numbers
+        if constexpr (std::is_signed_v<T>)
+            assert(result[0][0] == T(-2) && result[0][3] == T(-1));
+        Geometrix::LA::mul(&a, &b, result, 1);
+        assert(result[0] == (V(a) *= b));
+    }
+
+    template<typename T, std::size_t Dim>
+    static void conversionOp(std::size_t count)
+    {
+        std::cout << "Integer vectors to float and back test, " << sizeof(T) * 8 << " bits, with size " << count << std::endl;
+        using Geometrix::LA::Vector;
+        constexpr float Lowest = float(std::numeric_limits<T>::lowest());
+        constexpr float Highest = float(std::numeric_limits<T>::max());
+        std::vector<Vector<T, Dim>> in(count), back(count + 1);
+        std::vector<Vector<float, Dim>> floats(count);
+        for (std::size_t i = 0; i < count; ++i)
+            in[i] = numbers<T, 1, Dim, true>(i);
+        back[count][0] = T(7);
+
+        Geometrix::LA::convert(in.data(), floats.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                assert(floats[i][k] == float(in[i][k]));
+        if constexpr (sizeof(T) == 2)
+        {
+            // 16 bit numbers are exact
+            Geometrix::LA::convert(floats.data(), back.data(), count);
+            for (std::size_t i = 0; i < count; ++i)
+                assert(back[i] == in[i]);
+        }
+
+        // rounding to nearest even, saturation and NaN
+        const float special[] = {2.5f, 3.5f, -2.5f, 0.49f, -0.51f, 1e10f, -1e10f, Highest + 0.75f, Lowest - 0.75f,
+                                 std::numeric_limits<float>::quiet_NaN(), 100.25f, -7.75f};
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                floats[i][k] = special[(i * Dim + k) % std::size(special)];
+        roundingOp<Geometrix::LA::Rounding::Nearest>(floats, back, count, [](float f) { return std::nearbyint(f); });
+        roundingOp<Geometrix::LA::Rounding::Down>(floats, back, count, [](float f) { return std::floor(f); });
+        roundingOp<Geometrix::LA::Rounding::Up>(floats, back, count, [](float f) { return std::ceil(f); });
+        roundingOp<Geometrix::LA::Rounding::TowardZero>(floats, back, count, [](float f) { return std::trunc(f); });
+        // nothing is written past the last vector
+        assert(back[count][0] == T(7));
+    }
+
+    template<Geometrix::LA::Rounding Mode, typename T, std::size_t Dim, typename Round>
+    static void roundingOp(const std::vector<Geometrix::LA::Vector<float, Dim>> &floats,
+                           std::vector<Geometrix::LA::Vector<T, Dim>> &back, std::size_t count, Round round)
+    {
+        constexpr float Lowest = float(std::numeric_limits<T>::lowest());
+        constexpr float Highest = float(std::numeric_limits<T>::max());
+        Geometrix::LA::convert<Mode>(floats.data(), back.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+            {
+                const float f = floats[i][k];
+                T e;
+                if (std::isnan(f) || f <= Lowest)
+                    e = std::numeric_limits<T>::lowest();
+                else if (f >= Highest)
+                    e = std::numeric_limits<T>::max();
+                else
+                    e = T(round(f));
+                // int32_t max isn't a float, the highest one below it is taken
+                if (sizeof(T) == 4 && e == std::numeric_limits<T>::max())
+                    e = T(2147483520);
+                assert(back[i][k] == e);
+            }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        operatorOp<T>();
+        for (std::size_t count : {0, 1, 5, 37})
+        {
+            batchOp<Geometrix::LA::Vector4D<T>>(count);
+            batchOp<Geometrix::LA::Vector3D<T>>(count);
+            batchOp<Geometrix::LA::Matrix<T, 3, 3>>(count);
+            if constexpr (Geometrix::LA::FloatConvertibleType<T>)
+            {
+                conversionOp<T, 2>(count);
+                conversionOp<T, 3>(count);
+            }
+        }
+    }
+};
+
+class CompactPointTester
+{
+    template<typename P>
+    static void intersectOp()
+    {
+        using T = typename P::Type;
+        std::cout << "Compact point intersections test, " << sizeof(T) * 8 << " bits" << std::endl;
+        [[maybe_unused]] const Geometrix::Rectangle2D<T> rect{P(T(-100), T(-50)), P(T(300), T(250))};
+        assert(Geometrix::intersect(P(T(0), T(0)), rect));
+        assert(!Geometrix::intersect(P(T(-200), T(0)), rect));
+        assert(rect.p2() == P(T(300), T(-50)) && rect.p4() == P(T(-100), T(250)));
+        assert(rect.width() == 400 && rect.height() == 300);
+
+        // squared distances don't fit 16 bits
+        [[maybe_unused]] const Geometrix::Circle2D<T> circle{P(T(1000), T(1000)), T(500)};
+        assert(Geometrix::intersect(P(T(1300), T(1300)), circle));
+        assert(!Geometrix::intersect(P(T(1400), T(1400)), circle));
+        assert(Geometrix::intersect(Geometrix::Circle2D<T>{P(T(1900), T(1000)), T(401)}, circle));
+        assert(!Geometrix::intersect(Geometrix::Circle2D<T>{P(T(1900), T(1000)), T(399)}, circle));
+        assert(Geometrix::intersect(rect, Geometrix::Rectangle2D<T>{P(T(200), T(200)), P(T(400), T(400))}));
+        assert(!Geometrix::intersect(rect, Geometrix::Rectangle2D<T>{P(T(301), T(0)), P(T(400), T(400))}));
+        assert(Geometrix::intersect(rect, Geometrix::Circle2D<T>{P(T(700), T(100)), T(400)}));
+        assert(!Geometrix::intersect(Geometrix::Circle2D<T>{P(T(700), T(100)), T(399)}, rect));
+
+        // differences of coordinates don't fit the type
+        const T lo = std::numeric_limits<T>::lowest(), hi = std::numeric_limits<T>::max();
+        [[maybe_unused]] const Geometrix::Circle2D<T> left{P(lo, T(0)), T(10)}, wide{P(lo, T(0)), hi};
+        assert(!Geometrix::intersect(left, Geometrix::Circle2D<T>{P(hi, T(0)), T(10)}));
+        assert(!Geometrix::intersect(left, Geometrix::Rectangle2D<T>{P(T(hi - 7), T(0)), P(hi, T(10))}));
+        assert(!Geometrix::intersect(P(hi, T(0)), left));
+        assert(!Geometrix::intersect(P(hi, hi), Geometrix::Circle2D<T>{P(lo, lo), hi}));
+        assert(Geometrix::intersect(P(T(lo + hi / 2), T(hi / 2)), wide));
+        assert(!Geometrix::intersect(wide, Geometrix::Circle2D<T>{P(T(hi - 1), T(0)), hi}));
+        assert(Geometrix::intersect(wide, Geometrix::Circle2D<T>{P(T(hi - 2), T(0)), hi}));
+        assert(Geometrix::intersect(Geometrix::Circle2D<T>{P(hi, hi), hi}, Geometrix::Rectangle2D<T>{P(T(0), T(0)), P(T(1), hi)}));
+        assert(!Geometrix::intersect(Geometrix::Circle2D<T>{P(hi, hi), hi}, Geometrix::Rectangle2D<T>{P(lo, lo), P(T(-1), T(-1))}));
+    }
+
+    template<typename P>
+    static void batchOp()
+    {
+        using T = typename P::Type;
+        std::cout << "Compact point batches test, " << sizeof(T) * 8 << " bits" << std::endl;
+        constexpr T Max = std::numeric_limits<T>::max(), Min = std::numeric_limits<T>::lowest();
+        const P points[3] = {P(Max, Min), P(T(Max - 5), T(Min + 5)), P(T(10), T(-10))};
+        const P offset[3] = {P(T(1), T(-1)), P(T(10), T(-10)), P(T(10), T(-10))};
+        P result[3];
+        Geometrix::LA::add<Geometrix::LA::Overflow::Saturate>(points, offset, result, 3);
+        assert(result[0] == P(Max, Min) && result[1] == P(Max, Min) && result[2] == P(T(20), T(-20)));
+        Geometrix::LA::add(points, offset, result, 3);
+        assert(result[0] == P(Min, Max) && result[2] == P(T(20), T(-20)));
+        Geometrix::LA::sub<Geometrix::LA::Overflow::Saturate>(result, offset, result, 3);
+        assert(result[0] == P(Min, Max) && result[2] == points[2]);
+
+        Geometrix::LA::Vector2D<float> floats[3];
+        Geometrix::LA::convert(points, floats, 3);
+        assert(floats[2] == Geometrix::LA::Vector2D<float>(10.f, -10.f));
+        floats[2] = Geometrix::LA::Vector2D<float>(10.4f, -10.6f);
+        Geometrix::LA::convert(floats, result, 3);
+        assert(result[2] == P(T(10), T(-11)));
+        if constexpr (sizeof(T) == 2)
+            assert(result[0] == points[0] && result[1] == points[1]);
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        intersectOp<Geometrix::LA::Vector2D<T>>();
+        batchOp<Geometrix::LA::Vector2D<T>>();
+    }
+};
+
+class ConversionTester
+{
+    using Half = Geometrix::LA::Half;
+    using Rounding = Geometrix::LA::Rounding;
+
+    // number k of matrix, one-row matrices are indexed by element
+    template<typename M>
+    static auto &entry(M &m, std::size_t k)
+    {
+        if constexpr (M::Rows == 1)
+            return m[k];
+        else
+            return m[k / M::Columns][k % M::Columns];
+    }
+
+    static double wide(float f) { return f; }
+    static double wide(Half h) { return float(h); }
+    // infinity is taken for the power of two past the largest number by rounding to nearest
+    static double distanceValue(float f) { return std::isinf(f) ? std::copysign(0x1p128, f) : f; }
+    static double distanceValue(Half h) { return std::isinf(float(h)) ? std::copysign(65536., float(h)) : float(h); }
+    static bool even(float f) { return (std::bit_cast<std::uint32_t>(f) & 1) == 0; }
+    static bool even(Half h) { return (h.bits & 1) == 0; }
+    static bool same(float a, float b) { return std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b); }
+    static bool same(Half a, Half b) { return a == b; }
+    // the next number toward +infinity
+    static float next(float f) { return std::nextafter(f, std::numeric_limits<float>::infinity()); }
+    static Half next(Half h)
+    {
+        if (h.bits == 0x8000)
+            return Half::fromBits(1);
+        return Half::fromBits(std::uint16_t(h.bits & 0x8000 ? h.bits - 1 : h.bits + 1));
+    }
+
+    // down and up bracket w, the other modes pick one of them by IEEE 754 rules
+    template<typename N>
+    static void checkRounding(double w, [[maybe_unused]] N nearest, N down, N up, [[maybe_unused]] N towardZero)
+    {
+        if (std::isnan(w))
+        {
+            assert(std::isnan(wide(nearest)) && std::isnan(wide(down)) && std::isnan(wide(up)) && std::isnan(wide(towardZero)));
+            return;
+        }
+        assert(wide(down) <= w && w <= wide(up));
+        if (wide(down) == w)
+        {
+            assert(wide(up) == w && wide(nearest) == w && wide(towardZero) == w);
+            return;
+        }
+        assert(wide(next(down)) == wide(up));
+        assert(same(towardZero, w > 0 ? down : up));
+        [[maybe_unused]] const double below = w - distanceValue(down), above = distanceValue(up) - w;
+        assert(same(nearest, below < above ? down : above < below ? up : even(down) ? down : up));
+    }
+
+    // numbers of all magnitudes from exponent lowest to highest, specials and ties
+    template<typename T>
+    static std::vector<T> numbers(std::size_t count, int lowest, int highest, T tie)
+    {
+        const T special[] = {T(0), -T(0), T(1), T(-1), tie, -tie, std::numeric_limits<T>::infinity(),
+                             -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::quiet_NaN()};
+        std::vector<T> result(count);
+        std::uint64_t state = 12345;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            const T mantissa = T(1) + T(state >> 40) / T(1ull << 24) + T((state >> 12) & 0xfff) / T(1ull << 36);
+            const int exponent = lowest + int((state >> 20) % std::uint64_t(highest - lowest + 1));
+            result[i] = i < std::size(special) ? special[i] : std::ldexp(i % 2 ? -mantissa : mantissa, exponent);
+        }
+        return result;
+    }
+
+    template<typename V>
+    static void precisionOp(std::size_t count)
+    {
+        constexpr std::size_t N = std::size_t(V::Rows) * std::size_t(V::Columns);
+        std::cout << "Float and double bulk conversion test, " << V::Rows << "x" << V::Columns << ", with size " << count << std::endl;
+        using Wide = Geometrix::LA::Matrix<double, V::Rows, V::Columns>;
+        // exponents beyond float range give subnormals, zeros and infinities
+        const std::vector<double> values = numbers<double>(count * N, -160, 140, 1. + 0x1p-24);
+        std::vector<Wide> in(count);
+        std::vector<V> nearest(count + 1), down(count), up(count), towardZero(count);
+        for (std::size_t i = 0; i < count * N; ++i)
+            entry(in[i / N], i % N) = values[i];
+        entry(nearest[count], 0) = 7.f;
+
+        Geometrix::LA::convert(in.data(), nearest.data(), count);
+        Geometrix::LA::convert<Rounding::Down>(in.data(), down.data(), count);
+        Geometrix::LA::convert<Rounding::Up>(in.data(), up.data(), count);
+        Geometrix::LA::convert<Rounding::TowardZero>(in.data(), towardZero.data(), count);
+        for (std::size_t i = 0; i < count * N; ++i)
+            checkRounding(values[i], entry(nearest[i / N], i % N), entry(down[i / N], i % N), entry(up[i / N], i % N),
+                          entry(towardZero[i / N], i % N));
+        assert(entry(nearest[count], 0) == 7.f);
+
+        // widening is exact
+        std::vector<Wide> back(count);
+        Geometrix::LA::convert(nearest.data(), back.data(), count);
+        for (std::size_t i = 0; i < count * N; ++i)
+        {
+            [[maybe_unused]] const float f = entry(nearest[i / N], i % N);
+            assert(std::isnan(f) ? std::isnan(entry(back[i / N], i % N)) : entry(back[i / N], i % N) == double(f));
+        }
+    }
+
+    template<typename V>
+    static void halfOp(std::size_t count)
+    {
+        constexpr std::size_t N = std::size_t(V::Rows) * std::size_t(V::Columns);
+        std::cout << "Float and binary16 bulk conversion test, " << V::Rows << "x" << V::Columns << ", with size " << count << std::endl;
+        using Narrow = Geometrix::LA::Matrix<Half, V::Rows, V::Columns>;
+        // the largest number is 65504, the smallest subnormal 2^-24
+        const std::vector<float> values = numbers<float>(count * N, -30, 18, 1.f + 0x1p-11f);
+        std::vector<V> in(count);
+        std::vector<Narrow> nearest(count + 1), down(count), up(count), towardZero(count);
+        for (std::size_t i = 0; i < count * N; ++i)
+            entry(in[i / N], i % N) = values[i];
+        entry(nearest[count], 0) = Half::fromBits(7);
+
+        Geometrix::LA::convert(in.data(), nearest.data(), count);
+        Geometrix::LA::convert<Rounding::Down>(in.data(), down.data(), count);
+        Geometrix::LA::convert<Rounding::Up>(in.data(), up.data(), count);
+        Geometrix::LA::convert<Rounding::TowardZero>(in.data(), towardZero.data(), count);
+        for (std::size_t i = 0; i < count * N; ++i)
+        {
+            checkRounding(double(values[i]), entry(nearest[i / N], i % N), entry(down[i / N], i % N), entry(up[i / N], i % N),
+                          entry(towardZero[i / N], i % N));
+            assert(same(entry(nearest[i / N], i % N), Half(values[i])));
+        }
+        assert(entry(nearest[count], 0) == Half::fromBits(7));
+    }
+
+    // every binary16 number to float and back is exact in all modes
+    template<typename V>
+    static void halfBitsOp()
+    {
+        constexpr std::size_t N = std::size_t(V::Rows) * std::size_t(V::Columns);
+        std::cout << "Binary16 numbers round trip test, " << V::Rows << "x" << V::Columns << std::endl;
+        using Narrow = Geometrix::LA::Matrix<Half, V::Rows, V::Columns>;
+        const std::size_t count = (65536 + N - 1) / N;
+        std::vector<Narrow> in(count), back(count);
+        std::vector<V> floats(count);
+        for (std::size_t i = 0; i < count * N; ++i)
+            entry(in[i / N], i % N) = Half::fromBits(std::uint16_t(i));
+        Geometrix::LA::convert(in.data(), floats.data(), count);
+        for (std::size_t i = 0; i < count * N; ++i)
+        {
+            const std::uint16_t h = std::uint16_t(i), exponent = h >> 10 & 0x1f, mantissa = h & 0x3ff;
+            [[maybe_unused]] const float f = entry(floats[i / N], i % N);
+            if (exponent == 0x1f)
+                assert(mantissa ? std::bit_cast<std::uint32_t>(f) == ((h & 0x8000u) << 16 | 0x7fc00000u | mantissa << 13)
+                                : std::isinf(f));
+            else
+            {
+                [[maybe_unused]] const float e = exponent ? std::ldexp(float(mantissa | 0x400), exponent - 25) : std::ldexp(float(mantissa), -24);
+                assert(same(f, h & 0x8000 ? -e : e));
+            }
+            assert(same(float(Half::fromBits(h)), f));
+        }
+
+        // NaN stays quiet NaN with upper payload bits
+        const auto roundTrip = [&]() {
+            for (std::size_t i = 0; i < count * N; ++i)
+            {
+                [[maybe_unused]] const std::uint16_t h = std::uint16_t(i);
+                assert(entry(back[i / N], i % N).bits == ((h & 0x7fff) > 0x7c00 ? h | 0x200 : h));
+            }
+        };
+        Geometrix::LA::convert(floats.data(), back.data(), count);
+        roundTrip();
+        Geometrix::LA::convert<Rounding::Down>(floats.data(), back.data(), count);
+        roundTrip();
+        Geometrix::LA::convert<Rounding::Up>(floats.data(), back.data(), count);
+        roundTrip();
+        Geometrix::LA::convert<Rounding::TowardZero>(floats.data(), back.data(), count);
+        roundTrip();
+    }
+
+    static void vectorArrayOp(std::size_t count)
+    {
+        std::cout << "Vector array bulk conversion test, with size " << count << std::endl;
+        Geometrix::LA::VectorArray<double, 3> wide(count), back;
+        for (std::size_t i = 0; i < count; ++i)
+            wide[i] = Geometrix::LA::Vector<double, 3>(double(i) / 3., -double(i) / 7., 1e40);
+        Geometrix::LA::VectorArray<float, 3> nearest, down;
+        Geometrix::LA::convert(wide, nearest);
+        Geometrix::LA::convert<Rounding::Down>(wide, down);
+        assert(nearest.size() == count && down.size() == count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            [[maybe_unused]] const auto n = nearest.at(i), d = down.at(i);
+            assert(n[0] == float(double(i) / 3.) && n[1] == float(-double(i) / 7.) && std::isinf(n[2]));
+            assert(double(d[0]) <= double(i) / 3. && double(d[1]) <= -double(i) / 7. && d[2] == std::numeric_limits<float>::max());
+        }
+        Geometrix::LA::convert(nearest, back);
+        assert(back.size() == count && (count == 0 || back.at(count - 1)[0] == double(nearest.at(count - 1)[0])));
+    }
+
+public:
+    template <typename V>
+    static void test()
+    {
+        for (std::size_t count : {0, 1, 5, 37, 1000})
+        {
+            precisionOp<V>(count);
+            halfOp<V>(count);
+        }
+        halfBitsOp<V>();
+        vectorArrayOp(37);
+    }
+};
+
+class MatrixViewTester
+{
+    template<typename T>
+    struct Vertex
+    {
+        T position[3];
+        T normal[3];
+        T uv[2];
+    };
+
+    template<typename T>
+    static Geometrix::LA::Matrix<T, 4, 4> transform()
+    {
+        return Geometrix::LA::Matrix<T, 4, 4>{{T(0), T(-1), T(0), T(2)},
+                                              {T(1), T(0), T(0), T(-3)},
+                                              {T(0), T(0), T(2), T(0.5)},
+                                              {T(0), T(0), T(0), T(1)}};
+    }
+
+    template<typename T>
+    static void accessOp()
+    {
+        std::cout << "Strided view access test" << std::endl;
+        using namespace Geometrix::LA;
+        std::vector<Vertex<T>> vertices(5);
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                vertices[i].position[k] = T(i * 3 + k);
+                vertices[i].normal[k] = T(k == 2);
+            }
+        const VectorView<T, 3> positions(vertices[0].position, vertices.size(), sizeof(Vertex<T>));
+        const VectorView<T, 3, sizeof(Vertex<T>)> normals(vertices[0].normal, vertices.size());
+        assert(positions.size() == 5 && positions.stride() == sizeof(Vertex<T>) && !positions.packed());
+        assert(positions[1] == Vector3D<T>(T(3), T(4), T(5)));
+        assert(normals.at(4) == Vector3D<T>(T(0), T(0), T(1)));
+
+        positions[1] = Vector3D<T>(T(7), T(8), T(9));
+        positions[2] += Vector3D<T>(T(1));
+        positions[3] *= T(2);
+        positions[4][1] = T(-1);
+        assert(vertices[1].position[0] == T(7) && vertices[1].position[2] == T(9));
+        assert(vertices[2].position[0] == T(7) && vertices[3].position[2] == T(22));
+        assert(vertices[4].position[1] == T(-1) && vertices[4].normal[0] == T(0));
+
+        const VectorView<const T, 3> readOnly = positions;
+        assert(readOnly[3] == Vector3D<T>(T(18), T(20), T(22)));
+        [[maybe_unused]] const auto tail = readOnly.subview(3, 2);
+        assert(tail.size() == 2 && tail[0] == readOnly[3] && tail[1] == readOnly[4]);
+
+        Vector3D<T> packed[5];
+        readOnly.store(packed);
+        const VectorView<T, 3> packedView(packed, 5);
+        assert(packedView.packed() && packedView[1] == Vector3D<T>(T(7), T(8), T(9)));
+        copy(normals, packedView);
+        assert(packed[0] == Vector3D<T>(T(0), T(0), T(1)));
+
+        // matrices of 9 numbers, one number apart
+        T numbers[4 * 10];
+        for (std::size_t i = 0; i < std::size(numbers); ++i)
+            numbers[i] = T(i);
+        const MatrixView<T, 3, 3, 10 * sizeof(T)> matrices(numbers, 4);
+        [[maybe_unused]] const Matrix<T, 3, 3> m = matrices[2];
+        assert(m[0][0] == T(20) && m[1][2] == T(25) && m[2][2] == T(28));
+        assert(matrices[2](2, 1) == T(27));
+        matrices[1] = Matrix<T, 3, 3>(T(-1));
+        assert(numbers[10] == T(-1) && numbers[18] == T(-1) && numbers[19] == T(19) && numbers[20] == T(20));
+    }
+
+    template<typename T>
+    static void transformOp(std::size_t count)
+    {
+        std::cout << "Strided view transform test, with size " << count << std::endl;
+        using namespace Geometrix::LA;
+        const auto m = transform<T>();
+        // one spare vertex, so even empty views point into the array
+        std::vector<Vertex<T>> vertices(count + 1);
+        std::vector<Vector3D<T>> positions(count), normals(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                vertices[i].position[k] = positions[i][k] = T(int(i * 3 + k) % 17 - 8);
+                vertices[i].normal[k] = normals[i][k] = T(int(i + k) % 5 - 2);
+                vertices[i].uv[k % 2] = T(0.25);
+            }
+        transformPoints(m, positions.data(), positions.data(), count);
+        transformDirections(m, normals.data(), normals.data(), count);
+
+        // in place
+        const VectorView<T, 3> p(vertices.data()->position, count, sizeof(Vertex<T>));
+        const VectorView<T, 3, sizeof(Vertex<T>)> n(vertices.data()->normal, count);
+        transformPoints(m, p, p);
+        transformDirections(m, VectorView<const T, 3, sizeof(Vertex<T>)>(n), n);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(p[i] == positions[i] && n[i] == normals[i]);
+            assert(vertices[i].uv[0] == T(0.25) && vertices[i].uv[1] == T(0.25));
+        }
+
+        // strided to packed and back
+        std::vector<Vector3D<T>> packed(count);
+        transformPoints(m, VectorView<const T, 3>(p), VectorView<T, 3>(packed.data(), count));
+        transformPoints(m, positions.data(), positions.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(packed[i] == positions[i]);
+        transformPointsProjective(m, VectorView<T, 3>(packed.data(), count), p);
+        transformPoints(m, positions.data(), positions.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(p[i] == positions[i]);
+    }
+
+    // integer batches run block by block
+    static void blockOp(std::size_t count)
+    {
+        std::cout << "Strided view block test, with size " << count << std::endl;
+        using namespace Geometrix::LA;
+        std::vector<Vertex<float>> vertices(count + 1);
+        std::vector<Vector2D<std::int16_t>> quantized(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            vertices[i].uv[0] = float(i) * 0.5f;
+            vertices[i].uv[1] = -float(i);
+        }
+        const VectorView<const float, 2> uv(vertices.data()->uv, count, sizeof(Vertex<float>));
+        forEachBlock(uv, VectorView<std::int16_t, 2>(quantized.data(), count),
+                     [](const Vector2D<float> *in, Vector2D<std::int16_t> *out, std::size_t n) { convert(in, out, n); });
+        for (std::size_t i = 0; i < count; ++i)
+            assert(quantized[i] == Vector2D<std::int16_t>(std::int16_t(std::nearbyint(float(i) * 0.5f)),
+                                                          std::int16_t(-std::int16_t(i))));
+
+        // strided in and out
+        std::vector<Vector4D<std::int16_t>> shorts(count + 1);
+        const VectorView<std::int16_t, 2, sizeof(Vector4D<std::int16_t>)> lows(&shorts.data()->operator[](0), count);
+        const VectorView<std::int16_t, 2> highs(&shorts.data()->operator[](0) + 2, count, sizeof(Vector4D<std::int16_t>));
+        forEachBlock(VectorView<const std::int16_t, 2>(quantized.data(), count), lows,
+                     [](const Vector2D<std::int16_t> *in, Vector2D<std::int16_t> *out, std::size_t n) {
+                         add<Overflow::Saturate>(in, std::int16_t(30000), out, n);
+                     });
+        copy(VectorView<const std::int16_t, 2>(quantized.data(), count), highs);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            assert(shorts[i][0] == std::min(30000 + quantized[i][0], 32767));
+            assert(shorts[i][1] == 30000 + quantized[i][1]);
+            assert(shorts[i][2] == quantized[i][0] && shorts[i][3] == quantized[i][1]);
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        accessOp<T>();
+        for (std::size_t count : {0, 1, 7, 1000})
+            transformOp<T>(count);
+        if constexpr (std::is_same_v<T, float>)
+            for (std::size_t count : {0, 5, 1000})
+                blockOp(count);
+    }
+};
+
+class QuaternionTester
+{
+    template<typename T>
+    static bool near(const Geometrix::LA::Quaternion<T> &a, const Geometrix::LA::Quaternion<T> &b)
+    {
+        return approxEqual(a.x(), b.x()) && approxEqual(a.y(), b.y()) && approxEqual(a.z(), b.z()) && approxEqual(a.w(), b.w());
+    }
+
+    template<typename T, std::size_t Dim>
+    static bool near(const Geometrix::LA::Matrix<T, Dim, Dim> &a, const Geometrix::LA::Matrix<T, Dim, Dim> &b)
+    {
+        for (std::size_t i = 0; i < Dim; ++i)
+            for (std::size_t j = 0; j < Dim; ++j)
+                if (!approxEqual(a[i][j], b[i][j]))
+                    return false;
+        return true;
+    }
+
+    template<typename T>
+    static bool near(const Geometrix::LA::Vector3D<T> &a, const Geometrix::LA::Vector3D<T> &b)
+    {
+        return approxEqual(a.x(), b.x()) && approxEqual(a.y(), b.y()) && approxEqual(a.z(), b.z());
+    }
+
+    // unit quaternions of varied axes and angles, including half turns
+    template<typename T>
+    static std::vector<Geometrix::LA::Quaternion<T>> sequence(std::size_t count, T shift)
+    {
+        std::vector<Geometrix::LA::Quaternion<T>> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Geometrix::LA::Vector3D<T> axis(T(i % 3) - T(1) + shift, T(i % 5) / T(2), T(1) - T(i % 7) / T(3));
+            axis.unit();
+            const T angle = i % 4 == 0 ? T(3.14159265358979) : T(i) * T(0.7) + shift;
+            result.push_back(Geometrix::LA::Quaternion<T>::axisAngle(axis, angle));
+        }
+        return result;
+    }
+
+    template<typename T>
+    static void algebraOp()
+    {
+        std::cout << "Quaternion algebra test" << std::endl;
+        const auto qs = sequence<T>(16, T(0.25));
+        const auto rs = sequence<T>(16, T(-0.5));
+        const Geometrix::LA::Vector3D<T> v(T(1), T(-2), T(0.5));
+        for (std::size_t i = 0; i < qs.size(); ++i)
+        {
+            const auto &q = qs[i];
+            [[maybe_unused]] const auto &r = rs[i];
+            assert(approxEqual(q.length(), T(1)));
+            // product composes rotations
+            assert(near((q * r).matrix3(), Geometrix::LA::dot(q.matrix3(), r.matrix3())));
+            assert(near((q * r).rotate(v), q.rotate(r.rotate(v))));
+            assert(near(q * q.inverse(), Geometrix::LA::Quaternion<T>()));
+            assert(near(q.conjugate().rotate(q.rotate(v)), v));
+
+            // rotation agrees with matrix, conversion round trip is exact up to sign
+            const auto m = q.matrix3();
+            const Geometrix::LA::Vector3D<T> expected(Geometrix::LA::dot(m[0], v), Geometrix::LA::dot(m[1], v),
+                                                      Geometrix::LA::dot(m[2], v));
+            assert(near(q.rotate(v), expected));
+            const Geometrix::LA::Quaternion<T> back(m), back4(q.matrix4());
+            assert((near(back, q) || near(-back, q)));
+            assert(back == back4);
+        }
+        [[maybe_unused]] const auto quarter = Geometrix::LA::Quaternion<T>::axisAngle({T(0), T(0), T(1)}, T(1.57079632679490));
+        assert(near(quarter.rotate({T(1), T(0), T(0)}), Geometrix::LA::Vector3D<T>(T(0), T(1), T(0))));
+    }
+
+    template<typename T>
+    static void interpolationOp(std::size_t count)
+    {
+        std::cout << "Quaternion interpolation test, with count " << count << std::endl;
+        const auto a = sequence<T>(count, T(0.25));
+        auto b = sequence<T>(count, T(-0.5));
+        b[0] = -a[0]; // same rotation, opposite sign
+        std::vector<T> t(count);
+        for (std::size_t i = 0; i < count; ++i)
+            t[i] = T(i % 11) / T(10);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            [[maybe_unused]] const auto s = Geometrix::LA::slerp(a[i], b[i], t[i]);
+            assert(approxEqual(s.length(), T(1)));
+            assert(near(Geometrix::LA::slerp(a[i], b[i], T(0)), a[i]));
+            assert((near(Geometrix::LA::slerp(a[i], b[i], T(1)), b[i]) || near(-Geometrix::LA::slerp(a[i], b[i], T(1)), b[i])));
+            // nlerp goes along the same arc
+            [[maybe_unused]] const auto n = Geometrix::LA::nlerp(a[i], b[i], T(0.5));
+            assert(near(n, Geometrix::LA::slerp(a[i], b[i], T(0.5))));
+        }
+        // half of rotation around one axis
+        const Geometrix::LA::Vector3D<T> axis(T(0), T(1), T(0));
+        [[maybe_unused]] const auto half = Geometrix::LA::slerp(Geometrix::LA::Quaternion<T>(),
+                                               Geometrix::LA::Quaternion<T>::axisAngle(axis, T(2)), T(0.25));
+        assert(near(half, Geometrix::LA::Quaternion<T>::axisAngle(axis, T(0.5))));
+
+        std::vector<Geometrix::LA::Quaternion<T>> out(count);
+        Geometrix::LA::slerp(a.data(), b.data(), t.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], Geometrix::LA::slerp(a[i], b[i], t[i])));
+        Geometrix::LA::slerp(a.data(), b.data(), T(0.3), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], Geometrix::LA::slerp(a[i], b[i], T(0.3))));
+        // in place
+        out = a;
+        Geometrix::LA::slerp(out.data(), b.data(), t.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], Geometrix::LA::slerp(a[i], b[i], t[i])));
+    }
+
+    template<typename T>
+    static void rotationOp(std::size_t count)
+    {
+        std::cout << "Quaternion batch rotation test, with count " << count << std::endl;
+        const auto q = sequence<T>(3, T(0.1))[2];
+        std::vector<Geometrix::LA::Vector3D<T>> in(count), out(count);
+        for (std::size_t i = 0; i < count; ++i)
+            in[i] = Geometrix::LA::Vector3D<T>(T(i % 13) / T(4), T(1) - T(i % 3), T(i % 5));
+
+        Geometrix::LA::rotate(q, in.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], q.rotate(in[i])));
+
+        const Geometrix::LA::VectorArray<T, 3> soa(in);
+        Geometrix::LA::VectorArray<T, 3> soaOut;
+        Geometrix::LA::rotate(q, soa, soaOut);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(soaOut.at(i), q.rotate(in[i])));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        algebraOp<T>();
+        for (std::size_t count : {1, 3, 4, 9, 37})
+        {
+            interpolationOp<T>(count);
+            rotationOp<T>(count);
+        }
+    }
+};
+
+class AffineTester
+{
+    template<typename T>
+    static bool near(const Geometrix::LA::Matrix<T, 4, 4> &a, const Geometrix::LA::Matrix<T, 4, 4> &b)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+            for (std::size_t j = 0; j < 4; ++j)
+                if (!approxEqual(a[i][j], b[i][j]))
+                    return false;
+        return true;
+    }
+
+    template<typename T>
+    static bool near(const Geometrix::LA::Vector3D<T> &a, const Geometrix::LA::Vector3D<T> &b)
+    {
+        return approxEqual(a.x(), b.x()) && approxEqual(a.y(), b.y()) && approxEqual(a.z(), b.z());
+    }
+
+    // invertible, with rotation, scale, shear and translation
+    template<typename T>
+    static std::vector<Geometrix::LA::Affine<T>> sequence(std::size_t count, T shift)
+    {
+        std::vector<Geometrix::LA::Affine<T>> result(count);
+        for (std::size_t n = 0; n < count; ++n)
+            for (std::size_t i = 0; i < 3; ++i)
+                for (std::size_t j = 0; j < 4; ++j)
+                    result[n][i][j] = i == j ? T(3) + T(n % 4) : shift + T((n + i * 4 + j) % 5) / T(2);
+        return result;
+    }
+
+    // reference product of points with 4x4 matrix
+    template<typename T>
+    static Geometrix::LA::Vector3D<T> apply(const Geometrix::LA::Matrix<T, 4, 4> &m, const Geometrix::LA::Vector3D<T> &v, T w)
+    {
+        const Geometrix::LA::Vector4D<T> h(v.x(), v.y(), v.z(), w);
+        return Geometrix::LA::Vector3D<T>(Geometrix::LA::dot(m[0], h), Geometrix::LA::dot(m[1], h), Geometrix::LA::dot(m[2], h));
+    }
+
+    template<typename T>
+    static void singleOp()
+    {
+        std::cout << "Affine transform test" << std::endl;
+        static_assert(sizeof(Geometrix::LA::Affine<T>) == 12 * sizeof(T));
+        static_assert(!std::is_convertible_v<Geometrix::LA::Matrix<T, 3, 3>, Geometrix::LA::Affine<T>>);
+        static_assert(!std::is_convertible_v<Geometrix::LA::Quaternion<T>, Geometrix::LA::Affine<T>>);
+        const auto as = sequence<T>(8, T(0.5));
+        const auto bs = sequence<T>(8, T(-1));
+        const Geometrix::LA::Vector3D<T> v(T(1), T(-2), T(0.5));
+        Geometrix::LA::Matrix<T, 4, 4> identity(T(0));
+        for (std::size_t i = 0; i < 4; ++i)
+            identity[i][i] = T(1);
+        assert(Geometrix::LA::Affine<T>().matrix4() == identity);
+
+        for (std::size_t n = 0; n < as.size(); ++n)
+        {
+            const auto &a = as[n];
+            [[maybe_unused]] const auto &b = bs[n];
+            [[maybe_unused]] const auto m = a.matrix4();
+            assert(Geometrix::LA::Affine<T>(m) == a);
+            assert(Geometrix::LA::Affine<T>(a.linear(), a.translation()) == a);
+            assert(near((a * b).matrix4(), Geometrix::LA::dot(m, b.matrix4())));
+            assert(near(a.transformPoint(v), apply(m, v, T(1))));
+            assert(near(a.transformDirection(v), apply(m, v, T(0))));
+
+            bool correct = false;
+            [[maybe_unused]] const auto inverse = Geometrix::LA::invert(a, &correct);
+            assert(correct);
+            assert(near((a * inverse).matrix4(), identity));
+            assert(near(inverse.matrix4(), Geometrix::LA::invert(m)));
+
+            // aliasing
+            auto c = a;
+            c *= c;
+            assert(near(c.matrix4(), Geometrix::LA::dot(m, m)));
+        }
+
+        const auto q = Geometrix::LA::Quaternion<T>::axisAngle({T(0.6), T(0), T(0.8)}, T(1.2));
+        const Geometrix::LA::Affine<T> rigid(q, Geometrix::LA::Vector3D<T>(T(1), T(2), T(3)));
+        assert(near(rigid.transformPoint(v), q.rotate(v) + Geometrix::LA::Vector3D<T>(T(1), T(2), T(3))));
+        assert(near(Geometrix::LA::invertRigid(rigid).matrix4(), Geometrix::LA::invert(rigid).matrix4()));
+
+        bool correct = true;
+        Geometrix::LA::Matrix<T, 3, 3> singular(T(1));
+        Geometrix::LA::invert(Geometrix::LA::Affine<T>(singular), &correct);
+        assert(!correct);
+        // translation must not leak into determinant
+        correct = true;
+        Geometrix::LA::invert(Geometrix::LA::Affine<T>(singular, Geometrix::LA::Vector3D<T>(T(1), T(1.37), T(0.71))), &correct);
+        assert(!correct);
+
+        // far from origin, small determinant
+        Geometrix::LA::Matrix<T, 3, 3> linear;
+        const T elements[3][3] = {{T(1.2), T(0.3), T(-0.4)}, {T(0.5), T(0.9), T(0.1)}, {T(-0.2), T(0.6), T(0.4)}};
+        for (std::size_t i = 0; i < 3; ++i)
+            for (std::size_t j = 0; j < 3; ++j)
+                linear[i][j] = elements[i][j];
+        const Geometrix::LA::Affine<T> far(linear, Geometrix::LA::Vector3D<T>(T(123456), T(-98765), T(54321)));
+        correct = false;
+        [[maybe_unused]] const auto farInverse = Geometrix::LA::invert(far, &correct);
+        assert(correct);
+        assert(near(farInverse.matrix4(), Geometrix::LA::invert(far.matrix4())));
+    }
+
+    template<typename T>
+    static void batchOp(std::size_t count)
+    {
+        std::cout << "Affine batch test, with count " << count << std::endl;
+        const auto a = sequence<T>(count, T(0.5));
+        const auto b = sequence<T>(count, T(-1));
+        std::vector<Geometrix::LA::Affine<T>> composed(count);
+        Geometrix::LA::compose(a.data(), b.data(), composed.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(composed[i].matrix4(), (a[i] * b[i]).matrix4()));
+
+        std::vector<Geometrix::LA::Vector3D<T>> in(count), out(count);
+        for (std::size_t i = 0; i < count; ++i)
+            in[i] = Geometrix::LA::Vector3D<T>(T(i % 7), T(1) - T(i % 3), T(i % 5) / T(2));
+        Geometrix::LA::transformPoints(a[0], in.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], a[0].transformPoint(in[i])));
+        Geometrix::LA::transformDirections(a[0], in.data(), out.data(), count);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(out[i], a[0].transformDirection(in[i])));
+
+        const Geometrix::LA::VectorArray<T, 3> soa(in);
+        Geometrix::LA::VectorArray<T, 3> soaOut;
+        Geometrix::LA::transformPoints(a[0], soa, soaOut);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(soaOut.at(i), a[0].transformPoint(in[i])));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        singleOp<T>();
+        for (std::size_t count : {1, 5, 33})
+            batchOp<T>(count);
+    }
+};
+
+class SkinningTester
+{
+    template<typename T>
+    static bool near(const Geometrix::LA::Vector3D<T> &a, const Geometrix::LA::Vector3D<T> &b)
+    {
+        return approxEqual(a.x(), b.x()) && approxEqual(a.y(), b.y()) && approxEqual(a.z(), b.z());
+    }
+
+    // rigid bones of varied axes, angles and translations
+    template<typename T>
+    static std::vector<Geometrix::LA::DualQuaternion<T>> bones(std::size_t count)
+    {
+        std::vector<Geometrix::LA::DualQuaternion<T>> result;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            Geometrix::LA::Vector3D<T> axis(T(i % 3) - T(0.5), T(1), T(i % 4) / T(3));
+            axis.unit();
+            const auto rotation = Geometrix::LA::Quaternion<T>::axisAngle(axis, T(i) * T(0.4) - T(1));
+            result.emplace_back(rotation, Geometrix::LA::Vector3D<T>(T(i), T(1) - T(i % 2), T(i) / T(4)));
+        }
+        return result;
+    }
+
+    template<typename T>
+    static void dualQuaternionOp()
+    {
+        std::cout << "Dual quaternion test" << std::endl;
+        static_assert(sizeof(Geometrix::LA::DualQuaternion<T>) == 8 * sizeof(T));
+        const auto dqs = bones<T>(8);
+        const Geometrix::LA::Vector3D<T> v(T(1), T(-2), T(0.5));
+        assert(near(Geometrix::LA::DualQuaternion<T>().transformPoint(v), v));
+        for (std::size_t i = 0; i + 1 < dqs.size(); ++i)
+        {
+            const auto &a = dqs[i];
+            [[maybe_unused]] const auto &b = dqs[i + 1];
+            [[maybe_unused]] const auto affine = a.affine();
+            assert(near(a.transformPoint(v), affine.transformPoint(v)));
+            assert(near(a.transformDirection(v), affine.transformDirection(v)));
+            assert(near(Geometrix::LA::DualQuaternion<T>(affine).transformPoint(v), a.transformPoint(v)));
+            assert(near(a.translation(), affine.translation()));
+            // composition and inverse agree with affine transforms
+            assert(near((a * b).transformPoint(v), a.transformPoint(b.transformPoint(v))));
+            assert(near((a * b).transformPoint(v), (affine * b.affine()).transformPoint(v)));
+            assert(near(a.conjugate().transformPoint(a.transformPoint(v)), v));
+        }
+    }
+
+    // up to 4 influences of 7 bones, weights sum to 1, every 4th vertex has single bone
+    template<typename T>
+    static Geometrix::LA::SkinInfluences<T> influences(std::size_t count)
+    {
+        Geometrix::LA::SkinInfluences<T> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::int32_t bones[4] = {std::int32_t(i % 7), std::int32_t((i + 3) % 7),
+                                           std::int32_t((i * 5 + 1) % 7), std::int32_t((i + 6) % 7)};
+            T weights[4] = {T(1), T(0), T(0), T(0)};
+            if (i % 4)
+            {
+                weights[0] = T(0.4) + T(i % 3) / T(10);
+                weights[1] = T(0.3);
+                weights[2] = T(1) - weights[0] - weights[1] - (i % 2 ? T(0.1) : T(0));
+                weights[3] = T(1) - weights[0] - weights[1] - weights[2];
+            }
+            result.set(i, bones, weights);
+        }
+        return result;
+    }
+
+    template<typename T>
+    static void skinOp(std::size_t count, unsigned threads)
+    {
+        std::cout << "Skinning test, with count " << count << " and " << threads << " threads" << std::endl;
+        const auto dqs = bones<T>(7);
+        std::vector<Geometrix::LA::Affine<T>> matrices;
+        for (const auto &dq : dqs)
+            matrices.push_back(dq.affine());
+        const auto weights = influences<T>(count);
+        assert(weights.valid(dqs.size()));
+        assert(!weights.valid(5));
+
+        Geometrix::LA::VectorArray<T, 3> positions(count), normals(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            positions[i] = Geometrix::LA::Vector3D<T>(T(i % 11) / T(4), T(1) - T(i % 5), T(i % 3));
+            Geometrix::LA::Vector3D<T> n(T(i % 2), T(1), T(i % 7) / T(7));
+            normals[i] = n.unit();
+        }
+
+        Geometrix::LA::VectorArray<T, 3> linear, linearNormals, dual, dualNormals;
+        Geometrix::LA::skinLinear(matrices.data(), matrices.size(), weights, positions, normals, linear, linearNormals, threads);
+        Geometrix::LA::skinDualQuaternion(dqs.data(), dqs.size(), weights, positions, normals, dual, dualNormals, threads);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // reference blends through operators
+            Geometrix::LA::Affine<T> m(Geometrix::LA::Matrix<T, 3, 3>(T(0)));
+            Geometrix::LA::DualQuaternion<T> dq(Geometrix::LA::Quaternion<T>(T(0), T(0), T(0), T(0)),
+                                                Geometrix::LA::Quaternion<T>(T(0), T(0), T(0), T(0)));
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                const std::int32_t bone = weights.bones().stream(k)[i];
+                const T w = weights.weights().stream(k)[i];
+                for (std::size_t r = 0; r < 3; ++r)
+                    m[r] += matrices[bone][r] * w;
+                const auto &pivot = dqs[weights.bones().stream(0)[i]];
+                dq += dqs[bone] * (Geometrix::LA::dot(pivot.real(), dqs[bone].real()) < T(0) ? -w : w);
+            }
+            dq.unit();
+            [[maybe_unused]] const Geometrix::LA::Vector3D<T> p = positions[i], n = normals[i];
+            assert(near(Geometrix::LA::Vector3D<T>(linear[i]), m.transformPoint(p)));
+            assert(near(Geometrix::LA::Vector3D<T>(linearNormals[i]), m.transformDirection(n)));
+            assert(near(Geometrix::LA::Vector3D<T>(dual[i]), dq.transformPoint(p)));
+            assert(near(Geometrix::LA::Vector3D<T>(dualNormals[i]), dq.transformDirection(n)));
+            // both methods agree for single bone
+            if (i % 4 == 0)
+                assert(near(Geometrix::LA::Vector3D<T>(dual[i]), Geometrix::LA::Vector3D<T>(linear[i])));
+        }
+
+        // aliasing
+        auto inPlace = positions;
+        Geometrix::LA::skinDualQuaternion(dqs.data(), dqs.size(), weights, inPlace, inPlace, threads);
+        for (std::size_t i = 0; i < count; ++i)
+            assert(near(Geometrix::LA::Vector3D<T>(inPlace[i]), Geometrix::LA::Vector3D<T>(dual[i])));
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        dualQuaternionOp<T>();
+        skinOp<T>(1, 1);
+        skinOp<T>(37, 1);
+        skinOp<T>(20011, 4);
+    }
+};
+
+
+class ReductionTester
+{
+    // small integers, so every sum is exact
+    template<typename T, std::size_t Dim>
+    static std::vector<Geometrix::LA::Vector<T, Dim>> sequence(std::size_t count)
+    {
+        std::vector<Geometrix::LA::Vector<T, Dim>> result(count);
+        for (std::size_t i = 0; i < count; ++i)
+            for (std::size_t k = 0; k < Dim; ++k)
+                result[i][k] = T(int((i * 7 + k * 3) % 23) - 11);
+        return result;
+    }
+
+    template<typename T, std::size_t Dim>
+    static void sumOp(std::size_t count)
+    {
+        std::cout << "Vector array reduction test, with dimension " << Dim << " and size " << count << std::endl;
+        using namespace Geometrix::LA;
+        const auto aos = sequence<T, Dim>(count);
+        const VectorArray<T, Dim> soa(aos);
+        Vector<T, Dim> expected(T(0)), low(T(0)), high(T(0));
+        for (std::size_t k = 0; k < Dim; ++k)
+        {
+            low[k] = count ? std::numeric_limits<T>::max() : std::numeric_limits<T>::infinity();
+            high[k] = count ? std::numeric_limits<T>::lowest() : -std::numeric_limits<T>::infinity();
+        }
+        for (const auto &v : aos)
+            for (std::size_t k = 0; k < Dim; ++k)
+            {
+                expected[k] += v[k];
+                low[k] = std::min(low[k], v[k]);
+                high[k] = std::max(high[k], v[k]);
+            }
+
+        assert(sum(aos.data(), count) == expected);
+        assert(sum<Summation::Compensated>(aos.data(), count) == expected);
+        assert(sum(soa) == expected);
+        assert(sum<Summation::Compensated>(soa) == expected);
+        // blocks are added in the same order by any thread count
+        assert(sum(aos.data(), count, 1) == expected && sum(soa, 3) == expected);
+
+        [[maybe_unused]] const auto box = bounds(aos.data(), count), soaBox = bounds(soa, 2);
+        assert(box.min == low && box.max == high && soaBox.min == low && soaBox.max == high);
+        assert(box.empty() == !count);
+        if (!count)
+            return;
+
+        const auto m = mean(aos.data(), count);
+        for (std::size_t k = 0; k < Dim; ++k)
+            assert(m[k] == expected[k] / T(count));
+        assert(mean(soa) == m && centroid(aos.data(), count) == m && centroid(soa) == m);
+
+        if constexpr (Dim >= 2)
+        {
+            long double reference[Dim][Dim] = {};
+            for (const auto &v : aos)
+                for (std::size_t r = 0; r < Dim; ++r)
+                    for (std::size_t c = 0; c < Dim; ++c)
+                        reference[r][c] += (v[r] - (long double)(m[r])) * (v[c] - (long double)(m[c]));
+            const auto cov = covariance(aos.data(), count), soaCov = covariance(soa);
+            for (std::size_t r = 0; r < Dim; ++r)
+                for (std::size_t c = 0; c < Dim; ++c)
+                {
+                    assert(cov[r][c] == cov[c][r]);
+                    assert(approxEqual<long double>(cov[r][c], reference[r][c] / count, T(1e-4)));
+                    assert(approxEqual<long double>(soaCov[r][c], reference[r][c] / count, T(1e-4)));
+                }
+        }
+    }
+
+    template<typename T>
+    static void precisionOp()
+    {
+        std::cout << "Compensated reduction test" << std::endl;
+        using namespace Geometrix::LA;
+        // points far from origin, which differ by less than their sum keeps
+        constexpr std::size_t count = 3 * 4096 + 5;
+        const T origin = std::is_same_v<T, float> ? T(3e4) : T(3e12);
+        std::vector<Vector3D<T>> points(count);
+        long double reference[3] = {};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            points[i] = Vector3D<T>(origin + T(0.125) * T(i % 5), origin - T(i % 3) / T(3), T(i % 11) / T(7));
+            for (std::size_t k = 0; k < 3; ++k)
+                reference[k] += points[i][k];
+        }
+        const VectorArray<T, 3> soa(points);
+        [[maybe_unused]] const auto c = centroid(points.data(), count), soaC = centroid(soa);
+        [[maybe_unused]] const auto s = sum<Summation::Compensated>(points.data(), count);
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            // compensated sum is the correctly rounded one or its neighbour
+            [[maybe_unused]] const T rounded = static_cast<T>(reference[k]);
+            assert(s[k] == rounded || s[k] == std::nextafter(rounded, s[k]));
+            assert(approxEqual<long double>(c[k], reference[k] / count, std::numeric_limits<T>::epsilon()));
+            assert(approxEqual<long double>(soaC[k], reference[k] / count, std::numeric_limits<T>::epsilon()));
+        }
+    }
+
+    template<typename T>
+    static void nanOp()
+    {
+        std::cout << "Bounds with NaN test" << std::endl;
+        using namespace Geometrix::LA;
+        const T nan = std::numeric_limits<T>::quiet_NaN();
+        for (std::size_t count : {1, 3, 29, 100})
+        {
+            auto points = sequence<T, 4>(count);
+            for (std::size_t i = 0; i < count; i += 2)
+                points[i][1] = nan;
+            for (auto &p : points)
+                p[3] = nan;
+            points[count - 1][0] = T(100);
+            [[maybe_unused]] const auto box = bounds(points.data(), count), soaBox = bounds(VectorArray<T, 4>(points));
+            assert(box.max[0] == T(100) && soaBox.max[0] == T(100));
+            assert(box.min[3] == std::numeric_limits<T>::infinity() && box.max[3] == -std::numeric_limits<T>::infinity());
+            assert(soaBox.min[3] == box.min[3] && soaBox.max[3] == box.max[3]);
+            assert(!std::isnan(box.min[1]) && soaBox.min[1] == box.min[1] && soaBox.max[1] == box.max[1]);
+            assert(count > 1 || box.min[1] == std::numeric_limits<T>::infinity());
+        }
+    }
+
+public:
+    template <typename T>
+    static void test()
+    {
+        for (std::size_t count : {0, 1, 7, 64, 100, 4099, 5 * 4096 + 13, 21 * 4096})
+        {
+            sumOp<T, 2>(count);
+            sumOp<T, 3>(count);
+            sumOp<T, 4>(count);
+        }
+        precisionOp<T>();
+        nanOp<T>();
+    }
+};
 
 int main()
 {
     std::cout << std::endl << "Running matrix tests" << std::endl;
     TestGenerator<MatrixOperatorTester, short, int, long, long long, float, double>::test();
+    TestGenerator<MatrixProductTester, int, float, double>::test();
+    TestGenerator<MatrixLayoutTester, int, float, double>::test();
+    TestGenerator<MatrixTransposeTester, int, float, double>::test();
+    TestGenerator<MatrixInverseTester, float, double>::test();
+    TestGenerator<MatrixDecompositionTester, float, double>::test();
+    TestGenerator<MatrixExpressionTester, int, float, double>::test();
+    TestGenerator<VectorArrayTester, float, double>::test();
+    TestGenerator<FusedVectorTester, int, float, double>::test();
+    TestGenerator<TransformTester, float, double>::test();
+    TestGenerator<MatrixArrayTester, float, double>::test();
+    TestGenerator<EigenDecompositionTester, float, double>::test();
+    TestGenerator<LinearSolverTester, float, double>::test();
+    TestGenerator<DynamicMatrixTester, float, double>::test();
+    TestGenerator<PaddedVectorTester, float, double>::test();
+    TestGenerator<IntegerMatrixTester, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t, long long>::test();
+    TestGenerator<CompactPointTester, std::int16_t, std::int32_t>::test();
+    TestGenerator<ConversionTester, Geometrix::LA::Vector3D<float>, Geometrix::LA::Vector4D<float>, Geometrix::LA::Matrix<float, 3, 3>,
+                  Geometrix::LA::Matrix<float, 4, 4>>::test();
+    TestGenerator<MatrixViewTester, float, double>::test();
+    TestGenerator<QuaternionTester, float, double>::test();
+    TestGenerator<AffineTester, float, double>::test();
+    TestGenerator<SkinningTester, float, double>::test();
+    TestGenerator<ReductionTester, float, double>::test();
     // test with optimizations enabled
     Geometrix::Optimizer::init();
     std::cout << std::endl << "Running matrix tests with optimizations enabled" << std::endl;
 
     TestGenerator<MatrixOperatorTester, short, int, long, long long, float, double>::test();
+    TestGenerator<MatrixProductTester, int, float, double>::test();
+    TestGenerator<MatrixLayoutTester, int, float, double>::test();
+    TestGenerator<MatrixTransposeTester, int, float, double>::test();
+    TestGenerator<MatrixInverseTester, float, double>::test();
+    TestGenerator<MatrixDecompositionTester, float, double>::test();
+    TestGenerator<MatrixExpressionTester, int, float, double>::test();
+    TestGenerator<VectorArrayTester, float, double>::test();
+    TestGenerator<FusedVectorTester, int, float, double>::test();
+    TestGenerator<TransformTester, float, double>::test();
+    TestGenerator<MatrixArrayTester, float, double>::test();
+    TestGenerator<EigenDecompositionTester, float, double>::test();
+    TestGenerator<LinearSolverTester, float, double>::test();
+    TestGenerator<DynamicMatrixTester, float, double>::test();
+    TestGenerator<PaddedVectorTester, float, double>::test();
+    TestGenerator<IntegerMatrixTester, std::int16_t, std::uint16_t, std::int32_t, std::uint32_t, std::int64_t, std::uint64_t, long long>::test();
+    TestGenerator<CompactPointTester, std::int16_t, std::int32_t>::test();
+    TestGenerator<ConversionTester, Geometrix::LA::Vector3D<float>, Geometrix::LA::Vector4D<float>, Geometrix::LA::Matrix<float, 3, 3>,
+                  Geometrix::LA::Matrix<float, 4, 4>>::test();
+    TestGenerator<MatrixViewTester, float, double>::test();
+    TestGenerator<QuaternionTester, float, double>::test();
+    TestGenerator<AffineTester, float, double>::test();
+    TestGenerator<SkinningTester, float, double>::test();
+    TestGenerator<ReductionTester, float, double>::test();
     std::cout << std::endl << "Matrix tests finished succesfully" << std::endl;
     return 0;
 }
@@ -10,6 +10,8 @@
 #include <vector>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include "../include/matrix.hpp"
 
 //============================== Accuracy suite ============================//
 
@@ -52,6 +54,44 @@ template<typename T> T relativeError(const T& measure, const T& control, bool* e
     return std::abs(1 - std::abs(measure / control));
 }
 
+// measure is within tolerance of control, relative to |control| above 1 and absolute below,
+// integers compare exactly
+template<typename T> bool approxEqual(const T& measure, const T& control, T tolerance = T(1e-4))
+{
+    return std::abs(measure - control) <= tolerance * (T(1) + std::abs(control));
+}
+
+// the same numbers on every run, consecutive seeds continue the sequence. Narrow ones are
+// multiples of 1/8 in [-1, 1] (integers in [-8, 8]), so sums and products of a few are exact,
+// wide ones take all bits of integers and 24 bits of floating-point numbers.
+// diagonal is added to (i, i) numbers, to keep square matrices well conditioned
+template<typename T, std::size_t R, std::size_t C, bool Wide = false>
+Geometrix::LA::Matrix<T, R, C> numbers(std::size_t seed, T diagonal = T(0))
+{
+    Geometrix::LA::Matrix<T, R, C> m;
+    for (std::size_t i = 0; i < R; ++i)
+        for (std::size_t j = 0; j < C; ++j)
+        {
+            std::uint64_t x = ((seed * R + i) * C + j + 1) * 0x9E3779B97F4A7C15ull;
+            x ^= x >> 29;
+            x *= 0xBF58476D1CE4E5B9ull;
+            T number;
+            if constexpr (Wide)
+                number = std::is_integral_v<T> ? T(x) : T(std::int64_t(x) >> 40);
+            else
+                number = std::is_integral_v<T> ? T(int(x % 17) - 8) : T(int(x % 17) - 8) / T(8);
+            if (i == j)
+                number += diagonal;
+            if constexpr (R == 1 && C == 1)
+                m = number;
+            else if constexpr (R == 1)
+                m[j] = number;
+            else
+                m[i][j] = number;
+        }
+    return m;
+}
+
 // Root-Mean-Square error
 template<typename T> T rmsError(const std::vector<T>& measure, const std::vector<T>& control)
 {